@@ -0,0 +1,826 @@
+/**************************************************************************//*!
+ *  @file           if_aio.c
+ *  @brief          [APP] ファイルへの書き込みを io_uring か書き出し用のスレッドで行う。
+ *  @author         Ryoji Morita
+ *  @attention      AppIfAio_Writev() を呼ぶのは 1 スレッドに限る。
+ *  @sa             if_aio.h
+ *  @note           io_uring は liburing を使わず、io_uring_setup / io_uring_enter / io_uring_register を
+ *                  直接呼ぶ。WRITE_FIXED には IOSQE_ASYNC を付け、io_uring_enter() の中で
+ *                  ファイルシステムの処理 ( ページキャッシュへのコピーや書き戻し待ち ) をさせない。
+ *                  完了の回収は次の AppIfAio_Writev() の先頭で、待たずに行う。
+ *                  io_uring が使えない ( カーネルが古い, seccomp で禁止, memlock の制限 ) 場合は
+ *                  書き出し用のスレッドを使う。呼び出し元はスロットの番号を積んで sem_post() するだけ。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined( __has_include )
+#  if __has_include( <linux/io_uring.h> ) && defined( __NR_io_uring_setup )
+#    include <linux/io_uring.h>
+#    define AIO_URING
+#  endif
+#endif
+
+#include "if_aio.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define AIO_WAIT_USEC       (100)       // スレッドの書き出しを待つ間隔 ( usec )
+
+// io_uring の user_data ( スロットの番号 << 2 | fsync << 1 | 最後の操作 )
+#define AIO_UD( slot, fsync, last )     ( ( (unsigned long long)(slot) << 2 ) | ( (fsync) << 1 ) | (last) )
+#define AIO_UD_SLOT( ud )               ( (unsigned int)( (ud) >> 2 ) )
+#define AIO_UD_FSYNC( ud )              ( ( (ud) >> 1 ) & 1 )
+#define AIO_UD_LAST( ud )               ( (ud) & 1 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// スロットの型
+typedef struct tagSAppIfAioSlot
+{
+    int                 busy;       // 1 : 書き出し中 ( 書き出しが終わった側が 0 にする )
+    int                 fd;         // 書き込み先
+    size_t              len;        // 書き込むサイズ ( Byte )
+    unsigned long long  off;        // 書き込む位置 ( Byte )
+    EHalBool_t          sync;       // EN_TRUE : 書き込みの後に fdatasync() する
+    unsigned char*      buf;        // データ ( g_buf の中 )
+} SAppIfAioSlot_t;
+
+
+#ifdef AIO_URING
+// io_uring の型
+typedef struct tagSAppIfAioRing
+{
+    int                 fd;         // io_uring の fd
+    void*               sq;         // SQ リングの mmap 先
+    size_t              sqSize;     // SQ リングの mmap サイズ
+    void*               cq;         // CQ リングの mmap 先 ( IORING_FEAT_SINGLE_MMAP の場合は sq と同じ )
+    size_t              cqSize;     // CQ リングの mmap サイズ
+    struct io_uring_sqe*    sqes;   // SQE の配列
+    size_t              sqesSize;   // SQE の配列の mmap サイズ
+    unsigned int*       sqTail;
+    unsigned int*       sqMask;
+    unsigned int*       sqArray;
+    unsigned int*       cqHead;
+    unsigned int*       cqTail;
+    unsigned int*       cqMask;
+    struct io_uring_cqe*    cqes;
+} SAppIfAioRing_t;
+#endif
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static EAppIfAioMode_t  g_mode = EN_AIO_SYNC;           // 書き出しの方法
+static unsigned char*   g_buf = NULL;                   // スロットのバッファ ( mmap )
+static SAppIfAioSlot_t  g_slot[APP_IF_AIO_SLOT_NUM];    // スロット
+static SAppIfAioStat_t  g_stat;                         // 統計 ( done, error, bytes は書き出した側が加算 )
+
+#ifdef AIO_URING
+static SAppIfAioRing_t  g_ring;                         // io_uring
+#endif
+
+static pthread_t        g_thread;                       // 書き出し用のスレッド
+static sem_t            g_sem;                          // 積んだスロットの数
+static int              g_run = 0;                      // 1 : 書き出し用のスレッドが動いている
+static unsigned int     g_que[APP_IF_AIO_SLOT_NUM];     // 積んだスロットの番号
+static unsigned int     g_queHead = 0;                  // 次に取り出す位置 ( スレッド )
+static unsigned int     g_queTail = 0;                  // 次に積む位置 ( 呼び出し元 )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   WriteSync( int fd, const struct iovec* iov, int num, unsigned long long off, EHalBool_t sync );
+static void         Done( unsigned int slot, long long res, int fsync, int last );
+static int          Busy( void );
+
+#ifdef AIO_URING
+static EHalBool_t   UringOpen( void );
+static void         UringClose( void );
+static void         UringReap( void );
+static EHalBool_t   UringSubmit( unsigned int slot );
+#endif
+
+static void*        ThreadMain( void* arg );
+static EHalBool_t   ThreadOpen( void );
+static void         ThreadClose( void );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     呼び出し元のスレッドで書き込む。
+ * @attention なし。
+ * @note      途中までしか書けなかった場合は残りを書く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+WriteSync(
+    int                 fd,     ///< [in] 書き込み先
+    const struct iovec* iov,    ///< [in] データ
+    int                 num,    ///< [in] iov の数
+    unsigned long long  off,    ///< [in] 書き込む位置 ( Byte )
+    EHalBool_t          sync    ///< [in] EN_TRUE : 書き込みの後に fdatasync() する
+){
+    struct iovec        vec[8];
+    struct iovec*       v = vec;
+    ssize_t             res = 0;
+
+    if( num > (int)( sizeof(vec) / sizeof(vec[0]) ) )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : num = %d \n\r", num );
+        return EN_FALSE;
+    }
+
+    memcpy( vec, iov, sizeof(struct iovec) * (size_t)num );
+    while( num > 0 )
+    {
+        res = pwritev( fd, v, num, (off_t)off );
+        if( res < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            DBG_PRINT_ERROR( "pwritev() error. : %s \n\r", strerror( errno ) );
+            return EN_FALSE;
+        }
+        off += (unsigned long long)res;
+        __atomic_add_fetch( &g_stat.bytes, (unsigned long long)res, __ATOMIC_RELAXED );
+        while( num > 0 && (size_t)res >= v->iov_len )
+        {
+            res -= (ssize_t)v->iov_len;
+            v++;
+            num--;
+        }
+        if( num > 0 )
+        {
+            v->iov_base = (char*)v->iov_base + res;
+            v->iov_len -= (size_t)res;
+        }
+    }
+
+    if( sync && fdatasync( fd ) < 0 )
+    {
+        DBG_PRINT_ERROR( "fdatasync() error. : %s \n\r", strerror( errno ) );
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     スロットの 1 つの操作が終わった時の処理を行う。
+ * @attention なし。
+ * @note      最後の操作 ( fsync, fsync しない場合は write ) でスロットを空ける。
+ *            write が途中までしか書けなかった場合も失敗として数える
+ *            ( 繋いだ fsync は -ECANCELED で終わる )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Done(
+    unsigned int        slot,   ///< [in] スロットの番号
+    long long           res,    ///< [in] 結果 ( write : 書いたサイズ, 負 : -errno )
+    int                 fsync,  ///< [in] 1 : fsync の結果
+    int                 last    ///< [in] 1 : スロットの最後の操作
+){
+    SAppIfAioSlot_t*    s = &g_slot[slot];
+
+    if( res < 0 || ( !fsync && (size_t)res != s->len ) )
+    {
+        if( res != -ECANCELED )
+        {
+            DBG_PRINT_ERROR( "%s error. : %lld \n\r", fsync ? "fsync" : "write", res );
+        }
+        __atomic_add_fetch( &g_stat.error, 1, __ATOMIC_RELAXED );
+    } else if( !fsync )
+    {
+        __atomic_add_fetch( &g_stat.bytes, (unsigned long long)res, __ATOMIC_RELAXED );
+    }
+
+    if( last )
+    {
+        __atomic_add_fetch( &g_stat.done, 1, __ATOMIC_RELAXED );
+        __atomic_store_n( &s->busy, 0, __ATOMIC_RELEASE );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出し中のスロットの数を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    書き出し中のスロットの数
+ *************************************************************************** */
+static int
+Busy(
+    void
+){
+    int             num = 0;
+    unsigned int    i = 0;
+
+    for( i = 0; i < APP_IF_AIO_SLOT_NUM; i++ )
+    {
+        num += __atomic_load_n( &g_slot[i].busy, __ATOMIC_ACQUIRE );
+    }
+    return num;
+}
+
+
+#ifdef AIO_URING
+/**************************************************************************//*!
+ * @brief     io_uring を作成し、スロットを登録済みバッファにする。
+ * @attention なし。
+ * @note      SQE はスロット毎に最大 2 個 ( write + fsync ) なので、SQ はスロット数の 2 倍。
+ * @sa        UringClose()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+UringOpen(
+    void
+){
+    struct io_uring_params  p;
+    struct iovec            iov[APP_IF_AIO_SLOT_NUM];
+    unsigned char*          sq = NULL;
+    unsigned char*          cq = NULL;
+    unsigned int            i = 0;
+
+    memset( &g_ring, 0, sizeof(g_ring) );
+    g_ring.sq   = MAP_FAILED;
+    g_ring.cq   = MAP_FAILED;
+    g_ring.sqes = MAP_FAILED;
+
+    memset( &p, 0, sizeof(p) );
+    g_ring.fd = (int)syscall( __NR_io_uring_setup, APP_IF_AIO_SLOT_NUM * 2, &p );
+    if( g_ring.fd < 0 )
+    {
+        DBG_PRINT_WARN( "io_uring_setup() error. : %s \n\r", strerror( errno ) );
+        return EN_FALSE;
+    }
+
+    g_ring.sqSize   = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    g_ring.cqSize   = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    g_ring.sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    if( p.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        if( g_ring.cqSize > g_ring.sqSize ){ g_ring.sqSize = g_ring.cqSize; }
+        g_ring.cqSize = g_ring.sqSize;
+    }
+
+    g_ring.sq = mmap( NULL, g_ring.sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      g_ring.fd, IORING_OFF_SQ_RING );
+    if( g_ring.sq == MAP_FAILED ){ goto err; }
+
+    if( p.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        g_ring.cq = g_ring.sq;
+    } else
+    {
+        g_ring.cq = mmap( NULL, g_ring.cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          g_ring.fd, IORING_OFF_CQ_RING );
+        if( g_ring.cq == MAP_FAILED ){ goto err; }
+    }
+
+    g_ring.sqes = (struct io_uring_sqe*)mmap( NULL, g_ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                              g_ring.fd, IORING_OFF_SQES );
+    if( g_ring.sqes == MAP_FAILED ){ goto err; }
+
+    sq = (unsigned char*)g_ring.sq;
+    cq = (unsigned char*)g_ring.cq;
+    g_ring.sqTail  = (unsigned int*)( sq + p.sq_off.tail );
+    g_ring.sqMask  = (unsigned int*)( sq + p.sq_off.ring_mask );
+    g_ring.sqArray = (unsigned int*)( sq + p.sq_off.array );
+    g_ring.cqHead  = (unsigned int*)( cq + p.cq_off.head );
+    g_ring.cqTail  = (unsigned int*)( cq + p.cq_off.tail );
+    g_ring.cqMask  = (unsigned int*)( cq + p.cq_off.ring_mask );
+    g_ring.cqes    = (struct io_uring_cqe*)( cq + p.cq_off.cqes );
+
+    for( i = 0; i < APP_IF_AIO_SLOT_NUM; i++ )
+    {
+        iov[i].iov_base = g_slot[i].buf;
+        iov[i].iov_len  = APP_IF_AIO_SLOT_SIZE;
+    }
+    if( syscall( __NR_io_uring_register, g_ring.fd, IORING_REGISTER_BUFFERS, iov, APP_IF_AIO_SLOT_NUM ) < 0 )
+    {
+        DBG_PRINT_WARN( "IORING_REGISTER_BUFFERS error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+    return EN_TRUE;
+
+err :
+    UringClose();
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     io_uring を閉じる。
+ * @attention 書き出し中のスロットがないこと ( AppIfAio_Drain() )。
+ * @note      登録済みバッファは io_uring を閉じると解除される。
+ * @sa        UringOpen()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+UringClose(
+    void
+){
+    if( g_ring.sqes != MAP_FAILED ){ munmap( g_ring.sqes, g_ring.sqesSize ); }
+    if( g_ring.cq != MAP_FAILED && g_ring.cq != g_ring.sq ){ munmap( g_ring.cq, g_ring.cqSize ); }
+    if( g_ring.sq != MAP_FAILED ){ munmap( g_ring.sq, g_ring.sqSize ); }
+    if( g_ring.fd >= 0 ){ close( g_ring.fd ); }
+    memset( &g_ring, 0, sizeof(g_ring) );
+    g_ring.fd = -1;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     終わった操作を CQ から回収する。
+ * @attention なし。
+ * @note      待たない ( システムコールを呼ばない )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+UringReap(
+    void
+){
+    unsigned int            head = *g_ring.cqHead;
+    unsigned int            tail = __atomic_load_n( g_ring.cqTail, __ATOMIC_ACQUIRE );
+    struct io_uring_cqe*    cqe = NULL;
+
+    while( head != tail )
+    {
+        cqe = &g_ring.cqes[head & *g_ring.cqMask];
+        Done( AIO_UD_SLOT( cqe->user_data ), cqe->res, (int)AIO_UD_FSYNC( cqe->user_data ), (int)AIO_UD_LAST( cqe->user_data ) );
+        head++;
+    }
+    __atomic_store_n( g_ring.cqHead, head, __ATOMIC_RELEASE );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     スロットの書き込み ( と fdatasync ) を投入する。
+ * @attention なし。
+ * @note      WRITE_FIXED と FSYNC ( IORING_FSYNC_DATASYNC ) を IOSQE_IO_LINK で繋ぐので、
+ *            fsync は write が全て書けた場合だけ実行される。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+UringSubmit(
+    unsigned int            slot    ///< [in] スロットの番号
+){
+    SAppIfAioSlot_t*        s = &g_slot[slot];
+    struct io_uring_sqe*    sqe = NULL;
+    unsigned int            tail = *g_ring.sqTail;
+    unsigned int            num = 0;
+    long                    res = 0;
+
+    sqe = &g_ring.sqes[tail & *g_ring.sqMask];
+    memset( sqe, 0, sizeof(*sqe) );
+    sqe->opcode    = IORING_OP_WRITE_FIXED;
+    sqe->flags     = IOSQE_ASYNC | ( s->sync ? IOSQE_IO_LINK : 0 );
+    sqe->fd        = s->fd;
+    sqe->off       = s->off;
+    sqe->addr      = (unsigned long long)(uintptr_t)s->buf;
+    sqe->len       = (unsigned int)s->len;
+    sqe->buf_index = (unsigned short)slot;
+    sqe->user_data = AIO_UD( slot, 0, s->sync ? 0 : 1 );
+    g_ring.sqArray[tail & *g_ring.sqMask] = tail & *g_ring.sqMask;
+    tail++;
+    num++;
+
+    if( s->sync )
+    {
+        sqe = &g_ring.sqes[tail & *g_ring.sqMask];
+        memset( sqe, 0, sizeof(*sqe) );
+        sqe->opcode      = IORING_OP_FSYNC;
+        sqe->fd          = s->fd;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->user_data   = AIO_UD( slot, 1, 1 );
+        g_ring.sqArray[tail & *g_ring.sqMask] = tail & *g_ring.sqMask;
+        tail++;
+        num++;
+    }
+    __atomic_store_n( g_ring.sqTail, tail, __ATOMIC_RELEASE );
+
+    do
+    {
+        res = syscall( __NR_io_uring_enter, g_ring.fd, num, 0, 0, NULL, 0 );
+    } while( res < 0 && errno == EINTR );
+    if( res != (long)num )
+    {
+        DBG_PRINT_ERROR( "io_uring_enter() error. : %ld : %s \n\r", res, strerror( errno ) );
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+#endif
+
+
+/**************************************************************************//*!
+ * @brief     書き出し用のスレッド
+ * @attention なし。
+ * @note      積まれたスロットを順に書き出す。AppIfAio_Close() で空になってから終了する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    NULL
+ *************************************************************************** */
+static void*
+ThreadMain(
+    void*               arg     ///< [in] 未使用
+){
+    SAppIfAioSlot_t*    s = NULL;
+    struct iovec        iov;
+    unsigned int        slot = 0;
+    EHalBool_t          ok = EN_FALSE;
+
+    (void)arg;
+
+    while( 1 )
+    {
+        while( sem_wait( &g_sem ) < 0 && errno == EINTR ){}
+
+        if( g_queHead == __atomic_load_n( &g_queTail, __ATOMIC_ACQUIRE ) )
+        {
+            if( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) == 0 ){ break; }
+            continue;
+        }
+
+        slot = g_que[g_queHead % APP_IF_AIO_SLOT_NUM];
+        __atomic_store_n( &g_queHead, g_queHead + 1, __ATOMIC_RELEASE );
+
+        s = &g_slot[slot];
+        iov.iov_base = s->buf;
+        iov.iov_len  = s->len;
+        ok = WriteSync( s->fd, &iov, 1, s->off, s->sync );
+        if( ok == EN_FALSE ){ __atomic_add_fetch( &g_stat.error, 1, __ATOMIC_RELAXED ); }
+        __atomic_add_fetch( &g_stat.done, 1, __ATOMIC_RELAXED );
+        __atomic_store_n( &s->busy, 0, __ATOMIC_RELEASE );
+    }
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出し用のスレッドを起動する。
+ * @attention なし。
+ * @note      スレッドはシグナルを受けない ( 全てのシグナルをブロックして起動する )。
+ * @sa        ThreadClose()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+ThreadOpen(
+    void
+){
+    sigset_t        all;
+    sigset_t        org;
+    int             res = 0;
+
+    if( sem_init( &g_sem, 0, 0 ) < 0 )
+    {
+        DBG_PRINT_ERROR( "sem_init() error. : %s \n\r", strerror( errno ) );
+        return EN_FALSE;
+    }
+    g_queHead = 0;
+    g_queTail = 0;
+    __atomic_store_n( &g_run, 1, __ATOMIC_RELEASE );
+
+    sigfillset( &all );
+    pthread_sigmask( SIG_SETMASK, &all, &org );
+    res = pthread_create( &g_thread, NULL, ThreadMain, NULL );
+    pthread_sigmask( SIG_SETMASK, &org, NULL );
+    if( res != 0 )
+    {
+        DBG_PRINT_ERROR( "pthread_create() error. : %s \n\r", strerror( res ) );
+        __atomic_store_n( &g_run, 0, __ATOMIC_RELEASE );
+        sem_destroy( &g_sem );
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出し用のスレッドを終了する。
+ * @attention なし。
+ * @note      積まれたスロットを全て書き出してから終了する。
+ * @sa        ThreadOpen()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+ThreadClose(
+    void
+){
+    __atomic_store_n( &g_run, 0, __ATOMIC_RELEASE );
+    sem_post( &g_sem );
+    pthread_join( g_thread, NULL );
+    sem_destroy( &g_sem );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出しを開始する。
+ * @attention 既に開始している場合は終了してから開始する。
+ * @note      EN_AIO_AUTO は io_uring, 書き出し用のスレッドの順に試す。
+ *            EN_AIO_SYNC は終了した状態と同じ ( 呼び出し元で書く )。
+ * @sa        AppIfAio_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 呼び出し元で書く )
+ *************************************************************************** */
+EHalBool_t
+AppIfAio_Open(
+    EAppIfAioMode_t mode    ///< [in] 書き出しの方法
+){
+    unsigned int    i = 0;
+
+    DBG_PRINT_TRACE( "mode = %d \n\r", mode );
+
+    AppIfAio_Close();
+    if( mode == EN_AIO_SYNC )
+    {
+        return EN_TRUE;
+    }
+
+    g_buf = (unsigned char*)mmap( NULL, (size_t)APP_IF_AIO_SLOT_NUM * APP_IF_AIO_SLOT_SIZE, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0 );
+    if( g_buf == MAP_FAILED )
+    {
+        DBG_PRINT_ERROR( "mmap() error. : %s \n\r", strerror( errno ) );
+        g_buf = NULL;
+        return EN_FALSE;
+    }
+    memset( g_slot, 0, sizeof(g_slot) );
+    for( i = 0; i < APP_IF_AIO_SLOT_NUM; i++ )
+    {
+        g_slot[i].buf = g_buf + (size_t)i * APP_IF_AIO_SLOT_SIZE;
+    }
+
+#ifdef AIO_URING
+    if( mode == EN_AIO_AUTO || mode == EN_AIO_URING )
+    {
+        if( UringOpen() == EN_TRUE )
+        {
+            g_mode = EN_AIO_URING;
+            return EN_TRUE;
+        }
+        if( mode == EN_AIO_URING ){ goto err; }
+    }
+#else
+    if( mode == EN_AIO_URING )
+    {
+        DBG_PRINT_ERROR( "built without io_uring. \n\r" );
+        goto err;
+    }
+#endif
+
+    if( ThreadOpen() == EN_TRUE )
+    {
+        g_mode = EN_AIO_THREAD;
+        return EN_TRUE;
+    }
+
+err :
+    munmap( g_buf, (size_t)APP_IF_AIO_SLOT_NUM * APP_IF_AIO_SLOT_SIZE );
+    g_buf = NULL;
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出しを終了する。
+ * @attention なし。
+ * @note      書き出し中のスロットが全て終わるまで待つ。以降は呼び出し元で書く。
+ * @sa        AppIfAio_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfAio_Close(
+    void
+){
+    if( g_mode == EN_AIO_SYNC )
+    {
+        return;
+    }
+    DBG_PRINT_TRACE( "\n\r" );
+
+    AppIfAio_Drain();
+#ifdef AIO_URING
+    if( g_mode == EN_AIO_URING ){ UringClose(); }
+#endif
+    if( g_mode == EN_AIO_THREAD ){ ThreadClose(); }
+
+    munmap( g_buf, (size_t)APP_IF_AIO_SLOT_NUM * APP_IF_AIO_SLOT_SIZE );
+    g_buf  = NULL;
+    g_mode = EN_AIO_SYNC;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出しの方法を返す。
+ * @attention なし。
+ * @note      EN_AIO_AUTO で開始した場合は、実際に使っている方法を返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    書き出しの方法 ( EN_AIO_URING, EN_AIO_THREAD, EN_AIO_SYNC )
+ *************************************************************************** */
+EAppIfAioMode_t
+AppIfAio_GetMode(
+    void
+){
+    return g_mode;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ファイルの off の位置に書き込む。
+ * @attention データは APP_IF_AIO_SLOT_SIZE 以下であること。
+ * @note      データを空いているスロットにコピーして書き出しに回し、待たずに戻る。
+ *            空いているスロットがない場合は捨てて EN_FALSE を返す。
+ *            開始していない ( EN_AIO_SYNC ) 場合は、その場で書き込む。
+ * @sa        AppIfAio_Drain()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功 ( 書き出しに回した ), EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfAio_Writev(
+    int                 fd,     ///< [in] 書き込み先 ( 書き出しが終わるまで閉じないこと )
+    const struct iovec* iov,    ///< [in] データ
+    int                 num,    ///< [in] iov の数
+    unsigned long long  off,    ///< [in] 書き込む位置 ( Byte )
+    EHalBool_t          sync    ///< [in] EN_TRUE : 書き込みの後に fdatasync() する
+){
+    SAppIfAioSlot_t*    s = NULL;
+    size_t              len = 0;
+    unsigned int        slot = 0;
+    int                 i = 0;
+    EHalBool_t          ok = EN_FALSE;
+
+    __atomic_add_fetch( &g_stat.submit, 1, __ATOMIC_RELAXED );
+    if( g_mode == EN_AIO_SYNC )
+    {
+        ok = WriteSync( fd, iov, num, off, sync );
+        if( ok == EN_FALSE ){ __atomic_add_fetch( &g_stat.error, 1, __ATOMIC_RELAXED ); }
+        __atomic_add_fetch( &g_stat.done, 1, __ATOMIC_RELAXED );
+        return ok;
+    }
+
+#ifdef AIO_URING
+    if( g_mode == EN_AIO_URING ){ UringReap(); }
+#endif
+
+    for( i = 0; i < num; i++ )
+    {
+        len += iov[i].iov_len;
+    }
+    if( len > APP_IF_AIO_SLOT_SIZE )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : len = %zu \n\r", len );
+        __atomic_add_fetch( &g_stat.error, 1, __ATOMIC_RELAXED );
+        return EN_FALSE;
+    }
+
+    for( slot = 0; slot < APP_IF_AIO_SLOT_NUM; slot++ )
+    {
+        if( __atomic_load_n( &g_slot[slot].busy, __ATOMIC_ACQUIRE ) == 0 ){ break; }
+    }
+    if( slot >= APP_IF_AIO_SLOT_NUM )
+    {
+        __atomic_add_fetch( &g_stat.drop, 1, __ATOMIC_RELAXED );
+        return EN_FALSE;
+    }
+
+    s = &g_slot[slot];
+    s->fd   = fd;
+    s->len  = 0;
+    s->off  = off;
+    s->sync = sync;
+    for( i = 0; i < num; i++ )
+    {
+        memcpy( s->buf + s->len, iov[i].iov_base, iov[i].iov_len );
+        s->len += iov[i].iov_len;
+    }
+    s->busy = 1;
+
+#ifdef AIO_URING
+    if( g_mode == EN_AIO_URING )
+    {
+        if( UringSubmit( slot ) == EN_FALSE )
+        {
+            // 投入できなかった SQE は次の io_uring_enter() で投入されるので、スロットは空けない
+            __atomic_add_fetch( &g_stat.error, 1, __ATOMIC_RELAXED );
+            return EN_FALSE;
+        }
+        return EN_TRUE;
+    }
+#endif
+
+    g_que[g_queTail % APP_IF_AIO_SLOT_NUM] = slot;
+    __atomic_store_n( &g_queTail, g_queTail + 1, __ATOMIC_RELEASE );
+    sem_post( &g_sem );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き出し中のスロットが全て終わるまで待つ。
+ * @attention 待つので、周期処理の中では呼ばないこと。
+ * @note      ファイルを閉じる前に呼ぶ。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfAio_Drain(
+    void
+){
+    while( g_mode != EN_AIO_SYNC && Busy() > 0 )
+    {
+#ifdef AIO_URING
+        if( g_mode == EN_AIO_URING )
+        {
+            syscall( __NR_io_uring_enter, g_ring.fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0 );
+            UringReap();
+            continue;
+        }
+#endif
+        usleep( AIO_WAIT_USEC );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き込みの統計を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfAio_GetStat(
+    SAppIfAioStat_t*    out     ///< [out] 統計
+){
+    out->submit = __atomic_load_n( &g_stat.submit, __ATOMIC_RELAXED );
+    out->done   = __atomic_load_n( &g_stat.done,   __ATOMIC_RELAXED );
+    out->drop   = __atomic_load_n( &g_stat.drop,   __ATOMIC_RELAXED );
+    out->error  = __atomic_load_n( &g_stat.error,  __ATOMIC_RELAXED );
+    out->bytes  = __atomic_load_n( &g_stat.bytes,  __ATOMIC_RELAXED );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
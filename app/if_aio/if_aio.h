@@ -0,0 +1,82 @@
+/**************************************************************************//*!
+ *  @file           if_aio.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           ファイルへの書き込み ( と fdatasync() ) を呼び出し元のスレッドから切り離す。
+ *                  書き込むデータは APP_IF_AIO_SLOT_NUM 個のスロット ( 固定長のバッファ ) の
+ *                  どれかにコピーしてから書き出しに回すので、呼び出し元はすぐに戻る。
+ *                  書き出しの方法
+ *                      uring  : io_uring ( システムコールを直接呼ぶ )。スロットは登録済みバッファで、
+ *                               WRITE_FIXED と FSYNC を IOSQE_IO_LINK で繋いで 1 回で投入する。
+ *                      thread : 書き出し用のスレッドが pwrite() と fdatasync() を行う。
+ *                      sync   : 呼び出し元のスレッドで pwrite() と fdatasync() を行う ( 開始前の状態 )。
+ *                  空いているスロットがない場合は書き込みを捨てて数を数える ( 呼び出し元を待たせない )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_AIO_H_
+#define _APP_IF_AIO_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <sys/uio.h>
+
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_AIO_SLOT_NUM     (8)                 ///< @def : スロットの数
+#define APP_IF_AIO_SLOT_SIZE    (256 * 1024)        ///< @def : 1 スロットのサイズ ( Byte )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// 書き出しの方法に使用する型
+typedef enum tagEAppIfAioMode
+{
+    EN_AIO_AUTO = 0,        ///< @var : io_uring が使えなければ書き出し用のスレッド
+    EN_AIO_URING,           ///< @var : io_uring
+    EN_AIO_THREAD,          ///< @var : 書き出し用のスレッド
+    EN_AIO_SYNC             ///< @var : 呼び出し元のスレッド
+} EAppIfAioMode_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 書き込みの統計に使用する型
+typedef struct tagSAppIfAioStat
+{
+    unsigned long long  submit;     ///< @var : 書き出しに回した数
+    unsigned long long  done;       ///< @var : 書き出しが終わった数
+    unsigned long long  drop;       ///< @var : スロットが空いていないので捨てた数
+    unsigned long long  error;      ///< @var : 書き出しに失敗した数
+    unsigned long long  bytes;      ///< @var : 書き出したサイズ ( Byte )
+} SAppIfAioStat_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+EHalBool_t          AppIfAio_Open( EAppIfAioMode_t mode );
+void                AppIfAio_Close( void );
+EAppIfAioMode_t     AppIfAio_GetMode( void );
+EHalBool_t          AppIfAio_Writev( int fd, const struct iovec* iov, int num, unsigned long long off, EHalBool_t sync );
+void                AppIfAio_Drain( void );
+void                AppIfAio_GetStat( SAppIfAioStat_t* out );
+
+
+#endif /* _APP_IF_AIO_H_ */
@@ -0,0 +1,405 @@
+/**************************************************************************//*!
+ *  @file           if_arc.c
+ *  @brief          [APP] センサの生値を列毎に差分符号化してアーカイブに書き込む。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_arc.h ( ファイルのレイアウト ), if_arc_codec.c ( 符号化 ),
+ *                  if_arc_reader.c ( 読み出し側 )
+ *  @note           書き込みは 1 プロセス ( 1 スレッド ) に限る。
+ *                  レコードはメモリ上のブロックに列毎に溜め、APP_IF_ARC_BLOCK_NUM 個溜まるか
+ *                  APP_IF_ARC_BLOCK_MSEC 経つ度に符号化し、if_aio で書き出す ( fdatasync() まで待たない )。
+ *                  書き出す位置はこのファイルで決める ( pwritev() / AppIfAio_Writev() に渡す )。
+ *                  ブロックの索引はメモリ上に持ち、閉じる時に末尾と一緒に書き出す。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#include "if_arc.h"
+#include "../if_aio/if_aio.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define ARC_NSEC_PER_MSEC   (1000000ULL)
+
+#ifdef HAVE_LZ4
+#  define ARC_LZ4_MAX       LZ4_COMPRESSBOUND( APP_IF_ARC_RAW_MAX )
+#endif
+
+// 1 ブロックは if_aio の 1 スロットに入ること ( LZ4 は小さくなった場合だけ使う )
+_Static_assert( sizeof(SAppIfArcBlk_t) + APP_IF_ARC_RAW_MAX <= APP_IF_AIO_SLOT_SIZE, "block exceeds APP_IF_AIO_SLOT_SIZE" );
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static int                  g_fd = -1;                      // 書き込み中のファイル
+static unsigned int         g_flags = 0;                    // APP_IF_ARC_FLAG_*
+static unsigned long long   g_off = 0;                      // 次のブロックの位置 ( Byte )
+static unsigned long long   g_count = 0;                    // 書き出したレコード数
+static SAppIfArcCol_t       g_col;                          // 溜めているブロック
+static unsigned char        g_buf[APP_IF_ARC_RAW_MAX];      // 符号化したペイロード
+#ifdef HAVE_LZ4
+static char                 g_lz4[ARC_LZ4_MAX];             // 圧縮したペイロード
+#endif
+static SAppIfArcIdx_t*      g_idx = NULL;                   // ブロックの索引
+static unsigned long long   g_idxNum = 0;                   // ブロックの数
+static unsigned long long   g_idxCap = 0;                   // g_idx に入る数
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   WriteAll( const struct iovec* iov, int num );
+static EHalBool_t   Flush( void );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     iov を g_off の位置に全て書き出す。
+ * @attention 呼び出し元のスレッドで書く ( ヘッダ, 索引, 末尾 )。
+ * @note      途中までしか書けなかった場合は残りを書く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+WriteAll(
+    const struct iovec* iov,    ///< [in] 書き出すデータ
+    int                 num     ///< [in] iov の数
+){
+    struct iovec        vec[4];
+    struct iovec*       v = vec;
+    ssize_t             res = 0;
+
+    memcpy( vec, iov, sizeof(struct iovec) * (size_t)num );
+    while( num > 0 )
+    {
+        res = pwritev( g_fd, v, num, (off_t)g_off );
+        if( res < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            DBG_PRINT_ERROR( "pwritev() error. : %s \n\r", strerror( errno ) );
+            return EN_FALSE;
+        }
+        g_off += (unsigned long long)res;
+        while( num > 0 && (size_t)res >= v->iov_len )
+        {
+            res -= (ssize_t)v->iov_len;
+            v++;
+            num--;
+        }
+        if( num > 0 )
+        {
+            v->iov_base = (char*)v->iov_base + res;
+            v->iov_len -= (size_t)res;
+        }
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     溜めているブロックを符号化して書き出す。
+ * @attention なし。
+ * @note      LZ4 で小さくならない場合は圧縮せずに書く。
+ *            ブロックはスロットにコピーされるので、戻った後は g_buf, g_lz4 を上書きしてよい。
+ *            書き出しを開始している場合 ( AppIfAio_Open() ) は fdatasync() を繋ぐ。
+ *            呼び出し元のスレッドで書く場合は、周期処理を止めないよう fdatasync() しない。
+ *            スロットが空いていない場合は失敗し、ブロックは溜めたまま次の AppIfArc_Write() で再度書き出す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+Flush(
+    void
+){
+    SAppIfArcBlk_t      blk;
+    SAppIfArcIdx_t*     idx = NULL;
+    struct iovec        iov[2];
+    size_t              size = 0;
+#ifdef HAVE_LZ4
+    int                 lz4 = 0;
+#endif
+
+    if( g_col.count == 0 )
+    {
+        return EN_TRUE;
+    }
+
+    if( g_idxNum >= g_idxCap )
+    {
+        idx = (SAppIfArcIdx_t*)realloc( g_idx, sizeof(SAppIfArcIdx_t) * ( g_idxCap + 256 ) );
+        if( idx == NULL )
+        {
+            DBG_PRINT_ERROR( "realloc() error. \n\r" );
+            return EN_FALSE;
+        }
+        g_idx = idx;
+        g_idxCap += 256;
+    }
+
+    memset( &blk, 0, sizeof(blk) );
+    size = AppIfArc_Encode( g_buf, blk.col, &g_col );
+    blk.magic    = APP_IF_ARC_BLK_MAGIC;
+    blk.count    = g_col.count;
+    blk.raw_size = (unsigned int)size;
+    blk.size     = (unsigned int)size;
+    blk.first    = g_col.ts[0];
+    blk.last     = g_col.ts[g_col.count - 1];
+    iov[0].iov_base = &blk;
+    iov[0].iov_len  = sizeof(blk);
+    iov[1].iov_base = g_buf;
+    iov[1].iov_len  = size;
+
+#ifdef HAVE_LZ4
+    if( g_flags & APP_IF_ARC_FLAG_LZ4 )
+    {
+        lz4 = LZ4_compress_default( (const char*)g_buf, g_lz4, (int)size, (int)sizeof(g_lz4) );
+        if( lz4 > 0 && (size_t)lz4 < size )
+        {
+            blk.flags      |= APP_IF_ARC_FLAG_LZ4;
+            blk.size        = (unsigned int)lz4;
+            iov[1].iov_base = g_lz4;
+            iov[1].iov_len  = (size_t)lz4;
+        }
+    }
+#endif
+
+    g_idx[g_idxNum].offset = g_off;
+    g_idx[g_idxNum].first  = blk.first;
+    g_idx[g_idxNum].last   = blk.last;
+    g_idx[g_idxNum].count  = blk.count;
+
+    if( AppIfAio_Writev( g_fd, iov, 2, g_off, ( AppIfAio_GetMode() != EN_AIO_SYNC ) ? EN_TRUE : EN_FALSE ) == EN_FALSE )
+    {
+        return EN_FALSE;
+    }
+
+    g_off += iov[0].iov_len + iov[1].iov_len;
+    g_idxNum++;
+    g_count += g_col.count;
+    g_col.count = 0;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     アーカイブへの書き込みを開始する。
+ * @attention 既に開いている場合は閉じてから開始する。
+ * @note      HAVE_LZ4 を定義せずにビルドした場合、APP_IF_ARC_FLAG_LZ4 は無視する。
+ * @sa        AppIfArc_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfArc_Open(
+    const char*         path,   ///< [in] ファイルのパス
+    unsigned int        flags   ///< [in] APP_IF_ARC_FLAG_*
+){
+    SAppIfArcHdr_t      hdr;
+    struct iovec        iov;
+    unsigned long long  ts = HalCmnClock_GetNsec();
+    unsigned int        ch = 0;
+
+    DBG_PRINT_TRACE( "path = %s, flags = 0x%x \n\r", path, flags );
+
+    AppIfArc_Close();
+
+#ifndef HAVE_LZ4
+    if( flags & APP_IF_ARC_FLAG_LZ4 )
+    {
+        DBG_PRINT_WARN( "built without LZ4. the blocks are not compressed. \n\r" );
+        flags &= ~(unsigned int)APP_IF_ARC_FLAG_LZ4;
+    }
+#endif
+
+    g_fd = open( path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if( g_fd < 0 )
+    {
+        DBG_PRINT_ERROR( "open() error. : %s : %s \n\r", path, strerror( errno ) );
+        return EN_FALSE;
+    }
+
+    g_flags     = flags;
+    g_off       = 0;
+    g_count     = 0;
+    g_idxNum    = 0;
+    g_col.count = 0;
+
+    memset( &hdr, 0, sizeof(hdr) );
+    hdr.magic     = APP_IF_ARC_MAGIC;
+    hdr.ver       = APP_IF_ARC_VER;
+    hdr.hdr_size  = sizeof(hdr);
+    hdr.ch_num    = EN_SEN_CH_NUM;
+    hdr.block_num = APP_IF_ARC_BLOCK_NUM;
+    hdr.flags     = flags;
+    hdr.mono      = ts;
+    hdr.real      = HalCmnClock_ToReal( ts );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        hdr.scale[ch] = HalCmnHist_Scale( (EHalSensorCh_t)ch );
+        strncpy( hdr.name[ch], HalCmn_GetChName( (EHalSensorCh_t)ch ), APP_IF_ARC_NAME_LEN - 1 );
+    }
+
+    iov.iov_base = &hdr;
+    iov.iov_len  = sizeof(hdr);
+    if( WriteAll( &iov, 1 ) == EN_FALSE )
+    {
+        close( g_fd );
+        g_fd = -1;
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     アーカイブへの書き込みを終了する。
+ * @attention なし。
+ * @note      溜めているブロックを書き出し、書き出し中のブロックを待ってから索引, 末尾を書いて閉じる。
+ *            開いていない場合は何もしない。
+ * @sa        AppIfArc_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfArc_Close(
+    void
+){
+    SAppIfArcTail_t     tail;
+    struct iovec        iov[2];
+
+    if( g_fd < 0 )
+    {
+        return;
+    }
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( Flush() == EN_FALSE )
+    {
+        AppIfAio_Drain();           // スロットが空くのを待ってもう一度
+        Flush();
+    }
+    AppIfAio_Drain();
+
+    if( g_col.count == 0 )
+    {
+        memset( &tail, 0, sizeof(tail) );
+        tail.idx     = g_off;
+        tail.idx_num = g_idxNum;
+        tail.count   = g_count;
+        tail.magic   = APP_IF_ARC_TAIL_MAGIC;
+        iov[0].iov_base = g_idx;
+        iov[0].iov_len  = sizeof(SAppIfArcIdx_t) * g_idxNum;
+        iov[1].iov_base = &tail;
+        iov[1].iov_len  = sizeof(tail);
+        WriteAll( iov, 2 );
+    }
+
+    fdatasync( g_fd );
+    close( g_fd );
+    g_fd = -1;
+
+    free( g_idx );
+    g_idx    = NULL;
+    g_idxNum = 0;
+    g_idxCap = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     生値を 1 レコード書き込む。
+ * @attention 開いていない場合は失敗する。
+ * @note      ブロックが一杯になるか、ブロックの先頭から APP_IF_ARC_BLOCK_MSEC を過ぎた場合に書き出す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfArc_Write(
+    unsigned int        mask,   ///< [in] ch マスク
+    const short*        raw,    ///< [in] 生値 ( EHalSensorCh_t で添字, EN_SEN_CH_NUM 個 )
+    unsigned long long  ts      ///< [in] 転送開始時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    unsigned int        i = 0;
+    unsigned int        ch = 0;
+
+    if( g_fd < 0 )
+    {
+        return EN_FALSE;
+    }
+
+    // 前回書き出せなかったブロック
+    if( g_col.count >= APP_IF_ARC_BLOCK_NUM && Flush() == EN_FALSE )
+    {
+        return EN_FALSE;
+    }
+
+    if( ts == 0 )
+    {
+        ts = HalCmnClock_GetNsec();     // 一度も転送していない ch
+    }
+
+    mask &= ( 1U << EN_SEN_CH_NUM ) - 1;
+    i = g_col.count;
+    g_col.ts[i]   = ts;
+    g_col.mask[i] = (unsigned short)mask;
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        g_col.raw[ch][i] = ( mask & ( 1U << ch ) ) ? raw[ch] : 0;
+    }
+    g_col.count++;
+
+    if( g_col.count >= APP_IF_ARC_BLOCK_NUM
+     || ts >= g_col.ts[0] + APP_IF_ARC_BLOCK_MSEC * ARC_NSEC_PER_MSEC )
+    {
+        return Flush();
+    }
+    return EN_TRUE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
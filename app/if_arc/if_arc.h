@@ -0,0 +1,164 @@
+/**************************************************************************//*!
+ *  @file           if_arc.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           センサの生値を ch 毎の列に分け、差分符号化して長期保存する ( 追記のみ )。
+ *                  ファイルのレイアウト
+ *                      SAppIfArcHdr_t
+ *                      ( SAppIfArcBlk_t + ペイロード ) * ブロック数
+ *                      SAppIfArcIdx_t * ブロック数   ( ブロックの索引 )
+ *                      SAppIfArcTail_t
+ *                  1 ブロックは最大 APP_IF_ARC_BLOCK_NUM レコードで、ブロック毎に単独で復号できる。
+ *                  ペイロードは列 ( 時刻, ch マスク, ch 毎の生値 ) を順に並べたもの。
+ *                      時刻     : 差分の差分 ( delta-of-delta ) を zigzag + varint
+ *                      ch マスク : ( マスク, 連続数 ) の varint
+ *                      生値     : その ch が有効なレコードだけ、前の値との差分を zigzag + varint
+ *                  HAVE_LZ4 を定義してビルドした場合は、ペイロードを LZ4 で圧縮できる
+ *                  ( 小さくならないブロックは圧縮しない )。
+ *                  索引と末尾がない ( 書き込み中に終了した ) ファイルは、ブロックを先頭から辿って読む。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_ARC_H_
+#define _APP_IF_ARC_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stddef.h>
+
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_ARC_MAGIC        (0x43524142)        ///< @def : ファイルの識別子     ( "BARC" )
+#define APP_IF_ARC_BLK_MAGIC    (0x4B4C4242)        ///< @def : ブロックの識別子     ( "BBLK" )
+#define APP_IF_ARC_TAIL_MAGIC   (0x444E4542)        ///< @def : ファイル末尾の識別子 ( "BEND" )
+#define APP_IF_ARC_VER          (1)                 ///< @def : レイアウトのバージョン
+#define APP_IF_ARC_NAME_LEN     (16)                ///< @def : ch 名の最大長 ( 終端を含む )
+#define APP_IF_ARC_BLOCK_NUM    (4096)              ///< @def : 1 ブロックの最大レコード数
+#define APP_IF_ARC_BLOCK_MSEC   (1000)              ///< @def : ブロックを書き出すまでの時間 ( msec )
+#define APP_IF_ARC_COL_NUM      (2 + EN_SEN_CH_NUM) ///< @def : 列の数 ( 時刻, ch マスク, ch 毎の生値 )
+
+// 1 ブロックのペイロードの最大サイズ ( Byte, 時刻 10 + マスク 2 * 3 + 生値 3 / ch )
+#define APP_IF_ARC_RAW_MAX      ( APP_IF_ARC_BLOCK_NUM * ( 10 + 6 + 3 * EN_SEN_CH_NUM ) )
+
+#define APP_IF_ARC_FLAG_LZ4     (0x0001)            ///< @def : ペイロードを LZ4 で圧縮する
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// ファイルのヘッダの型
+typedef struct tagSAppIfArcHdr
+{
+    unsigned int        magic;              ///< @var : APP_IF_ARC_MAGIC
+    unsigned int        ver;                ///< @var : APP_IF_ARC_VER
+    unsigned int        hdr_size;           ///< @var : sizeof(SAppIfArcHdr_t)
+    unsigned int        ch_num;             ///< @var : EN_SEN_CH_NUM
+    unsigned int        block_num;          ///< @var : APP_IF_ARC_BLOCK_NUM
+    unsigned int        flags;              ///< @var : APP_IF_ARC_FLAG_*
+    unsigned long long  mono;               ///< @var : ファイルを作成した時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+    unsigned long long  real;               ///< @var : mono に相当する UNIX 時間 ( nsec )
+    double              scale[EN_SEN_CH_NUM];                   ///< @var : 生値から物理量への換算係数
+    char                name[EN_SEN_CH_NUM][APP_IF_ARC_NAME_LEN];  ///< @var : ch 名 ( HalCmn_GetChName() )
+} SAppIfArcHdr_t;
+
+
+// ブロックのヘッダの型 ( 直後にペイロードが続く )
+typedef struct tagSAppIfArcBlk
+{
+    unsigned int        magic;              ///< @var : APP_IF_ARC_BLK_MAGIC
+    unsigned int        flags;              ///< @var : APP_IF_ARC_FLAG_* ( このブロックに適用したもの )
+    unsigned int        count;              ///< @var : レコード数
+    unsigned int        size;               ///< @var : ペイロードのサイズ ( Byte, 圧縮後 )
+    unsigned int        raw_size;           ///< @var : ペイロードのサイズ ( Byte, 圧縮前 )
+    unsigned int        col[APP_IF_ARC_COL_NUM];    ///< @var : 列毎のサイズ ( Byte, 圧縮前 )
+    unsigned int        reserved;           ///< @var : 予約 ( 0 )
+    unsigned long long  first;              ///< @var : 先頭のレコードの時刻 ( nsec )
+    unsigned long long  last;               ///< @var : 最後のレコードの時刻 ( nsec )
+} SAppIfArcBlk_t;
+
+
+// ブロックの索引の型
+typedef struct tagSAppIfArcIdx
+{
+    unsigned long long  offset;             ///< @var : ブロックのヘッダの位置 ( Byte )
+    unsigned long long  first;              ///< @var : 先頭のレコードの時刻 ( nsec )
+    unsigned long long  last;               ///< @var : 最後のレコードの時刻 ( nsec )
+    unsigned long long  count;              ///< @var : レコード数
+} SAppIfArcIdx_t;
+
+
+// ファイルの末尾の型
+typedef struct tagSAppIfArcTail
+{
+    unsigned long long  idx;                ///< @var : 索引の位置 ( Byte )
+    unsigned long long  idx_num;            ///< @var : 索引の数 ( = ブロック数 )
+    unsigned long long  count;              ///< @var : 全レコード数
+    unsigned int        reserved;           ///< @var : 予約 ( 0 )
+    unsigned int        magic;              ///< @var : APP_IF_ARC_TAIL_MAGIC
+} SAppIfArcTail_t;
+
+
+// 復号した 1 ブロックの型 ( 列毎 )
+typedef struct tagSAppIfArcCol
+{
+    unsigned int        count;                                      ///< @var : レコード数
+    unsigned long long  ts[APP_IF_ARC_BLOCK_NUM];                   ///< @var : 時刻 ( nsec )
+    unsigned short      mask[APP_IF_ARC_BLOCK_NUM];                 ///< @var : 有効な ch のマスク
+    short               raw[EN_SEN_CH_NUM][APP_IF_ARC_BLOCK_NUM];   ///< @var : 生値 ( mask にない ch は 0 )
+} SAppIfArcCol_t;
+
+
+// 読み出し側で開いたファイルの型
+typedef struct tagSAppIfArcFile
+{
+    const SAppIfArcHdr_t*   hdr;            ///< @var : ヘッダ
+    const SAppIfArcIdx_t*   idx;            ///< @var : ブロックの索引
+    unsigned long long      idx_num;        ///< @var : ブロック数
+    unsigned long long      count;          ///< @var : 全レコード数
+    size_t                  size;           ///< @var : mmap したサイズ ( Byte )
+    SAppIfArcIdx_t*         scan;           ///< @var : 末尾がない場合に辿って作った索引 ( malloc() )
+    unsigned char*          buf;            ///< @var : LZ4 の展開先 ( malloc() )
+} SAppIfArcFile_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// 書き込み側 ( board.out )
+EHalBool_t      AppIfArc_Open( const char* path, unsigned int flags );
+void            AppIfArc_Close( void );
+EHalBool_t      AppIfArc_Write( unsigned int mask, const short* raw, unsigned long long ts );
+
+// 符号化 / 復号 ( 書き込み側と読み出し側で共用 )
+size_t          AppIfArc_Encode( unsigned char* out, unsigned int* col, const SAppIfArcCol_t* in );
+EHalBool_t      AppIfArc_Decode( SAppIfArcCol_t* out, const unsigned char* in, const unsigned int* col,
+                                 unsigned int count, unsigned long long first );
+
+// 読み出し側
+EHalBool_t      AppIfArcReader_Open( SAppIfArcFile_t* file, const char* path );
+void            AppIfArcReader_Close( SAppIfArcFile_t* file );
+unsigned long long  AppIfArcReader_Find( const SAppIfArcFile_t* file, unsigned long long ts );
+EHalBool_t      AppIfArcReader_Read( SAppIfArcFile_t* file, unsigned long long blk, SAppIfArcCol_t* col );
+
+
+#endif /* _APP_IF_ARC_H_ */
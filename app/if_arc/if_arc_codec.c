@@ -0,0 +1,314 @@
+/**************************************************************************//*!
+ *  @file           if_arc_codec.c
+ *  @brief          [APP] アーカイブの 1 ブロックを列毎に符号化 / 復号する。
+ *  @author         Ryoji Morita
+ *  @attention      HAL の関数は使わないので、書き込み側と読み出し側の両方にリンクする。
+ *  @sa             if_arc.h ( ファイルのレイアウト )
+ *  @note           varint は 7 bit 毎に下位から並べ、続きがある Byte の最上位 bit を 1 にする。
+ *                  zigzag は符号付きの値を 0, -1, 1, -2, ... -> 0, 1, 2, 3, ... に写す。
+ *                  12 bit の ADC や 16 bit の IMU の値は前の値との差分が小さいので、
+ *                  1 つの値がほぼ 1 Byte に収まる。
+ *                  一定周期の時刻は差分の差分がほぼ 0 になるので、これも 1 Byte に収まる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "if_arc.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define COL_TS      (0)         // 時刻の列
+#define COL_MASK    (1)         // ch マスクの列
+#define COL_CH      (2)         // ch 毎の生値の列の先頭
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static inline unsigned char*        PutVar( unsigned char* p, unsigned long long v );
+static inline const unsigned char*  GetVar( const unsigned char* p, const unsigned char* end, unsigned long long* v );
+static inline unsigned long long    Zig( long long v );
+static inline long long             Zag( unsigned long long v );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     varint を書く。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    書いた後の位置
+ *************************************************************************** */
+static inline unsigned char*
+PutVar(
+    unsigned char*      p,  ///< [out] 書く位置
+    unsigned long long  v   ///< [in]  値
+){
+    while( v >= 0x80 )
+    {
+        *p++ = (unsigned char)( v | 0x80 );
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+
+/**************************************************************************//*!
+ * @brief     varint を読む。
+ * @attention なし。
+ * @note      end を越える場合と 10 Byte を越える場合は NULL を返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    読んだ後の位置, NULL : 失敗
+ *************************************************************************** */
+static inline const unsigned char*
+GetVar(
+    const unsigned char*    p,      ///< [in]  読む位置
+    const unsigned char*    end,    ///< [in]  列の終端
+    unsigned long long*     v       ///< [out] 値
+){
+    unsigned long long      res = 0;
+    unsigned int            shift = 0;
+
+    while( p < end && shift < 64 )
+    {
+        res |= (unsigned long long)( *p & 0x7F ) << shift;
+        if( ( *p++ & 0x80 ) == 0 )
+        {
+            *v = res;
+            return p;
+        }
+        shift += 7;
+    }
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     zigzag 符号化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    符号なしの値
+ *************************************************************************** */
+static inline unsigned long long
+Zig(
+    long long   v   ///< [in] 符号付きの値
+){
+    return ( (unsigned long long)v << 1 ) ^ (unsigned long long)( v >> 63 );
+}
+
+
+/**************************************************************************//*!
+ * @brief     zigzag 符号化を戻す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    符号付きの値
+ *************************************************************************** */
+static inline long long
+Zag(
+    unsigned long long  v   ///< [in] 符号なしの値
+){
+    return (long long)( v >> 1 ) ^ -(long long)( v & 1 );
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 ブロックを列毎に符号化する。
+ * @attention out は APP_IF_ARC_RAW_MAX Byte 以上であること。
+ * @note      時刻の差分の差分は先頭のレコード ( 差分 0 ) から書く。
+ *            ch の生値はその ch が有効なレコードだけを書く。
+ * @sa        AppIfArc_Decode()
+ * @author    Ryoji Morita
+ * @return    ペイロードのサイズ ( Byte )
+ *************************************************************************** */
+size_t
+AppIfArc_Encode(
+    unsigned char*          out,    ///< [out] ペイロード
+    unsigned int*           col,    ///< [out] 列毎のサイズ ( APP_IF_ARC_COL_NUM 個 )
+    const SAppIfArcCol_t*   in      ///< [in]  レコード
+){
+    unsigned char*          p = out;
+    unsigned char*          top = out;
+    unsigned long long      prev = 0;
+    long long               delta = 0;
+    long long               dod = 0;
+    short                   last = 0;
+    unsigned int            run = 0;
+    unsigned int            ch = 0;
+    unsigned int            i = 0;
+
+    // 時刻 ( 差分の差分 )
+    prev = ( in->count > 0 ) ? in->ts[0] : 0;
+    delta = 0;
+    for( i = 0; i < in->count; i++ )
+    {
+        dod   = (long long)( in->ts[i] - prev ) - delta;
+        delta = (long long)( in->ts[i] - prev );
+        prev  = in->ts[i];
+        p = PutVar( p, Zig( dod ) );
+    }
+    col[COL_TS] = (unsigned int)( p - top );
+    top = p;
+
+    // ch マスク ( マスク, 連続数 )
+    for( i = 0; i < in->count; i += run )
+    {
+        for( run = 1; i + run < in->count && in->mask[i + run] == in->mask[i]; run++ ){}
+        p = PutVar( p, in->mask[i] );
+        p = PutVar( p, run );
+    }
+    col[COL_MASK] = (unsigned int)( p - top );
+    top = p;
+
+    // ch 毎の生値 ( 差分 )
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        last = 0;
+        for( i = 0; i < in->count; i++ )
+        {
+            if( in->mask[i] & ( 1U << ch ) )
+            {
+                p = PutVar( p, Zig( (long long)in->raw[ch][i] - last ) );
+                last = in->raw[ch][i];
+            }
+        }
+        col[COL_CH + ch] = (unsigned int)( p - top );
+        top = p;
+    }
+
+    return (size_t)( p - out );
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 ブロックを復号する。
+ * @attention なし。
+ * @note      列毎のサイズとレコード数が合わない場合は失敗する ( 壊れたブロック )。
+ * @sa        AppIfArc_Encode()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfArc_Decode(
+    SAppIfArcCol_t*         out,    ///< [out] レコード
+    const unsigned char*    in,     ///< [in]  ペイロード
+    const unsigned int*     col,    ///< [in]  列毎のサイズ ( APP_IF_ARC_COL_NUM 個 )
+    unsigned int            count,  ///< [in]  レコード数
+    unsigned long long      first   ///< [in]  先頭のレコードの時刻
+){
+    const unsigned char*    p = in;
+    const unsigned char*    end = in;
+    unsigned long long      v = 0;
+    unsigned long long      run = 0;
+    unsigned long long      prev = first;
+    unsigned long long      delta = 0;
+    long long               last = 0;
+    unsigned int            ch = 0;
+    unsigned int            i = 0;
+    unsigned int            j = 0;
+
+    if( count > APP_IF_ARC_BLOCK_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid count. : %u \n\r", count );
+        return EN_FALSE;
+    }
+    out->count = count;
+
+    // 時刻 ( 差分の差分 )
+    end += col[COL_TS];
+    for( i = 0; i < count; i++ )
+    {
+        if( ( p = GetVar( p, end, &v ) ) == NULL ){ goto err; }
+        delta += (unsigned long long)Zag( v );
+        prev  += delta;
+        out->ts[i] = prev;
+    }
+    if( p != end ){ goto err; }
+
+    // ch マスク ( マスク, 連続数 )
+    end += col[COL_MASK];
+    for( i = 0; i < count; i += (unsigned int)run )
+    {
+        if( ( p = GetVar( p, end, &v ) ) == NULL ){ goto err; }
+        if( ( p = GetVar( p, end, &run ) ) == NULL ){ goto err; }
+        if( run == 0 || run > count - i ){ goto err; }
+        for( j = 0; j < run; j++ )
+        {
+            out->mask[i + j] = (unsigned short)v;
+        }
+    }
+    if( p != end ){ goto err; }
+
+    // ch 毎の生値 ( 差分 )
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        end += col[COL_CH + ch];
+        last = 0;
+        for( i = 0; i < count; i++ )
+        {
+            if( out->mask[i] & ( 1U << ch ) )
+            {
+                if( ( p = GetVar( p, end, &v ) ) == NULL ){ goto err; }
+                last += Zag( v );
+                out->raw[ch][i] = (short)last;
+            } else
+            {
+                out->raw[ch][i] = 0;
+            }
+        }
+        if( p != end ){ goto err; }
+    }
+
+    return EN_TRUE;
+
+err :
+    DBG_PRINT_ERROR( "corrupted block. \n\r" );
+    return EN_FALSE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,356 @@
+/**************************************************************************//*!
+ *  @file           if_arc_reader.c
+ *  @brief          [APP] アーカイブからセンサの生値をブロック単位で読み出す。
+ *  @author         Ryoji Morita
+ *  @attention      HAL の関数は使わないので、if_arc_codec.c と一緒にリンクすれば
+ *                  board.out 以外のプロセスからも使える ( libif_arc_reader.a )。
+ *  @sa             if_arc.h ( ファイルのレイアウト ), if_arc.c ( 書き込み側 )
+ *  @note           ファイル全体を読み出し専用で mmap する。
+ *                  末尾の索引で時刻からブロックを二分探索し、そのブロックだけを復号する。
+ *                  末尾がない場合は、ブロックのヘッダを先頭から辿って索引を作る。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#include "if_arc.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   Scan( SAppIfArcFile_t* file );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ブロックのヘッダを先頭から辿って索引を作る。
+ * @attention なし。
+ * @note      書き込み中に終了したファイル ( 末尾がない ) の場合に使う。
+ *            途中で壊れたブロックがあれば、その前までを読める範囲とする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+Scan(
+    SAppIfArcFile_t*        file    ///< [in,out] ファイル
+){
+    const unsigned char*    top = (const unsigned char*)file->hdr;
+    const SAppIfArcBlk_t*   blk = NULL;
+    SAppIfArcIdx_t*         idx = NULL;
+    unsigned long long      cap = 0;
+    size_t                  off = file->hdr->hdr_size;
+
+    while( off + sizeof(SAppIfArcBlk_t) <= file->size )
+    {
+        blk = (const SAppIfArcBlk_t*)( top + off );
+        if( blk->magic != APP_IF_ARC_BLK_MAGIC
+         || blk->count == 0 || blk->count > APP_IF_ARC_BLOCK_NUM
+         || blk->size > file->size - off - sizeof(SAppIfArcBlk_t) )
+        {
+            break;
+        }
+
+        if( file->idx_num >= cap )
+        {
+            idx = (SAppIfArcIdx_t*)realloc( file->scan, sizeof(SAppIfArcIdx_t) * ( cap + 256 ) );
+            if( idx == NULL )
+            {
+                DBG_PRINT_ERROR( "realloc() error. \n\r" );
+                return EN_FALSE;
+            }
+            file->scan = idx;
+            cap += 256;
+        }
+
+        file->scan[file->idx_num].offset = off;
+        file->scan[file->idx_num].first  = blk->first;
+        file->scan[file->idx_num].last   = blk->last;
+        file->scan[file->idx_num].count  = blk->count;
+        file->idx_num++;
+        file->count += blk->count;
+        off += sizeof(SAppIfArcBlk_t) + blk->size;
+    }
+
+    file->idx = file->scan;
+    DBG_PRINT_WARN( "no index. %llu blocks found. \n\r", file->idx_num );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     アーカイブを開く。
+ * @attention なし。
+ * @note      レイアウト ( バージョン, ch 数, ブロックのレコード数 ) が一致しない場合は失敗する。
+ * @sa        AppIfArcReader_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfArcReader_Open(
+    SAppIfArcFile_t*        file,   ///< [out] 開いたファイル
+    const char*             path    ///< [in]  ファイルのパス
+){
+    int                     fd = -1;
+    struct stat             st;
+    void*                   addr = MAP_FAILED;
+    const SAppIfArcHdr_t*   hdr = NULL;
+    const SAppIfArcTail_t*  tail = NULL;
+    size_t                  size = 0;
+
+    memset( file, 0, sizeof(*file) );
+    DBG_PRINT_TRACE( "path = %s \n\r", path );
+
+    fd = open( path, O_RDONLY | O_CLOEXEC );
+    if( fd < 0 )
+    {
+        return EN_FALSE;
+    }
+
+    if( fstat( fd, &st ) < 0 || (size_t)st.st_size < sizeof(SAppIfArcHdr_t) )
+    {
+        DBG_PRINT_ERROR( "invalid file size. : %s \n\r", path );
+        close( fd );
+        return EN_FALSE;
+    }
+    size = (size_t)st.st_size;
+
+    addr = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( addr == MAP_FAILED )
+    {
+        DBG_PRINT_ERROR( "mmap() error. : %s \n\r", path );
+        return EN_FALSE;
+    }
+
+    hdr = (const SAppIfArcHdr_t*)addr;
+    if( hdr->magic     != APP_IF_ARC_MAGIC
+     || hdr->ver       != APP_IF_ARC_VER
+     || hdr->hdr_size  != sizeof(SAppIfArcHdr_t)
+     || hdr->ch_num    != EN_SEN_CH_NUM
+     || hdr->block_num != APP_IF_ARC_BLOCK_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid layout. : %s \n\r", path );
+        goto err;
+    }
+    file->hdr  = hdr;
+    file->size = size;
+
+    if( hdr->flags & APP_IF_ARC_FLAG_LZ4 )
+    {
+        file->buf = (unsigned char*)malloc( APP_IF_ARC_RAW_MAX );
+        if( file->buf == NULL )
+        {
+            DBG_PRINT_ERROR( "malloc() error. \n\r" );
+            goto err;
+        }
+    }
+
+    if( size >= sizeof(SAppIfArcHdr_t) + sizeof(SAppIfArcTail_t) )
+    {
+        tail = (const SAppIfArcTail_t*)( (const unsigned char*)addr + size - sizeof(SAppIfArcTail_t) );
+        if( tail->magic == APP_IF_ARC_TAIL_MAGIC
+         && tail->idx >= sizeof(SAppIfArcHdr_t)
+         && tail->idx_num <= ( size - tail->idx ) / sizeof(SAppIfArcIdx_t)
+         && tail->idx + tail->idx_num * sizeof(SAppIfArcIdx_t) + sizeof(SAppIfArcTail_t) == size )
+        {
+            file->idx     = (const SAppIfArcIdx_t*)( (const unsigned char*)addr + tail->idx );
+            file->idx_num = tail->idx_num;
+            file->count   = tail->count;
+            return EN_TRUE;
+        }
+    }
+
+    if( Scan( file ) == EN_TRUE )
+    {
+        return EN_TRUE;
+    }
+
+err :
+    free( file->scan );
+    free( file->buf );
+    munmap( addr, size );
+    memset( file, 0, sizeof(*file) );
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     アーカイブを閉じる。
+ * @attention なし。
+ * @note      開いていない場合は何もしない。
+ * @sa        AppIfArcReader_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfArcReader_Close(
+    SAppIfArcFile_t*    file    ///< [in] ファイル
+){
+    if( file->hdr != NULL )
+    {
+        munmap( (void*)file->hdr, file->size );
+    }
+    free( file->scan );
+    free( file->buf );
+    memset( file, 0, sizeof(*file) );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時刻 ts 以降のレコードを含む最初のブロックを探す。
+ * @attention なし。
+ * @note      索引を二分探索する。ブロックは時刻順に並んでいる。
+ * @sa        AppIfArcReader_Read()
+ * @author    Ryoji Morita
+ * @return    ブロックの番号, idx_num : 該当なし
+ *************************************************************************** */
+unsigned long long
+AppIfArcReader_Find(
+    const SAppIfArcFile_t*  file,   ///< [in] ファイル
+    unsigned long long      ts      ///< [in] 時刻 ( nsec )
+){
+    unsigned long long      lo = 0;
+    unsigned long long      hi = file->idx_num;
+    unsigned long long      mid = 0;
+
+    while( lo < hi )
+    {
+        mid = lo + ( hi - lo ) / 2;
+        if( file->idx[mid].last < ts )
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 ブロックを読み出して復号する。
+ * @attention なし。
+ * @note      LZ4 で圧縮したブロックは HAVE_LZ4 を定義してビルドした場合だけ読める。
+ * @sa        AppIfArcReader_Find()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfArcReader_Read(
+    SAppIfArcFile_t*        file,   ///< [in]  ファイル
+    unsigned long long      blk,    ///< [in]  ブロックの番号
+    SAppIfArcCol_t*         col     ///< [out] レコード
+){
+    const SAppIfArcBlk_t*   b = NULL;
+    const unsigned char*    payload = NULL;
+    unsigned long long      off = 0;
+    unsigned long long      sum = 0;
+    unsigned int            i = 0;
+
+    if( blk >= file->idx_num )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : blk = %llu \n\r", blk );
+        return EN_FALSE;
+    }
+
+    off = file->idx[blk].offset;
+    if( off + sizeof(SAppIfArcBlk_t) > file->size )
+    {
+        goto err;
+    }
+    b = (const SAppIfArcBlk_t*)( (const unsigned char*)file->hdr + off );
+    payload = (const unsigned char*)( b + 1 );
+    for( i = 0; i < APP_IF_ARC_COL_NUM; i++ )
+    {
+        sum += b->col[i];
+    }
+    if( b->magic != APP_IF_ARC_BLK_MAGIC
+     || b->size > file->size - off - sizeof(SAppIfArcBlk_t)
+     || b->raw_size > APP_IF_ARC_RAW_MAX
+     || sum != b->raw_size )
+    {
+        goto err;
+    }
+
+    if( b->flags & APP_IF_ARC_FLAG_LZ4 )
+    {
+#ifdef HAVE_LZ4
+        if( file->buf == NULL
+         || LZ4_decompress_safe( (const char*)payload, (char*)file->buf, (int)b->size, APP_IF_ARC_RAW_MAX ) != (int)b->raw_size )
+        {
+            goto err;
+        }
+        payload = file->buf;
+#else
+        DBG_PRINT_ERROR( "built without LZ4. \n\r" );
+        return EN_FALSE;
+#endif
+    } else if( b->size != b->raw_size )
+    {
+        goto err;
+    }
+
+    return AppIfArc_Decode( col, payload, b->col, b->count, b->first );
+
+err :
+    DBG_PRINT_ERROR( "corrupted block. : blk = %llu \n\r", blk );
+    return EN_FALSE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,458 @@
+/**************************************************************************//*!
+ *  @file           if_frame.c
+ *  @brief          [APP] センサの生値をバイナリフレームで送信する。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_frame.h ( フレームの形式 )
+ *  @note           出力先は標準出力, pty, シリアルデバイスのいずれか。
+ *                  端末 ( tty ) の場合は raw モードにして、指定したボーレートを設定する。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "if_frame.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define FRAME_CRC_INIT      (0xFFFF)        // CRC-16/CCITT-FALSE の初期値
+#define FRAME_CRC_POLY      (0x1021)        // CRC-16/CCITT-FALSE の生成多項式
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static int              g_fd = STDOUT_FILENO;   // 出力先
+static unsigned int     g_seq = 0;              // 通し番号
+static unsigned short   g_crcTable[256];        // CRC の計算表
+static EHalBool_t       g_crcReady = EN_FALSE;  // EN_TRUE : 計算表を作成済み
+static struct termios   g_tioOrg;               // 変更する前の端末の設定
+static EHalBool_t       g_tioSaved = EN_FALSE;  // EN_TRUE : 端末の設定を変更した
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void             InitCrc( void );
+static unsigned short   Crc16( const unsigned char* buf, unsigned int len );
+static unsigned int     Cobs( const unsigned char* in, unsigned int len, unsigned char* out );
+static speed_t          ToSpeed( unsigned int baud );
+static EHalBool_t       SetTty( int fd, unsigned int baud );
+static EHalBool_t       WriteAll( const unsigned char* buf, unsigned int len );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     CRC の計算表を作成する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitCrc(
+    void  ///< [in] ナシ
+){
+    unsigned int    i = 0;
+    unsigned int    b = 0;
+    unsigned short  crc = 0;
+
+    for( i = 0; i < 256; i++ )
+    {
+        crc = (unsigned short)( i << 8 );
+        for( b = 0; b < 8; b++ )
+        {
+            crc = ( crc & 0x8000 ) ? (unsigned short)( ( crc << 1 ) ^ FRAME_CRC_POLY ) : (unsigned short)( crc << 1 );
+        }
+        g_crcTable[i] = crc;
+    }
+
+    g_crcReady = EN_TRUE;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     CRC-16/CCITT-FALSE を計算する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    CRC
+ *************************************************************************** */
+static unsigned short
+Crc16(
+    const unsigned char*    buf,    ///< [in] データ
+    unsigned int            len     ///< [in] データのサイズ
+){
+    unsigned short  crc = FRAME_CRC_INIT;
+    unsigned int    i = 0;
+
+    if( g_crcReady == EN_FALSE )
+    {
+        InitCrc();
+    }
+
+    for( i = 0; i < len; i++ )
+    {
+        crc = (unsigned short)( ( crc << 8 ) ^ g_crcTable[( ( crc >> 8 ) ^ buf[i] ) & 0xFF] );
+    }
+    return crc;
+}
+
+
+/**************************************************************************//*!
+ * @brief     COBS で符号化し、区切りの 0x00 を付ける。
+ * @attention out は len + len / 254 + 2 Byte 以上確保すること。
+ * @note      符号化後のデータには 0x00 が現れないので、受信側は 0x00 で
+ *            フレームの区切りを見つけて途中からでも同期できる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    符号化後のサイズ ( 区切りを含む )
+ *************************************************************************** */
+static unsigned int
+Cobs(
+    const unsigned char*    in,     ///< [in]  符号化前のデータ
+    unsigned int            len,    ///< [in]  符号化前のサイズ
+    unsigned char*          out     ///< [out] 符号化後のデータ
+){
+    unsigned int    code = 0;       // 現在のブロックのコードを書く位置
+    unsigned int    pos = 1;        // 次に書く位置
+    unsigned char   run = 1;        // 現在のブロックのコード
+    unsigned int    i = 0;
+
+    for( i = 0; i < len; i++ )
+    {
+        if( in[i] == 0x00 )
+        {
+            out[code] = run;
+            code = pos++;
+            run = 1;
+        } else
+        {
+            out[pos++] = in[i];
+            run++;
+            if( run == 0xFF )
+            {
+                out[code] = run;
+                code = pos++;
+                run = 1;
+            }
+        }
+    }
+
+    out[code] = run;
+    out[pos++] = 0x00;
+    return pos;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ボーレートを termios の定数に変換する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    termios の定数 ( 未対応の場合は B0 )
+ *************************************************************************** */
+static speed_t
+ToSpeed(
+    unsigned int    baud    ///< [in] ボーレート
+){
+    switch( baud )
+    {
+    case 9600    : return B9600;
+    case 19200   : return B19200;
+    case 38400   : return B38400;
+    case 57600   : return B57600;
+    case 115200  : return B115200;
+    case 230400  : return B230400;
+    case 460800  : return B460800;
+    case 921600  : return B921600;
+    case 1000000 : return B1000000;
+    default      : return B0;
+    }
+}
+
+
+/**************************************************************************//*!
+ * @brief     端末を raw モードにしてボーレートを設定する。
+ * @attention なし。
+ * @note      baud = 0 の場合はボーレートを変更しない ( pty など )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+SetTty(
+    int             fd,     ///< [in] 端末
+    unsigned int    baud    ///< [in] ボーレート
+){
+    struct termios  tio;
+    speed_t         speed = B0;
+
+    if( tcgetattr( fd, &tio ) != 0 )
+    {
+        DBG_PRINT_ERROR( "tcgetattr() error. : %s \n\r", strerror( errno ) );
+        return EN_FALSE;
+    }
+
+    g_tioOrg = tio;
+    cfmakeraw( &tio );
+    if( baud != 0 )
+    {
+        speed = ToSpeed( baud );
+        if( speed == B0 )
+        {
+            DBG_PRINT_ERROR( "unsupported baud rate. : %u \n\r", baud );
+            return EN_FALSE;
+        }
+        cfsetispeed( &tio, speed );
+        cfsetospeed( &tio, speed );
+    }
+
+    if( tcsetattr( fd, TCSANOW, &tio ) != 0 )
+    {
+        DBG_PRINT_ERROR( "tcsetattr() error. : %s \n\r", strerror( errno ) );
+        return EN_FALSE;
+    }
+
+    g_tioSaved = EN_TRUE;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     出力先に全てのデータを書き込む。
+ * @attention なし。
+ * @note      シリアルデバイスなどで一部しか書けなかった場合は続きを書く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+WriteAll(
+    const unsigned char*    buf,    ///< [in] データ
+    unsigned int            len     ///< [in] データのサイズ
+){
+    ssize_t     ret = 0;
+
+    while( len > 0 )
+    {
+        ret = write( g_fd, buf, len );
+        if( ret < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            DBG_PRINT_ERROR( "write() error. : %s \n\r", strerror( errno ) );
+            return EN_FALSE;
+        }
+        buf += ret;
+        len -= (unsigned int)ret;
+    }
+
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     出力先を開く。
+ * @attention なし。
+ * @note      path = NULL の場合は標準出力に出力する。
+ *            出力先が端末の場合は raw モードにする ( 標準出力の場合も同じ )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfFrame_Open(
+    const char*     path,   ///< [in] 出力先のパス ( /dev/ttyS0, /dev/pts/N, ファイルなど )
+    unsigned int    baud    ///< [in] ボーレート ( 0 = 変更しない )
+){
+    int     fd = STDOUT_FILENO;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    AppIfFrame_Close();
+
+    if( path != NULL )
+    {
+        fd = open( path, O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY | O_CLOEXEC, 0644 );
+        if( fd < 0 )
+        {
+            DBG_PRINT_ERROR( "open() error. : %s : %s \n\r", path, strerror( errno ) );
+            return EN_FALSE;
+        }
+    }
+
+    if( isatty( fd ) && SetTty( fd, baud ) == EN_FALSE )
+    {
+        if( fd != STDOUT_FILENO ){ close( fd ); }
+        return EN_FALSE;
+    }
+
+    g_fd  = fd;
+    g_seq = 0;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     出力先を閉じる。
+ * @attention なし。
+ * @note      端末の設定を元に戻し、以降は標準出力に出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfFrame_Close(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( g_tioSaved == EN_TRUE )
+    {
+        tcdrain( g_fd );
+        tcsetattr( g_fd, TCSANOW, &g_tioOrg );
+        g_tioSaved = EN_FALSE;
+    }
+
+    if( g_fd != STDOUT_FILENO )
+    {
+        close( g_fd );
+    }
+
+    g_fd = STDOUT_FILENO;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     フレームを組み立てる。
+ * @attention out は APP_IF_FRAME_MAX Byte 以上確保すること。
+ * @note      COBS の符号化は行わない。
+ * @sa        if_frame.h ( フレームの形式 )
+ * @author    Ryoji Morita
+ * @return    フレームのサイズ
+ *************************************************************************** */
+unsigned int
+AppIfFrame_Encode(
+    unsigned char*      out,    ///< [out] フレーム
+    unsigned int        seq,    ///< [in]  通し番号
+    unsigned int        mask,   ///< [in]  ch マスク
+    const short*        raw,    ///< [in]  生値 ( EHalSensorCh_t で添字, EN_SEN_CH_NUM 個 )
+    unsigned long long  ts      ///< [in]  時刻 ( nsec )
+){
+    unsigned int    pos = 0;
+    unsigned int    ch = 0;
+    unsigned int    i = 0;
+    unsigned short  crc = 0;
+
+    out[pos++] = APP_IF_FRAME_VER;
+
+    for( i = 0; i < 4; i++ ){ out[pos++] = (unsigned char)( seq >> ( 8 * i ) ); }
+    for( i = 0; i < 8; i++ ){ out[pos++] = (unsigned char)( ts  >> ( 8 * i ) ); }
+
+    mask &= ( 1U << EN_SEN_CH_NUM ) - 1;
+    out[pos++] = (unsigned char)( mask );
+    out[pos++] = (unsigned char)( mask >> 8 );
+
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        if( mask & ( 1U << ch ) )
+        {
+            out[pos++] = (unsigned char)( (unsigned short)raw[ch] );
+            out[pos++] = (unsigned char)( (unsigned short)raw[ch] >> 8 );
+        }
+    }
+
+    crc = Crc16( out, pos );
+    out[pos++] = (unsigned char)( crc );
+    out[pos++] = (unsigned char)( crc >> 8 );
+    return pos;
+}
+
+
+/**************************************************************************//*!
+ * @brief     フレームを組み立てて COBS で符号化する。
+ * @attention out は APP_IF_FRAME_WIRE_MAX Byte 以上確保すること。
+ * @note      末尾に区切りの 0x00 を付ける。
+ * @sa        AppIfFrame_Encode()
+ * @author    Ryoji Morita
+ * @return    符号化したサイズ ( 区切りを含む )
+ *************************************************************************** */
+unsigned int
+AppIfFrame_Pack(
+    unsigned char*      out,    ///< [out] 符号化したフレーム
+    unsigned int        seq,    ///< [in]  通し番号
+    unsigned int        mask,   ///< [in]  ch マスク
+    const short*        raw,    ///< [in]  生値 ( EHalSensorCh_t で添字, EN_SEN_CH_NUM 個 )
+    unsigned long long  ts      ///< [in]  時刻 ( nsec )
+){
+    unsigned char   frame[APP_IF_FRAME_MAX];
+    unsigned int    len = 0;
+
+    len = AppIfFrame_Encode( frame, seq, mask, raw, ts );
+    return Cobs( frame, len, out );
+}
+
+
+/**************************************************************************//*!
+ * @brief     生値をフレームにして送信する。
+ * @attention なし。
+ * @note      1 フレームを 1 回の write() で送信する。
+ * @sa        if_frame.h ( フレームの形式 )
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfFrame_Send(
+    unsigned int        mask,   ///< [in] ch マスク
+    const short*        raw,    ///< [in] 生値 ( EHalSensorCh_t で添字, EN_SEN_CH_NUM 個 )
+    unsigned long long  ts      ///< [in] 時刻 ( nsec )
+){
+    unsigned char   wire[APP_IF_FRAME_WIRE_MAX];
+    unsigned int    len = 0;
+
+    len = AppIfFrame_Pack( wire, g_seq++, mask, raw, ts );
+    return WriteAll( wire, len );
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,68 @@
+/**************************************************************************//*!
+ *  @file           if_frame.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           バイナリフレームの形式 ( リトルエンディアン )
+ *                      offset  size  内容
+ *                           0     1  バージョン ( APP_IF_FRAME_VER )
+ *                           1     4  通し番号
+ *                           5     8  時刻 ( nsec, -t オプションで指定した基準 )
+ *                          13     2  ch マスク ( bit n = EHalSensorCh_t の n )
+ *                          15  2xN   生値 ( int16, マスクの bit が立っている ch を昇順に N 個 )
+ *                     15+2N     2  CRC-16/CCITT-FALSE ( offset 0 から生値の末尾まで )
+ *                  上記を COBS で符号化し、区切りとして 0x00 を付けて送信する。
+ *                  同じ ch マスクのフレームは常に同じサイズになる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_FRAME_H_
+#define _APP_IF_FRAME_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_FRAME_VER        (0x01)      ///< @def : フレーム形式のバージョン
+#define APP_IF_FRAME_HEAD       (15)        ///< @def : 生値より前のサイズ ( Byte )
+#define APP_IF_FRAME_MAX        ( APP_IF_FRAME_HEAD + 2 * EN_SEN_CH_NUM + 2 )   ///< @def : 符号化前の最大サイズ ( Byte )
+#define APP_IF_FRAME_WIRE_MAX   ( APP_IF_FRAME_MAX + APP_IF_FRAME_MAX / 254 + 2 )  ///< @def : COBS で符号化した後の最大サイズ ( 254 Byte 毎に 1 Byte 増える + 先頭 1 Byte + 区切り 1 Byte )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+EHalBool_t      AppIfFrame_Open( const char* path, unsigned int baud );
+void            AppIfFrame_Close( void );
+EHalBool_t      AppIfFrame_Send( unsigned int mask, const short* raw, unsigned long long ts );
+
+unsigned int    AppIfFrame_Encode( unsigned char* out, unsigned int seq, unsigned int mask, const short* raw, unsigned long long ts );
+unsigned int    AppIfFrame_Pack( unsigned char* out, unsigned int seq, unsigned int mask, const short* raw, unsigned long long ts );
+
+
+#endif /* _APP_IF_FRAME_H_ */
@@ -0,0 +1,419 @@
+/**************************************************************************//*!
+ *  @file           if_metric.c
+ *  @brief          [APP] 動作状況の計測値を公開する HTTP サーバ。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_metric.h ( 計測値の名前 )
+ *  @note           スレッドは全てのシグナルをブロックして起動する
+ *                  ( SIGINT, SIGTERM はメインスレッド / app/if_srv の signalfd で受け取る )。
+ *                  AppIfMetric_Close() はリッスンソケットを shutdown() して accept() から戻し、
+ *                  スレッドの終了を待つ。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "if_metric.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define METRIC_REQ_LEN      (1024)      // リクエストの最大長 ( Byte )
+#define METRIC_TIMEOUT      (1)         // 送受信のタイムアウト ( sec )
+#define METRIC_BACKLOG      (4)         // listen() の接続待ちの数
+#define METRIC_TYPE         "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 応答の本文を作る時に使用する型
+typedef struct {
+    char*               buf;    // 出力先
+    unsigned int        size;   // 出力先のサイズ
+    unsigned int        len;    // 書き込んだサイズ
+} SAppIfMetricOut_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static int              g_lfd = -1;                     // リッスンソケット
+static pthread_t        g_thread;                       // 応答するスレッド
+static EHalBool_t       g_run = EN_FALSE;               // EN_TRUE : スレッドが動いている
+static char             g_body[APP_IF_METRIC_SIZE];     // 応答の本文 ( スレッドだけが使う )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Put( SAppIfMetricOut_t* out, const char* fmt, ... ) __attribute__(( format( printf, 2, 3 ) ));
+static void         Answer( int fd );
+static void*        Main( void* arg );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     本文に書式付きで書き込む。
+ * @attention なし。
+ * @note      入りきらない分は捨てる ( len は size - 1 で止まる )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Put(
+    SAppIfMetricOut_t*  out,    ///< [in] 出力先
+    const char*         fmt,    ///< [in] 書式
+    ...                         ///< [in] 引数
+){
+    va_list             ap;
+    int                 n = 0;
+
+    if( out->len + 1 >= out->size )
+    {
+        return;
+    }
+
+    va_start( ap, fmt );
+    n = vsnprintf( &out->buf[out->len], out->size - out->len, fmt, ap );
+    va_end( ap );
+
+    if( n < 0 ){ return; }
+    out->len += ( out->len + (unsigned int)n < out->size ) ? (unsigned int)n : out->size - 1 - out->len;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 つの接続のリクエストに応答する。
+ * @attention 接続は呼び出し元で閉じる。
+ * @note      ヘッダの終わりまで読み、1 行目だけを見る。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Answer(
+    int                 fd      ///< [in] 接続
+){
+    char                req[METRIC_REQ_LEN];
+    char                head[256];
+    unsigned int        len = 0;
+    unsigned int        body = 0;
+    int                 hlen = 0;
+    ssize_t             n = 0;
+    const char*         status = "404 Not Found";
+
+    while( len < sizeof(req) - 1 )
+    {
+        n = read( fd, &req[len], sizeof(req) - 1 - len );
+        if( n <= 0 ){ return; }
+        len += (unsigned int)n;
+        req[len] = '\0';
+        if( strstr( req, "\r\n\r\n" ) != NULL || strstr( req, "\n\n" ) != NULL ){ break; }
+    }
+
+    if( 0 == strncmp( req, "GET /metrics ", strlen("GET /metrics ") )
+     || 0 == strncmp( req, "GET /metrics?", strlen("GET /metrics?") ) )
+    {
+        status = "200 OK";
+        body = AppIfMetric_Format( g_body, sizeof(g_body) );
+    } else
+    {
+        body = (unsigned int)snprintf( g_body, sizeof(g_body), "not found\n" );
+    }
+
+    hlen = snprintf( head, sizeof(head),
+                     "HTTP/1.1 %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Content-Length: %u\r\n"
+                     "Connection: close\r\n"
+                     "\r\n",
+                     status, ( status[0] == '2' ) ? METRIC_TYPE : "text/plain", body );
+
+    if( send( fd, head, (size_t)hlen, MSG_NOSIGNAL | MSG_MORE ) == hlen )
+    {
+        send( fd, g_body, body, MSG_NOSIGNAL );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     接続を受け付けて応答するスレッド。
+ * @attention なし。
+ * @note      AppIfMetric_Close() でリッスンソケットを shutdown() すると終了する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    NULL
+ *************************************************************************** */
+static void*
+Main(
+    void*               arg     ///< [in] 未使用
+){
+    struct timeval      tv;
+    int                 fd = -1;
+
+    (void)arg;
+
+    tv.tv_sec  = METRIC_TIMEOUT;
+    tv.tv_usec = 0;
+
+    while( 1 )
+    {
+        fd = accept( g_lfd, NULL, NULL );
+        if( fd < 0 )
+        {
+            if( errno == EINTR || errno == ECONNABORTED ){ continue; }
+            break;
+        }
+
+        // 読まないクライアントで止まらないようにする
+        setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv) );
+        setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv) );
+        Answer( fd );
+        close( fd );
+    }
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     計測値を OpenMetrics のテキスト形式で書き込む。
+ * @attention 入りきらない分は捨てる。
+ * @note      最後に "# EOF" の行を付ける。
+ * @sa        HalCmnMetric_Get()
+ * @author    Ryoji Morita
+ * @return    書き込んだサイズ ( Byte, 終端の '\0' を除く )
+ *************************************************************************** */
+unsigned int
+AppIfMetric_Format(
+    char*               buf,    ///< [out] 出力先
+    unsigned int        size    ///< [in]  出力先のサイズ
+){
+    static const char*  bus[EN_METRIC_BUS_NUM] = { "spi", "i2c" };
+    SHalMetric_t        m;
+    SAppIfMetricOut_t   out;
+    unsigned long long  cum = 0;
+    unsigned long long  bound = 0;
+    unsigned int        cap = 0;
+    unsigned int        i = 0;
+    unsigned int        j = 0;
+
+    if( buf == NULL || size == 0 ){ return 0; }
+    out.buf  = buf;
+    out.size = size;
+    out.len  = 0;
+    buf[0]   = '\0';
+
+    HalCmnMetric_Get( &m );
+
+    Put( &out, "# TYPE board_samples counter\n" );
+    Put( &out, "# HELP board_samples Samples read per channel.\n" );
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        Put( &out, "board_samples_total{ch=\"%s\"} %llu\n", HalCmn_GetChName( (EHalSensorCh_t)i ), m.sample[i] );
+    }
+
+    Put( &out, "# TYPE board_bus_transfers counter\n" );
+    Put( &out, "# HELP board_bus_transfers Bus transfers.\n" );
+    for( i = 0; i < EN_METRIC_BUS_NUM; i++ )
+    {
+        Put( &out, "board_bus_transfers_total{bus=\"%s\"} %llu\n", bus[i], m.bus[i].xfer );
+    }
+
+    Put( &out, "# TYPE board_bus_errors counter\n" );
+    Put( &out, "# HELP board_bus_errors Failed bus transfers.\n" );
+    for( i = 0; i < EN_METRIC_BUS_NUM; i++ )
+    {
+        Put( &out, "board_bus_errors_total{bus=\"%s\"} %llu\n", bus[i], m.bus[i].err );
+    }
+
+    Put( &out, "# TYPE board_bus_latency_seconds histogram\n" );
+    Put( &out, "# UNIT board_bus_latency_seconds seconds\n" );
+    Put( &out, "# HELP board_bus_latency_seconds Bus transfer latency.\n" );
+    for( i = 0; i < EN_METRIC_BUS_NUM; i++ )
+    {
+        cum = 0;
+        for( j = 0; j < HAL_METRIC_BUCKET_NUM; j++ )
+        {
+            cum  += m.bus[i].bucket[j];
+            bound = HalCmnMetric_GetBound( j );
+            if( bound == 0 )
+            {
+                Put( &out, "board_bus_latency_seconds_bucket{bus=\"%s\",le=\"+Inf\"} %llu\n", bus[i], cum );
+            } else
+            {
+                Put( &out, "board_bus_latency_seconds_bucket{bus=\"%s\",le=\"%g\"} %llu\n", bus[i], (double)bound / 1e9, cum );
+            }
+        }
+        // count は +Inf の区間と一致させる ( xfer とは一時的にずれる場合がある )
+        Put( &out, "board_bus_latency_seconds_count{bus=\"%s\"} %llu\n", bus[i], cum );
+        Put( &out, "board_bus_latency_seconds_sum{bus=\"%s\"} %.9f\n", bus[i], (double)m.bus[i].sum / 1e9 );
+    }
+
+    Put( &out, "# TYPE board_deadline_misses counter\n" );
+    Put( &out, "# HELP board_deadline_misses Acquisition periods that started late.\n" );
+    Put( &out, "board_deadline_misses_total %llu\n", m.count[EN_METRIC_DEADLINE_MISS] );
+
+    Put( &out, "# TYPE board_lcd_bytes counter\n" );
+    Put( &out, "# UNIT board_lcd_bytes bytes\n" );
+    Put( &out, "# HELP board_lcd_bytes Bytes written to the LCD.\n" );
+    Put( &out, "board_lcd_bytes_total %llu\n", m.count[EN_METRIC_LCD_BYTES] );
+
+    Put( &out, "# TYPE board_gpio_writes counter\n" );
+    Put( &out, "# HELP board_gpio_writes GPIO pin writes ( LEDs ).\n" );
+    Put( &out, "board_gpio_writes_total %llu\n", m.count[EN_METRIC_GPIO_WRITES] );
+
+    Put( &out, "# TYPE board_hist_fill_ratio gauge\n" );
+    Put( &out, "# HELP board_hist_fill_ratio Fill level of the per-channel history ring.\n" );
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        cap = HalCmnHist_Cap( (EHalSensorCh_t)i );
+        if( cap == 0 ){ continue; }
+        Put( &out, "board_hist_fill_ratio{ch=\"%s\"} %.6f\n",
+             HalCmn_GetChName( (EHalSensorCh_t)i ), (double)HalCmnHist_Count( (EHalSensorCh_t)i ) / (double)cap );
+    }
+
+    Put( &out, "# TYPE board_shm_ring_records gauge\n" );
+    Put( &out, "# HELP board_shm_ring_records Records held in the shared memory ring.\n" );
+    Put( &out, "board_shm_ring_records %llu\n", m.gauge[EN_METRIC_GAUGE_SHM_FILL] );
+
+    Put( &out, "# TYPE board_queue_bytes gauge\n" );
+    Put( &out, "# UNIT board_queue_bytes bytes\n" );
+    Put( &out, "# HELP board_queue_bytes Bytes waiting in the send queues.\n" );
+    Put( &out, "board_queue_bytes{queue=\"stdout\"} %llu\n", m.gauge[EN_METRIC_GAUGE_QUE_FILL] );
+    Put( &out, "board_queue_bytes{queue=\"srv\"} %llu\n", m.gauge[EN_METRIC_GAUGE_SRV_QUE_FILL] );
+
+    Put( &out, "# EOF\n" );
+    return out.len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     HTTP サーバを開始する。
+ * @attention 127.0.0.1 だけで待ち受ける。
+ * @note      応答するスレッドを起動して戻る。
+ * @sa        AppIfMetric_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfMetric_Open(
+    unsigned short      port    ///< [in] ポート ( 0 : APP_IF_METRIC_PORT )
+){
+    struct sockaddr_in  addr;
+    sigset_t            all;
+    sigset_t            org;
+    int                 on = 1;
+    int                 res = 0;
+
+    DBG_PRINT_TRACE( "port = %u \n\r", port );
+
+    AppIfMetric_Close();
+
+    if( port == 0 ){ port = APP_IF_METRIC_PORT; }
+
+    g_lfd = socket( AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if( g_lfd < 0 )
+    {
+        DBG_PRINT_ERROR( "socket() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+    setsockopt( g_lfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on) );
+
+    memset( &addr, 0, sizeof(addr) );
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons( port );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    if( bind( g_lfd, (struct sockaddr*)&addr, sizeof(addr) ) < 0 || listen( g_lfd, METRIC_BACKLOG ) < 0 )
+    {
+        DBG_PRINT_ERROR( "bind() / listen() error. : %u : %s \n\r", port, strerror( errno ) );
+        goto err;
+    }
+
+    // 起動したスレッドはシグナルマスクを引き継ぐ
+    sigfillset( &all );
+    pthread_sigmask( SIG_SETMASK, &all, &org );
+    res = pthread_create( &g_thread, NULL, Main, NULL );
+    pthread_sigmask( SIG_SETMASK, &org, NULL );
+    if( res != 0 )
+    {
+        DBG_PRINT_ERROR( "pthread_create() error. : %s \n\r", strerror( res ) );
+        goto err;
+    }
+
+    g_run = EN_TRUE;
+    return EN_TRUE;
+
+err :
+    AppIfMetric_Close();
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     HTTP サーバを終了する。
+ * @attention なし。
+ * @note      処理中のリクエストがあれば応答し終えるまで待つ ( 最大でタイムアウトまで )。
+ * @sa        AppIfMetric_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfMetric_Close(
+    void
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( g_lfd >= 0 ){ shutdown( g_lfd, SHUT_RDWR ); }
+    if( g_run == EN_TRUE )
+    {
+        pthread_join( g_thread, NULL );
+        g_run = EN_FALSE;
+    }
+    if( g_lfd >= 0 )
+    {
+        close( g_lfd );
+        g_lfd = -1;
+    }
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,67 @@
+/**************************************************************************//*!
+ *  @file           if_metric.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           動作状況の計測値 ( hal_cmn_metric.c ) を OpenMetrics のテキスト形式で
+ *                  公開する HTTP サーバ。127.0.0.1 だけで待ち受ける。
+ *                  別スレッドで 1 リクエストずつ処理するので、センサの読み出しを止めない。
+ *                      GET /metrics    計測値 ( Content-Type: application/openmetrics-text )
+ *                  計測値
+ *                      board_samples_total{ch}                 ch 毎のサンプル数
+ *                      board_bus_transfers_total{bus}          SPI / I2C の転送回数
+ *                      board_bus_errors_total{bus}             SPI / I2C の失敗した転送回数
+ *                      board_bus_latency_seconds{bus}          SPI / I2C の転送時間 ( ヒストグラム )
+ *                      board_deadline_misses_total             読み出し周期に間に合わなかった回数
+ *                      board_lcd_bytes_total                   LCD に書き込んだ Byte 数
+ *                      board_hist_fill_ratio{ch}               履歴のリングバッファの使用率
+ *                      board_shm_ring_records                  共有メモリのリングバッファのレコード数
+ *                      board_queue_bytes{queue}                送信キューに積んでいるサイズ
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_METRIC_H_
+#define _APP_IF_METRIC_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_METRIC_PORT      (9464)      ///< @def : 待ち受けるポートの省略時
+#define APP_IF_METRIC_SIZE      (16384)     ///< @def : 応答の本文の最大サイズ ( Byte )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+EHalBool_t      AppIfMetric_Open( unsigned short port );
+void            AppIfMetric_Close( void );
+unsigned int    AppIfMetric_Format( char* buf, unsigned int size );
+
+
+#endif /* _APP_IF_METRIC_H_ */
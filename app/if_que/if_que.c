@@ -0,0 +1,356 @@
+/**************************************************************************//*!
+ *  @file           if_que.c
+ *  @brief          [APP] 出力先毎の上限付き送信キュー。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_que.h ( ポリシ )
+ *  @note           まだ書いていないデータを buf[] のリングバッファに buf[head] から並べ、
+ *                  レコード毎のサイズは rlen[] のリングバッファに記録する。
+ *                  先頭レコードは sent Byte 書き終えている場合がある。
+ *                  積む / 捨てる時にキュー全体を詰め直さないので、
+ *                  出力先が読まずにあふれ続けても 1 回の処理はレコードの大きさ程度で終わる。
+ *                  buf[] の末尾をまたぐデータは 2 回の write() / send() で書く。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "if_que.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define QUE_MASK            ( APP_IF_QUE_SIZE - 1 )
+#define QUE_REC(que, i)     ( (que)->rlen[( (que)->first + (i) ) & ( APP_IF_QUE_REC_MAX - 1 )] )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Remove( SAppIfQue_t* que );
+static void         Copy( SAppIfQue_t* que, unsigned int pos, const void* data, unsigned int len );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     書きかけでない最も古いレコードを 1 つ捨てる。
+ * @attention 捨てられるレコードがあること。
+ * @note      先頭レコードが書きかけの場合は、先頭レコードの残りを 2 番目のレコードの
+ *            後ろにずらして 2 番目のレコードを捨てる ( 動かすのは書きかけの残りだけ )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Remove(
+    SAppIfQue_t*    que     ///< [in] キュー
+){
+    unsigned int    len0 = QUE_REC( que, 0 ) - que->sent;    // 先頭レコードの残り
+    unsigned int    len1 = 0;
+    unsigned int    i = 0;
+
+    if( que->sent == 0 )
+    {
+        que->head   = ( que->head + len0 ) & QUE_MASK;
+        que->len   -= len0;
+        que->first  = ( que->first + 1 ) & ( APP_IF_QUE_REC_MAX - 1 );
+    } else
+    {
+        // 重なる範囲を後ろへずらすので、末尾から 1 Byte ずつ動かす
+        len1 = QUE_REC( que, 1 );
+        for( i = len0; i > 0; i-- )
+        {
+            que->buf[( que->head + len1 + i - 1 ) & QUE_MASK] = que->buf[( que->head + i - 1 ) & QUE_MASK];
+        }
+        QUE_REC( que, 1 ) = QUE_REC( que, 0 );
+        que->head   = ( que->head + len1 ) & QUE_MASK;
+        que->len   -= len1;
+        que->first  = ( que->first + 1 ) & ( APP_IF_QUE_REC_MAX - 1 );
+    }
+
+    que->num--;
+    que->drop++;
+    if( que->num == 0 ){ que->head = 0; }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     buf[pos] から data を書き込む。
+ * @attention len は APP_IF_QUE_SIZE 以下であること。
+ * @note      buf[] の末尾をまたぐ場合は先頭に続けて書き込む。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Copy(
+    SAppIfQue_t*    que,    ///< [in] キュー
+    unsigned int    pos,    ///< [in] 書き込む位置 ( buf の添字 )
+    const void*     data,   ///< [in] データ
+    unsigned int    len     ///< [in] サイズ
+){
+    unsigned int    n = APP_IF_QUE_SIZE - pos;
+
+    if( len <= n )
+    {
+        memcpy( &que->buf[pos], data, len );
+        return;
+    }
+    memcpy( &que->buf[pos], data, n );
+    memcpy( que->buf, (const unsigned char*)data + n, len - n );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     キューを初期化する。
+ * @attention なし。
+ * @note      limit が 0 または APP_IF_QUE_SIZE より大きい場合は APP_IF_QUE_SIZE にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfQue_Init(
+    SAppIfQue_t*        que,    ///< [in] キュー
+    EAppIfQuePolicy_t   policy, ///< [in] あふれた時のポリシ
+    unsigned int        limit   ///< [in] キューのサイズ ( Byte )
+){
+    DBG_PRINT_TRACE( "policy = %d, limit = %u \n\r", policy, limit );
+
+    if( limit == 0 || limit > APP_IF_QUE_SIZE ){ limit = APP_IF_QUE_SIZE; }
+
+    que->policy = policy;
+    que->limit  = limit;
+    que->sock   = -1;
+    que->head   = 0;
+    que->len    = 0;
+    que->first  = 0;
+    que->num    = 0;
+    que->sent   = 0;
+    que->push   = 0;
+    que->drop   = 0;
+    que->out    = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードを積む。
+ * @attention なし。
+ * @note      AppIfQue_Pushv() を参照。
+ * @sa        AppIfQue_Pushv()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 積んだ, EN_FALSE : 捨てた
+ *************************************************************************** */
+EHalBool_t
+AppIfQue_Push(
+    SAppIfQue_t*    que,    ///< [in] キュー
+    const void*     data,   ///< [in] レコード
+    unsigned int    len     ///< [in] サイズ
+){
+    struct iovec    iov;
+
+    iov.iov_base = (void*)data;
+    iov.iov_len  = len;
+    return AppIfQue_Pushv( que, &iov, 1 );
+}
+
+
+/**************************************************************************//*!
+ * @brief     複数の部分からなるレコードを 1 レコードとして積む。
+ * @attention なし。
+ * @note      入りきらない場合はポリシに従って捨てる。
+ *            CSV の列名の行とレコードのように、分けて捨てたくないものを 1 レコードにする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 積んだ, EN_FALSE : 捨てた
+ *************************************************************************** */
+EHalBool_t
+AppIfQue_Pushv(
+    SAppIfQue_t*        que,    ///< [in] キュー
+    const struct iovec* iov,    ///< [in] レコード
+    int                 num     ///< [in] iov の数
+){
+    unsigned int        len = 0;
+    unsigned int        keep = 0;
+    unsigned int        pos = 0;
+    int                 i = 0;
+
+    for( i = 0; i < num; i++ )
+    {
+        len += (unsigned int)iov[i].iov_len;
+    }
+
+    // 書きかけのレコードは残るので、その分を除いて入らない大きさは捨てる
+    keep = ( que->sent > 0 ) ? QUE_REC( que, 0 ) - que->sent : 0;
+    if( len == 0 || len > 0xFFFF || keep + len > que->limit )
+    {
+        que->drop++;
+        return EN_FALSE;
+    }
+
+    if( que->len + len > que->limit || que->num >= APP_IF_QUE_REC_MAX )
+    {
+        if( que->policy == EN_QUE_DROP_NEWEST )
+        {
+            que->drop++;
+            return EN_FALSE;
+        }
+
+        if( que->policy == EN_QUE_LATEST )
+        {
+            // 書きかけのレコードの残り以外をまとめて捨てる
+            que->drop += que->num - ( ( keep > 0 ) ? 1U : 0U );
+            que->num   = ( keep > 0 ) ? 1U : 0U;
+            que->len   = keep;
+            if( que->num == 0 ){ que->head = 0; }
+        }
+
+        while( que->len + len > que->limit || que->num >= APP_IF_QUE_REC_MAX )
+        {
+            Remove( que );
+        }
+    }
+
+    pos = que->head + que->len;
+    for( i = 0; i < num; i++ )
+    {
+        pos &= QUE_MASK;
+        Copy( que, pos, iov[i].iov_base, (unsigned int)iov[i].iov_len );
+        pos += (unsigned int)iov[i].iov_len;
+    }
+    QUE_REC( que, que->num ) = (unsigned short)len;
+    que->len += len;
+    que->num++;
+    que->push++;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     積んでいるレコードを書けるだけ書く。
+ * @attention 出力先がブロッキングの場合は全て書くまで戻らない。
+ * @note      ソケットには MSG_NOSIGNAL | MSG_DONTWAIT で send() し、
+ *            それ以外 ( パイプ, ファイル, 端末 ) には write() する。
+ *            buf[] の末尾までを書いてから、先頭に続くデータを書く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    0 : 全て書いた, 1 : 書き切れなかった ( EAGAIN ), -1 : 失敗
+ *************************************************************************** */
+int
+AppIfQue_Flush(
+    SAppIfQue_t*    que,    ///< [in] キュー
+    int             fd      ///< [in] 出力先
+){
+    ssize_t         ret = 0;
+    unsigned int    n = 0;
+    unsigned int    len = 0;
+
+    while( que->len > 0 )
+    {
+        len = APP_IF_QUE_SIZE - que->head;
+        if( len > que->len ){ len = que->len; }
+
+        if( que->sock != 0 )
+        {
+            ret = send( fd, &que->buf[que->head], len, MSG_NOSIGNAL | MSG_DONTWAIT );
+            if( ret < 0 && errno == ENOTSOCK )
+            {
+                que->sock = 0;
+                continue;
+            }
+            if( ret >= 0 ){ que->sock = 1; }
+        } else
+        {
+            ret = write( fd, &que->buf[que->head], len );
+        }
+
+        if( ret < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            if( errno == EAGAIN || errno == EWOULDBLOCK ){ return 1; }
+            DBG_PRINT_ERROR( "write() error. : %s \n\r", strerror( errno ) );
+            return -1;
+        }
+
+        // 書き終えたレコードを外す
+        que->out  += (unsigned long long)ret;
+        que->head  = ( que->head + (unsigned int)ret ) & QUE_MASK;
+        que->len  -= (unsigned int)ret;
+        n = que->sent + (unsigned int)ret;
+        while( que->num > 0 && n >= QUE_REC( que, 0 ) )
+        {
+            n -= QUE_REC( que, 0 );
+            que->first = ( que->first + 1 ) & ( APP_IF_QUE_REC_MAX - 1 );
+            que->num--;
+        }
+        que->sent = n;
+    }
+
+    que->head = 0;
+    return 0;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ポリシの名前を変換する。
+ * @attention なし。
+ * @note      oldest, newest, latest
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 不正な名前
+ *************************************************************************** */
+EHalBool_t
+AppIfQue_Policy(
+    const char*         str,    ///< [in]  名前
+    EAppIfQuePolicy_t*  policy  ///< [out] ポリシ
+){
+    if( 0 == strcmp( str, "oldest" ) ){ *policy = EN_QUE_DROP_OLDEST; return EN_TRUE; }
+    if( 0 == strcmp( str, "newest" ) ){ *policy = EN_QUE_DROP_NEWEST; return EN_TRUE; }
+    if( 0 == strcmp( str, "latest" ) ){ *policy = EN_QUE_LATEST;      return EN_TRUE; }
+    return EN_FALSE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,88 @@
+/**************************************************************************//*!
+ *  @file           if_que.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           出力先 ( 標準出力のパイプ, ソケット ) 毎の上限付き送信キュー。
+ *                  レコード単位で積み、ノンブロッキングで書けるだけ書く。
+ *                  出力先が読まない場合はキューがあふれ、ポリシに従ってレコードを捨てる。
+ *                  書き込みは待たないので、センサの読み出し周期は出力先の速さに依存しない。
+ *                  ポリシ
+ *                      oldest : 古いレコードから捨てて新しいレコードを積む ( 初期値 )
+ *                      newest : 新しいレコードを捨てる
+ *                      latest : 積んでいるレコードを全て捨てて最新の 1 レコードだけにする
+ *                  書きかけのレコードは捨てない ( ストリームの途中でレコードが切れないようにする )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_QUE_H_
+#define _APP_IF_QUE_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <sys/uio.h>
+
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_QUE_SIZE         (16384)     ///< @def : キューの最大サイズ ( Byte, 2 のべき乗 )
+#define APP_IF_QUE_REC_MAX      (1024)      ///< @def : キューに積めるレコードの最大数 ( 2 のべき乗 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// キューがあふれた時のポリシに使用する型
+typedef enum tagEAppIfQuePolicy
+{
+    EN_QUE_DROP_OLDEST = 0, ///< @var : 古いレコードから捨てる
+    EN_QUE_DROP_NEWEST,     ///< @var : 新しいレコードを捨てる
+    EN_QUE_LATEST           ///< @var : 最新の 1 レコードだけを残す
+} EAppIfQuePolicy_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 送信キューの型 ( 呼び出し元が確保する )
+typedef struct tagSAppIfQue
+{
+    EAppIfQuePolicy_t   policy;                     ///< @var : あふれた時のポリシ
+    unsigned int        limit;                      ///< @var : キューのサイズ ( Byte, APP_IF_QUE_SIZE 以下 )
+    int                 sock;                       ///< @var : 出力先の種類 ( -1 : 未確認, 0 : ソケット以外, 1 : ソケット )
+    unsigned int        head;                       ///< @var : 先頭レコードの位置 ( buf のリングバッファの添字 )
+    unsigned int        len;                        ///< @var : 積んでいるサイズ ( Byte )
+    unsigned int        first;                      ///< @var : 先頭レコードの rlen の添字
+    unsigned int        num;                        ///< @var : 積んでいるレコード数
+    unsigned int        sent;                       ///< @var : 先頭レコードの書き込み済みのサイズ
+    unsigned long long  push;                       ///< @var : 積んだレコード数
+    unsigned long long  drop;                       ///< @var : 捨てたレコード数
+    unsigned long long  out;                        ///< @var : 書き込んだサイズ ( Byte )
+    unsigned short      rlen[APP_IF_QUE_REC_MAX];   ///< @var : レコード毎のサイズ
+    unsigned char       buf[APP_IF_QUE_SIZE];       ///< @var : レコード
+} SAppIfQue_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+void            AppIfQue_Init( SAppIfQue_t* que, EAppIfQuePolicy_t policy, unsigned int limit );
+EHalBool_t      AppIfQue_Push( SAppIfQue_t* que, const void* data, unsigned int len );
+EHalBool_t      AppIfQue_Pushv( SAppIfQue_t* que, const struct iovec* iov, int num );
+int             AppIfQue_Flush( SAppIfQue_t* que, int fd );
+EHalBool_t      AppIfQue_Policy( const char* str, EAppIfQuePolicy_t* policy );
+
+
+#endif /* _APP_IF_QUE_H_ */
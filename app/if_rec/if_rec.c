@@ -0,0 +1,574 @@
+/**************************************************************************//*!
+ *  @file           if_rec.c
+ *  @brief          [APP] センサの生値を mmap したセグメントファイルに記録する。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_rec.h ( セグメントのレイアウト ), if_rec_reader.c ( 読み出し側 )
+ *  @note           書き込みは 1 プロセス ( 1 スレッド ) に限る。
+ *                  1 レコードの書き込みは memcpy だけで、システムコールは発生しない。
+ *                  APP_IF_REC_SYNC_BYTES 書くか APP_IF_REC_SYNC_MSEC 経つ度に、
+ *                  書いた範囲を msync( MS_ASYNC ) してヘッダの count を進める。
+ *                  セグメントの作成 ( open, posix_fallocate, mmap ) と、閉じる処理
+ *                  ( msync( MS_SYNC ), ftruncate, fdatasync ) はセグメント用のスレッドで行う。
+ *                  スレッドは次のセグメントを先に作っておくので、切り替えは
+ *                  セグメントを入れ替えるだけで済む ( 書き込む側はシステムコールを呼ばない )。
+ *                  先に作ったセグメントは magic が 0 なので、読み出し側はまだないものとして扱う。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#define _GNU_SOURCE     // SCHED_BATCH
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "if_rec.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define REC_PATH_LEN        (256)           // セグメントのパスの最大長
+#define REC_PAGE            (4096)          // msync() の単位 ( Byte )
+#define REC_NSEC_PER_MSEC   (1000000ULL)
+#define REC_NSEC_PER_SEC    (1000000000ULL)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// 先に作るセグメントの状態に使用する型
+typedef enum {
+    EN_REC_SPARE_NONE = 0,  // ない ( スレッドが作る )
+    EN_REC_SPARE_READY,     // 作成済み
+    EN_REC_SPARE_ERROR      // 作成に失敗した
+} EAppIfRecSpare_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// セグメントの型
+typedef struct {
+    int                 fd;         // ファイル ( -1 : なし )
+    SAppIfRecHdr_t*     hdr;        // mmap 先 ( NULL : なし )
+    unsigned int        seg;        // セグメントの番号
+    unsigned long long  num;        // 書いたレコード数 ( 閉じる時に切り詰める大きさ )
+} SAppIfRecSeg_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static char                 g_path[REC_PATH_LEN];   // セグメントのパスの接頭辞
+static size_t               g_segSize = 0;          // セグメントの最大サイズ ( Byte )
+static unsigned long long   g_segNs = 0;            // セグメントの最大時間 ( nsec, 0 = 無制限 )
+static unsigned int         g_seg = 0;              // 次に作るセグメントの番号 ( 開始後はスレッドだけが使う )
+static SAppIfRecSeg_t       g_cur = { -1, NULL, 0, 0 };     // 書き込み中のセグメント
+static SAppIfRecHdr_t*      g_hdr = NULL;           // 書き込み中のセグメントの mmap 先
+static SAppIfRecRec_t*      g_rec = NULL;           // レコードの配列
+static unsigned long long   g_cap = 0;              // セグメントに入るレコード数
+static unsigned long long   g_num = 0;              // 書いたレコード数
+static unsigned long long   g_synced = 0;           // msync() 済みのレコード数
+static unsigned long long   g_syncTs = 0;           // 最後に msync() したレコードの時刻
+
+static pthread_t            g_thread;               // セグメント用のスレッド
+static sem_t                g_sem;                  // スレッドへの依頼
+static sem_t                g_done;                 // スレッドの処理の完了
+static int                  g_run = 0;              // 1 : スレッドが動いている
+static SAppIfRecSeg_t       g_spare = { -1, NULL, 0, 0 };   // 先に作ったセグメント ( g_spareState で受け渡す )
+static int                  g_spareState = EN_REC_SPARE_NONE;   // g_spare の状態 ( EAppIfRecSpare_t )
+static SAppIfRecSeg_t       g_retire = { -1, NULL, 0, 0 };  // 閉じるセグメント ( g_retireBusy で受け渡す )
+static int                  g_retireBusy = 0;       // 1 : スレッドが g_retire を閉じる
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   SegCreate( SAppIfRecSeg_t* seg, unsigned int num );
+static void         SegStart( SAppIfRecSeg_t* seg, unsigned long long ts );
+static void         SegClose( SAppIfRecSeg_t* seg );
+static void         SegDiscard( SAppIfRecSeg_t* seg );
+static void*        ThreadMain( void* arg );
+static EHalBool_t   Rotate( unsigned long long ts );
+static void         Sync( unsigned long long ts );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     セグメントを作成する。
+ * @attention なし。
+ * @note      最大サイズまで確保してから mmap するので、書き込み中に容量不足で
+ *            SIGBUS になることはない。
+ *            時刻と magic 以外のヘッダを書き込む ( SegStart() で書き始める )。
+ * @sa        SegStart()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+SegCreate(
+    SAppIfRecSeg_t*     seg,    ///< [out] セグメント
+    unsigned int        num     ///< [in]  セグメントの番号
+){
+    char                name[REC_PATH_LEN + 8];
+    void*               addr = MAP_FAILED;
+    SAppIfRecHdr_t*     hdr = NULL;
+    unsigned int        ch = 0;
+    int                 res = 0;
+
+    snprintf( name, sizeof(name), "%s.%04u", g_path, num );
+    DBG_PRINT_TRACE( "name = %s \n\r", name );
+
+    seg->fd = open( name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if( seg->fd < 0 )
+    {
+        DBG_PRINT_ERROR( "open() error. : %s : %s \n\r", name, strerror( errno ) );
+        goto err;
+    }
+
+    res = posix_fallocate( seg->fd, 0, (off_t)g_segSize );
+    if( res != 0 )
+    {
+        DBG_PRINT_ERROR( "posix_fallocate() error. : %s : %s \n\r", name, strerror( res ) );
+        goto err;
+    }
+
+    addr = mmap( NULL, g_segSize, PROT_READ | PROT_WRITE, MAP_SHARED, seg->fd, 0 );
+    if( addr == MAP_FAILED )
+    {
+        DBG_PRINT_ERROR( "mmap() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+    madvise( (unsigned char*)addr + APP_IF_REC_HDR_SIZE, g_segSize - APP_IF_REC_HDR_SIZE, MADV_SEQUENTIAL );
+
+    hdr = (SAppIfRecHdr_t*)addr;
+    hdr->h.ver      = APP_IF_REC_VER;
+    hdr->h.hdr_size = APP_IF_REC_HDR_SIZE;
+    hdr->h.rec_size = sizeof(SAppIfRecRec_t);
+    hdr->h.ch_num   = EN_SEN_CH_NUM;
+    hdr->h.seg      = num;
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        hdr->h.scale[ch] = HalCmnHist_Scale( (EHalSensorCh_t)ch );
+        strncpy( hdr->h.name[ch], HalCmn_GetChName( (EHalSensorCh_t)ch ), APP_IF_REC_NAME_LEN - 1 );
+    }
+
+    seg->hdr = hdr;
+    seg->seg = num;
+    seg->num = 0;
+    return EN_TRUE;
+
+err :
+    if( seg->fd >= 0 ){ close( seg->fd ); unlink( name ); }
+    seg->fd  = -1;
+    seg->hdr = NULL;
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     作成したセグメントに書き始める。
+ * @attention なし。
+ * @note      ヘッダの時刻を書いてから magic を書く ( 読み出し側はここから読める )。
+ *            システムコールは呼ばない。
+ * @sa        SegCreate()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SegStart(
+    SAppIfRecSeg_t*     seg,    ///< [in] セグメント
+    unsigned long long  ts      ///< [in] 時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    g_cur = *seg;
+    g_hdr = seg->hdr;
+    g_rec = (SAppIfRecRec_t*)( (unsigned char*)g_hdr + APP_IF_REC_HDR_SIZE );
+    g_cap = ( g_segSize - APP_IF_REC_HDR_SIZE ) / sizeof(SAppIfRecRec_t);
+    g_num = 0;
+    g_synced = 0;
+    g_syncTs = ts;
+
+    g_hdr->h.mono  = ts;
+    g_hdr->h.real  = HalCmnClock_ToReal( ts );
+    g_hdr->h.magic = APP_IF_REC_MAGIC;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     セグメントを閉じる。
+ * @attention ヘッダの count, closed は呼び出し元で書いておくこと。
+ * @note      書いたレコードを全て書き出してから、有効なレコードの分まで切り詰める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SegClose(
+    SAppIfRecSeg_t*     seg     ///< [in] セグメント
+){
+    size_t              used = APP_IF_REC_HDR_SIZE + seg->num * sizeof(SAppIfRecRec_t);
+
+    if( seg->hdr == NULL )
+    {
+        return;
+    }
+
+    msync( seg->hdr, used, MS_SYNC );
+    munmap( seg->hdr, g_segSize );
+
+    if( ftruncate( seg->fd, (off_t)used ) < 0 )
+    {
+        DBG_PRINT_ERROR( "ftruncate() error. : %s \n\r", strerror( errno ) );
+    }
+    fdatasync( seg->fd );
+    close( seg->fd );
+
+    seg->fd  = -1;
+    seg->hdr = NULL;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き始めていないセグメントを削除する。
+ * @attention なし。
+ * @note      記録の終了時に、先に作ったセグメントを残さない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SegDiscard(
+    SAppIfRecSeg_t*     seg     ///< [in] セグメント
+){
+    char                name[REC_PATH_LEN + 8];
+
+    if( seg->hdr == NULL )
+    {
+        return;
+    }
+
+    snprintf( name, sizeof(name), "%s.%04u", g_path, seg->seg );
+    munmap( seg->hdr, g_segSize );
+    close( seg->fd );
+    unlink( name );
+
+    seg->fd  = -1;
+    seg->hdr = NULL;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     セグメント用のスレッド
+ * @attention なし。
+ * @note      書き込む側から渡されたセグメントを閉じ、次のセグメントを先に作る。
+ *            AppIfRec_Close() で渡されたセグメントを閉じてから終了する。
+ *            SCHED_BATCH で動かし、起こした時に書き込む側のスレッドから CPU を奪わない。
+ * @sa        Rotate()
+ * @author    Ryoji Morita
+ * @return    NULL
+ *************************************************************************** */
+static void*
+ThreadMain(
+    void*               arg     ///< [in] 未使用
+){
+    struct sched_param  sp;
+    EHalBool_t          ok = EN_FALSE;
+
+    (void)arg;
+
+    memset( &sp, 0, sizeof(sp) );
+    pthread_setschedparam( pthread_self(), SCHED_BATCH, &sp );
+
+    while( 1 )
+    {
+        while( sem_wait( &g_sem ) < 0 && errno == EINTR ){}
+
+        // 次の切り替えに必要なセグメントの作成 ( 速い ) を、閉じる処理 ( fdatasync() で遅い ) より先に行う
+        if( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) != 0
+         && __atomic_load_n( &g_spareState, __ATOMIC_ACQUIRE ) == EN_REC_SPARE_NONE )
+        {
+            ok = SegCreate( &g_spare, g_seg );
+            if( ok == EN_TRUE ){ g_seg++; }
+            __atomic_store_n( &g_spareState, ( ok == EN_TRUE ) ? EN_REC_SPARE_READY : EN_REC_SPARE_ERROR, __ATOMIC_RELEASE );
+            sem_post( &g_done );
+        }
+
+        if( __atomic_load_n( &g_retireBusy, __ATOMIC_ACQUIRE ) != 0 )
+        {
+            SegClose( &g_retire );
+            __atomic_store_n( &g_retireBusy, 0, __ATOMIC_RELEASE );
+            sem_post( &g_done );
+        }
+
+        if( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) == 0 ){ break; }
+    }
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     次のセグメントに切り替える。
+ * @attention なし。
+ * @note      書き込み中のセグメントをスレッドに渡して閉じさせ、先に作ったセグメントに書き始める。
+ *            スレッドが前のセグメントを閉じ終わっていないか、次のセグメントを作り終わっていない
+ *            場合だけ待つ ( セグメントが一杯になる間隔より処理が遅い場合 )。
+ * @sa        ThreadMain()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 次のセグメントを作れない )
+ *************************************************************************** */
+static EHalBool_t
+Rotate(
+    unsigned long long  ts      ///< [in] 時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    while( __atomic_load_n( &g_retireBusy, __ATOMIC_ACQUIRE ) != 0
+        || __atomic_load_n( &g_spareState, __ATOMIC_ACQUIRE ) == EN_REC_SPARE_NONE )
+    {
+        while( sem_wait( &g_done ) < 0 && errno == EINTR ){}
+    }
+
+    g_hdr->h.count  = g_num;
+    g_hdr->h.closed = 1;
+    g_cur.num = g_num;
+    g_retire  = g_cur;
+    __atomic_store_n( &g_retireBusy, 1, __ATOMIC_RELEASE );
+
+    if( __atomic_load_n( &g_spareState, __ATOMIC_ACQUIRE ) == EN_REC_SPARE_ERROR )
+    {
+        g_cur.fd  = -1;
+        g_cur.hdr = NULL;
+        g_hdr = NULL;
+        g_rec = NULL;
+        sem_post( &g_sem );
+        return EN_FALSE;
+    }
+
+    SegStart( &g_spare, ts );
+    __atomic_store_n( &g_spareState, EN_REC_SPARE_NONE, __ATOMIC_RELEASE );
+    sem_post( &g_sem );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     msync() していないレコードの書き出しを開始する。
+ * @attention なし。
+ * @note      MS_ASYNC なので書き出しの完了は待たない。
+ *            レコードを書き出しに回してからヘッダの count を進める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Sync(
+    unsigned long long  ts      ///< [in] 時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    size_t              from = APP_IF_REC_HDR_SIZE + g_synced * sizeof(SAppIfRecRec_t);
+    size_t              to   = APP_IF_REC_HDR_SIZE + g_num * sizeof(SAppIfRecRec_t);
+
+    from &= ~(size_t)( REC_PAGE - 1 );
+    msync( (unsigned char*)g_hdr + from, to - from, MS_ASYNC );
+
+    g_hdr->h.count = g_num;
+    g_synced = g_num;
+    g_syncTs = ts;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     記録を開始する。
+ * @attention 既に開いている場合は閉じてから開始する。
+ * @note      最初のセグメント ( path.0000 ) を作成してから、セグメント用のスレッドを起動する。
+ *            スレッドはシグナルを受けない ( 全てのシグナルをブロックして起動する )。
+ * @sa        AppIfRec_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfRec_Open(
+    const char*     path,   ///< [in] セグメントのパスの接頭辞
+    unsigned int    segMb,  ///< [in] セグメントの最大サイズ ( MByte, 0 : APP_IF_REC_SEG_MB )
+    unsigned int    segSec  ///< [in] セグメントの最大時間 ( sec, 0 : 無制限 )
+){
+    SAppIfRecSeg_t  seg;
+    sigset_t        all;
+    sigset_t        org;
+    int             res = 0;
+
+    DBG_PRINT_TRACE( "path = %s, segMb = %u, segSec = %u \n\r", path, segMb, segSec );
+
+    AppIfRec_Close();
+
+    if( segMb == 0 ){ segMb = APP_IF_REC_SEG_MB; }
+    if( path == NULL || strlen( path ) >= sizeof(g_path) || segMb > 4096 )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. \n\r" );
+        return EN_FALSE;
+    }
+
+    strcpy( g_path, path );
+    g_segSize = (size_t)segMb * 1024 * 1024;
+    g_segNs   = (unsigned long long)segSec * REC_NSEC_PER_SEC;
+    g_seg     = 0;
+
+    if( SegCreate( &seg, g_seg ) == EN_FALSE )
+    {
+        return EN_FALSE;
+    }
+    g_seg++;
+    SegStart( &seg, HalCmnClock_GetNsec() );
+
+    sem_init( &g_sem, 0, 0 );
+    sem_init( &g_done, 0, 0 );
+    g_spareState = EN_REC_SPARE_NONE;
+    g_retireBusy = 0;
+    __atomic_store_n( &g_run, 1, __ATOMIC_RELEASE );
+
+    sigfillset( &all );
+    pthread_sigmask( SIG_SETMASK, &all, &org );
+    res = pthread_create( &g_thread, NULL, ThreadMain, NULL );
+    pthread_sigmask( SIG_SETMASK, &org, NULL );
+    if( res != 0 )
+    {
+        DBG_PRINT_ERROR( "pthread_create() error. : %s \n\r", strerror( res ) );
+        __atomic_store_n( &g_run, 0, __ATOMIC_RELEASE );
+        sem_destroy( &g_sem );
+        sem_destroy( &g_done );
+        g_hdr->h.count  = 0;
+        g_hdr->h.closed = 1;
+        SegClose( &g_cur );
+        g_hdr = NULL;
+        g_rec = NULL;
+        return EN_FALSE;
+    }
+
+    // 次のセグメントを作らせる
+    sem_post( &g_sem );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     記録を終了する。
+ * @attention なし。
+ * @note      開いていない場合は何もしない。
+ *            スレッドが閉じているセグメントを閉じ終わるのを待ってから、
+ *            書き込み中のセグメントを閉じ、先に作ったセグメントを削除する。
+ * @sa        AppIfRec_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfRec_Close(
+    void
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( __atomic_exchange_n( &g_run, 0, __ATOMIC_ACQ_REL ) == 0 )
+    {
+        return;
+    }
+    sem_post( &g_sem );
+    pthread_join( g_thread, NULL );
+    sem_destroy( &g_sem );
+    sem_destroy( &g_done );
+
+    if( g_hdr != NULL )
+    {
+        g_hdr->h.count  = g_num;
+        g_hdr->h.closed = 1;
+        g_cur.num = g_num;
+        SegClose( &g_cur );
+    }
+    if( g_spareState == EN_REC_SPARE_READY ){ SegDiscard( &g_spare ); }
+    g_spareState = EN_REC_SPARE_NONE;
+
+    g_hdr = NULL;
+    g_rec = NULL;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     生値を 1 レコード記録する。
+ * @attention 開いていない場合は失敗する。
+ * @note      セグメントが一杯になるか最大時間を過ぎた場合は次のセグメントに切り替える
+ *            ( 先に作ったセグメントに入れ替えるだけで、作成と閉じる処理はスレッドで行う )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfRec_Write(
+    unsigned int        mask,   ///< [in] ch マスク
+    const short*        raw,    ///< [in] 生値 ( EHalSensorCh_t で添字, EN_SEN_CH_NUM 個 )
+    unsigned long long  ts      ///< [in] 転送開始時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    SAppIfRecRec_t*     rec = NULL;
+    unsigned int        ch = 0;
+
+    if( g_hdr == NULL )
+    {
+        return EN_FALSE;
+    }
+
+    if( ts == 0 )
+    {
+        ts = HalCmnClock_GetNsec();     // 一度も転送していない ch
+    }
+
+    if( g_num >= g_cap || ( g_segNs != 0 && ts >= g_hdr->h.mono + g_segNs ) )
+    {
+        if( Rotate( ts ) == EN_FALSE )
+        {
+            return EN_FALSE;
+        }
+    }
+
+    mask &= ( 1U << EN_SEN_CH_NUM ) - 1;
+    rec = &g_rec[g_num];
+    rec->ts   = ts;
+    rec->mask = (unsigned short)mask;
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        rec->raw[ch] = ( mask & ( 1U << ch ) ) ? raw[ch] : 0;
+    }
+    g_num++;
+
+    if( ( g_num - g_synced ) * sizeof(SAppIfRecRec_t) >= APP_IF_REC_SYNC_BYTES
+     || ts >= g_syncTs + APP_IF_REC_SYNC_MSEC * REC_NSEC_PER_MSEC )
+    {
+        Sync( ts );
+    }
+    return EN_TRUE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
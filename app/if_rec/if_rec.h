@@ -0,0 +1,113 @@
+/**************************************************************************//*!
+ *  @file           if_rec.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           センサの生値を固定長のレコードでファイルに記録する ( 追記のみ )。
+ *                  ファイルはセグメントに分け、path.0000, path.0001, ... の順に作る。
+ *                  セグメントのレイアウト
+ *                      SAppIfRecHdr_t ( APP_IF_REC_HDR_SIZE Byte ) + SAppIfRecRec_t * count
+ *                  セグメントは作成時に最大サイズまで確保して mmap し、レコードは memcpy で書く。
+ *                  サイズか時間が上限に達したら次のセグメントに切り替え、
+ *                  閉じたセグメントは有効なレコードの分まで切り詰める。
+ *                  次のセグメントは書き込み中に別のスレッドで作っておく ( ヘッダの magic は 0 )。
+ *                  生値から物理量への換算係数と ch 名はヘッダに記録する。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_REC_H_
+#define _APP_IF_REC_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stddef.h>
+
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_REC_MAGIC        (0x43455242)        ///< @def : ファイルの識別子 ( "BREC" )
+#define APP_IF_REC_VER          (1)                 ///< @def : レイアウトのバージョン
+#define APP_IF_REC_HDR_SIZE     (4096)              ///< @def : ヘッダのサイズ ( Byte, ページサイズの倍数 )
+#define APP_IF_REC_NAME_LEN     (16)                ///< @def : ch 名の最大長 ( 終端を含む )
+#define APP_IF_REC_SEG_MB       (64)                ///< @def : セグメントの最大サイズの省略時 ( MByte )
+#define APP_IF_REC_SYNC_BYTES   (1024 * 1024)       ///< @def : msync() するまでに書くサイズ ( Byte )
+#define APP_IF_REC_SYNC_MSEC    (1000)              ///< @def : msync() するまでの時間 ( msec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 1 レコードの型 ( 40 Byte )
+typedef struct tagSAppIfRecRec
+{
+    unsigned long long  ts;                     ///< @var : 転送開始時刻 ( CLOCK_MONOTONIC_RAW, nsec, 0 = 未記録 )
+    unsigned short      mask;                   ///< @var : 有効な ch のマスク ( 1 << EHalSensorCh_t )
+    short               raw[EN_SEN_CH_NUM];     ///< @var : 生値 ( mask にない ch は 0 )
+    unsigned short      reserved;               ///< @var : 予約 ( 0 )
+} SAppIfRecRec_t;
+
+
+// セグメントのヘッダの型
+typedef union tagSAppIfRecHdr
+{
+    struct {
+        unsigned int        magic;              ///< @var : APP_IF_REC_MAGIC
+        unsigned int        ver;                ///< @var : APP_IF_REC_VER
+        unsigned int        hdr_size;           ///< @var : APP_IF_REC_HDR_SIZE
+        unsigned int        rec_size;           ///< @var : sizeof(SAppIfRecRec_t)
+        unsigned int        ch_num;             ///< @var : EN_SEN_CH_NUM
+        unsigned int        seg;                ///< @var : セグメントの番号
+        unsigned int        closed;             ///< @var : 1 : 閉じた ( count が確定している )
+        unsigned int        reserved;           ///< @var : 予約 ( 0 )
+        unsigned long long  count;              ///< @var : msync() 済みのレコード数
+        unsigned long long  mono;               ///< @var : セグメントを作成した時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+        unsigned long long  real;               ///< @var : mono に相当する UNIX 時間 ( nsec )
+        double              scale[EN_SEN_CH_NUM];                   ///< @var : 生値から物理量への換算係数
+        char                name[EN_SEN_CH_NUM][APP_IF_REC_NAME_LEN];  ///< @var : ch 名 ( HalCmn_GetChName() )
+    } h;
+    unsigned char           pad[APP_IF_REC_HDR_SIZE];
+} SAppIfRecHdr_t;
+
+
+// 読み出し側で開いたセグメントの型
+typedef struct tagSAppIfRecFile
+{
+    const SAppIfRecHdr_t*   hdr;                ///< @var : ヘッダ
+    const SAppIfRecRec_t*   rec;                ///< @var : レコードの配列
+    unsigned long long      count;              ///< @var : 読み出せるレコード数
+    size_t                  size;               ///< @var : mmap したサイズ ( Byte )
+} SAppIfRecFile_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// 書き込み側 ( board.out )
+EHalBool_t      AppIfRec_Open( const char* path, unsigned int segMb, unsigned int segSec );
+void            AppIfRec_Close( void );
+EHalBool_t      AppIfRec_Write( unsigned int mask, const short* raw, unsigned long long ts );
+
+// 読み出し側
+EHalBool_t      AppIfRecReader_Open( SAppIfRecFile_t* file, const char* path, unsigned int seg );
+void            AppIfRecReader_Close( SAppIfRecFile_t* file );
+
+
+#endif /* _APP_IF_REC_H_ */
@@ -0,0 +1,172 @@
+/**************************************************************************//*!
+ *  @file           if_rec_reader.c
+ *  @brief          [APP] 記録したセグメントファイルからセンサの生値を読み出す。
+ *  @author         Ryoji Morita
+ *  @attention      HAL の関数は使わないので、このファイルだけをリンクすれば
+ *                  board.out 以外のプロセスからも使える ( libif_rec_reader.a )。
+ *  @sa             if_rec.h ( セグメントのレイアウト ), if_rec.c ( 書き込み側 )
+ *  @note           セグメント全体を読み出し専用で mmap する。
+ *                  書き込み中のセグメントはヘッダの count ( msync() 済み ) までを読む。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "if_rec.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// なし
+
+
+
+
+/**************************************************************************//*!
+ * @brief     セグメントを開く。
+ * @attention なし。
+ * @note      path.seg ( 4 桁 ) を開く。レイアウト ( バージョン, サイズ, ch 数 ) が
+ *            一致しない場合は失敗する。
+ *            書き込み側が先に作って、まだ書き始めていないセグメント ( magic が 0 ) は
+ *            ないものとして扱う。
+ * @sa        AppIfRecReader_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( セグメントがない場合を含む )
+ *************************************************************************** */
+EHalBool_t
+AppIfRecReader_Open(
+    SAppIfRecFile_t*        file,   ///< [out] 開いたセグメント
+    const char*             path,   ///< [in]  セグメントのパスの接頭辞
+    unsigned int            seg     ///< [in]  セグメントの番号
+){
+    char                    name[512];
+    int                     fd = -1;
+    struct stat             st;
+    void*                   addr = MAP_FAILED;
+    const SAppIfRecHdr_t*   hdr = NULL;
+    unsigned long long      max = 0;
+
+    memset( file, 0, sizeof(*file) );
+    snprintf( name, sizeof(name), "%s.%04u", path, seg );
+    DBG_PRINT_TRACE( "name = %s \n\r", name );
+
+    fd = open( name, O_RDONLY | O_CLOEXEC );
+    if( fd < 0 )
+    {
+        return EN_FALSE;
+    }
+
+    if( fstat( fd, &st ) < 0 || (size_t)st.st_size < sizeof(SAppIfRecHdr_t) )
+    {
+        DBG_PRINT_ERROR( "invalid file size. : %s \n\r", name );
+        goto err;
+    }
+
+    addr = mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    if( addr == MAP_FAILED )
+    {
+        DBG_PRINT_ERROR( "mmap() error. : %s \n\r", name );
+        goto err;
+    }
+    close( fd );
+    fd = -1;
+
+    hdr = (const SAppIfRecHdr_t*)addr;
+    if( hdr->h.magic == 0 )
+    {
+        // 次のセグメントとして先に作ってあり、まだ書き始めていない
+        munmap( addr, (size_t)st.st_size );
+        return EN_FALSE;
+    }
+    if( hdr->h.magic    != APP_IF_REC_MAGIC
+     || hdr->h.ver      != APP_IF_REC_VER
+     || hdr->h.hdr_size != APP_IF_REC_HDR_SIZE
+     || hdr->h.rec_size != sizeof(SAppIfRecRec_t)
+     || hdr->h.ch_num   != EN_SEN_CH_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid layout. : %s \n\r", name );
+        munmap( addr, (size_t)st.st_size );
+        return EN_FALSE;
+    }
+
+    max = ( (size_t)st.st_size - APP_IF_REC_HDR_SIZE ) / sizeof(SAppIfRecRec_t);
+    file->hdr   = hdr;
+    file->rec   = (const SAppIfRecRec_t*)( (const unsigned char*)addr + APP_IF_REC_HDR_SIZE );
+    file->count = ( hdr->h.count < max ) ? hdr->h.count : max;
+    file->size  = (size_t)st.st_size;
+    return EN_TRUE;
+
+err :
+    if( fd >= 0 ){ close( fd ); }
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     セグメントを閉じる。
+ * @attention なし。
+ * @note      開いていない場合は何もしない。
+ * @sa        AppIfRecReader_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfRecReader_Close(
+    SAppIfRecFile_t*    file    ///< [in] セグメント
+){
+    if( file->hdr != NULL )
+    {
+        munmap( (void*)file->hdr, file->size );
+    }
+    memset( file, 0, sizeof(*file) );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
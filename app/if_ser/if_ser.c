@@ -0,0 +1,1290 @@
+/**************************************************************************//*!
+ *  @file           if_ser.c
+ *  @brief          [APP] センサ値を JSON / CSV の 1 レコードにシリアライズする。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_ser.h ( 使い方 )
+ *  @note           printf() は呼び出す度に書式文字列を解釈するので、
+ *                  整数は 4 / 8 桁ずつ 1 つのレジスタ内で並列に ( SWAR ) 変換し、
+ *                  小数は桁数を固定した整数演算で文字列にする。
+ *                  区切りの "," は要素数から決めるので、末尾に余計な "," は付かない。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "if_ser.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SER_UINT_LEN        (20)        // unsigned long long の最大桁数
+#define SER_CHUNK_LEN       (8)         // Ascii8() でまとめて変換する桁数
+#define SER_CHUNK           (100000000ULL)
+#define SER_PREC_MAX        (9)         // 小数点以下の最大桁数
+#define SER_FIX_LEN         ( 1 + SER_UINT_LEN + 1 + SER_PREC_MAX )    // 小数の最大長
+#define SER_FIX_MAX         (1.8e19)    // 整数演算で変換できる上限 ( 値 x 10^桁数 )
+
+#define SER_CBOR_HEAD_LEN   (9)         // CBOR の先頭バイト + 引数 ( 最大 8 Byte )
+#define SER_CBOR_UINT       (0x00)      // CBOR のメジャータイプ 0 : 符号なし整数
+#define SER_CBOR_NINT       (0x20)      // CBOR のメジャータイプ 1 : 負の整数
+#define SER_CBOR_TEXT       (0x60)      // CBOR のメジャータイプ 3 : 文字列
+#define SER_CBOR_ARR        (0x9F)      // CBOR : 長さ不定の配列の開始
+#define SER_CBOR_MAP        (0xBF)      // CBOR : 長さ不定の map の開始
+#define SER_CBOR_F32        (0xFA)      // CBOR : float32
+#define SER_CBOR_F64        (0xFB)      // CBOR : float64
+#define SER_CBOR_BREAK      (0xFF)      // CBOR : 長さ不定の map / 配列の終了
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// 小数点以下の桁数の倍率 ( 10^prec を double で持ち、変換のたびに整数から変換しない )
+static const double g_scale[SER_PREC_MAX + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+// JSON でエスケープする文字 ( 制御文字, ", \ ) なら 1
+static const unsigned char g_esc[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+};
+static const unsigned long long g_pow10[SER_UINT_LEN] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+    1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static inline char*                 Reserve( SAppIfSer_t* ser, unsigned int n );
+static inline unsigned int          Ascii4( unsigned int v );
+static inline unsigned long long    Ascii8( unsigned int v );
+static inline unsigned int          Count( unsigned long long value );
+static inline unsigned int          Digits( char* out, unsigned long long value ) __attribute__((always_inline));
+static inline unsigned int          Fixed( char* out, double value, unsigned int prec ) __attribute__((always_inline));
+static unsigned int                 CborHead( char* out, unsigned int major, unsigned long long value );
+static void                         CborKey( SAppIfSer_t* ser, const char* key );
+static char*                        CsvKey( SAppIfSer_t* ser, const char* key, unsigned int n );
+static inline char*                 Key( SAppIfSer_t* ser, const char* key, unsigned int n ) __attribute__((always_inline));
+static void                         HdrKey( SAppIfSer_t* ser, const char* key, char* out, unsigned int* len, unsigned int max );
+static unsigned int                 CsvPrefix( SAppIfSer_t* ser, const char* key );
+static inline void                  Push( SAppIfSer_t* ser, const char* key, char open, EHalBool_t arr );
+static void                         Pop( SAppIfSer_t* ser, char close );
+static EHalBool_t                   WriteAll( int fd, struct iovec* iov, int num );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     レコードのバッファを n Byte 確保する。
+ * @attention 足りない場合は over を EN_TRUE にする。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    書き込む位置 ( NULL : 足りない )
+ *************************************************************************** */
+static inline char*
+Reserve(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    unsigned int    n       ///< [in] サイズ
+){
+    if( ser->len + n > APP_IF_SER_SIZE )
+    {
+        ser->over = EN_TRUE;
+        return NULL;
+    }
+    return &ser->buf[ser->len];
+}
+
+
+/**************************************************************************//*!
+ * @brief     4 桁以下の整数を 0 埋めの 4 桁の文字列 ( 4 Byte ) にする。
+ * @attention v は 10^4 未満であること。
+ * @note      Ascii8() の 2 段目以降と同じ ( 2 桁 x 2 -> 1 桁 x 4 )。
+ * @sa        Ascii8()
+ * @author    Ryoji Morita
+ * @return    文字列 ( リトルエンディアン )
+ *************************************************************************** */
+static inline unsigned int
+Ascii4(
+    unsigned int    v       ///< [in] 値
+){
+    unsigned int    x = 0;
+    unsigned int    y = 0;
+
+    y = ( v * 10486 ) >> 20;
+    x = y | ( ( v - y * 100 ) << 16 );
+    y = ( ( x * 103 ) >> 10 ) & 0x000F000FU;
+    x = y | ( ( x - y * 10 ) << 8 );
+    return x | 0x30303030U;
+}
+
+
+/**************************************************************************//*!
+ * @brief     8 桁以下の整数を 0 埋めの 8 桁の文字列 ( 8 Byte ) にする。
+ * @attention v は 10^8 未満であること。
+ * @note      4 桁 x 2 ( 32 bit 単位 ) -> 2 桁 x 4 ( 16 bit 単位 ) -> 1 桁 x 8 ( 8 bit 単位 ) と
+ *            1 つの 64 bit 値の中でまとめて割る ( 桁数による分岐をしない )。
+ *            / 100 は x 10486 >> 20, / 10 は x 103 >> 10 ( 範囲内で正確 ) で計算する。
+ *            リトルエンディアンで格納すると上位の桁から並ぶ。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    文字列 ( リトルエンディアン )
+ *************************************************************************** */
+static inline unsigned long long
+Ascii8(
+    unsigned int    v       ///< [in] 値
+){
+    unsigned long long  x = ( v / 10000 ) | ( (unsigned long long)( v % 10000 ) << 32 );
+    unsigned long long  y = 0;
+
+    y = ( ( x * 10486 ) >> 20 ) & 0x0000007F0000007FULL;
+    x = y | ( ( x - y * 100 ) << 16 );
+    y = ( ( x * 103 ) >> 10 ) & 0x000F000F000F000FULL;
+    x = y | ( ( x - y * 10 ) << 8 );
+    return x | 0x3030303030303030ULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     符号なし整数の 10 進数の桁数を求める。
+ * @attention なし。
+ * @note      ビット数 x log10(2) ( x 1233 >> 12 ) で見積もり、10 のべき乗と 1 回比べて補正する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    桁数 ( 1 - 20 )
+ *************************************************************************** */
+static inline unsigned int
+Count(
+    unsigned long long  value   ///< [in] 値
+){
+    unsigned int        t = ( (unsigned int)( 64 - __builtin_clzll( value | 1 ) ) * 1233 ) >> 12;
+
+    return t + 1 - ( ( value | 1 ) < g_pow10[t] );
+}
+
+
+/**************************************************************************//*!
+ * @brief     符号なし整数を 10 進数で書き込む。
+ * @attention 終端文字は付けない。out は SER_UINT_LEN ( 20 ) Byte 以上必要
+ *            ( 8 Byte 単位で書き込むので、桁数より後ろも書き換える )。
+ * @note      先に Count() で桁数を求めて、8 桁ずつ Ascii8() で変換して
+ *            out に直接書き込む。最上位の 8 桁は先頭の 0 をずらして詰める。
+ *            4 桁以下 ( センサ値の多く ) は Ascii4() だけで変換する。
+ *            17 桁以上は上位 ( 4 桁以下 ) を Ascii4() で変換する。
+ *            リトルエンディアンであること ( x86, ARM )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    文字数
+ *************************************************************************** */
+static inline unsigned int
+Digits(
+    char*               out,    ///< [out] 書き込む先
+    unsigned long long  value   ///< [in]  値
+){
+    unsigned int        n = 0;
+    unsigned long long  hi = 0;
+    unsigned long long  x = 0;
+    unsigned int        y = 0;
+
+    if( value < SER_CHUNK )
+    {
+        n = Count( value );
+        if( n <= 4 )
+        {
+            y = Ascii4( (unsigned int)value ) >> ( ( 4 - n ) * 8 );
+            memcpy( out, &y, 4 );
+            return n;
+        }
+        x = Ascii8( (unsigned int)value ) >> ( ( SER_CHUNK_LEN - n ) * 8 );
+        memcpy( out, &x, SER_CHUNK_LEN );
+        return n;
+    }
+
+    if( value < SER_CHUNK * SER_CHUNK )
+    {
+        hi = value / SER_CHUNK;
+        n  = Count( hi );
+        x  = Ascii8( (unsigned int)hi ) >> ( ( SER_CHUNK_LEN - n ) * 8 );
+        memcpy( out, &x, SER_CHUNK_LEN );
+        x = Ascii8( (unsigned int)( value - hi * SER_CHUNK ) );
+        memcpy( out + n, &x, SER_CHUNK_LEN );
+        return n + SER_CHUNK_LEN;
+    }
+
+    hi    = value / ( SER_CHUNK * SER_CHUNK );
+    value = value - hi * ( SER_CHUNK * SER_CHUNK );
+    n = Count( hi );
+    y = Ascii4( (unsigned int)hi ) >> ( ( 4 - n ) * 8 );
+    memcpy( out, &y, 4 );
+    x = Ascii8( (unsigned int)( value / SER_CHUNK ) );
+    memcpy( out + n, &x, SER_CHUNK_LEN );
+    x = Ascii8( (unsigned int)( value % SER_CHUNK ) );
+    memcpy( out + n + SER_CHUNK_LEN, &x, SER_CHUNK_LEN );
+    return n + SER_CHUNK_LEN * 2;
+}
+
+
+/**************************************************************************//*!
+ * @brief     小数を小数点以下の桁数を固定した文字列にする。
+ * @attention 終端文字は付けない。value は有限であること。
+ *            out は SER_FIX_LEN ( 31 ) Byte 以上必要。
+ * @note      value x 10^prec を四捨五入した整数を 1 回で変換して、下から prec 桁目の前に
+ *            "." を入れる ( 整数部と小数部に分ける除算をしない )。
+ *            8 桁以下 ( センサ値のほとんど ) は 1 回の Ascii4() / Ascii8() と 8 Byte の書き込み 2 回で、
+ *            小数点の位置による分岐をせずに変換する。
+ *            整数に収まらない大きさの場合は snprintf() で変換する。
+ *            丸めた結果が 0 の場合は "-" を付けない。
+ * @sa        AppIfSer_FmtFix()
+ * @author    Ryoji Morita
+ * @return    文字数
+ *************************************************************************** */
+static inline unsigned int
+Fixed(
+    char*           out,    ///< [out] 書き込む先
+    double          value,  ///< [in]  値
+    unsigned int    prec    ///< [in]  小数点以下の桁数 ( 0 - SER_PREC_MAX )
+){
+    char*               p = out;
+    double              a = 0.0;
+    unsigned long long  u = 0;
+    unsigned long long  x = 0;
+    unsigned int        v = 0;
+    unsigned int        n = 0;
+    unsigned int        i = 0;
+
+    a = fabs( value ) * g_scale[prec] + 0.5;
+
+    // 符号は分岐せずに書き込む ( 正負が交互に来ても分岐予測を外さない )
+    *p = '-';
+
+    if( a < (double)SER_CHUNK && prec > 0 && prec < SER_CHUNK_LEN )
+    {
+        // 8 桁以下 : 整数部が 1 桁以上になるように 0 埋めした桁を 8 Byte で書き込み、
+        //            整数部の後ろに "." + 小数部を 8 Byte で上書きする
+        v = (unsigned int)a;
+        p += ( value < 0.0 && v != 0 );
+        n = Count( v );
+        if( n < prec + 1 ){ n = prec + 1; }
+        x = ( n <= 4 ) ? (unsigned long long)Ascii4( v ) << 32 : Ascii8( v );
+        x >>= ( SER_CHUNK_LEN - n ) * 8;
+        memcpy( p, &x, SER_CHUNK_LEN );
+        x = '.' | ( ( x >> ( ( n - prec ) * 8 ) ) << 8 );
+        memcpy( p + n - prec, &x, SER_CHUNK_LEN );
+        return (unsigned int)( p + n + 1 - out );
+    }
+
+    if( a >= SER_FIX_MAX )
+    {
+        return (unsigned int)snprintf( out, SER_FIX_LEN, "%.*e", (int)prec, value );
+    }
+
+    u = (unsigned long long)a;
+    p += ( value < 0.0 && u != 0 );
+
+    if( prec == 0 )
+    {
+        return (unsigned int)( p - out ) + Digits( p, u );
+    }
+
+    if( u >= g_pow10[prec] )
+    {
+        // 整数部 . 小数部 ( 1 つ後ろに変換して、整数部を 1 つ前にずらして "." を入れる )
+        n = Digits( p + 1, u ) - prec;
+        for( i = 0; i < n; i++ )
+        {
+            p[i] = p[i + 1];
+        }
+        p[n] = '.';
+        p += n + 1 + prec;
+    } else
+    {
+        // 0 . ( 0 埋め ) 小数部
+        *p++ = '0';
+        *p++ = '.';
+        n = prec;
+        while( u < g_pow10[n - 1] && n > 1 )
+        {
+            *p++ = '0';
+            n--;
+        }
+        p += Digits( p, u );
+    }
+
+    return (unsigned int)( p - out );
+}
+
+
+/**************************************************************************//*!
+ * @brief     CBOR の先頭バイトと引数を書き込む。
+ * @attention out は SER_CBOR_HEAD_LEN Byte 以上必要。
+ * @note      引数は値に応じて最短の長さ ( 0, 1, 2, 4, 8 Byte ) のビッグエンディアンにする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    書き込んだサイズ
+ *************************************************************************** */
+static unsigned int
+CborHead(
+    char*               out,    ///< [out] 書き込む先
+    unsigned int        major,  ///< [in]  メジャータイプ ( SER_CBOR_UINT など )
+    unsigned long long  value   ///< [in]  引数
+){
+    unsigned int    n = 0;
+    unsigned int    i = 0;
+
+    if( value < 24 )
+    {
+        out[0] = (char)( major | (unsigned int)value );
+        return 1;
+    }
+
+    if( value <= 0xFFULL )           { out[0] = (char)( major | 24 ); n = 1; }
+    else if( value <= 0xFFFFULL )    { out[0] = (char)( major | 25 ); n = 2; }
+    else if( value <= 0xFFFFFFFFULL ){ out[0] = (char)( major | 26 ); n = 4; }
+    else                             { out[0] = (char)( major | 27 ); n = 8; }
+
+    for( i = n; i > 0; i-- )
+    {
+        out[i] = (char)( value & 0xFF );
+        value >>= 8;
+    }
+    return n + 1;
+}
+
+
+/**************************************************************************//*!
+ * @brief     CBOR の map のキーを書き込む。
+ * @attention なし。
+ * @note      配列の要素の場合は何も書き込まない ( 区切りも不要 )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+CborKey(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key     ///< [in] キー
+){
+    char*           p = NULL;
+    unsigned int    klen = 0;
+
+    ser->cnt[ser->depth]++;
+    if( ( ser->arr & ( 1U << ser->depth ) ) || key == NULL )
+    {
+        return;
+    }
+
+    klen = (unsigned int)strlen( key );
+    p = Reserve( ser, SER_CBOR_HEAD_LEN + klen );
+    if( p == NULL )
+    {
+        return;
+    }
+
+    p += CborHead( p, SER_CBOR_TEXT, klen );
+    memcpy( p, key, klen );
+    ser->len = (unsigned int)( p + klen - ser->buf );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     列名 ( 接頭辞 + キー ) を書き込む。
+ * @attention なし。
+ * @note      キーが NULL ( 配列の要素 ) の場合は添字にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+HdrKey(
+    SAppIfSer_t*    ser,    ///< [in]     シリアライザ
+    const char*     key,    ///< [in]     キー
+    char*           out,    ///< [out]    書き込む先
+    unsigned int*   len,    ///< [in,out] 書き込んだサイズ
+    unsigned int    max     ///< [in]     書き込む先のサイズ
+){
+    unsigned int    plen = ser->plen[ser->depth];
+    unsigned int    klen = 0;
+    char            idx[SER_UINT_LEN];
+
+    if( key == NULL )
+    {
+        klen = AppIfSer_FmtUint( idx, ser->cnt[ser->depth] );
+        key  = idx;
+    } else
+    {
+        klen = (unsigned int)strlen( key );
+    }
+
+    if( *len + plen + 1 + klen > max )
+    {
+        ser->over = EN_TRUE;
+        return;
+    }
+
+    memcpy( &out[*len], ser->prefix, plen );
+    *len += plen;
+    if( plen > 0 ){ out[(*len)++] = '.'; }
+    memcpy( &out[*len], key, klen );
+    *len += klen;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     CSV の区切りと列名を書き込み、値のバッファを n Byte 確保する。
+ * @attention 足りない場合は over を EN_TRUE にする。
+ * @note      2 つ目以降の列の前に ","、列名は hdr に書き込む。
+ * @sa        Key()
+ * @author    Ryoji Morita
+ * @return    値を書き込む位置 ( NULL : 足りない )
+ *************************************************************************** */
+static char*
+CsvKey(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    unsigned int    n       ///< [in] 値のサイズ
+){
+    char*           p = NULL;
+
+    if( ser->hlen > 0 )
+    {
+        if( ( p = Reserve( ser, 1 ) ) != NULL ){ *p = ','; ser->len++; }
+        if( ser->hlen < APP_IF_SER_SIZE ){ ser->hdr[ser->hlen++] = ','; }
+    }
+    HdrKey( ser, key, ser->hdr, &ser->hlen, APP_IF_SER_SIZE );
+    ser->cnt[ser->depth]++;
+    return Reserve( ser, n );
+}
+
+
+/**************************************************************************//*!
+ * @brief     値の前に区切りとキーを書き込み、値のバッファを n Byte 確保する。
+ * @attention 足りない場合は over を EN_TRUE にする。
+ * @note      JSON : 2 つ目以降の要素の前に ","、オブジェクトの要素には "key":
+ *            CSV  : 2 つ目以降の列の前に ","、列名は hdr に書き込む。
+ *            CBOR : CborKey()
+ *            JSON ではキーと値の範囲を 1 回で確認して len を更新しない
+ *            ( 値を書き込んだ呼び出し元が len を 1 回だけ更新する )。
+ * @sa        Reserve()
+ * @author    Ryoji Morita
+ * @return    値を書き込む位置 ( NULL : 足りない )
+ *************************************************************************** */
+static inline char*
+Key(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    unsigned int    n       ///< [in] 値のサイズ
+){
+    char*           p = NULL;
+    char*           end = NULL;
+
+    if( ser->fmt == EN_SER_CBOR )
+    {
+        CborKey( ser, key );
+        return Reserve( ser, n );
+    }
+
+    if( ser->fmt == EN_SER_CSV )
+    {
+        return CsvKey( ser, key, n );
+    }
+
+    if( ser->arr & ( 1U << ser->depth ) ){ key = NULL; }
+
+    // "," + '"' + '"' + ":" の 4 Byte と値の n Byte を先に確認する
+    if( ser->len + n + 4 > APP_IF_SER_SIZE )
+    {
+        ser->over = EN_TRUE;
+        return NULL;
+    }
+
+    // キーは短いので strlen() + memcpy() せずに 1 文字ずつ書き込む
+    p   = &ser->buf[ser->len];
+    end = &ser->buf[APP_IF_SER_SIZE - n - 2];
+    if( ser->cnt[ser->depth] > 0 ){ *p++ = ','; }
+    if( key != NULL )
+    {
+        *p++ = '"';
+        while( *key != '\0' )
+        {
+            if( p >= end )
+            {
+                ser->over = EN_TRUE;
+                return NULL;
+            }
+            *p++ = *key++;
+        }
+        *p++ = '"';
+        *p++ = ':';
+    }
+    ser->cnt[ser->depth]++;
+    return p;
+}
+
+
+/**************************************************************************//*!
+ * @brief     列名の接頭辞に key ( 配列の要素は添字 ) を追加する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        Push()
+ * @author    Ryoji Morita
+ * @return    追加した後の接頭辞の長さ
+ *************************************************************************** */
+static unsigned int
+CsvPrefix(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key     ///< [in] キー
+){
+    unsigned int    plen = 0;
+    char            name[APP_IF_SER_KEY_LEN];
+
+    HdrKey( ser, key, name, &plen, APP_IF_SER_KEY_LEN );
+    memcpy( ser->prefix, name, plen );
+    ser->cnt[ser->depth]++;
+    return plen;
+}
+
+
+/**************************************************************************//*!
+ * @brief     オブジェクト / 配列を開始する。
+ * @attention 入れ子が APP_IF_SER_DEPTH を超える場合は over を EN_TRUE にする。
+ * @note      CSV では列名の接頭辞に key ( 配列の要素は添字 ) を追加する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static inline void
+Push(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    char            open,   ///< [in] 開始文字 ( JSON )
+    EHalBool_t      arr     ///< [in] EN_TRUE : 配列
+){
+    char*           p = NULL;
+    unsigned int    plen = 0;
+
+    if( ser->depth + 1 >= APP_IF_SER_DEPTH )
+    {
+        ser->over = EN_TRUE;
+        return;
+    }
+
+    if( ser->fmt == EN_SER_CSV )
+    {
+        plen = CsvPrefix( ser, key );
+    } else
+    {
+        if( ser->fmt == EN_SER_CBOR ){ open = (char)( ( arr == EN_TRUE ) ? SER_CBOR_ARR : SER_CBOR_MAP ); }
+        if( ( p = Key( ser, key, 1 ) ) != NULL )
+        {
+            *p++ = open;
+            ser->len = (unsigned int)( p - ser->buf );
+        }
+    }
+
+    ser->depth++;
+    ser->cnt[ser->depth]  = 0;
+    ser->plen[ser->depth] = plen;
+    if( arr == EN_TRUE ){ ser->arr |=  ( 1U << ser->depth ); }
+    else                { ser->arr &= ~( 1U << ser->depth ); }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     オブジェクト / 配列を終了する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Pop(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    char            close   ///< [in] 終了文字 ( JSON )
+){
+    char*           p = NULL;
+
+    if( ser->depth == 0 )
+    {
+        ser->over = EN_TRUE;
+        return;
+    }
+
+    if( ser->fmt == EN_SER_CBOR ){ close = (char)SER_CBOR_BREAK; }
+    if( ser->fmt != EN_SER_CSV && ( p = Reserve( ser, 1 ) ) != NULL ){ *p = close; ser->len++; }
+    ser->depth--;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     iovec を全て書き込む。
+ * @attention なし。
+ * @note      シグナルによる中断と、途中までの書き込みは続きから書き直す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+WriteAll(
+    int             fd,     ///< [in] 出力先
+    struct iovec*   iov,    ///< [in] 書き込むデータ
+    int             num     ///< [in] iov の数
+){
+    ssize_t         ret = 0;
+
+    while( num > 0 )
+    {
+        ret = writev( fd, iov, num );
+        if( ret < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            DBG_PRINT_ERROR( "writev() error. : %s \n\r", strerror( errno ) );
+            return EN_FALSE;
+        }
+
+        while( num > 0 && (size_t)ret >= iov->iov_len )
+        {
+            ret -= (ssize_t)iov->iov_len;
+            iov++;
+            num--;
+        }
+        if( num > 0 )
+        {
+            iov->iov_base = (char*)iov->iov_base + ret;
+            iov->iov_len -= (size_t)ret;
+        }
+    }
+
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     シリアライザを初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_Init(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    EAppIfSerFmt_t  fmt     ///< [in] 出力形式
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    ser->fmt      = fmt;
+    ser->over     = EN_FALSE;
+    ser->len      = 0;
+    ser->hlen     = 0;
+    ser->hlenPrev = 0;
+    ser->depth    = 0;
+    ser->arr      = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードを開始する。
+ * @attention なし。
+ * @note      JSON, CBOR ではレコード全体を 1 つのオブジェクト ( map ) にする。
+ * @sa        AppIfSer_End()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_Begin(
+    SAppIfSer_t*    ser     ///< [in] シリアライザ
+){
+    ser->over    = EN_FALSE;
+    ser->len     = 0;
+    ser->hlen    = 0;
+    ser->depth   = 0;
+    ser->arr     = 0;
+    ser->cnt[0]  = 0;
+    ser->plen[0] = 0;
+
+    if( ser->fmt == EN_SER_JSON )
+    {
+        ser->buf[ser->len++] = '{';
+    } else if( ser->fmt == EN_SER_CBOR )
+    {
+        ser->buf[ser->len++] = (char)SER_CBOR_MAP;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードを終了する。
+ * @attention 入れ子を閉じ忘れた場合とバッファがあふれた場合は 0 を返す。
+ * @note      JSON, CSV はレコードの末尾に改行を付ける。CBOR は改行を付けない。
+ * @sa        AppIfSer_Write()
+ * @author    Ryoji Morita
+ * @return    レコードのサイズ ( Byte )
+ *************************************************************************** */
+unsigned int
+AppIfSer_End(
+    SAppIfSer_t*    ser     ///< [in] シリアライザ
+){
+    char*           p = NULL;
+
+    if( ser->depth != 0 )
+    {
+        ser->over = EN_TRUE;
+    }
+
+    p = Reserve( ser, 2 );
+    if( p != NULL )
+    {
+        if( ser->fmt == EN_SER_CBOR )
+        {
+            *p++ = (char)SER_CBOR_BREAK;
+        } else
+        {
+            if( ser->fmt == EN_SER_JSON ){ *p++ = '}'; }
+            *p++ = '\n';
+        }
+        ser->len = (unsigned int)( p - ser->buf );
+    }
+
+    if( ser->fmt == EN_SER_CSV )
+    {
+        if( ser->hlen < APP_IF_SER_SIZE ){ ser->hdr[ser->hlen++] = '\n'; }
+        else                             { ser->over = EN_TRUE; }
+    }
+
+    if( ser->over == EN_TRUE )
+    {
+        DBG_PRINT_ERROR( "record overflow. \n\r" );
+        return 0;
+    }
+    return ser->len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     出力するデータ ( 列名の行とレコード ) を iovec に設定する。
+ * @attention iov は 2 個以上確保すること。
+ * @note      CSV では列名が前回と変わった場合だけ、列名の行を先頭に設定する。
+ *            出力先に書き込まずに送信バッファへコピーする場合 ( app/if_srv ) に使う。
+ * @sa        AppIfSer_Write()
+ * @author    Ryoji Morita
+ * @return    iov の数 ( 0 : 出力するデータがない )
+ *************************************************************************** */
+int
+AppIfSer_Iov(
+    SAppIfSer_t*    ser,    ///< [in]  シリアライザ
+    struct iovec*   iov     ///< [out] 出力するデータ
+){
+    int             num = 0;
+
+    if( ser->over == EN_TRUE || ser->len == 0 )
+    {
+        return 0;
+    }
+
+    if( ser->fmt == EN_SER_CSV
+     && ( ser->hlen != ser->hlenPrev || 0 != memcmp( ser->hdr, ser->hdrPrev, ser->hlen ) ) )
+    {
+        memcpy( ser->hdrPrev, ser->hdr, ser->hlen );
+        ser->hlenPrev = ser->hlen;
+
+        iov[num].iov_base = ser->hdr;
+        iov[num].iov_len  = ser->hlen;
+        num++;
+    }
+
+    iov[num].iov_base = ser->buf;
+    iov[num].iov_len  = ser->len;
+    num++;
+    return num;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードを 1 回の write() で出力する。
+ * @attention 標準出力に printf() で書いた内容との順序を守るため、先に fflush() する。
+ * @note      CSV では列名が前回と変わった場合だけ、列名の行も同じ writev() で出力する。
+ * @sa        AppIfSer_Iov()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfSer_Write(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    int             fd      ///< [in] 出力先
+){
+    struct iovec    iov[2];
+    int             num = 0;
+
+    num = AppIfSer_Iov( ser, iov );
+    if( num == 0 )
+    {
+        return EN_FALSE;
+    }
+
+    if( fd == STDOUT_FILENO ){ fflush( stdout ); }
+    return WriteAll( fd, iov, num );
+}
+
+
+/**************************************************************************//*!
+ * @brief     オブジェクトを開始する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        AppIfSer_ObjEnd()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_ObjBegin(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key     ///< [in] キー ( 配列の要素の場合は NULL )
+){
+    Push( ser, key, '{', EN_FALSE );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     オブジェクトを終了する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_ObjEnd(
+    SAppIfSer_t*    ser     ///< [in] シリアライザ
+){
+    Pop( ser, '}' );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     配列を開始する。
+ * @attention なし。
+ * @note      配列の要素はキーを NULL にして書き込む。
+ * @sa        AppIfSer_ArrEnd()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_ArrBegin(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key     ///< [in] キー ( 配列の要素の場合は NULL )
+){
+    Push( ser, key, '[', EN_TRUE );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     配列を終了する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_ArrEnd(
+    SAppIfSer_t*    ser     ///< [in] シリアライザ
+){
+    Pop( ser, ']' );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     符号付き整数を書き込む。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_Int(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    long long       value   ///< [in] 値
+){
+    char*           p = NULL;
+
+    p = Key( ser, key, 1 + SER_UINT_LEN );
+    if( p == NULL )
+    {
+        return;
+    }
+
+    if( ser->fmt == EN_SER_CBOR )
+    {
+        if( value < 0 ){ p += CborHead( p, SER_CBOR_NINT, (unsigned long long)( -1 - value ) ); }
+        else           { p += CborHead( p, SER_CBOR_UINT, (unsigned long long)value ); }
+        ser->len = (unsigned int)( p - ser->buf );
+        return;
+    }
+
+    if( value < 0 )
+    {
+        *p++ = '-';
+        p += Digits( p, 0ULL - (unsigned long long)value );
+    } else
+    {
+        p += Digits( p, (unsigned long long)value );
+    }
+    ser->len = (unsigned int)( p - ser->buf );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     符号なし整数を書き込む。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_Uint(
+    SAppIfSer_t*        ser,    ///< [in] シリアライザ
+    const char*         key,    ///< [in] キー
+    unsigned long long  value   ///< [in] 値
+){
+    char*               p = NULL;
+
+    p = Key( ser, key, SER_UINT_LEN );
+    if( p == NULL )
+    {
+        return;
+    }
+
+    if( ser->fmt == EN_SER_CBOR ){ p += CborHead( p, SER_CBOR_UINT, value ); }
+    else                         { p += Digits( p, value ); }
+    ser->len = (unsigned int)( p - ser->buf );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     符号なし整数の配列を書き込む。
+ * @attention なし。
+ * @note      ArrBegin() + 要素毎の Uint() + ArrEnd() と同じ出力になる。
+ *            JSON では入れ子を作らずに "[" から "]" までを 1 回の呼び出しで書き込む
+ *            ( [ 開始, 終了 ] の時刻など、短い配列の呼び出し回数を減らす )。
+ *            残りのバッファは要素毎に Uint() と同じ大きさで確認する。
+ *            CSV ( 列名 ), CBOR は要素毎に書き込む。
+ * @sa        AppIfSer_Uint()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_UintArr(
+    SAppIfSer_t*                ser,    ///< [in] シリアライザ
+    const char*                 key,    ///< [in] キー
+    const unsigned long long*   value,  ///< [in] 値
+    unsigned int                num     ///< [in] 値の数
+){
+    char*           p = NULL;
+    unsigned int    i = 0;
+
+    if( ser->fmt != EN_SER_JSON || ser->depth + 1 >= APP_IF_SER_DEPTH )
+    {
+        AppIfSer_ArrBegin( ser, key );
+        for( i = 0; i < num; i++ )
+        {
+            AppIfSer_Uint( ser, NULL, value[i] );
+        }
+        AppIfSer_ArrEnd( ser );
+        return;
+    }
+
+    p = Key( ser, key, 1 );
+    if( p == NULL )
+    {
+        return;
+    }
+
+    *p++ = '[';
+    for( i = 0; i < num; i++ )
+    {
+        // "," + 値 ( Key() と同じく 4 Byte の余裕を見る )
+        if( (unsigned int)( p - ser->buf ) + SER_UINT_LEN + 4 > APP_IF_SER_SIZE )
+        {
+            ser->over = EN_TRUE;
+            return;
+        }
+        *p = ',';
+        p += ( i > 0 );
+        p += Digits( p, value[i] );
+    }
+
+    if( (unsigned int)( p - ser->buf ) + 1 > APP_IF_SER_SIZE )
+    {
+        ser->over = EN_TRUE;
+        return;
+    }
+    *p++ = ']';
+    ser->len = (unsigned int)( p - ser->buf );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     小数点以下の桁数を固定した小数を書き込む。
+ * @attention なし。
+ * @note      NaN と無限大は JSON では null、CSV では空欄にする。
+ *            CBOR では float32 で小数点以下 prec 桁の精度を保てる場合は float32、
+ *            それ以外は float64 で書き込む ( NaN, 無限大もそのまま書き込む )。
+ * @sa        AppIfSer_FmtFix()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_Fix(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    double          value,  ///< [in] 値
+    unsigned int    prec    ///< [in] 小数点以下の桁数 ( 0 - 9 )
+){
+    char*               p = NULL;
+    float               f = 0.0f;
+    unsigned int        bits32 = 0;
+    unsigned long long  bits = 0;
+    unsigned int        n = 0;
+    unsigned int        i = 0;
+
+    p = Key( ser, key, SER_FIX_LEN + 4 );
+    if( p == NULL )
+    {
+        return;
+    }
+
+    if( prec > SER_PREC_MAX ){ prec = SER_PREC_MAX; }
+
+    if( ser->fmt == EN_SER_CBOR )
+    {
+        // float32 の誤差が JSON で書き込む桁 ( prec ) の丸め誤差以下なら 5 Byte で書き込む
+        f = (float)value;
+        if( fabs( (double)f - value ) <= 0.5 / g_scale[prec] || isnan( value ) )
+        {
+            memcpy( &bits32, &f, sizeof(bits32) );
+            *p = (char)SER_CBOR_F32;
+            bits = bits32;
+            n = 4;
+        } else
+        {
+            memcpy( &bits, &value, sizeof(bits) );
+            *p = (char)SER_CBOR_F64;
+            n = 8;
+        }
+        for( i = n; i > 0; i-- )
+        {
+            p[i] = (char)( bits & 0xFF );
+            bits >>= 8;
+        }
+        ser->len = (unsigned int)( p + n + 1 - ser->buf );
+        return;
+    }
+
+    if( !isfinite( value ) )
+    {
+        if( ser->fmt == EN_SER_JSON ){ memcpy( p, "null", 4 ); p += 4; }
+        ser->len = (unsigned int)( p - ser->buf );
+        return;
+    }
+
+    p += Fixed( p, value, prec );
+    ser->len = (unsigned int)( p - ser->buf );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     文字列を書き込む。
+ * @attention なし。
+ * @note      JSON : " で囲み、" \ と制御文字をエスケープする。
+ *            CSV  : , " 改行を含む場合だけ " で囲み、" を "" にする。
+ *            CBOR : 長さ + そのままのバイト列 ( UTF-8 であること )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSer_Str(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    const char*     value   ///< [in] 値
+){
+    static const char   hex[] = "0123456789abcdef";
+    const unsigned char* s = (const unsigned char*)value;
+    unsigned int    vlen = 0;
+    EHalBool_t      quote = EN_TRUE;
+    char*           p = NULL;
+    char*           end = NULL;
+
+    if( ser->fmt == EN_SER_JSON )
+    {
+        // 長さを先に求めずに、残りのバッファ ( エスケープ 1 文字の 6 Byte と閉じる " ) を
+        // 確認しながら 1 回で書き込む
+        p = Key( ser, key, 2 );
+        if( p == NULL )
+        {
+            return;
+        }
+
+        end = &ser->buf[APP_IF_SER_SIZE - 7];
+        *p++ = '"';
+        for( ; *s != '\0'; s++ )
+        {
+            if( p >= end )
+            {
+                ser->over = EN_TRUE;
+                return;
+            }
+
+            if( g_esc[*s] == 0 )
+            {
+                *p++ = (char)*s;
+            } else if( *s >= 0x20 )
+            {
+                *p++ = '\\';
+                *p++ = (char)*s;
+            } else
+            {
+                memcpy( p, "\\u00", 4 );
+                p += 4;
+                *p++ = hex[*s >> 4];
+                *p++ = hex[*s & 0xF];
+            }
+        }
+        *p++ = '"';
+        ser->len = (unsigned int)( p - ser->buf );
+        return;
+    }
+
+    // 最悪の場合 ( CSV で全ての文字が " ) のサイズを確保する
+    vlen = (unsigned int)strlen( value );
+    p = Key( ser, key, vlen * 2 + SER_CBOR_HEAD_LEN );
+    if( p == NULL )
+    {
+        return;
+    }
+
+    if( ser->fmt == EN_SER_CBOR )
+    {
+        p += CborHead( p, SER_CBOR_TEXT, vlen );
+        memcpy( p, value, vlen );
+        ser->len = (unsigned int)( p + vlen - ser->buf );
+        return;
+    }
+
+    quote = ( strpbrk( value, ",\"\r\n" ) != NULL ) ? EN_TRUE : EN_FALSE;
+    if( quote == EN_TRUE ){ *p++ = '"'; }
+    for( ; *s != '\0'; s++ )
+    {
+        if( *s == '"' ){ *p++ = '"'; }
+        *p++ = (char)*s;
+    }
+    if( quote == EN_TRUE ){ *p++ = '"'; }
+    ser->len = (unsigned int)( p - ser->buf );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     符号なし整数を 10 進数の文字列にする。
+ * @attention 終端文字は付けない。out は SER_UINT_LEN ( 20 ) Byte 以上必要。
+ * @note      なし。
+ * @sa        Digits()
+ * @author    Ryoji Morita
+ * @return    文字数
+ *************************************************************************** */
+unsigned int
+AppIfSer_FmtUint(
+    char*               out,    ///< [out] 書き込む先
+    unsigned long long  value   ///< [in]  値
+){
+    return Digits( out, value );
+}
+
+
+/**************************************************************************//*!
+ * @brief     小数を小数点以下の桁数を固定した文字列にする。
+ * @attention 終端文字は付けない。value は有限であること。
+ *            out は SER_FIX_LEN ( 31 ) Byte 以上必要。
+ * @note      value x 10^prec を四捨五入した整数を 1 回で変換して、下から prec 桁目の前に
+ *            "." を入れる ( 整数部と小数部に分ける除算をしない )。
+ *            8 桁以下 ( センサ値のほとんど ) は 1 回の Ascii4() / Ascii8() と 8 Byte の書き込み 2 回で、
+ *            小数点の位置による分岐をせずに変換する。
+ *            整数に収まらない大きさの場合は snprintf() で変換する。
+ *            丸めた結果が 0 の場合は "-" を付けない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    文字数
+ *************************************************************************** */
+unsigned int
+AppIfSer_FmtFix(
+    char*           out,    ///< [out] 書き込む先
+    double          value,  ///< [in]  値
+    unsigned int    prec    ///< [in]  小数点以下の桁数 ( 0 - 9 )
+){
+    if( prec > SER_PREC_MAX ){ prec = SER_PREC_MAX; }
+    return Fixed( out, value, prec );
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
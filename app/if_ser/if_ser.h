@@ -0,0 +1,113 @@
+/**************************************************************************//*!
+ *  @file           if_ser.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           1 レコードを呼び出し元が確保したバッファに JSON, CSV または CBOR で書き込み、
+ *                  AppIfSer_Write() で 1 回の write() で出力する。
+ *                  使い方
+ *                      AppIfSer_Begin( ser );
+ *                      AppIfSer_Str( ser, "sensor", "sa_pm" );
+ *                      AppIfSer_ObjBegin( ser, "value" );
+ *                      AppIfSer_Int( ser, "fl", 12 );
+ *                      AppIfSer_ObjEnd( ser );
+ *                      AppIfSer_End( ser );
+ *                      AppIfSer_Write( ser, STDOUT_FILENO );
+ *                  JSON : {"sensor":"sa_pm","value":{"fl":12}}
+ *                  CSV  : 1 行目にキーを "." でつないだ列名 ( 列が変わった時だけ出力 )
+ *                         sensor,value.fl
+ *                         sa_pm,12
+ *                  配列の要素 ( key = NULL ) の列名は 添字 になる。
+ *                  CBOR : JSON と同じ構造を長さ不定の map / array で書き込む ( RFC 8949 )。
+ *                         レコードは改行で区切らず、CBOR Sequence ( RFC 8742 ) として連続して出力する。
+ *                         小数は float32 で小数点以下 prec 桁の精度を保てる場合は float32、
+ *                         それ以外は float64 にする。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_SER_H_
+#define _APP_IF_SER_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <sys/uio.h>
+
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_SER_SIZE         (2048)      ///< @def : 1 レコードの最大サイズ ( Byte )
+#define APP_IF_SER_DEPTH        (8)         ///< @def : オブジェクト / 配列の入れ子の最大数
+#define APP_IF_SER_KEY_LEN      (64)        ///< @def : CSV の列名の最大長 ( Byte )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// 出力形式に使用する型
+typedef enum tagEAppIfSerFmt
+{
+    EN_SER_JSON = 0,        ///< @var : JSON ( 1 レコード 1 行 )
+    EN_SER_CSV,             ///< @var : CSV
+    EN_SER_CBOR             ///< @var : CBOR ( バイナリ )
+} EAppIfSerFmt_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// シリアライザの型 ( 呼び出し元が確保する )
+typedef struct tagSAppIfSer
+{
+    EAppIfSerFmt_t      fmt;                            ///< @var : 出力形式
+    EHalBool_t          over;                           ///< @var : EN_TRUE : バッファがあふれた
+    unsigned int        len;                            ///< @var : buf に書き込んだサイズ
+    unsigned int        hlen;                           ///< @var : hdr に書き込んだサイズ ( CSV )
+    unsigned int        hlenPrev;                       ///< @var : 前回出力した列名のサイズ ( CSV )
+    unsigned int        depth;                          ///< @var : 入れ子の深さ
+    unsigned int        arr;                            ///< @var : bit n = 1 : 深さ n は配列
+    unsigned int        cnt[APP_IF_SER_DEPTH];          ///< @var : 深さ毎の要素数
+    unsigned int        plen[APP_IF_SER_DEPTH];         ///< @var : 深さ毎の列名の接頭辞の長さ ( CSV )
+    char                prefix[APP_IF_SER_KEY_LEN];     ///< @var : 列名の接頭辞 ( CSV )
+    char                buf[APP_IF_SER_SIZE];           ///< @var : レコード
+    char                hdr[APP_IF_SER_SIZE];           ///< @var : 列名 ( CSV )
+    char                hdrPrev[APP_IF_SER_SIZE];       ///< @var : 前回出力した列名 ( CSV )
+} SAppIfSer_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+void            AppIfSer_Init( SAppIfSer_t* ser, EAppIfSerFmt_t fmt );
+void            AppIfSer_Begin( SAppIfSer_t* ser );
+unsigned int    AppIfSer_End( SAppIfSer_t* ser );
+int             AppIfSer_Iov( SAppIfSer_t* ser, struct iovec* iov );
+EHalBool_t      AppIfSer_Write( SAppIfSer_t* ser, int fd );
+
+void            AppIfSer_ObjBegin( SAppIfSer_t* ser, const char* key );
+void            AppIfSer_ObjEnd( SAppIfSer_t* ser );
+void            AppIfSer_ArrBegin( SAppIfSer_t* ser, const char* key );
+void            AppIfSer_ArrEnd( SAppIfSer_t* ser );
+
+void            AppIfSer_Int( SAppIfSer_t* ser, const char* key, long long value );
+void            AppIfSer_Uint( SAppIfSer_t* ser, const char* key, unsigned long long value );
+void            AppIfSer_UintArr( SAppIfSer_t* ser, const char* key, const unsigned long long* value, unsigned int num );
+void            AppIfSer_Fix( SAppIfSer_t* ser, const char* key, double value, unsigned int prec );
+void            AppIfSer_Str( SAppIfSer_t* ser, const char* key, const char* value );
+
+unsigned int    AppIfSer_FmtUint( char* out, unsigned long long value );
+unsigned int    AppIfSer_FmtFix( char* out, double value, unsigned int prec );
+
+
+#endif /* _APP_IF_SER_H_ */
@@ -0,0 +1,227 @@
+/**************************************************************************//*!
+ *  @file           if_shm.c
+ *  @brief          [APP] センサの生値を共有メモリのリングバッファに書き込む。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_shm.h ( 共有メモリのレイアウト ), if_shm_reader.c ( 読み出し側 )
+ *  @note           書き込みは 1 プロセス ( 1 スレッド ) に限る。
+ *                  レコードは seq を 0 にしてから中身を書き、最後に seq を書く。
+ *                  最新レコードは lock を奇数にしてから書き、偶数に戻す。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "if_shm.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SAppIfShm_t*     g_shm = NULL;                   // 共有メモリ
+static char             g_name[64] = APP_IF_SHM_NAME;   // 共有メモリの名前
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// なし
+
+
+
+
+/**************************************************************************//*!
+ * @brief     共有メモリを作成する。
+ * @attention 既に開いている場合は閉じてから作成する。
+ * @note      同じ名前の共有メモリが残っている場合は、初期化して使う。
+ *            magic は他の項目を書き終えてから書くので、読み出し側は
+ *            初期化中の共有メモリにアタッチしない。
+ * @sa        AppIfShm_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfShm_Open(
+    const char*     name    ///< [in] 共有メモリの名前 ( NULL : APP_IF_SHM_NAME )
+){
+    int             fd = -1;
+    void*           addr = MAP_FAILED;
+    unsigned int    ch = 0;
+
+    DBG_PRINT_TRACE( "name = %s \n\r", name );
+
+    AppIfShm_Close();
+
+    if( name == NULL ){ name = APP_IF_SHM_NAME; }
+    if( name[0] != '/' || strlen( name ) >= sizeof(g_name) )
+    {
+        DBG_PRINT_ERROR( "invalid shared memory name. : %s \n\r", name );
+        goto err;
+    }
+
+    fd = shm_open( name, O_CREAT | O_RDWR, 0644 );
+    if( fd < 0 )
+    {
+        DBG_PRINT_ERROR( "shm_open() error. : %s \n\r", name );
+        goto err;
+    }
+
+    if( ftruncate( fd, sizeof(SAppIfShm_t) ) < 0 )
+    {
+        DBG_PRINT_ERROR( "ftruncate() error. \n\r" );
+        goto err;
+    }
+
+    addr = mmap( NULL, sizeof(SAppIfShm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( addr == MAP_FAILED )
+    {
+        DBG_PRINT_ERROR( "mmap() error. \n\r" );
+        goto err;
+    }
+    close( fd );
+
+    g_shm = (SAppIfShm_t*)addr;
+    __atomic_store_n( &g_shm->magic, 0, __ATOMIC_RELEASE );
+    memset( (char*)g_shm + sizeof(g_shm->magic), 0, sizeof(SAppIfShm_t) - sizeof(g_shm->magic) );
+
+    g_shm->ver    = APP_IF_SHM_VER;
+    g_shm->slots  = APP_IF_SHM_SLOTS;
+    g_shm->size   = sizeof(SAppIfShmRec_t);
+    g_shm->ch_num = EN_SEN_CH_NUM;
+    g_shm->pid    = (int)getpid();
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        g_shm->scale[ch] = HalCmnHist_Scale( (EHalSensorCh_t)ch );
+    }
+
+    __atomic_store_n( &g_shm->magic, APP_IF_SHM_MAGIC, __ATOMIC_RELEASE );
+
+    strcpy( g_name, name );
+    return EN_TRUE;
+
+err :
+    if( fd >= 0 ){ close( fd ); shm_unlink( name ); }
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     共有メモリを削除する。
+ * @attention アタッチ済みの読み出し側は、それまでの内容を読み続けられる。
+ * @note      開いていない場合は何もしない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfShm_Close(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( g_shm == NULL )
+    {
+        return;
+    }
+
+    munmap( g_shm, sizeof(SAppIfShm_t) );
+    shm_unlink( g_name );
+    g_shm = NULL;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     生値をリングバッファと最新レコードに書き込む。
+ * @attention 開いていない場合は APP_IF_SHM_NAME で作成する。
+ * @note      システムコールは発生しない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfShm_Publish(
+    unsigned int        mask,   ///< [in] ch マスク
+    const short*        raw,    ///< [in] 生値 ( EHalSensorCh_t で添字, EN_SEN_CH_NUM 個 )
+    unsigned long long  ts      ///< [in] 時刻 ( nsec )
+){
+    SAppIfShmRec_t*     rec = NULL;
+    unsigned long long  seq = 0;
+    unsigned int        lock = 0;
+    unsigned int        ch = 0;
+
+    if( g_shm == NULL && AppIfShm_Open( NULL ) == EN_FALSE )
+    {
+        return EN_FALSE;
+    }
+
+    mask &= ( 1U << EN_SEN_CH_NUM ) - 1;
+    seq = g_shm->head;
+    rec = &g_shm->rec[seq & ( APP_IF_SHM_SLOTS - 1 )];
+
+    // リングバッファ
+    __atomic_store_n( &rec->seq, 0, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    rec->ts   = ts;
+    rec->mask = mask;
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        rec->raw[ch] = ( mask & ( 1U << ch ) ) ? raw[ch] : 0;
+    }
+
+    __atomic_store_n( &rec->seq, seq + 1, __ATOMIC_RELEASE );
+
+    // 最新レコード
+    lock = g_shm->lock;
+    __atomic_store_n( &g_shm->lock, lock + 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    g_shm->latest = *rec;
+    __atomic_store_n( &g_shm->head, seq + 1, __ATOMIC_RELAXED );
+
+    __atomic_store_n( &g_shm->lock, lock + 2, __ATOMIC_RELEASE );
+
+    HalCmnMetric_Set( EN_METRIC_GAUGE_SHM_FILL, ( seq + 1 < APP_IF_SHM_SLOTS ) ? seq + 1 : APP_IF_SHM_SLOTS );
+    return EN_TRUE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,98 @@
+/**************************************************************************//*!
+ *  @file           if_shm.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           共有メモリ ( shm_open + mmap ) のレイアウト
+ *                      SAppIfShm_t ( ヘッダ + 最新レコード + APP_IF_SHM_SLOTS 個のリングバッファ )
+ *                  書き込むのは board.out ( AppIfShm_*() ) の 1 プロセスだけで、
+ *                  読み出すプロセスの数に制限はない ( AppIfShmReader_*() )。
+ *                  読み出し側は PROT_READ で mmap するだけなので、
+ *                  アタッチした後はシステムコールもパイプ経由のコピーも発生しない。
+ *                  最新レコードはヘッダの seqlock ( lock ) で保護し、
+ *                  リングバッファの各レコードは seq を seqlock として使う。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_SHM_H_
+#define _APP_IF_SHM_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_SHM_NAME         "/board_sensor"     ///< @def : 共有メモリの名前 ( 省略時 )
+#define APP_IF_SHM_MAGIC        (0x4D485342)        ///< @def : 共有メモリの識別子 ( "BSHM" )
+#define APP_IF_SHM_VER          (1)                 ///< @def : レイアウトのバージョン
+#define APP_IF_SHM_SLOTS        (4096)              ///< @def : リングバッファのレコード数 ( 2 のべき乗 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 共有メモリに書き込むレコードの型 ( バイナリフレームと同じ内容 )
+typedef struct tagSAppIfShmRec
+{
+    unsigned long long  seq;                    ///< @var : 通し番号 + 1 ( 0 = 書込中 / 未書込 )
+    unsigned long long  ts;                     ///< @var : 時刻 ( nsec, -t オプションで指定した基準 )
+    unsigned int        mask;                   ///< @var : ch マスク ( bit n = EHalSensorCh_t の n )
+    short               raw[EN_SEN_CH_NUM];     ///< @var : 生値 ( EHalSensorCh_t で添字, マスク外は 0 )
+} SAppIfShmRec_t;
+
+
+// 共有メモリ全体の型
+typedef struct tagSAppIfShm
+{
+    unsigned int        magic;                  ///< @var : APP_IF_SHM_MAGIC ( 初期化が終わってから書く )
+    unsigned int        ver;                    ///< @var : APP_IF_SHM_VER
+    unsigned int        slots;                  ///< @var : APP_IF_SHM_SLOTS
+    unsigned int        size;                   ///< @var : sizeof(SAppIfShmRec_t)
+    unsigned int        ch_num;                 ///< @var : EN_SEN_CH_NUM
+    int                 pid;                    ///< @var : 書き込むプロセスの pid
+    double              scale[EN_SEN_CH_NUM];   ///< @var : 生値から物理量への換算係数
+
+    unsigned int        lock;                   ///< @var : latest, head の seqlock ( 奇数 = 書込中 )
+    unsigned long long  head;                   ///< @var : 次に書き込む通し番号
+    SAppIfShmRec_t      latest;                 ///< @var : 最新レコード
+
+    SAppIfShmRec_t      rec[APP_IF_SHM_SLOTS];  ///< @var : リングバッファ ( 通し番号 n は rec[n % slots] )
+} SAppIfShm_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// 書き込み側 ( board.out )
+EHalBool_t          AppIfShm_Open( const char* name );
+void                AppIfShm_Close( void );
+EHalBool_t          AppIfShm_Publish( unsigned int mask, const short* raw, unsigned long long ts );
+
+// 読み出し側
+const SAppIfShm_t*  AppIfShmReader_Open( const char* name );
+void                AppIfShmReader_Close( const SAppIfShm_t* shm );
+unsigned long long  AppIfShmReader_Head( const SAppIfShm_t* shm );
+EHalBool_t          AppIfShmReader_Latest( const SAppIfShm_t* shm, SAppIfShmRec_t* out );
+EHalBool_t          AppIfShmReader_Read( const SAppIfShm_t* shm, unsigned long long seq, SAppIfShmRec_t* out );
+EHalBool_t          AppIfShmReader_Next( const SAppIfShm_t* shm, unsigned long long* cursor, SAppIfShmRec_t* out );
+
+
+#endif /* _APP_IF_SHM_H_ */
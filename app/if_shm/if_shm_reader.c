@@ -0,0 +1,289 @@
+/**************************************************************************//*!
+ *  @file           if_shm_reader.c
+ *  @brief          [APP] 共有メモリのリングバッファからセンサの生値を読み出す。
+ *  @author         Ryoji Morita
+ *  @attention      HAL の関数は使わないので、このファイルだけをリンクすれば
+ *                  board.out 以外のプロセスからも使える ( libif_shm_reader.a )。
+ *  @sa             if_shm.h ( 共有メモリのレイアウト ), if_shm.c ( 書き込み側 )
+ *  @note           読み出しはロックを取らない。書き込み中のレコードを読んだ場合は
+ *                  読む前後の seq ( lock ) が一致しないので、捨てて読み直す。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "if_shm.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SHM_RETRY_MAX       (1000)      // 最新レコードを読み直す回数の上限
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// なし
+
+
+
+
+/**************************************************************************//*!
+ * @brief     共有メモリにアタッチする。
+ * @attention 読み出し専用で mmap する。
+ * @note      レイアウト ( バージョン, レコード数, サイズ, ch 数 ) が
+ *            一致しない場合は失敗する。
+ * @sa        AppIfShmReader_Close()
+ * @author    Ryoji Morita
+ * @return    共有メモリのアドレス ( NULL : 失敗 )
+ *************************************************************************** */
+const SAppIfShm_t*
+AppIfShmReader_Open(
+    const char*     name    ///< [in] 共有メモリの名前 ( NULL : APP_IF_SHM_NAME )
+){
+    int                 fd = -1;
+    struct stat         st;
+    void*               addr = MAP_FAILED;
+    const SAppIfShm_t*  shm = NULL;
+
+    DBG_PRINT_TRACE( "name = %s \n\r", name );
+
+    if( name == NULL ){ name = APP_IF_SHM_NAME; }
+
+    fd = shm_open( name, O_RDONLY, 0 );
+    if( fd < 0 )
+    {
+        DBG_PRINT_ERROR( "shm_open() error. : %s \n\r", name );
+        goto err;
+    }
+
+    if( fstat( fd, &st ) < 0 || (size_t)st.st_size < sizeof(SAppIfShm_t) )
+    {
+        DBG_PRINT_ERROR( "invalid shared memory size. \n\r" );
+        goto err;
+    }
+
+    addr = mmap( NULL, sizeof(SAppIfShm_t), PROT_READ, MAP_SHARED, fd, 0 );
+    if( addr == MAP_FAILED )
+    {
+        DBG_PRINT_ERROR( "mmap() error. \n\r" );
+        goto err;
+    }
+    close( fd );
+    fd = -1;
+
+    shm = (const SAppIfShm_t*)addr;
+    if( __atomic_load_n( &shm->magic, __ATOMIC_ACQUIRE ) != APP_IF_SHM_MAGIC
+     || shm->ver    != APP_IF_SHM_VER
+     || shm->slots  != APP_IF_SHM_SLOTS
+     || shm->size   != sizeof(SAppIfShmRec_t)
+     || shm->ch_num != EN_SEN_CH_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid shared memory layout. \n\r" );
+        goto err;
+    }
+
+    return shm;
+
+err :
+    if( addr != MAP_FAILED ){ munmap( addr, sizeof(SAppIfShm_t) ); }
+    if( fd >= 0 ){ close( fd ); }
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     共有メモリからデタッチする。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfShmReader_Close(
+    const SAppIfShm_t*  shm     ///< [in] 共有メモリ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( shm != NULL )
+    {
+        munmap( (void*)shm, sizeof(SAppIfShm_t) );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     次に書き込まれる通し番号を返す。
+ * @attention なし。
+ * @note      最新レコードの通し番号は AppIfShmReader_Head() - 1 になる。
+ *            リングバッファに残っているのは直近 APP_IF_SHM_SLOTS 個。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    通し番号
+ *************************************************************************** */
+unsigned long long
+AppIfShmReader_Head(
+    const SAppIfShm_t*  shm     ///< [in] 共有メモリ
+){
+    return __atomic_load_n( &shm->head, __ATOMIC_ACQUIRE );
+}
+
+
+/**************************************************************************//*!
+ * @brief     最新レコードを読み出す。
+ * @attention 書き込み側が止まっている間に lock が奇数のままの場合は
+ *            SHM_RETRY_MAX 回で諦める。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : まだ書き込まれていない
+ *************************************************************************** */
+EHalBool_t
+AppIfShmReader_Latest(
+    const SAppIfShm_t*  shm,    ///< [in]  共有メモリ
+    SAppIfShmRec_t*     out     ///< [out] レコード
+){
+    unsigned int    lock1 = 0;
+    unsigned int    lock2 = 0;
+    unsigned int    i = 0;
+
+    for( i = 0; i < SHM_RETRY_MAX; i++ )
+    {
+        lock1 = __atomic_load_n( &shm->lock, __ATOMIC_ACQUIRE );
+        if( lock1 & 1 )
+        {
+            continue;
+        }
+
+        memcpy( out, &shm->latest, sizeof(SAppIfShmRec_t) );
+
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        lock2 = __atomic_load_n( &shm->lock, __ATOMIC_RELAXED );
+        if( lock1 == lock2 )
+        {
+            return ( out->seq != 0 ) ? EN_TRUE : EN_FALSE;
+        }
+    }
+
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     通し番号 seq のレコードを読み出す。
+ * @attention なし。
+ * @note      まだ書き込まれていない場合と、既に上書きされた場合は失敗する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfShmReader_Read(
+    const SAppIfShm_t*  shm,    ///< [in]  共有メモリ
+    unsigned long long  seq,    ///< [in]  通し番号
+    SAppIfShmRec_t*     out     ///< [out] レコード
+){
+    const SAppIfShmRec_t*   rec = &shm->rec[seq & ( APP_IF_SHM_SLOTS - 1 )];
+    unsigned long long      seq1 = 0;
+    unsigned long long      seq2 = 0;
+
+    seq1 = __atomic_load_n( &rec->seq, __ATOMIC_ACQUIRE );
+    if( seq1 != seq + 1 )
+    {
+        return EN_FALSE;
+    }
+
+    memcpy( out, rec, sizeof(SAppIfShmRec_t) );
+
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    seq2 = __atomic_load_n( &rec->seq, __ATOMIC_RELAXED );
+    return ( seq1 == seq2 ) ? EN_TRUE : EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     cursor のレコードを読み出して cursor を進める。
+ * @attention なし。
+ * @note      リングバッファを先頭から順に読む ( リプレイ ) ために使う。
+ *            cursor が上書きされたレコードを指している場合は、
+ *            残っている最も古いレコードまで読み飛ばす。
+ *            読み飛ばした数は out->seq - 1 と呼ぶ前の cursor の差で分かる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 読み出した, EN_FALSE : 新しいレコードがない
+ *************************************************************************** */
+EHalBool_t
+AppIfShmReader_Next(
+    const SAppIfShm_t*  shm,    ///< [in]     共有メモリ
+    unsigned long long* cursor, ///< [in,out] 次に読む通し番号
+    SAppIfShmRec_t*     out     ///< [out]    レコード
+){
+    unsigned long long  head = 0;
+
+    while( 1 )
+    {
+        head = AppIfShmReader_Head( shm );
+        if( *cursor >= head )
+        {
+            return EN_FALSE;
+        }
+
+        if( head - *cursor > APP_IF_SHM_SLOTS )
+        {
+            *cursor = head - APP_IF_SHM_SLOTS;
+        }
+
+        if( AppIfShmReader_Read( shm, *cursor, out ) == EN_TRUE )
+        {
+            (*cursor)++;
+            return EN_TRUE;
+        }
+
+        // 読んでいる間に上書きされたので、残っている最も古いレコードから読み直す
+        *cursor = AppIfShmReader_Head( shm ) - APP_IF_SHM_SLOTS + 1;
+    }
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
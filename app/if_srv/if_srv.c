@@ -0,0 +1,864 @@
+/**************************************************************************//*!
+ *  @file           if_srv.c
+ *  @brief          [APP] Unix ドメインソケットでセンサ値を配信する。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             if_srv.h ( コマンドとレコードの形式 )
+ *  @note           epoll で待つのはリッスンソケット, timerfd ( 取得周期 ), signalfd ( SIGINT, SIGTERM ),
+ *                  クライアントのソケットの 4 種類。epoll_event.data.u32 で区別する。
+ *                  送信はクライアント毎の送信キュー ( app/if_que ) に積んでから send() し、
+ *                  送り切れない分は EPOLLOUT で続きを送る。送信キューがあふれた場合は
+ *                  クライアントが指定したポリシでレコードを捨てて数える。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "if_srv.h"
+#include "../if_frame/if_frame.h"
+#include "../if_que/if_que.h"
+#include "../if_ser/if_ser.h"
+
+//#define DBG_PRINT
+#define MY_NAME "APP"
+#include "../log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SRV_ID_LISTEN       (0xFFFF0000)    // epoll の識別子 : リッスンソケット
+#define SRV_ID_TIMER        (0xFFFF0001)    // epoll の識別子 : timerfd
+#define SRV_ID_SIGNAL       (0xFFFF0002)    // epoll の識別子 : signalfd
+#define SRV_EVENT_MAX       (16)            // 1 回の epoll_wait() で受け取るイベントの数
+#define SRV_BACKLOG         (16)            // listen() の接続待ちの数
+#define SRV_PREC            (6)             // 値の小数点以下の桁数 ( json, csv )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// クライアントの型
+typedef struct tagSAppIfSrvCli
+{
+    int                 fd;                         // ソケット ( -1 : 未使用 )
+    EAppIfSrvFmt_t      fmt;                        // 配信する形式
+    unsigned int        mask;                       // 購読している ch ( bit n = EHalSensorCh_t の n, 0 : 購読していない )
+    unsigned int        div;                        // 間引き率 ( 取得 div 回に 1 回送る )
+    unsigned long long  next;                       // 次に送る取得回数
+    unsigned long long  sent;                       // 送信キューに積んだレコード数
+    EHalBool_t          pollOut;                    // EN_TRUE : EPOLLOUT を待っている
+    unsigned int        inLen;                      // 受信バッファのサイズ
+    char                in[APP_IF_SRV_CMD_LEN];     // 受信バッファ ( コマンド )
+    SAppIfQue_t         que;                        // 送信キュー
+    SAppIfSer_t         ser;                        // json, csv, cbor のシリアライザ
+} SAppIfSrvCli_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static int                  g_lfd = -1;                     // リッスンソケット
+static int                  g_efd = -1;                     // epoll
+static int                  g_tfd = -1;                     // timerfd
+static int                  g_sfd = -1;                     // signalfd
+static sigset_t             g_sigOrg;                       // 変更する前のシグナルマスク
+static char                 g_path[sizeof(((struct sockaddr_un*)0)->sun_path)];   // ソケットのパス
+static unsigned int         g_hz = APP_IF_SRV_HZ;           // 取得周期 ( Hz )
+static unsigned long long   g_tick = 0;                     // 取得回数 ( 遅れた周期を含む )
+static unsigned long long   g_overrun = 0;                  // 遅れて取得しなかった周期の数
+static SHalSensor_t*        g_data[EN_SEN_CH_NUM];          // 今回の周期で読み出したセンサ値
+static SAppIfSrvCli_t       g_cli[APP_IF_SRV_CLI_MAX];      // クライアント
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static SHalSensor_t*    GetSensor( EHalSensorCh_t ch );
+static unsigned int     ParseCh( char* str );
+static EHalBool_t       Ctl( SAppIfSrvCli_t* cli, int op, unsigned int events );
+static void             Drop( SAppIfSrvCli_t* cli );
+static void             Flush( SAppIfSrvCli_t* cli );
+static void             Reply( SAppIfSrvCli_t* cli, const char* msg );
+static void             Command( SAppIfSrvCli_t* cli, char* line );
+static void             Accept( void );
+static void             Recv( SAppIfSrvCli_t* cli );
+static void             Send( SAppIfSrvCli_t* cli, unsigned long long ts );
+static void             Tick( void );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ch のセンサ値を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    センサ変数
+ *************************************************************************** */
+static SHalSensor_t*
+GetSensor(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    switch( ch )
+    {
+    case EN_SEN_CH_DIST_FL  : return HalSensorDist_GetFL();
+    case EN_SEN_CH_DIST_FR  : return HalSensorDist_GetFR();
+    case EN_SEN_CH_DIST_FSL : return HalSensorDist_GetFSL();
+    case EN_SEN_CH_DIST_FSR : return HalSensorDist_GetFSR();
+    case EN_SEN_CH_PM       : return HalSensorPm_Get();
+    case EN_SEN_CH_ACC_X    :
+    case EN_SEN_CH_ACC_Y    :
+    case EN_SEN_CH_ACC_Z    : return HalSensorBmx055_GetAcc( (EHalSensorBMX055_t)( ch - EN_SEN_CH_ACC_X ) );
+    case EN_SEN_CH_GYRO_X   :
+    case EN_SEN_CH_GYRO_Y   :
+    case EN_SEN_CH_GYRO_Z   : return HalSensorBmx055_GetGyro( (EHalSensorBMX055_t)( ch - EN_SEN_CH_GYRO_X ) );
+    case EN_SEN_CH_MAG_X    :
+    case EN_SEN_CH_MAG_Y    :
+    case EN_SEN_CH_MAG_Z    : return HalSensorBmx055_GetMag( (EHalSensorBMX055_t)( ch - EN_SEN_CH_MAG_X ) );
+    default                 : return NULL;
+    }
+}
+
+
+/**************************************************************************//*!
+ * @brief     カンマ区切りの ch 名を ch マスクにする。
+ * @attention str は書き換える。
+ * @note      ch 名の他に dist, acc, gyro, mag, imu, all を指定できる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    ch マスク ( 0 : 不正な ch 名がある )
+ *************************************************************************** */
+static unsigned int
+ParseCh(
+    char*           str     ///< [in] ch 名
+){
+    static const struct {
+        const char*     name;
+        unsigned int    mask;
+    } group[] = {
+        { "dist", 0x0FU << EN_SEN_CH_DIST_FL },
+        { "acc",  0x07U << EN_SEN_CH_ACC_X },
+        { "gyro", 0x07U << EN_SEN_CH_GYRO_X },
+        { "mag",  0x07U << EN_SEN_CH_MAG_X },
+        { "imu",  0x1FFU << EN_SEN_CH_ACC_X },
+        { "all",  ( 1U << EN_SEN_CH_NUM ) - 1 },
+    };
+    unsigned int    mask = 0;
+    unsigned int    bit = 0;
+    unsigned int    i = 0;
+    char*           save = NULL;
+    char*           tok = NULL;
+
+    for( tok = strtok_r( str, ",", &save ); tok != NULL; tok = strtok_r( NULL, ",", &save ) )
+    {
+        bit = 0;
+        for( i = 0; i < sizeof(group) / sizeof(group[0]); i++ )
+        {
+            if( 0 == strcmp( tok, group[i].name ) ){ bit = group[i].mask; }
+        }
+        for( i = 0; i < EN_SEN_CH_NUM; i++ )
+        {
+            if( 0 == strcmp( tok, HalCmn_GetChName( (EHalSensorCh_t)i ) ) ){ bit = 1U << i; }
+        }
+
+        if( bit == 0 )
+        {
+            return 0;
+        }
+        mask |= bit;
+    }
+
+    return mask;
+}
+
+
+/**************************************************************************//*!
+ * @brief     クライアントのソケットを epoll に登録 / 変更する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+Ctl(
+    SAppIfSrvCli_t* cli,    ///< [in] クライアント
+    int             op,     ///< [in] EPOLL_CTL_ADD / EPOLL_CTL_MOD
+    unsigned int    events  ///< [in] 待つイベント
+){
+    struct epoll_event  ev;
+
+    memset( &ev, 0, sizeof(ev) );
+    ev.events   = events;
+    ev.data.u32 = (unsigned int)( cli - g_cli );
+    if( epoll_ctl( g_efd, op, cli->fd, &ev ) < 0 )
+    {
+        DBG_PRINT_ERROR( "epoll_ctl() error. : %s \n\r", strerror( errno ) );
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     クライアントを切断する。
+ * @attention なし。
+ * @note      close() すると epoll からも外れる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Drop(
+    SAppIfSrvCli_t* cli     ///< [in] クライアント
+){
+    DBG_PRINT_TRACE( "fd = %d, sent = %llu, drop = %llu \n\r", cli->fd, cli->sent, cli->que.drop );
+
+    if( cli->fd >= 0 )
+    {
+        close( cli->fd );
+    }
+    cli->fd = -1;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     送信バッファをノンブロッキングで送る。
+ * @attention なし。
+ * @note      送り切れない場合は EPOLLOUT を待ち、送り切ったら待つのを止める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Flush(
+    SAppIfSrvCli_t* cli     ///< [in] クライアント
+){
+    int             ret = 0;
+    EHalBool_t      pollOut = EN_FALSE;
+
+    ret = AppIfQue_Flush( &cli->que, cli->fd );
+    if( ret < 0 )
+    {
+        Drop( cli );
+        return;
+    }
+    pollOut = ( ret > 0 ) ? EN_TRUE : EN_FALSE;
+
+    if( pollOut != cli->pollOut )
+    {
+        cli->pollOut = pollOut;
+        if( Ctl( cli, EPOLL_CTL_MOD, EPOLLIN | ( ( pollOut == EN_TRUE ) ? EPOLLOUT : 0 ) ) == EN_FALSE )
+        {
+            Drop( cli );
+        }
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エラーを返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Reply(
+    SAppIfSrvCli_t* cli,    ///< [in] クライアント
+    const char*     msg     ///< [in] 理由
+){
+    char            buf[APP_IF_SRV_CMD_LEN];
+    int             len = 0;
+
+    len = snprintf( buf, sizeof(buf), "error: %s\n", msg );
+    AppIfQue_Push( &cli->que, buf, (unsigned int)len );
+    Flush( cli );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     コマンドを 1 行実行する。
+ * @attention line は書き換える。
+ * @note      コマンドの形式は if_srv.h を参照。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Command(
+    SAppIfSrvCli_t* cli,    ///< [in] クライアント
+    char*           line    ///< [in] コマンド
+){
+    static const char*  fmtName[] = { "json", "csv", "cbor", "bin" };
+    static const EAppIfSerFmt_t serFmt[] = { EN_SER_JSON, EN_SER_CSV, EN_SER_CBOR, EN_SER_JSON };
+    char*               save = NULL;
+    char*               cmd = NULL;
+    char*               chs = NULL;
+    char*               hzs = NULL;
+    char*               fmts = NULL;
+    char*               pols = NULL;
+    char*               end = NULL;
+    EAppIfQuePolicy_t   policy = EN_QUE_DROP_OLDEST;
+    unsigned int        mask = 0;
+    unsigned long       hz = 0;
+    unsigned int        fmt = EN_SRV_FMT_JSON;
+
+    DBG_PRINT_TRACE( "line = %s \n\r", line );
+
+    cmd = strtok_r( line, " \t\r", &save );
+    if( cmd == NULL )
+    {
+        return;
+    }
+
+    if( 0 == strcmp( cmd, "unsub" ) )
+    {
+        cli->mask = 0;
+        return;
+    }
+
+    if( 0 != strcmp( cmd, "sub" ) )
+    {
+        Reply( cli, "unknown command" );
+        return;
+    }
+
+    chs  = strtok_r( NULL, " \t\r", &save );
+    hzs  = strtok_r( NULL, " \t\r", &save );
+    fmts = strtok_r( NULL, " \t\r", &save );
+    pols = strtok_r( NULL, " \t\r", &save );
+    if( chs == NULL || hzs == NULL )
+    {
+        Reply( cli, "usage: sub <ch>[,<ch>...] <Hz> [json|csv|cbor|bin] [oldest|newest|latest]" );
+        return;
+    }
+
+    mask = ParseCh( chs );
+    if( mask == 0 )
+    {
+        Reply( cli, "invalid ch" );
+        return;
+    }
+
+    hz = strtoul( hzs, &end, 10 );
+    if( end == hzs || *end != '\0' || hz == 0 )
+    {
+        Reply( cli, "invalid Hz" );
+        return;
+    }
+
+    if( fmts != NULL )
+    {
+        for( fmt = 0; fmt < sizeof(fmtName) / sizeof(fmtName[0]); fmt++ )
+        {
+            if( 0 == strcmp( fmts, fmtName[fmt] ) ){ break; }
+        }
+        if( fmt >= sizeof(fmtName) / sizeof(fmtName[0]) )
+        {
+            Reply( cli, "invalid format" );
+            return;
+        }
+    }
+
+    if( pols != NULL && AppIfQue_Policy( pols, &policy ) == EN_FALSE )
+    {
+        Reply( cli, "invalid policy" );
+        return;
+    }
+
+    cli->que.policy = policy;
+    cli->fmt  = (EAppIfSrvFmt_t)fmt;
+    cli->mask = mask;
+    cli->div  = (unsigned int)( ( g_hz + hz / 2 ) / hz );
+    if( cli->div == 0 ){ cli->div = 1; }
+    cli->next = g_tick;
+    AppIfSer_Init( &cli->ser, serFmt[fmt] );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     接続を受け付ける。
+ * @attention なし。
+ * @note      接続待ちがなくなるまで受け付ける。空きがない場合はエラーを返して切断する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Accept(
+    void
+){
+    static const char   full[] = "error: too many clients\n";
+    SAppIfSrvCli_t*     cli = NULL;
+    int                 fd = -1;
+    unsigned int        i = 0;
+
+    while( 1 )
+    {
+        fd = accept( g_lfd, NULL, NULL );
+        if( fd < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            if( errno != EAGAIN && errno != EWOULDBLOCK )
+            {
+                DBG_PRINT_ERROR( "accept() error. : %s \n\r", strerror( errno ) );
+            }
+            return;
+        }
+        fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK );
+        fcntl( fd, F_SETFD, FD_CLOEXEC );
+
+        cli = NULL;
+        for( i = 0; i < APP_IF_SRV_CLI_MAX; i++ )
+        {
+            if( g_cli[i].fd < 0 ){ cli = &g_cli[i]; break; }
+        }
+
+        if( cli == NULL )
+        {
+            (void)send( fd, full, sizeof(full) - 1, MSG_NOSIGNAL | MSG_DONTWAIT );
+            close( fd );
+            continue;
+        }
+
+        memset( cli, 0, offsetof( SAppIfSrvCli_t, que ) );
+        cli->fd = fd;
+        AppIfQue_Init( &cli->que, EN_QUE_DROP_OLDEST, 0 );
+        if( Ctl( cli, EPOLL_CTL_ADD, EPOLLIN ) == EN_FALSE )
+        {
+            Drop( cli );
+        }
+    }
+}
+
+
+/**************************************************************************//*!
+ * @brief     コマンドを受信する。
+ * @attention なし。
+ * @note      改行までを 1 行として実行する。APP_IF_SRV_CMD_LEN を超える行は捨てる。
+ *            相手が切断した場合は切断する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Recv(
+    SAppIfSrvCli_t* cli     ///< [in] クライアント
+){
+    ssize_t         ret = 0;
+    char*           line = NULL;
+    char*           nl = NULL;
+    unsigned int    rest = 0;
+
+    while( cli->fd >= 0 )
+    {
+        ret = recv( cli->fd, &cli->in[cli->inLen], APP_IF_SRV_CMD_LEN - 1 - cli->inLen, MSG_DONTWAIT );
+        if( ret < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            if( errno != EAGAIN && errno != EWOULDBLOCK ){ Drop( cli ); }
+            return;
+        }
+        if( ret == 0 )
+        {
+            Drop( cli );
+            return;
+        }
+
+        cli->inLen += (unsigned int)ret;
+        cli->in[cli->inLen] = '\0';
+
+        line = cli->in;
+        while( ( nl = strchr( line, '\n' ) ) != NULL )
+        {
+            *nl = '\0';
+            Command( cli, line );
+            line = nl + 1;
+        }
+
+        rest = cli->inLen - (unsigned int)( line - cli->in );
+        if( rest >= APP_IF_SRV_CMD_LEN - 1 )
+        {
+            Reply( cli, "command too long" );
+            rest = 0;
+        }
+        memmove( cli->in, line, rest );
+        cli->inLen = rest;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     購読している ch のレコードを送信バッファに積んで送る。
+ * @attention g_data[] に購読している ch を読み出しておくこと。
+ * @note      なし。
+ * @sa        if_srv.h ( レコードの形式 )
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Send(
+    SAppIfSrvCli_t*     cli,    ///< [in] クライアント
+    unsigned long long  ts      ///< [in] 時刻 ( nsec )
+){
+    struct iovec        iov[2];
+    unsigned char       wire[APP_IF_FRAME_WIRE_MAX];
+    short               raw[EN_SEN_CH_NUM];
+    unsigned long long  drop = cli->que.drop;
+    unsigned int        len = 0;
+    unsigned int        ch = 0;
+    int                 num = 0;
+
+    if( cli->fmt == EN_SRV_FMT_BIN )
+    {
+        memset( raw, 0, sizeof(raw) );
+        for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+        {
+            if( cli->mask & ( 1U << ch ) ){ raw[ch] = (short)g_data[ch]->raw; }
+        }
+        len = AppIfFrame_Pack( wire, (unsigned int)g_tick, cli->mask, raw, ts );
+        if( AppIfQue_Push( &cli->que, wire, len ) == EN_TRUE ){ cli->sent++; }
+    } else
+    {
+        AppIfSer_Begin( &cli->ser );
+        AppIfSer_Uint( &cli->ser, "seq", g_tick );
+        AppIfSer_Uint( &cli->ser, "ts",  ts );
+        AppIfSer_ObjBegin( &cli->ser, "value" );
+        for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+        {
+            if( cli->mask & ( 1U << ch ) )
+            {
+                AppIfSer_Fix( &cli->ser, HalCmn_GetChName( (EHalSensorCh_t)ch ), g_data[ch]->cur, SRV_PREC );
+            }
+        }
+        AppIfSer_ObjEnd( &cli->ser );
+        AppIfSer_End( &cli->ser );
+
+        // CSV の列名の行はレコードと一緒に積む ( 別々に捨てない )
+        num = AppIfSer_Iov( &cli->ser, iov );
+        if( num > 0 && AppIfQue_Pushv( &cli->que, iov, num ) == EN_TRUE ){ cli->sent++; }
+
+        // 列名の行を含むレコードを捨てた可能性があるので、次のレコードに列名の行を付け直す
+        if( cli->que.drop != drop ){ cli->ser.hlenPrev = 0; }
+    }
+
+    if( cli->pollOut == EN_FALSE ){ Flush( cli ); }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     取得周期の処理をする。
+ * @attention なし。
+ * @note      送信する時期になったクライアントが購読している ch の和を 1 回だけ読み出し、
+ *            それぞれのクライアントに送る。
+ *            処理が遅れて周期を飛ばした場合も取得回数は進めるので、間引き後の周期は保たれる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Tick(
+    void
+){
+    unsigned long long  exp = 0;
+    unsigned long long  ts = 0;
+    unsigned long long  fill = 0;
+    unsigned int        mask = 0;
+    unsigned int        ch = 0;
+    unsigned int        i = 0;
+    SAppIfSrvCli_t*     cli = NULL;
+
+    if( read( g_tfd, &exp, sizeof(exp) ) != sizeof(exp) || exp == 0 )
+    {
+        return;
+    }
+    g_tick    += exp;
+    g_overrun += exp - 1;
+    if( exp > 1 ){ HalCmnMetric_Add( EN_METRIC_DEADLINE_MISS, exp - 1 ); }
+
+    for( i = 0; i < APP_IF_SRV_CLI_MAX; i++ )
+    {
+        cli = &g_cli[i];
+        if( cli->fd >= 0 && cli->mask != 0 && g_tick >= cli->next )
+        {
+            mask |= cli->mask;
+        }
+    }
+    if( mask == 0 )
+    {
+        return;
+    }
+
+    ts = HalCmnClock_Export( HalCmnClock_GetNsec() );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        if( mask & ( 1U << ch ) ){ g_data[ch] = GetSensor( (EHalSensorCh_t)ch ); }
+    }
+
+    for( i = 0; i < APP_IF_SRV_CLI_MAX; i++ )
+    {
+        cli = &g_cli[i];
+        if( cli->fd >= 0 && cli->mask != 0 && g_tick >= cli->next )
+        {
+            cli->next = g_tick - g_tick % cli->div + cli->div;
+            Send( cli, ts );
+        }
+        if( cli->fd >= 0 ){ fill += cli->que.len; }
+    }
+    HalCmnMetric_Set( EN_METRIC_GAUGE_SRV_QUE_FILL, fill );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     サーバを開始する。
+ * @attention SIGINT, SIGTERM はブロックして signalfd で受け取る ( AppIfSrv_Close() で戻す )。
+ * @note      同じパスのソケットが残っている場合は削除してから作成する。
+ * @sa        AppIfSrv_Run(), AppIfSrv_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfSrv_Open(
+    const char*     path,   ///< [in] ソケットのパス
+    unsigned int    hz      ///< [in] 取得周期 ( Hz, 0 : APP_IF_SRV_HZ )
+){
+    struct sockaddr_un  addr;
+    struct epoll_event  ev;
+    struct itimerspec   its;
+    sigset_t            sig;
+    unsigned int        i = 0;
+
+    DBG_PRINT_TRACE( "path = %s, hz = %u \n\r", path, hz );
+
+    AppIfSrv_Close();
+
+    if( hz == 0 ){ hz = APP_IF_SRV_HZ; }
+    if( path == NULL || strlen( path ) >= sizeof(g_path) || hz > 1000000000U )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. \n\r" );
+        return EN_FALSE;
+    }
+    strcpy( g_path, path );
+    g_hz      = hz;
+    g_tick    = 0;
+    g_overrun = 0;
+    for( i = 0; i < APP_IF_SRV_CLI_MAX; i++ )
+    {
+        g_cli[i].fd = -1;
+    }
+
+    g_lfd = socket( AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if( g_lfd < 0 )
+    {
+        DBG_PRINT_ERROR( "socket() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+
+    memset( &addr, 0, sizeof(addr) );
+    addr.sun_family = AF_UNIX;
+    strcpy( addr.sun_path, g_path );
+    unlink( g_path );
+    if( bind( g_lfd, (struct sockaddr*)&addr, sizeof(addr) ) < 0 || listen( g_lfd, SRV_BACKLOG ) < 0 )
+    {
+        DBG_PRINT_ERROR( "bind() / listen() error. : %s : %s \n\r", g_path, strerror( errno ) );
+        goto err;
+    }
+
+    g_tfd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+    if( g_tfd < 0 )
+    {
+        DBG_PRINT_ERROR( "timerfd_create() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+
+    sigemptyset( &sig );
+    sigaddset( &sig, SIGINT );
+    sigaddset( &sig, SIGTERM );
+    sigprocmask( SIG_BLOCK, &sig, &g_sigOrg );
+    g_sfd = signalfd( -1, &sig, SFD_NONBLOCK | SFD_CLOEXEC );
+    if( g_sfd < 0 )
+    {
+        DBG_PRINT_ERROR( "signalfd() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+
+    g_efd = epoll_create1( EPOLL_CLOEXEC );
+    if( g_efd < 0 )
+    {
+        DBG_PRINT_ERROR( "epoll_create1() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+
+    memset( &ev, 0, sizeof(ev) );
+    ev.events = EPOLLIN;
+    ev.data.u32 = SRV_ID_LISTEN;
+    if( epoll_ctl( g_efd, EPOLL_CTL_ADD, g_lfd, &ev ) < 0 ){ goto err; }
+    ev.data.u32 = SRV_ID_TIMER;
+    if( epoll_ctl( g_efd, EPOLL_CTL_ADD, g_tfd, &ev ) < 0 ){ goto err; }
+    ev.data.u32 = SRV_ID_SIGNAL;
+    if( epoll_ctl( g_efd, EPOLL_CTL_ADD, g_sfd, &ev ) < 0 ){ goto err; }
+
+    memset( &its, 0, sizeof(its) );
+    its.it_interval.tv_sec  = 0;
+    its.it_interval.tv_nsec = 1000000000L / hz;
+    its.it_value            = its.it_interval;
+    if( timerfd_settime( g_tfd, 0, &its, NULL ) < 0 )
+    {
+        DBG_PRINT_ERROR( "timerfd_settime() error. : %s \n\r", strerror( errno ) );
+        goto err;
+    }
+
+    return EN_TRUE;
+
+err :
+    AppIfSrv_Close();
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     サーバを終了する。
+ * @attention なし。
+ * @note      全てのクライアントを切断し、ソケットのファイルを削除する。
+ * @sa        AppIfSrv_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppIfSrv_Close(
+    void
+){
+    unsigned int    i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( g_efd >= 0 )
+    {
+        for( i = 0; i < APP_IF_SRV_CLI_MAX; i++ )
+        {
+            Drop( &g_cli[i] );
+        }
+    }
+
+    if( g_lfd >= 0 ){ close( g_lfd ); g_lfd = -1; unlink( g_path ); }
+    if( g_tfd >= 0 ){ close( g_tfd ); g_tfd = -1; }
+    if( g_efd >= 0 ){ close( g_efd ); g_efd = -1; }
+    if( g_sfd >= 0 )
+    {
+        close( g_sfd );
+        g_sfd = -1;
+        sigprocmask( SIG_SETMASK, &g_sigOrg, NULL );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     SIGINT / SIGTERM を受け取るまで配信する。
+ * @attention AppIfSrv_Open() で開始してから呼ぶこと。
+ * @note      終了時に取得回数と遅れた周期の数、クライアント毎の送信数と破棄数を
+ *            標準エラー出力に表示する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : シグナルで終了した, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+AppIfSrv_Run(
+    void
+){
+    struct epoll_event          ev[SRV_EVENT_MAX];
+    struct signalfd_siginfo     si;
+    SAppIfSrvCli_t*             cli = NULL;
+    int                         num = 0;
+    int                         i = 0;
+    int                         j = 0;
+
+    if( g_efd < 0 )
+    {
+        DBG_PRINT_ERROR( "server is not opened. \n\r" );
+        return EN_FALSE;
+    }
+
+    while( 1 )
+    {
+        num = epoll_wait( g_efd, ev, SRV_EVENT_MAX, -1 );
+        if( num < 0 )
+        {
+            if( errno == EINTR ){ continue; }
+            DBG_PRINT_ERROR( "epoll_wait() error. : %s \n\r", strerror( errno ) );
+            return EN_FALSE;
+        }
+
+        for( i = 0; i < num; i++ )
+        {
+            switch( ev[i].data.u32 )
+            {
+            case SRV_ID_LISTEN : Accept(); break;
+            case SRV_ID_TIMER  : Tick();   break;
+            case SRV_ID_SIGNAL :
+                if( read( g_sfd, &si, sizeof(si) ) == sizeof(si) )
+                {
+                    fprintf( stderr, "if_srv: tick = %llu, overrun = %llu \n", g_tick, g_overrun );
+                    for( j = 0; j < APP_IF_SRV_CLI_MAX; j++ )
+                    {
+                        if( g_cli[j].fd < 0 ){ continue; }
+                        fprintf( stderr, "if_srv: client %d : sent = %llu, drop = %llu \n",
+                                 j, g_cli[j].sent, g_cli[j].que.drop );
+                    }
+                    return EN_TRUE;
+                }
+                break;
+            default :
+                cli = &g_cli[ev[i].data.u32];
+                if( cli->fd >= 0 && ( ev[i].events & ( EPOLLERR | EPOLLHUP ) ) ){ Drop( cli ); }
+                if( cli->fd >= 0 && ( ev[i].events & EPOLLIN ) )  { Recv( cli ); }
+                if( cli->fd >= 0 && ( ev[i].events & EPOLLOUT ) ) { Flush( cli ); }
+                break;
+            }
+        }
+    }
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
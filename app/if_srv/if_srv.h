@@ -0,0 +1,79 @@
+/**************************************************************************//*!
+ *  @file           if_srv.h
+ *  @brief          [APP] 外部公開 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : App[モジュール名]_処理名()
+ *  @sa             none.
+ *  @note           Unix ドメインソケットでセンサ値を配信するサーバ。
+ *                  1 スレッドの epoll ループで、取得周期 ( timerfd ) 毎に購読されている ch を
+ *                  1 回だけ読み出し、クライアント毎の間引き率で送信キュー ( app/if_que ) に積む。
+ *                  ソケットは全てノンブロッキングで、読まないクライアントがいても取得周期は遅れない。
+ *                  コマンド ( クライアント -> サーバ, 1 行のテキスト )
+ *                      sub <ch>[,<ch>...] <Hz> [json|csv|cbor|bin] [oldest|newest|latest]
+ *                                                                   購読を開始 / 変更する
+ *                          ch : dist_fl ... mag_z ( HalCmn_GetChName() ),
+ *                               dist, acc, gyro, mag, imu ( acc + gyro + mag ), all
+ *                          Hz : 送信周期 ( 取得周期を割り切れない場合は近い間引き率にする )
+ *                          oldest|newest|latest : 送信キューがあふれた時のポリシ ( 省略時 oldest )
+ *                      unsub                                        購読を止める
+ *                  応答は失敗した場合だけ "error: 理由\n" を返す。
+ *                  レコード ( サーバ -> クライアント )
+ *                      json : {"seq":取得回数,"ts":時刻,"value":{"dist_fl":値,...}}
+ *                      csv  : seq,ts,value.dist_fl,...  ( 列が変わった時だけ列名の行を付ける )
+ *                      cbor : json と同じ構造 ( app/if_ser )
+ *                      bin  : 生値のフレーム ( app/if_frame )
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _APP_IF_SRV_H_
+#define _APP_IF_SRV_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "../../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define APP_IF_SRV_HZ           (1000)      ///< @def : 取得周期の省略時 ( Hz )
+#define APP_IF_SRV_CLI_MAX      (64)        ///< @def : 同時に接続できるクライアントの数
+#define APP_IF_SRV_CMD_LEN      (256)       ///< @def : コマンド 1 行の最大長 ( Byte )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// 配信する形式に使用する型
+typedef enum tagEAppIfSrvFmt
+{
+    EN_SRV_FMT_JSON = 0,    ///< @var : json
+    EN_SRV_FMT_CSV,         ///< @var : csv
+    EN_SRV_FMT_CBOR,        ///< @var : cbor
+    EN_SRV_FMT_BIN          ///< @var : バイナリフレーム
+} EAppIfSrvFmt_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+EHalBool_t      AppIfSrv_Open( const char* path, unsigned int hz );
+void            AppIfSrv_Close( void );
+EHalBool_t      AppIfSrv_Run( void );
+
+
+#endif /* _APP_IF_SRV_H_ */
@@ -0,0 +1,646 @@
+/**************************************************************************//*!
+ *  @file           log.c
+ *  @brief          [APP] DBG_PRINT_* の出力をバックグラウンドで行うファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             log.h
+ *  @note           DBG_PRINT_* を呼んだスレッド ( 書き手 ) は、初回にスレッド専用の
+ *                  リングバッファを確保し、以降はレコードをコピーするだけで戻る。
+ *                  書き手と読み手 ( バックグラウンドのスレッド ) が 1 つずつなので、
+ *                  head / tail の acquire / release だけでロックを使わない。
+ *                  リングバッファが一杯の場合はレコードを捨てて数を数え、
+ *                  読み手が "N records dropped" を出力する。
+ *                  スレッドを跨いだ出力の順序は通し番号で保つ。
+ *                  スレッドが終了してもリングバッファは解放しない ( スレッドの数は少ない )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MY_NAME "LOG"
+#include "log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define LOG_RING_NUM        (256)       // 1 スレッドのリングバッファのレコード数 ( 2 の累乗 )
+#define LOG_STR_SIZE        (160)       // 1 レコードにコピーできる文字列の合計 ( Byte, 終端を含む )
+#define LOG_LINE_SIZE       (1024)      // 整形した 1 行の最大長 ( Byte )
+#define LOG_SPEC_SIZE       (32)        // 1 つの変換指定の最大長 ( Byte )
+#define LOG_POLL_USEC       (1000)      // レコードがない時に読み手が待つ時間 ( usec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// リングバッファの 1 レコード ( 256 Byte )
+typedef struct tagSAppLogRec
+{
+    const SAppLogSite_t*    site;                   // 出力する場所
+    unsigned long long      seq;                    // 通し番号
+    unsigned char           num;                    // 引数の数
+    unsigned char           kind[APP_LOG_ARG_MAX];  // 引数の型 ( EAppLogArg_t )
+    UAppLogVal_t            val[APP_LOG_ARG_MAX];   // 引数の値 ( 文字列は str[] の位置 )
+    char                    str[LOG_STR_SIZE];      // 文字列の引数のコピー
+} SAppLogRec_t;
+
+
+// スレッド毎のリングバッファ
+typedef struct tagSAppLogRing
+{
+    unsigned int            head __attribute__((aligned(64)));  // 書き手が進める
+    unsigned long long      drop;                               // 捨てたレコード数 ( 書き手が更新 )
+    unsigned int            tail __attribute__((aligned(64)));  // 読み手が進める
+    struct tagSAppLogRing*  next;                               // 次のリングバッファ
+    SAppLogRec_t            rec[LOG_RING_NUM];
+} SAppLogRing_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+int                             g_appLogLevel = EN_LOG_DEBUG;   // 実行時のレベル
+
+static __thread SAppLogRing_t*  g_ring = NULL;      // このスレッドのリングバッファ
+static SAppLogRing_t*           g_list = NULL;      // 全てのリングバッファ
+static unsigned long long       g_seq = 0;          // 通し番号
+static int                      g_run = 0;          // 1 : 読み手が動いている
+static int                      g_fd = -1;          // 出力先 ( -1 : stderr / stdout )
+static pthread_t                g_thread;
+static unsigned long long       g_dropOut = 0;      // 出力済みの捨てたレコード数
+static int                      g_atexit = 0;       // atexit() に登録済み
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static SAppLogRing_t*   RingNew( void );
+static void             Fill( SAppLogRec_t* rec, const SAppLogSite_t* site, const SAppLogArg_t* arg, unsigned int num );
+static unsigned int     Format( char* buf, unsigned int size, const SAppLogRec_t* rec );
+static void             Write( const SAppLogSite_t* site, const char* buf, unsigned int len );
+static unsigned int     Drain( void );
+static void*            Main( void* arg );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     このスレッドのリングバッファを確保して一覧に加える。
+ * @attention なし。
+ * @note      一覧への追加は CAS で行う ( 一覧から外すことはない )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    リングバッファ ( NULL : 失敗 )
+ *************************************************************************** */
+static SAppLogRing_t*
+RingNew(
+    void
+){
+    SAppLogRing_t*  ring = NULL;
+    int             err = errno;
+
+    if( posix_memalign( (void**)&ring, 64, sizeof(SAppLogRing_t) ) != 0 )
+    {
+        errno = err;
+        return NULL;
+    }
+    memset( ring, 0, sizeof(SAppLogRing_t) );
+
+    ring->next = __atomic_load_n( &g_list, __ATOMIC_RELAXED );
+    while( !__atomic_compare_exchange_n( &g_list, &ring->next, ring, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED ) );
+
+    g_ring = ring;
+    errno = err;
+    return ring;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードに引数をコピーする。
+ * @attention なし。
+ * @note      文字列は str[] に詰めてコピーし、入り切らない分は切り詰める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Fill(
+    SAppLogRec_t*           rec,    ///< [out] レコード
+    const SAppLogSite_t*    site,   ///< [in]  出力する場所
+    const SAppLogArg_t*     arg,    ///< [in]  引数
+    unsigned int            num     ///< [in]  引数の数
+){
+    const char*     s = NULL;
+    unsigned int    pos = 0;
+    unsigned int    len = 0;
+    unsigned int    i = 0;
+
+    if( num > APP_LOG_ARG_MAX ){ num = APP_LOG_ARG_MAX; }
+
+    rec->site = site;
+    rec->num  = (unsigned char)num;
+    for( i = 0; i < num; i++ )
+    {
+        rec->kind[i] = (unsigned char)arg[i].kind;
+        if( arg[i].kind != EN_LOG_ARG_STR )
+        {
+            rec->val[i] = arg[i].v;
+            continue;
+        }
+
+        // 入り切らない場合は最後の 1 Byte ( 空文字列 ) を指す
+        s   = ( arg[i].v.s != NULL ) ? arg[i].v.s : "(null)";
+        len = ( pos < LOG_STR_SIZE - 1 ) ? (unsigned int)strnlen( s, LOG_STR_SIZE - 1 - pos ) : 0;
+        if( len == 0 && pos >= LOG_STR_SIZE - 1 ){ pos = LOG_STR_SIZE - 1; }
+        memcpy( &rec->str[pos], s, len );
+        rec->str[pos + len] = '\0';
+        rec->val[i].i = pos;
+        if( pos + len < LOG_STR_SIZE - 1 ){ pos += len + 1; }
+        else                              { pos = LOG_STR_SIZE - 1; }
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードを 1 行に整形する。
+ * @attention なし。
+ * @note      従来の DBG_PRINT_* と同じ形式 ( [名前][レベル] [ファイル:行][関数()] 本文 )。
+ *            書式文字列を変換指定毎に分け、引数の型に合わせて snprintf() する。
+ *            長さ修飾子は書式文字列に従って引数を切り詰める ( %d なら int )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    整形した長さ ( Byte )
+ *************************************************************************** */
+static unsigned int
+Format(
+    char*                   buf,    ///< [out] 出力先
+    unsigned int            size,   ///< [in]  出力先のサイズ
+    const SAppLogRec_t*     rec     ///< [in]  レコード
+){
+    static const char* const    head[] = {
+        DBG_COLOR_RED    "[ERR]  ",
+        DBG_COLOR_BLUE   "[WARN] ",
+        DBG_COLOR_YELLOW "[TRACE]",
+        DBG_COLOR_PURPLE "[DEBUG]"
+    };
+    const SAppLogSite_t*    site = rec->site;
+    const char*             p = site->fmt;
+    char                    spec[LOG_SPEC_SIZE];
+    char                    len[3];
+    unsigned int            k = 0;
+    unsigned int            l = 0;
+    unsigned int            i = 0;
+    unsigned int            out = 0;
+    int                     n = 0;
+    long long               v = 0;
+    char                    conv = 0;
+
+    if( site->level == EN_LOG_DEBUG )
+    {
+        n = snprintf( buf, size, "[%s]%s" DBG_COLOR_WHITE " ", site->name, head[site->level] );
+    } else
+    {
+        n = snprintf( buf, size, "[%s]%s" DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] ",
+                      site->name, head[site->level], site->file, site->line, site->func );
+    }
+    out = ( n > 0 ) ? (unsigned int)n : 0;
+
+    while( *p != '\0' && out + 1 < size )
+    {
+        if( *p != '%' || p[1] == '%' )
+        {
+            buf[out++] = *p;
+            p += ( *p == '%' ) ? 2 : 1;
+            continue;
+        }
+
+        // フラグ, 幅, 精度 ( * は引数から取る )
+        spec[0] = '%';
+        k = 1;
+        for( p++; *p != '\0' && k < LOG_SPEC_SIZE - 8; p++ )
+        {
+            if( *p == '*' )
+            {
+                v = ( i < rec->num ) ? rec->val[i++].i : 0;
+                k += (unsigned int)snprintf( &spec[k], LOG_SPEC_SIZE - 8 - k, "%d", (int)v );
+            } else if( strchr( "-+ #0123456789.", *p ) != NULL )
+            {
+                spec[k++] = *p;
+            } else
+            {
+                break;
+            }
+        }
+
+        // 長さ修飾子
+        for( l = 0; *p != '\0' && strchr( "hlLqjzt", *p ) != NULL; p++ )
+        {
+            if( l < sizeof(len) ){ len[l++] = *p; }
+        }
+        conv = *p;
+        if( conv == '\0' ){ break; }
+        p++;
+
+        if( i >= rec->num )
+        {
+            n = snprintf( &buf[out], size - out, "(?)" );
+            out += ( n > 0 ) ? (unsigned int)n : 0;
+            if( out >= size ){ out = size - 1; }
+            continue;
+        }
+
+        v = rec->val[i].i;
+        switch( conv )
+        {
+        case 'd' :
+        case 'i' :
+            if( rec->kind[i] == EN_LOG_ARG_FLOAT ){ v = (long long)rec->val[i].f; }
+            if(      l == 0 )                                { v = (int)v; }
+            else if( l == 1 && len[0] == 'h' )               { v = (short)v; }
+            else if( l == 2 && len[0] == 'h' )               { v = (signed char)v; }
+            else if( l == 1 && len[0] == 'l' )               { v = (long)v; }
+            strcpy( &spec[k], "ll" );
+            spec[k + 2] = conv;
+            spec[k + 3] = '\0';
+            n = snprintf( &buf[out], size - out, spec, v );
+            break;
+
+        case 'u' :
+        case 'o' :
+        case 'x' :
+        case 'X' :
+            if( rec->kind[i] == EN_LOG_ARG_FLOAT ){ v = (long long)rec->val[i].f; }
+            if(      l == 0 )                                { v = (unsigned int)v; }
+            else if( l == 1 && len[0] == 'h' )               { v = (unsigned short)v; }
+            else if( l == 2 && len[0] == 'h' )               { v = (unsigned char)v; }
+            else if( l == 1 && len[0] == 'l' )               { v = (long long)(unsigned long)v; }
+            strcpy( &spec[k], "ll" );
+            spec[k + 2] = conv;
+            spec[k + 3] = '\0';
+            n = snprintf( &buf[out], size - out, spec, (unsigned long long)v );
+            break;
+
+        case 'c' :
+            spec[k] = 'c';
+            spec[k + 1] = '\0';
+            n = snprintf( &buf[out], size - out, spec, (int)v );
+            break;
+
+        case 'e' : case 'E' :
+        case 'f' : case 'F' :
+        case 'g' : case 'G' :
+        case 'a' : case 'A' :
+            spec[k] = conv;
+            spec[k + 1] = '\0';
+            n = snprintf( &buf[out], size - out, spec,
+                          ( rec->kind[i] == EN_LOG_ARG_FLOAT ) ? rec->val[i].f : (double)v );
+            break;
+
+        case 's' :
+            spec[k] = 's';
+            spec[k + 1] = '\0';
+            n = snprintf( &buf[out], size - out, spec,
+                          ( rec->kind[i] == EN_LOG_ARG_STR ) ? &rec->str[v] : "(?)" );
+            break;
+
+        case 'p' :
+            spec[k] = 'p';
+            spec[k + 1] = '\0';
+            n = snprintf( &buf[out], size - out, spec, rec->val[i].p );
+            break;
+
+        default :
+            n = 0;
+            break;
+        }
+        i++;
+
+        out += ( n > 0 ) ? (unsigned int)n : 0;
+        if( out >= size ){ out = size - 1; }
+    }
+
+    buf[out] = '\0';
+    return out;
+}
+
+
+/**************************************************************************//*!
+ * @brief     整形した 1 行を出力する。
+ * @attention なし。
+ * @note      ERROR / WARN は stderr, TRACE / DEBUG は stdout ( AppLog_Init() で fd を
+ *            指定した場合はその fd )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Write(
+    const SAppLogSite_t*    site,   ///< [in] 出力する場所 ( NULL : stderr )
+    const char*             buf,    ///< [in] 1 行
+    unsigned int            len     ///< [in] 長さ ( Byte )
+){
+    int             err = errno;
+
+    if( g_fd >= 0 )
+    {
+        if( write( g_fd, buf, len ) < 0 ){ /* 出力できない場合は捨てる */ }
+    } else
+    {
+        fwrite( buf, 1, len, ( site == NULL || site->level <= EN_LOG_WARN ) ? stderr : stdout );
+    }
+    errno = err;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     全てのリングバッファのレコードを通し番号の順に出力する。
+ * @attention 読み手 ( 1 スレッド ) だけが呼ぶこと。
+ * @note      リングバッファが空になるまで出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    出力したレコード数
+ *************************************************************************** */
+static unsigned int
+Drain(
+    void
+){
+    char                buf[LOG_LINE_SIZE];
+    SAppLogRing_t*      ring = NULL;
+    SAppLogRing_t*      best = NULL;
+    const SAppLogRec_t* rec = NULL;
+    unsigned long long  drop = 0;
+    unsigned int        count = 0;
+    unsigned int        len = 0;
+
+    while( 1 )
+    {
+        best = NULL;
+        for( ring = __atomic_load_n( &g_list, __ATOMIC_ACQUIRE ); ring != NULL; ring = ring->next )
+        {
+            if( ring->tail == __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE ) ){ continue; }
+            if( best == NULL
+             || ring->rec[ring->tail & ( LOG_RING_NUM - 1 )].seq < best->rec[best->tail & ( LOG_RING_NUM - 1 )].seq )
+            {
+                best = ring;
+            }
+        }
+        if( best == NULL ){ break; }
+
+        rec = &best->rec[best->tail & ( LOG_RING_NUM - 1 )];
+        len = Format( buf, sizeof(buf), rec );
+        __atomic_store_n( &best->tail, best->tail + 1, __ATOMIC_RELEASE );
+        Write( rec->site, buf, len );
+        count++;
+    }
+
+    for( ring = __atomic_load_n( &g_list, __ATOMIC_ACQUIRE ); ring != NULL; ring = ring->next )
+    {
+        drop += __atomic_load_n( &ring->drop, __ATOMIC_RELAXED );
+    }
+    if( drop != g_dropOut )
+    {
+        len = (unsigned int)snprintf( buf, sizeof(buf), "[%s]" DBG_COLOR_BLUE "[WARN] " DBG_COLOR_WHITE " %llu records dropped. \n\r",
+                                      MY_NAME, drop - g_dropOut );
+        Write( NULL, buf, len );
+        g_dropOut = drop;
+    }
+
+    if( count > 0 && g_fd < 0 ){ fflush( stdout ); }
+    return count;
+}
+
+
+/**************************************************************************//*!
+ * @brief     読み手のスレッド。
+ * @attention なし。
+ * @note      レコードがない間は LOG_POLL_USEC 毎に確認する
+ *            ( 書き手がシステムコールで起こさなくて済むように )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    NULL
+ *************************************************************************** */
+static void*
+Main(
+    void*   arg     ///< [in] 未使用
+){
+    (void)arg;
+
+    while( 1 )
+    {
+        if( Drain() == 0 )
+        {
+            if( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) == 0 ){ break; }
+            usleep( LOG_POLL_USEC );
+        }
+    }
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     バックグラウンドでの出力を開始する。
+ * @attention 既に開始している場合は何もしない。
+ * @note      fd に -1 を指定すると従来通り stderr / stdout に出力する。
+ *            終了時 ( exit() ) に残っているレコードを出力するよう atexit() に登録する。
+ * @sa        AppLog_Fini()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 以降もその場で出力する )
+ *************************************************************************** */
+EHalBool_t
+AppLog_Init(
+    int             fd      ///< [in] 出力先 ( -1 : stderr / stdout )
+){
+    sigset_t        all;
+    sigset_t        org;
+    int             res = 0;
+
+    if( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) != 0 )
+    {
+        return EN_TRUE;
+    }
+
+    g_fd = fd;
+    __atomic_store_n( &g_run, 1, __ATOMIC_RELEASE );
+
+    // 起動したスレッドはシグナルマスクを引き継ぐ
+    sigfillset( &all );
+    pthread_sigmask( SIG_SETMASK, &all, &org );
+    res = pthread_create( &g_thread, NULL, Main, NULL );
+    pthread_sigmask( SIG_SETMASK, &org, NULL );
+    if( res != 0 )
+    {
+        __atomic_store_n( &g_run, 0, __ATOMIC_RELEASE );
+        DBG_PRINT_ERROR( "pthread_create() error. : %s \n\r", strerror( res ) );
+        return EN_FALSE;
+    }
+
+    if( g_atexit == 0 )
+    {
+        atexit( AppLog_Fini );
+        g_atexit = 1;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     バックグラウンドでの出力を終了する。
+ * @attention なし。
+ * @note      残っているレコードを出力してから戻る。以降はその場で出力する。
+ * @sa        AppLog_Init()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppLog_Fini(
+    void
+){
+    if( __atomic_exchange_n( &g_run, 0, __ATOMIC_ACQ_REL ) == 0 )
+    {
+        return;
+    }
+
+    pthread_join( g_thread, NULL );
+    Drain();
+    g_fd = -1;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     積んだレコードが全て出力されるまで待つ。
+ * @attention なし。
+ * @note      バックグラウンドで出力していない場合は何もしない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppLog_Flush(
+    void
+){
+    SAppLogRing_t*  ring = NULL;
+
+    while( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) != 0 )
+    {
+        for( ring = __atomic_load_n( &g_list, __ATOMIC_ACQUIRE ); ring != NULL; ring = ring->next )
+        {
+            if( __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) != __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE ) ){ break; }
+        }
+        if( ring == NULL ){ break; }
+        usleep( LOG_POLL_USEC / 10 );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     実行時のレベルを設定する。
+ * @attention なし。
+ * @note      level より上のレベルは積まない ( EN_LOG_OFF : 全て積まない )。
+ *            コンパイル時に除いたレベルは出力できない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppLog_SetLevel(
+    EAppLogLevel_t  level   ///< [in] レベル
+){
+    __atomic_store_n( &g_appLogLevel, (int)level, __ATOMIC_RELAXED );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードをこのスレッドのリングバッファに積む。
+ * @attention DBG_PRINT_* から呼ぶ。直接呼ばないこと。
+ * @note      リングバッファが一杯の場合は捨てる ( 書き手を待たせない )。
+ *            バックグラウンドで出力していない場合はその場で整形して出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+AppLog_Push(
+    const SAppLogSite_t*    site,   ///< [in] 出力する場所
+    const SAppLogArg_t*     arg,    ///< [in] 引数
+    unsigned int            num     ///< [in] 引数の数
+){
+    SAppLogRing_t*          ring = g_ring;
+    SAppLogRec_t            tmp;
+    char                    buf[LOG_LINE_SIZE];
+    unsigned int            head = 0;
+
+    if( __atomic_load_n( &g_run, __ATOMIC_ACQUIRE ) == 0
+     || ( ring == NULL && ( ring = RingNew() ) == NULL ) )
+    {
+        Fill( &tmp, site, arg, num );
+        Write( site, buf, Format( buf, sizeof(buf), &tmp ) );
+        return;
+    }
+
+    head = ring->head;
+    if( head - __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) >= LOG_RING_NUM )
+    {
+        __atomic_store_n( &ring->drop, ring->drop + 1, __ATOMIC_RELAXED );
+        return;
+    }
+
+    Fill( &ring->rec[head & ( LOG_RING_NUM - 1 )], site, arg, num );
+    ring->rec[head & ( LOG_RING_NUM - 1 )].seq = __atomic_fetch_add( &g_seq, 1, __ATOMIC_RELAXED );
+    __atomic_store_n( &ring->head, head + 1, __ATOMIC_RELEASE );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     リングバッファが一杯で捨てたレコード数を返す。
+ * @attention なし。
+ * @note      全てのスレッドの合計。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    捨てたレコード数
+ *************************************************************************** */
+unsigned long long
+AppLog_GetDrop(
+    void
+){
+    SAppLogRing_t*      ring = NULL;
+    unsigned long long  drop = 0;
+
+    for( ring = __atomic_load_n( &g_list, __ATOMIC_ACQUIRE ); ring != NULL; ring = ring->next )
+    {
+        drop += __atomic_load_n( &ring->drop, __ATOMIC_RELAXED );
+    }
+    return drop;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -6,10 +6,20 @@
  *                  関数命名規則
  *                      通常関数 : App[モジュール名]_処理名()
  *  @sa             none.
+ *  @note           DBG_PRINT_* はその場で fprintf() せず、書式文字列 ( 呼び出し元の静的な情報 ) の
+ *                  ポインタと引数だけをスレッド毎のリングバッファに積む ( app/log/log.c )。
+ *                  整形と出力はバックグラウンドのスレッドが行う。
+ *                  AppLog_Init() の前 / AppLog_Fini() の後は、従来通りその場で出力する。
+ *                  出力のレベル
+ *                      コンパイル時 : APP_LOG_LEVEL_MAX より上のレベルはコードを生成しない。
+ *                                     TRACE / DEBUG は DBG_PRINT を定義したファイルだけ。
+ *                      実行時       : AppLog_SetLevel() より上のレベルはリングバッファに積まない。
+ *                  引数は整数, 浮動小数点数, 文字列 ( char* ), ポインタ ( void* ) で、
+ *                  最大 APP_LOG_ARG_MAX 個。文字列は積む時にコピーする。
  *  @bug            none.
  *  @warning        none.
  *  @version        1.00
- *  @last updated   2016.06.24
+ *  @last updated   2026.10.19
  ****************************************************************************** */
 
 // 多重コンパイル抑止
@@ -22,6 +32,8 @@
 #include <stdio.h>
 #include <unistd.h>
 
+#include "../../hal/hal_cmn.h"
+
 
 //**************************************************
 /*! @def                                           */
@@ -35,22 +47,67 @@
 #define DBG_COLOR_AQUA   "\x1b[1;36m"
 #define DBG_COLOR_GRARY  "\x1b[1;37m"
 
+#define APP_LOG_ARG_MAX     (8)                 ///< @def : 1 回の出力の引数の最大数
+
+// コンパイル時のレベル ( -DAPP_LOG_LEVEL_MAX=0 で ERROR 以外を生成しない )
+#ifndef APP_LOG_LEVEL_MAX
+#  define APP_LOG_LEVEL_MAX (EN_LOG_DEBUG)
+#endif
+
 // Debug Print Log
 #ifndef MY_NAME
 #  define MY_NAME "---"
 #endif
 
+// 引数を SAppLogArg_t に変換する ( 型毎に関数を選ぶ )
+#define APP_LOG_ARG(x)      _Generic( (x),                                  \
+                                float       : AppLog_ArgF,                  \
+                                double      : AppLog_ArgF,                  \
+                                long double : AppLog_ArgF,                  \
+                                char*       : AppLog_ArgS,                  \
+                                const char* : AppLog_ArgS,                  \
+                                void*       : AppLog_ArgP,                  \
+                                const void* : AppLog_ArgP,                  \
+                                default     : AppLog_ArgI )( x ),
+
+#define APP_LOG_NARG_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...)  n
+#define APP_LOG_NARG(arg...)    APP_LOG_NARG_( _, ##arg, 8, 7, 6, 5, 4, 3, 2, 1, 0 )
+#define APP_LOG_CAT_(a, b)      a##b
+#define APP_LOG_CAT(a, b)       APP_LOG_CAT_( a, b )
+#define APP_LOG_MAP0()
+#define APP_LOG_MAP1(a)         APP_LOG_ARG( a )
+#define APP_LOG_MAP2(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP1( __VA_ARGS__ )
+#define APP_LOG_MAP3(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP2( __VA_ARGS__ )
+#define APP_LOG_MAP4(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP3( __VA_ARGS__ )
+#define APP_LOG_MAP5(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP4( __VA_ARGS__ )
+#define APP_LOG_MAP6(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP5( __VA_ARGS__ )
+#define APP_LOG_MAP7(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP6( __VA_ARGS__ )
+#define APP_LOG_MAP8(a, ...)    APP_LOG_ARG( a ) APP_LOG_MAP7( __VA_ARGS__ )
+#define APP_LOG_MAP(arg...)     APP_LOG_CAT( APP_LOG_MAP, APP_LOG_NARG( arg ) )( arg )
+
+// レベルを確認してリングバッファに積む
+#define APP_LOG(lv, fmt, arg...)                                                            \
+    do {                                                                                    \
+        if( (lv) <= APP_LOG_LEVEL_MAX                                                       \
+         && (int)(lv) <= __atomic_load_n( &g_appLogLevel, __ATOMIC_RELAXED ) )              \
+        {                                                                                   \
+            static const SAppLogSite_t  site_ = { (lv), MY_NAME, __FILE__, __LINE__, __FUNCTION__, fmt }; \
+            const SAppLogArg_t          arg_[] = { APP_LOG_MAP( arg ) AppLog_ArgI( 0 ) };  \
+            AppLog_Push( &site_, arg_, sizeof(arg_) / sizeof(arg_[0]) - 1 );                \
+        }                                                                                   \
+    } while( 0 )
+
 #ifdef DBG_PRINT /*DBG_PRINT----------------*/
 
-    #define DBG_PRINT_ERROR(fmt, arg...) fprintf( stderr, "["MY_NAME"]" DBG_COLOR_RED    "[ERR]  " DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] " fmt, __FILE__, __LINE__, __FUNCTION__, ##arg )
-    #define DBG_PRINT_WARN(fmt, arg...)  fprintf( stderr, "["MY_NAME"]" DBG_COLOR_BLUE   "[WARN] " DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] " fmt, __FILE__, __LINE__, __FUNCTION__, ##arg )
-    #define DBG_PRINT_TRACE(fmt, arg...) fprintf( stdout, "["MY_NAME"]" DBG_COLOR_YELLOW "[TRACE]" DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] " fmt, __FILE__, __LINE__, __FUNCTION__, ##arg )
-    #define DBG_PRINT_DEBUG(fmt, arg...) fprintf( stdout, "["MY_NAME"]" DBG_COLOR_PURPLE "[DEBUG]" DBG_COLOR_WHITE " "                                                     fmt, ##arg )
+    #define DBG_PRINT_ERROR(fmt, arg...) APP_LOG( EN_LOG_ERROR, fmt, ##arg )
+    #define DBG_PRINT_WARN(fmt, arg...)  APP_LOG( EN_LOG_WARN,  fmt, ##arg )
+    #define DBG_PRINT_TRACE(fmt, arg...) APP_LOG( EN_LOG_TRACE, fmt, ##arg )
+    #define DBG_PRINT_DEBUG(fmt, arg...) APP_LOG( EN_LOG_DEBUG, fmt, ##arg )
 
 #else /*NO DBG_PRINT------------------------*/
 
-    #define DBG_PRINT_ERROR(fmt, arg...) fprintf( stderr, "["MY_NAME"]" DBG_COLOR_RED    "[ERR]  " DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] " fmt, __FILE__, __LINE__, __FUNCTION__, ##arg )
-    #define DBG_PRINT_WARN(fmt, arg...)  fprintf( stderr, "["MY_NAME"]" DBG_COLOR_BLUE   "[WARN] " DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] " fmt, __FILE__, __LINE__, __FUNCTION__, ##arg )
+    #define DBG_PRINT_ERROR(fmt, arg...) APP_LOG( EN_LOG_ERROR, fmt, ##arg )
+    #define DBG_PRINT_WARN(fmt, arg...)  APP_LOG( EN_LOG_WARN,  fmt, ##arg )
     #define DBG_PRINT_TRACE(fmt, arg...)
     #define DBG_PRINT_DEBUG(fmt, arg...)
 
@@ -60,20 +117,76 @@
 //**************************************************
 /*! @enum                                          */
 //**************************************************
-// なし
+// 出力のレベルに使用する型
+typedef enum tagEAppLogLevel
+{
+    EN_LOG_OFF = -1,        ///< @var : 何も出力しない ( AppLog_SetLevel() のみ )
+    EN_LOG_ERROR = 0,       ///< @var : DBG_PRINT_ERROR ( stderr )
+    EN_LOG_WARN,            ///< @var : DBG_PRINT_WARN  ( stderr )
+    EN_LOG_TRACE,           ///< @var : DBG_PRINT_TRACE ( stdout )
+    EN_LOG_DEBUG            ///< @var : DBG_PRINT_DEBUG ( stdout )
+} EAppLogLevel_t;
+
+
+// 引数の型の区別に使用する型
+typedef enum tagEAppLogArg
+{
+    EN_LOG_ARG_INT = 0,     ///< @var : 整数 ( long long に拡張 )
+    EN_LOG_ARG_FLOAT,       ///< @var : 浮動小数点数 ( double )
+    EN_LOG_ARG_STR,         ///< @var : 文字列 ( 積む時にコピーする )
+    EN_LOG_ARG_PTR          ///< @var : ポインタ ( %p )
+} EAppLogArg_t;
 
 
 //**************************************************
 /*! @struct                                        */
 //**************************************************
-// なし
+// 出力する場所の情報に使用する型 ( 呼び出し元毎に static const で 1 つ )
+typedef struct tagSAppLogSite
+{
+    EAppLogLevel_t      level;      ///< @var : レベル
+    const char*         name;       ///< @var : MY_NAME
+    const char*         file;       ///< @var : __FILE__
+    int                 line;       ///< @var : __LINE__
+    const char*         func;       ///< @var : __FUNCTION__
+    const char*         fmt;        ///< @var : 書式文字列
+} SAppLogSite_t;
+
+
+// 引数の値に使用する型
+typedef union tagUAppLogVal
+{
+    long long           i;          ///< @var : EN_LOG_ARG_INT   ( リングバッファでは文字列の位置 )
+    double              f;          ///< @var : EN_LOG_ARG_FLOAT
+    const char*         s;          ///< @var : EN_LOG_ARG_STR
+    const void*         p;          ///< @var : EN_LOG_ARG_PTR
+} UAppLogVal_t;
+
+
+// 引数に使用する型
+typedef struct tagSAppLogArg
+{
+    EAppLogArg_t        kind;       ///< @var : 型
+    UAppLogVal_t        v;          ///< @var : 値
+} SAppLogArg_t;
 
 
 //********************************************************
 /* 関数プロトタイプ宣言                                  */
 //********************************************************
-// なし
+extern int      g_appLogLevel;      // 実行時のレベル ( AppLog_SetLevel() )
 
+EHalBool_t      AppLog_Init( int fd );
+void            AppLog_Fini( void );
+void            AppLog_Flush( void );
+void            AppLog_SetLevel( EAppLogLevel_t level );
+void            AppLog_Push( const SAppLogSite_t* site, const SAppLogArg_t* arg, unsigned int num );
+unsigned long long  AppLog_GetDrop( void );
 
-#endif  // _APP_LOG_H
+static inline SAppLogArg_t AppLog_ArgI( long long v )   { SAppLogArg_t a; a.kind = EN_LOG_ARG_INT;   a.v.i = v; return a; }
+static inline SAppLogArg_t AppLog_ArgF( double v )      { SAppLogArg_t a; a.kind = EN_LOG_ARG_FLOAT; a.v.f = v; return a; }
+static inline SAppLogArg_t AppLog_ArgS( const char* v ) { SAppLogArg_t a; a.kind = EN_LOG_ARG_STR;   a.v.s = v; return a; }
+static inline SAppLogArg_t AppLog_ArgP( const void* v ) { SAppLogArg_t a; a.kind = EN_LOG_ARG_PTR;   a.v.p = v; return a; }
 
+
+#endif  // _APP_LOG_H
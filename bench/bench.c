@@ -0,0 +1,265 @@
+/**************************************************************************//*!
+ *  @file           bench.c
+ *  @brief          [BENCH] ベンチマークの main() と共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           環境変数 BENCH_FORMAT=json の場合、結果を 1 行 1 件の JSON で出力する ( バージョン間の比較用 )。
+ *                  JSON 以外の行 ( 確認の結果など ) も出力するので、'{' で始まる行だけを読むこと。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "BEN"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#ifndef BENCH_VERSION
+#define BENCH_VERSION   "unknown"   // CMake の PROJECT_VERSION で上書きする
+#endif
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+typedef struct {
+    const char*     name;       // ベンチマーク名
+    void            (*run)( void );
+} SBench_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static const SBench_t   g_bench[] = {
+    { "sensor", BenchSensor_Run },
+    { "filter", BenchFilter_Run },
+    { "ser",    BenchSer_Run    },
+    { "que",    BenchQue_Run    },
+    { "rec",    BenchRec_Run    },
+    { "log",    BenchLog_Run    },
+    { "arc",    BenchArc_Run    },
+    { "aio",    BenchAio_Run    },
+    { "spi",    BenchSpi_Run    },
+    { "i2c",    BenchI2c_Run    },
+    { "gpio",   BenchGpio_Run   },
+    { "hal",    BenchHal_Run    },
+    { "cyclic", BenchCyclic_Run },
+    { NULL,     NULL            },  // termination
+};
+
+static unsigned int     g_seed = 0x12345678;
+static const char*      g_name = "";        // 実行中のベンチマーク名
+static int              g_json = 0;         // 1 : JSON で出力する
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static int  Compare( const void* a, const void* b );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     qsort() の比較関数 ( 昇順 )
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    -1, 0, 1
+ *************************************************************************** */
+static int
+Compare(
+    const void*     a,      ///< [in] 要素 a
+    const void*     b       ///< [in] 要素 b
+){
+    unsigned long long  x = *(const unsigned long long*)a;
+    unsigned long long  y = *(const unsigned long long*)b;
+
+    return ( x > y ) - ( x < y );
+}
+
+
+/**************************************************************************//*!
+ * @brief     ベンチマークの結果を表示する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+Bench_Report(
+    const char*         name,   ///< [in] 計測項目の名前
+    unsigned long long  count,  ///< [in] 実行回数
+    unsigned long long  ns      ///< [in] 経過時間 ( nsec )
+){
+    if( g_json != 0 )
+    {
+        printf( "{\"version\":\"%s\",\"bench\":\"%s\",\"name\":\"%s\",\"ops\":%llu,\"ns_per_op\":%.2f}\n",
+                BENCH_VERSION, g_name, name, count, (double)ns / (double)count );
+        return;
+    }
+
+    printf( "%-32s %12llu ops %10.2f ns/op %10.3f Mops/s \n",
+            name, count,
+            (double)ns / (double)count,
+            (double)count * 1000.0 / (double)ns );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     処理時間の分布 ( min, p50, p99, max, 平均 ) を表示する。
+ * @attention なし。
+ * @note      Bench_ReportDist(), BenchHdr_Report() の共通の出力。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+Bench_ReportPct(
+    const char*         name,   ///< [in] 計測項目の名前
+    unsigned long long  num,    ///< [in] サンプル数
+    unsigned long long  min,    ///< [in] 最小値 ( nsec )
+    unsigned long long  p50,    ///< [in] 50 パーセンタイル ( nsec )
+    unsigned long long  p99,    ///< [in] 99 パーセンタイル ( nsec )
+    unsigned long long  max,    ///< [in] 最大値 ( nsec )
+    double              mean    ///< [in] 平均 ( nsec )
+){
+    if( g_json != 0 )
+    {
+        printf( "{\"version\":\"%s\",\"bench\":\"%s\",\"name\":\"%s\",\"unit\":\"ns\",\"n\":%llu,"
+                "\"min\":%llu,\"p50\":%llu,\"p99\":%llu,\"max\":%llu,\"mean\":%.1f}\n",
+                BENCH_VERSION, g_name, name, num, min, p50, p99, max, mean );
+        return;
+    }
+
+    printf( "%-32s n %7llu min %9llu p50 %9llu p99 %9llu max %10llu ns \n",
+            name, num, min, p50, p99, max );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 回毎の処理時間の分布 ( min, p50, p99, max, 平均 ) を表示する。
+ * @attention ns は昇順に並べ替える。
+ * @note      パーセンタイルは並べ替えた ns[ num * p / 100 ] ( 最近傍 )。
+ * @sa        Bench_ReportPct()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+Bench_ReportDist(
+    const char*         name,   ///< [in]     計測項目の名前
+    unsigned long long* ns,     ///< [in,out] 1 回毎の処理時間 ( nsec )
+    unsigned int        num     ///< [in]     ns の要素数
+){
+    unsigned long long  sum = 0;
+    unsigned int        i = 0;
+
+    if( num == 0 )
+    {
+        return;
+    }
+
+    qsort( ns, num, sizeof(ns[0]), Compare );
+    for( i = 0; i < num; i++ )
+    {
+        sum += ns[i];
+    }
+
+    Bench_ReportPct( name, num, ns[0], ns[num / 2], ns[(unsigned long long)num * 99 / 100], ns[num - 1],
+                     (double)sum / num );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     擬似乱数を返す。
+ * @attention なし。
+ * @note      xorshift32。ベンチマークの入力を毎回同じにするために使う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    擬似乱数
+ *************************************************************************** */
+unsigned int
+Bench_Rand(
+    void
+){
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+    return g_seed;
+}
+
+
+/**************************************************************************//*!
+ * @brief     メイン
+ * @attention なし。
+ * @note      引数でベンチマーク名を指定すると、そのベンチマークだけを実行する。
+ *            環境変数 BENCH_FORMAT=json の場合、結果を JSON で出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    0 : 成功, 1 : 失敗
+ *************************************************************************** */
+int main(int argc, char *argv[ ])
+{
+    int         i = 0;
+    int         found = 0;
+    const char* fmt = getenv( "BENCH_FORMAT" );
+
+    HalCmnClock_Init();
+    g_json = ( fmt != NULL && 0 == strcmp( fmt, "json" ) ) ? 1 : 0;
+
+    for( i = 0; g_bench[i].name != NULL; i++ )
+    {
+        if( argc < 2 || 0 == strcmp( argv[1], g_bench[i].name ) )
+        {
+            if( g_json == 0 ){ printf( "[%s] \n", g_bench[i].name ); }
+            g_name = g_bench[i].name;
+            g_bench[i].run();
+            found = 1;
+        }
+    }
+
+    if( found == 0 )
+    {
+        DBG_PRINT_ERROR( "invalid benchmark. : \"%s\" \n\r", argv[1] );
+        return 1;
+    }
+
+    return 0;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,82 @@
+/**************************************************************************//*!
+ *  @file           bench.h
+ *  @brief          [BENCH] ベンチマークの共通 API を宣言したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *                  関数命名規則
+ *                      通常関数 : Bench[モジュール名]_処理名()
+ *  @sa             none.
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "../hal/hal_cmn.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define BENCH_HDR_SUB_BITS  (7)     ///< @def : HDR ヒストグラムの 2 のべき乗の区間毎の分割数 ( 2^n, 相対誤差 1 / 2^n 以下 )
+#define BENCH_HDR_NUM       ( ( 65 - BENCH_HDR_SUB_BITS ) << BENCH_HDR_SUB_BITS )  ///< @def : HDR ヒストグラムのバケット数 ( 64 bit の値をすべて数える )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// HDR ( High Dynamic Range ) ヒストグラム
+// 2^(BENCH_HDR_SUB_BITS + 1) 未満は 1 ns 単位、それ以上は 2 のべき乗の区間を 2^BENCH_HDR_SUB_BITS 個に分けて数える。
+typedef struct {
+    unsigned long long  count[BENCH_HDR_NUM];   ///< @var : バケット毎のサンプル数
+    unsigned long long  total;      ///< @var : サンプル数
+    unsigned long long  min;        ///< @var : 最小値
+    unsigned long long  max;        ///< @var : 最大値
+    double              sum;        ///< @var : 合計 ( 平均の計算用 )
+} SBenchHdr_t;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+void Bench_Report( const char* name, unsigned long long count, unsigned long long ns );
+void Bench_ReportPct( const char* name, unsigned long long num, unsigned long long min, unsigned long long p50,
+                      unsigned long long p99, unsigned long long max, double mean );
+void Bench_ReportDist( const char* name, unsigned long long* ns, unsigned int num );
+unsigned int Bench_Rand( void );
+
+void BenchHdr_Init( SBenchHdr_t* hdr );
+void BenchHdr_Add( SBenchHdr_t* hdr, unsigned long long value );
+unsigned long long BenchHdr_Get( const SBenchHdr_t* hdr, unsigned int pct );
+void BenchHdr_Report( const char* name, const SBenchHdr_t* hdr );
+
+void BenchSensor_Run( void );
+void BenchFilter_Run( void );
+void BenchSer_Run( void );
+void BenchQue_Run( void );
+void BenchRec_Run( void );
+void BenchLog_Run( void );
+void BenchArc_Run( void );
+void BenchAio_Run( void );
+void BenchSpi_Run( void );
+void BenchI2c_Run( void );
+void BenchGpio_Run( void );
+void BenchHal_Run( void );
+void BenchCyclic_Run( void );
+
+
+#endif /* _BENCH_H_ */
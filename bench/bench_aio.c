@@ -0,0 +1,266 @@
+/**************************************************************************//*!
+ *  @file           bench_aio.c
+ *  @brief          [BENCH] ブロックの書き出し ( app/if_aio ) が周期に与える影響のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      環境変数 BENCH_AIO_PATH のディレクトリ ( 既定 : /tmp ) にファイルを作り、終了時に削除する。
+ *                  SD カードなどの遅い記録先を計る場合は、そのファイルシステムのディレクトリを指定する。
+ *  @sa             none.
+ *  @note           1 msec 周期のループで AIO_BLOCK_MSEC 周期毎に AIO_BLOCK のブロックを書き出し
+ *                  ( fdatasync() 付き )、周期毎に「予定時刻から処理が終わるまで」の遅れを計る。
+ *                  遅い記録先を模擬するため、子プロセスが同じディレクトリに大きな書き込みと fsync() を
+ *                  繰り返す ( 書き戻しの競合で fdatasync() が数十 msec 待たされる )。
+ *                      sync   : 周期処理のスレッドで pwritev() + fdatasync()
+ *                      thread : 書き出し用のスレッド
+ *                      uring  : io_uring ( WRITE_FIXED + FSYNC )
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "../app/if_aio/if_aio.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define AIO_LOOP        (3000)              // 周期数 ( 1 msec 周期 )
+#define AIO_PERIOD      (1000000L)          // 周期 ( nsec )
+#define AIO_BLOCK       (64 * 1024)         // 1 ブロックのサイズ ( Byte )
+#define AIO_BLOCK_MSEC  (10)                // ブロックを書き出す周期 ( msec )
+#define AIO_STRESS      (4 * 1024 * 1024)   // 負荷の子プロセスが 1 回に書くサイズ ( Byte )
+#define AIO_STRESS_MAX  (64)                // 負荷の子プロセスが書くファイルの最大サイズ ( AIO_STRESS 単位 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static unsigned long long   g_late[AIO_LOOP];   // 周期毎の遅れ ( nsec )
+static unsigned char        g_block[AIO_BLOCK]; // 書き出すブロック
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static pid_t        Stress( const char* path );
+static int          Compare( const void* a, const void* b );
+static void         Run( const char* name, const char* dir, EAppIfAioMode_t mode );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     記録先に負荷をかける子プロセスを起動する。
+ * @attention なし。
+ * @note      SIGTERM を受けるまで AIO_STRESS 毎に書き込みと fsync() を繰り返す。
+ *            ファイルは AIO_STRESS_MAX 回毎に先頭から書き直す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    子プロセスの pid ( -1 : 失敗 )
+ *************************************************************************** */
+static pid_t
+Stress(
+    const char*     path    ///< [in] 負荷用のファイルのパス
+){
+    unsigned char*  buf = NULL;
+    unsigned int    i = 0;
+    int             fd = -1;
+    pid_t           pid = fork();
+
+    if( pid != 0 ){ return pid; }
+
+    fd  = open( path, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    buf = (unsigned char*)malloc( AIO_STRESS );
+    if( fd < 0 || buf == NULL ){ _exit( 1 ); }
+    memset( buf, 0x5A, AIO_STRESS );
+
+    while( 1 )
+    {
+        if( pwrite( fd, buf, AIO_STRESS, (off_t)( i % AIO_STRESS_MAX ) * AIO_STRESS ) < 0 ){ _exit( 1 ); }
+        fsync( fd );
+        i++;
+    }
+}
+
+
+/**************************************************************************//*!
+ * @brief     qsort() の比較関数。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    比較結果
+ *************************************************************************** */
+static int
+Compare(
+    const void*     a,  ///< [in] 値
+    const void*     b   ///< [in] 値
+){
+    unsigned long long  x = *(const unsigned long long*)a;
+    unsigned long long  y = *(const unsigned long long*)b;
+
+    return ( x > y ) - ( x < y );
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 msec 周期でブロックを書き出し、周期の遅れを計る。
+ * @attention なし。
+ * @note      書き出せなかった ( スロットが空いていない ) ブロックは捨てて drop に数える。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*         name,   ///< [in] 計測項目の名前
+    const char*         dir,    ///< [in] ファイルを作るディレクトリ
+    EAppIfAioMode_t     mode    ///< [in] 書き出しの方法
+){
+    SAppIfAioStat_t     start;
+    SAppIfAioStat_t     stat;
+    struct iovec        iov;
+    struct timespec     next;
+    struct timespec     now;
+    char                path[256];
+    char                stress[256];
+    unsigned long long  deadline = 0;
+    unsigned long long  off = 0;
+    unsigned long long  miss = 0;
+    unsigned int        i = 0;
+    int                 fd = -1;
+    pid_t               pid = 0;
+
+    snprintf( path,   sizeof(path),   "%s/bench_aio",        dir );
+    snprintf( stress, sizeof(stress), "%s/bench_aio_stress", dir );
+
+    if( AppIfAio_Open( mode ) == EN_FALSE || AppIfAio_GetMode() != mode )
+    {
+        printf( "%-32s not available \n", name );
+        AppIfAio_Close();
+        return;
+    }
+
+    fd = open( path, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( fd < 0 )
+    {
+        printf( "%-32s open() error : %s \n", name, path );
+        AppIfAio_Close();
+        return;
+    }
+
+    pid = Stress( stress );
+    if( pid < 0 )
+    {
+        printf( "%-32s fork() error \n", name );
+        close( fd );
+        AppIfAio_Close();
+        return;
+    }
+    usleep( 200 * 1000 );   // 負荷が書き戻しを始めるまで待つ
+
+    iov.iov_base = g_block;
+    iov.iov_len  = sizeof(g_block);
+    AppIfAio_GetStat( &start );
+
+    clock_gettime( CLOCK_MONOTONIC, &next );
+    for( i = 0; i < AIO_LOOP; i++ )
+    {
+        next.tv_nsec += AIO_PERIOD;
+        if( next.tv_nsec >= 1000000000L )
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+        deadline = (unsigned long long)next.tv_sec * 1000000000ULL + (unsigned long long)next.tv_nsec;
+
+        if( i % AIO_BLOCK_MSEC == 0 )
+        {
+            g_block[0] = (unsigned char)i;
+            if( AppIfAio_Writev( fd, &iov, 1, off, EN_TRUE ) == EN_TRUE )
+            {
+                off += sizeof(g_block);
+            }
+        }
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        g_late[i] = (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec - deadline;
+        if( g_late[i] >= (unsigned long long)AIO_PERIOD ){ miss++; }
+    }
+
+    kill( pid, SIGTERM );
+    waitpid( pid, NULL, 0 );
+
+    AppIfAio_GetStat( &stat );
+    AppIfAio_Close();
+    close( fd );
+    unlink( path );
+    unlink( stress );
+
+    qsort( g_late, AIO_LOOP, sizeof(g_late[0]), Compare );
+    printf( "%-32s p50 %8.1f us  p99 %8.1f us  max %8.1f us  miss %5llu  drop %4llu  error %llu \n",
+            name,
+            (double)g_late[AIO_LOOP / 2] / 1000.0,
+            (double)g_late[AIO_LOOP * 99 / 100] / 1000.0,
+            (double)g_late[AIO_LOOP - 1] / 1000.0,
+            miss, stat.drop - start.drop, stat.error - start.error );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ブロックの書き出しのベンチマークを実行する。
+ * @attention 実時間で 10 秒ほどかかる。記録先に数百 MB 書き込む。
+ * @note      miss は遅れが 1 周期以上になった回数。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchAio_Run(
+    void
+){
+    const char*     dir = getenv( "BENCH_AIO_PATH" );
+
+    if( dir == NULL ){ dir = "/tmp"; }
+
+    Run( "aio/sync",   dir, EN_AIO_SYNC );
+    Run( "aio/thread", dir, EN_AIO_THREAD );
+    Run( "aio/uring",  dir, EN_AIO_URING );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,300 @@
+/**************************************************************************//*!
+ *  @file           bench_arc.c
+ *  @brief          [BENCH] アーカイブ ( app/if_arc ) のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      /tmp にアーカイブを作り、終了時に削除する。
+ *  @sa             none.
+ *  @note           1 kHz で全 ch を取得した ARC_LOOP 個のレコードを模擬し ( 事前に作っておく )、
+ *                  json ( 1 レコード 1 行 ), rec ( app/if_rec の固定長 ) と比べた圧縮率と、
+ *                  符号化 / 復号の速度を計る。
+ *                      距離センサ, ポテンショメータ : 12 bit の ADC, ゆっくり変わる値 + 数 LSB の雑音
+ *                      BMX055                         : 16 bit, 重力 / 静止 + 雑音
+ *                  時刻は 1 msec 周期に数 usec の揺らぎを加える。
+ *                  読み出した値が書いた値と一致することも確かめる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "../app/if_arc/if_arc.h"
+#include "../app/if_rec/if_rec.h"
+#include "../app/if_ser/if_ser.h"
+
+#define MY_NAME "BEN"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define ARC_PATH        "/tmp/bench_arc"    // アーカイブのパス
+#define ARC_LOOP        (1000000)           // レコード数
+#define ARC_PERIOD      (1000000ULL)        // 周期 ( nsec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SAppIfArcCol_t   g_col;      // 復号したブロック
+static short*           g_raw;      // 模擬したレコードの生値 ( ARC_LOOP * EN_SEN_CH_NUM )
+static unsigned long long*  g_ts;   // 模擬したレコードの時刻 ( ARC_LOOP )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void                 Make( unsigned int i, short* raw, unsigned long long* ts );
+static int                  Noise( int amp );
+static unsigned long long   JsonSize( void );
+static void                 Run( const char* name, unsigned int flags, unsigned long long json );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     -amp から amp までの雑音を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    雑音
+ *************************************************************************** */
+static int
+Noise(
+    int     amp     ///< [in] 振幅
+){
+    return (int)( Bench_Rand() % (unsigned int)( amp * 2 + 1 ) ) - amp;
+}
+
+
+/**************************************************************************//*!
+ * @brief     i 番目のレコードを作る。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Make(
+    unsigned int        i,      ///< [in]  レコードの番号
+    short*              raw,    ///< [out] 生値 ( EN_SEN_CH_NUM 個 )
+    unsigned long long* ts      ///< [out] 時刻 ( nsec )
+){
+    double              t = (double)i / 1000.0;
+    unsigned int        ch = 0;
+
+    for( ch = EN_SEN_CH_DIST_FL; ch <= EN_SEN_CH_DIST_FSR; ch++ )
+    {
+        raw[ch] = (short)( 2048 + 1200 * sin( t * 0.5 + ch ) + Noise( 3 ) );
+    }
+    raw[EN_SEN_CH_PM]     = (short)( 1024 + 512 * sin( t * 0.1 ) + Noise( 2 ) );
+    raw[EN_SEN_CH_ACC_X]  = (short)( Noise( 20 ) );
+    raw[EN_SEN_CH_ACC_Y]  = (short)( Noise( 20 ) );
+    raw[EN_SEN_CH_ACC_Z]  = (short)( 1024 + Noise( 20 ) );
+    raw[EN_SEN_CH_GYRO_X] = (short)( Noise( 10 ) );
+    raw[EN_SEN_CH_GYRO_Y] = (short)( Noise( 10 ) );
+    raw[EN_SEN_CH_GYRO_Z] = (short)( Noise( 10 ) );
+    raw[EN_SEN_CH_MAG_X]  = (short)( 300 + Noise( 4 ) );
+    raw[EN_SEN_CH_MAG_Y]  = (short)( -120 + Noise( 4 ) );
+    raw[EN_SEN_CH_MAG_Z]  = (short)( 450 + Noise( 4 ) );
+    *ts = 1000000000ULL + (unsigned long long)i * ARC_PERIOD + (unsigned long long)( Noise( 3000 ) + 3000 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     同じレコードを json ( 1 レコード 1 行 ) で出力した場合のサイズを求める。
+ * @attention なし。
+ * @note      ch 名をキーに物理量を小数点以下 3 桁で書く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ ( Byte )
+ *************************************************************************** */
+static unsigned long long
+JsonSize(
+    void
+){
+    SAppIfSer_t         ser;
+    const short*        raw = NULL;
+    unsigned long long  size = 0;
+    unsigned int        ch = 0;
+    unsigned int        i = 0;
+
+    AppIfSer_Init( &ser, EN_SER_JSON );
+    for( i = 0; i < ARC_LOOP; i++ )
+    {
+        raw = &g_raw[i * EN_SEN_CH_NUM];
+        AppIfSer_Begin( &ser );
+        AppIfSer_Uint( &ser, "ts", g_ts[i] );
+        for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+        {
+            AppIfSer_Fix( &ser, HalCmn_GetChName( (EHalSensorCh_t)ch ),
+                          raw[ch] * HalCmnHist_Scale( (EHalSensorCh_t)ch ), 3 );
+        }
+        size += AppIfSer_End( &ser );
+    }
+    return size;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き込みと読み出しを計る。
+ * @attention なし。
+ * @note      書き込みは AppIfArc_Close() ( fdatasync() ) までを含む。
+ *            読み出しは全ブロックの復号で、書いた値との比較は含まない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*         name,   ///< [in] 計測項目の名前
+    unsigned int        flags,  ///< [in] APP_IF_ARC_FLAG_*
+    unsigned long long  json    ///< [in] json のサイズ ( Byte )
+){
+    SAppIfArcFile_t     file;
+    unsigned long long  start = 0;
+    unsigned long long  enc = 0;
+    unsigned long long  dec = 0;
+    unsigned long long  blk = 0;
+    unsigned long long  bad = 0;
+    unsigned long long  n = 0;
+    unsigned int        ch = 0;
+    unsigned int        i = 0;
+    char                label[64];
+
+    // 符号化
+    start = HalCmnClock_GetNsec();
+    AppIfArc_Open( ARC_PATH, flags );
+    for( i = 0; i < ARC_LOOP; i++ )
+    {
+        AppIfArc_Write( 0xFFFF, &g_raw[i * EN_SEN_CH_NUM], g_ts[i] );
+    }
+    AppIfArc_Close();
+    enc = HalCmnClock_GetNsec() - start;
+
+    if( AppIfArcReader_Open( &file, ARC_PATH ) == EN_FALSE )
+    {
+        unlink( ARC_PATH );
+        return;
+    }
+
+    // 復号
+    start = HalCmnClock_GetNsec();
+    for( blk = 0; blk < file.idx_num; blk++ )
+    {
+        AppIfArcReader_Read( &file, blk, &g_col );
+    }
+    dec = HalCmnClock_GetNsec() - start;
+
+    // 照合
+    for( blk = 0; blk < file.idx_num; blk++ )
+    {
+        if( AppIfArcReader_Read( &file, blk, &g_col ) == EN_FALSE ){ bad++; continue; }
+        for( i = 0; i < g_col.count && n < ARC_LOOP; i++, n++ )
+        {
+            if( g_col.ts[i] != g_ts[n] ){ bad++; }
+            for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+            {
+                if( g_col.raw[ch][i] != g_raw[n * EN_SEN_CH_NUM + ch] ){ bad++; }
+            }
+        }
+    }
+    if( n != ARC_LOOP ){ bad++; }
+
+    snprintf( label, sizeof(label), "%s/encode", name );
+    Bench_Report( label, ARC_LOOP, enc );
+    snprintf( label, sizeof(label), "%s/decode", name );
+    Bench_Report( label, file.count, dec );
+    printf( "%-32s %12zu Byte %6.2f Byte/rec  ratio json %6.1f x  rec %5.1f x  enc %6.1f MB/s  dec %6.1f MB/s  mismatch %llu \n",
+            name, file.size, (double)file.size / ARC_LOOP,
+            (double)json / (double)file.size,
+            (double)ARC_LOOP * sizeof(SAppIfRecRec_t) / (double)file.size,
+            (double)ARC_LOOP * sizeof(SAppIfRecRec_t) * 1000.0 / (double)enc,
+            (double)ARC_LOOP * sizeof(SAppIfRecRec_t) * 1000.0 / (double)dec,
+            bad );
+
+    AppIfArcReader_Close( &file );
+    unlink( ARC_PATH );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     アーカイブのベンチマークを実行する。
+ * @attention なし。
+ * @note      速度 ( MB/s ) は rec の固定長レコードに換算したサイズで求める。
+ *            LZ4 は HAVE_LZ4 を定義してビルドした場合だけ計る。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchArc_Run(
+    void
+){
+    unsigned long long  json = 0;
+    unsigned int        i = 0;
+
+    g_raw = (short*)malloc( sizeof(short) * EN_SEN_CH_NUM * ARC_LOOP );
+    g_ts  = (unsigned long long*)malloc( sizeof(unsigned long long) * ARC_LOOP );
+    if( g_raw == NULL || g_ts == NULL )
+    {
+        DBG_PRINT_ERROR( "malloc() error. \n\r" );
+        goto end;
+    }
+    for( i = 0; i < ARC_LOOP; i++ )
+    {
+        Make( i, &g_raw[i * EN_SEN_CH_NUM], &g_ts[i] );
+    }
+
+    json = JsonSize();
+    printf( "%-32s %12llu Byte %6.2f Byte/rec \n", "arc/json", json, (double)json / ARC_LOOP );
+    printf( "%-32s %12llu Byte %6.2f Byte/rec \n", "arc/rec",
+            (unsigned long long)ARC_LOOP * sizeof(SAppIfRecRec_t), (double)sizeof(SAppIfRecRec_t) );
+
+    Run( "arc/delta", 0, json );
+#ifdef HAVE_LZ4
+    Run( "arc/delta+lz4", APP_IF_ARC_FLAG_LZ4, json );
+#endif
+
+end :
+    free( g_raw );
+    free( g_ts );
+    g_raw = NULL;
+    g_ts  = NULL;
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,465 @@
+/**************************************************************************//*!
+ *  @file           bench_cyclic.c
+ *  @brief          [BENCH] 周期的な読み出しの遅れ ( レイテンシ, ジッタ ) のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      SCHED_FIFO, mlockall() には権限 ( CAP_SYS_NICE, CAP_IPC_LOCK ) が必要。
+ *  @sa             bench_hdr.c, main.c の Run_Repeat()
+ *  @note           cyclictest と同じく、絶対時刻で周期的に起床してセンサを読み出し、レコードを出力する。
+ *                  次の 3 つを HDR ヒストグラムに数え、Bench_ReportDist() と同じ書式で出力する。
+ *                      cyclic/wakeup : 起床の遅れ ( 予定の時刻から clock_nanosleep() が戻るまで )
+ *                      cyclic/xfer   : 1 回の転送時間 ( センサ変数の ts_end - ts_start )
+ *                      cyclic/e2e    : 最初の転送の開始から、レコードを書き終えるまで
+ *                  設定は環境変数で行う。
+ *                      BENCH_CYCLIC_PERIOD_US : 周期 ( usec, 既定 1000 )
+ *                      BENCH_CYCLIC_SEC       : 実行時間 ( sec, 既定 10 )
+ *                      BENCH_CYCLIC_SENSOR    : dist ( 既定, 4 ch ), pm, acc
+ *                      BENCH_CYCLIC_PRIO      : SCHED_FIFO の優先度 ( 1 - 99, 既定 0 = SCHED_OTHER )
+ *                      BENCH_CYCLIC_CPU       : 実行する CPU ( 既定 -1 = 指定しない )
+ *                      BENCH_CYCLIC_LOAD      : 負荷をかけるスレッドの数 ( 既定 0 )
+ *                      BENCH_HAL_DEV          : real の場合は実際のデバイスを使う ( 既定はエミュレータ )
+ *                  負荷のスレッドは SCHED_OTHER でメモリを書き続ける。CPU を指定した場合は同じ CPU で動かす。
+ *                  レコードは json で /dev/null に書く。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#define _GNU_SOURCE     // CPU_SET(), pthread_setaffinity_np()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "bench.h"
+#include "../hal/hal.h"
+#include "../app/if_ser/if_ser.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define CYCLIC_NSEC_PER_SEC     (1000000000ULL)
+#define CYCLIC_CH_MAX           (4)             // 1 周期で読み出すセンサ変数の最大数
+#define CYCLIC_LOAD_MAX         (16)            // 負荷をかけるスレッドの最大数
+#define CYCLIC_LOAD_SIZE        (1024 * 1024)   // 負荷のスレッドが書き込む領域の大きさ ( キャッシュを追い出す )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 読み出すセンサ
+typedef struct {
+    const char*     name;       // BENCH_CYCLIC_SENSOR で指定する名前
+    const char*     sensor;     // レコードの "sensor"
+    unsigned int    num;        // 1 周期で読み出すセンサ変数の数
+    const char*     key[CYCLIC_CH_MAX];
+    void            (*get)( SHalSensor_t** data );
+} SBenchCyclicSensor_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SBenchHdr_t          g_wakeup;           // 起床の遅れ
+static SBenchHdr_t          g_xfer;             // 転送時間
+static SBenchHdr_t          g_e2e;              // 転送の開始から出力まで
+static SAppIfSer_t          g_ser;              // json のシリアライザ
+static volatile int         g_stop = 0;         // 1 : 負荷のスレッドを止める
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static long         Env( const char* name, long def );
+static void         GetDist( SHalSensor_t** data );
+static void         GetPm( SHalSensor_t** data );
+static void         GetAcc( SHalSensor_t** data );
+static void         Output( const SBenchCyclicSensor_t* sen, SHalSensor_t** data, int fd );
+static void*        Load( void* arg );
+static void         Loop( const SBenchCyclicSensor_t* sen, unsigned long long period, unsigned long long num, int fd );
+
+
+// 読み出すセンサの一覧
+static const SBenchCyclicSensor_t   g_sensor[] = {
+    { "dist", "sa_dist", 4, { "fl", "fr", "fsl", "fsr" }, GetDist },
+    { "pm",   "sa_pm",   1, { "pm" },                     GetPm   },
+    { "acc",  "acc",     3, { "x", "y", "z" },            GetAcc  },
+    { NULL,   NULL,      0, { NULL },                     NULL    },  // termination
+};
+
+
+
+
+/**************************************************************************//*!
+ * @brief     環境変数を整数で返す。
+ * @attention なし。
+ * @note      設定されていない場合は def を返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    値
+ *************************************************************************** */
+static long
+Env(
+    const char*     name,   ///< [in] 環境変数の名前
+    long            def     ///< [in] 既定値
+){
+    const char*     str = getenv( name );
+
+    return ( str != NULL && *str != '\0' ) ? strtol( str, NULL, 10 ) : def;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ ( FL, FR, FSL, FSR ) を読み出す。
+ * @attention なし。
+ * @note      Run_Sa_Dist() と同じ順。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+GetDist(
+    SHalSensor_t**  data    ///< [out] センサ変数
+){
+    data[0] = HalSensorDist_GetFL();
+    data[1] = HalSensorDist_GetFR();
+    data[2] = HalSensorDist_GetFSL();
+    data[3] = HalSensorDist_GetFSR();
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     圧力センサを読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+GetPm(
+    SHalSensor_t**  data    ///< [out] センサ変数
+){
+    data[0] = HalSensorPm_Get();
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     加速度センサ ( 3 軸 ) を読み出す。
+ * @attention なし。
+ * @note      1 回の転送で 3 軸を読むので、3 軸の転送時間は同じ。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+GetAcc(
+    SHalSensor_t**  data    ///< [out] センサ変数
+){
+    data[0] = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X );
+    data[1] = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Y );
+    data[2] = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Z );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     読み出した値と転送の時刻を json のレコードで出力する。
+ * @attention なし。
+ * @note      {"sensor":"sa_dist","raw":{"fl":123,...},"ts":{"fl":[start,end],...}}
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Output(
+    const SBenchCyclicSensor_t* sen,    ///< [in] 読み出したセンサ
+    SHalSensor_t**              data,   ///< [in] センサ変数
+    int                         fd      ///< [in] 出力先
+){
+    unsigned int    i = 0;
+
+    AppIfSer_Begin( &g_ser );
+    AppIfSer_Str( &g_ser, "sensor", sen->sensor );
+    AppIfSer_ObjBegin( &g_ser, "raw" );
+    for( i = 0; i < sen->num; i++ ){ AppIfSer_Int( &g_ser, sen->key[i], data[i]->raw ); }
+    AppIfSer_ObjEnd( &g_ser );
+    AppIfSer_ObjBegin( &g_ser, "ts" );
+    for( i = 0; i < sen->num; i++ )
+    {
+        AppIfSer_ArrBegin( &g_ser, sen->key[i] );
+        AppIfSer_Uint( &g_ser, NULL, HalCmnClock_Export( data[i]->ts_start ) );
+        AppIfSer_Uint( &g_ser, NULL, HalCmnClock_Export( data[i]->ts_end ) );
+        AppIfSer_ArrEnd( &g_ser );
+    }
+    AppIfSer_ObjEnd( &g_ser );
+    if( AppIfSer_End( &g_ser ) > 0 )
+    {
+        AppIfSer_Write( &g_ser, fd );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     負荷をかけるスレッド
+ * @attention なし。
+ * @note      g_stop が 1 になるまで CYCLIC_LOAD_SIZE の領域を書き続ける。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    NULL
+ *************************************************************************** */
+static void*
+Load(
+    void*           arg     ///< [in] 未使用
+){
+    unsigned char*  buf = malloc( CYCLIC_LOAD_SIZE );
+    unsigned int    i = 0;
+
+    (void)arg;
+    if( buf == NULL )
+    {
+        return NULL;
+    }
+
+    while( g_stop == 0 )
+    {
+        memset( buf, (int)( i++ & 0xFF ), CYCLIC_LOAD_SIZE );
+    }
+
+    free( buf );
+    return NULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     周期的に読み出し、遅れをヒストグラムに数える。
+ * @attention なし。
+ * @note      周期は開始時刻を基準にするので、遅れが積み重ならない ( Run_Repeat() と同じ )。
+ *            起床が 1 周期以上遅れた回数を miss として表示する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Loop(
+    const SBenchCyclicSensor_t* sen,    ///< [in] 読み出すセンサ
+    unsigned long long          period, ///< [in] 周期 ( nsec )
+    unsigned long long          num,    ///< [in] 周期の数
+    int                         fd      ///< [in] 出力先
+){
+    SHalSensor_t*       data[CYCLIC_CH_MAX];
+    struct timespec     next;
+    struct timespec     now;
+    unsigned long long  deadline = 0;
+    unsigned long long  wake = 0;
+    unsigned long long  miss = 0;
+    unsigned long long  n = 0;
+    unsigned int        i = 0;
+
+    BenchHdr_Init( &g_wakeup );
+    BenchHdr_Init( &g_xfer );
+    BenchHdr_Init( &g_e2e );
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    deadline = (unsigned long long)now.tv_sec * CYCLIC_NSEC_PER_SEC + (unsigned long long)now.tv_nsec;
+    for( n = 0; n < num; n++ )
+    {
+        deadline += period;
+        next.tv_sec  = (time_t)( deadline / CYCLIC_NSEC_PER_SEC );
+        next.tv_nsec = (long)( deadline % CYCLIC_NSEC_PER_SEC );
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        wake = (unsigned long long)now.tv_sec * CYCLIC_NSEC_PER_SEC + (unsigned long long)now.tv_nsec;
+        wake = ( wake > deadline ) ? wake - deadline : 0;
+        BenchHdr_Add( &g_wakeup, wake );
+        if( wake >= period ){ miss++; }
+
+        sen->get( data );
+        for( i = 0; i < sen->num; i++ )
+        {
+            BenchHdr_Add( &g_xfer, data[i]->ts_end - data[i]->ts_start );
+        }
+
+        Output( sen, data, fd );
+        BenchHdr_Add( &g_e2e, HalCmnClock_GetNsec() - data[0]->ts_start );
+    }
+
+    BenchHdr_Report( "cyclic/wakeup", &g_wakeup );
+    BenchHdr_Report( "cyclic/xfer",   &g_xfer );
+    BenchHdr_Report( "cyclic/e2e",    &g_e2e );
+    printf( "%-32s miss %llu / %llu \n", "cyclic/miss", miss, num );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     周期的な読み出しのベンチマークを実行する。
+ * @attention 実時間で BENCH_CYCLIC_SEC 秒 ( 既定 10 秒 ) かかる。
+ * @note      SCHED_FIFO, CPU の指定に失敗した場合は表示して、そのまま続ける。
+ *            終了時にスケジューリング, CPU の指定, 入出力の手段を元に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchCyclic_Run(
+    void
+){
+    const char*                 dev = getenv( "BENCH_HAL_DEV" );
+    const char*                 name = getenv( "BENCH_CYCLIC_SENSOR" );
+    const SBenchCyclicSensor_t* sen = &g_sensor[0];
+    int                         real = ( dev != NULL && 0 == strcmp( dev, "real" ) ) ? 1 : 0;
+    long                        periodUs = Env( "BENCH_CYCLIC_PERIOD_US", 1000 );
+    long                        sec = Env( "BENCH_CYCLIC_SEC", 10 );
+    long                        prio = Env( "BENCH_CYCLIC_PRIO", 0 );
+    long                        cpu = Env( "BENCH_CYCLIC_CPU", -1 );
+    long                        load = Env( "BENCH_CYCLIC_LOAD", 0 );
+    pthread_t                   self = pthread_self();
+    pthread_t                   th[CYCLIC_LOAD_MAX];
+    struct sched_param          sp;
+    struct sched_param          spOrg;
+    int                         policyOrg = SCHED_OTHER;
+    cpu_set_t                   set;
+    cpu_set_t                   setOrg;
+    int                         locked = 0;
+    int                         fd = -1;
+    int                         res = 0;
+    long                        i = 0;
+    long                        loadNum = 0;
+
+    if( name != NULL )
+    {
+        for( sen = &g_sensor[0]; sen->name != NULL; sen++ )
+        {
+            if( 0 == strcmp( name, sen->name ) ){ break; }
+        }
+        if( sen->name == NULL )
+        {
+            printf( "%-32s invalid sensor \"%s\" \n", "cyclic/config", name );
+            return;
+        }
+    }
+    if( periodUs <= 0 || sec <= 0 || prio < 0 || prio > 99 || load < 0 || load > CYCLIC_LOAD_MAX )
+    {
+        printf( "%-32s invalid argument \n", "cyclic/config" );
+        return;
+    }
+    printf( "%-32s sensor %s period %ld us sec %ld prio %ld cpu %ld load %ld \n",
+            "cyclic/config", sen->name, periodUs, sec, prio, cpu, load );
+
+    fd = open( "/dev/null", O_WRONLY );
+    if( fd < 0 )
+    {
+        printf( "%-32s fail to open /dev/null \n", "cyclic/config" );
+        return;
+    }
+
+    // デバイス
+    if( real == 0 )
+    {
+        HalCmnSpi_SetOps( HalCmnSpiSim_GetOps() );
+        HalCmnI2c_SetOps( HalCmnI2cSim_GetOps() );
+        HalCmnGpio_SetOps( HalCmnGpioSim_GetOps() );
+    }
+    HalCmnHist_Init();
+    HalCmnFilter_Init();
+    HalCmnTrack_Init();
+    HalCmnGpio_Init();
+    HalCmnI2c_Init();
+    HalCmnSpi_Init();
+    if( sen->get == GetAcc ){ HalSensorBmx055_Init(); }
+    HalSensorPm_Init();
+    HalSensorDist_Init();
+    AppIfSer_Init( &g_ser, EN_SER_JSON );
+
+    // CPU の指定
+    pthread_getaffinity_np( self, sizeof(setOrg), &setOrg );
+    CPU_ZERO( &set );
+    if( cpu >= 0 )
+    {
+        CPU_SET( (int)cpu, &set );
+        res = pthread_setaffinity_np( self, sizeof(set), &set );
+        if( res != 0 ){ printf( "%-32s affinity error ( %s ) \n", "cyclic/config", strerror( res ) ); }
+    }
+
+    // 負荷
+    g_stop = 0;
+    for( i = 0; i < load; i++ )
+    {
+        if( pthread_create( &th[loadNum], NULL, Load, NULL ) != 0 ){ break; }
+        if( cpu >= 0 ){ pthread_setaffinity_np( th[loadNum], sizeof(set), &set ); }
+        loadNum++;
+    }
+
+    // スケジューリング ( 負荷のスレッドは SCHED_OTHER のまま )
+    pthread_getschedparam( self, &policyOrg, &spOrg );
+    if( prio > 0 )
+    {
+        memset( &sp, 0, sizeof(sp) );
+        sp.sched_priority = (int)prio;
+        res = pthread_setschedparam( self, SCHED_FIFO, &sp );
+        if( res != 0 ){ printf( "%-32s SCHED_FIFO error ( %s ) \n", "cyclic/config", strerror( res ) ); }
+
+        if( mlockall( MCL_CURRENT | MCL_FUTURE ) == 0 ){ locked = 1; }
+        else{ printf( "%-32s mlockall error ( %s ) \n", "cyclic/config", strerror( errno ) ); }
+    }
+
+    Loop( sen, (unsigned long long)periodUs * 1000ULL,
+          (unsigned long long)sec * CYCLIC_NSEC_PER_SEC / ( (unsigned long long)periodUs * 1000ULL ), fd );
+
+    // 元に戻す
+    if( locked != 0 ){ munlockall(); }
+    pthread_setschedparam( self, policyOrg, &spOrg );
+    g_stop = 1;
+    for( i = 0; i < loadNum; i++ )
+    {
+        pthread_join( th[i], NULL );
+    }
+    if( cpu >= 0 ){ pthread_setaffinity_np( self, sizeof(setOrg), &setOrg ); }
+
+    close( fd );
+    HalSensorDist_Fini();
+    HalSensorPm_Fini();
+    if( sen->get == GetAcc ){ HalSensorBmx055_Fini(); }
+    HalCmnSpi_Fini();
+    HalCmnI2c_Fini();
+    HalCmnGpio_Fini();
+    HalCmnHist_Fini();
+    if( real == 0 )
+    {
+        HalCmnSpi_SetOps( NULL );
+        HalCmnI2c_SetOps( NULL );
+        HalCmnGpio_SetOps( NULL );
+    }
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
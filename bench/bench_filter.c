@@ -0,0 +1,151 @@
+/**************************************************************************//*!
+ *  @file           bench_filter.c
+ *  @brief          [BENCH] メディアン / Hampel フィルタのベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           距離センサ 4 ch に交互にサンプルを入力し、1 サンプルあたりの処理時間と、
+ *                  1 kHz x 4 ch で取得した時の CPU 使用率の見積もりを表示する。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+
+#include "bench.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define FILTER_LOOP     (4000000)   // サンプル数 ( 4 ch 合計 )
+#define FILTER_INPUT    (4096)      // 入力データ数 ( 2 のべき乗 )
+#define FILTER_CH       (4)         // ch 数
+#define FILTER_RATE     (1000)      // 1 ch あたりのサンプリング周波数 ( Hz )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static int              g_input[FILTER_INPUT];  // 距離センサの AD 値を模した入力 ( スパイク入り )
+static volatile int     g_sink;                 // 出力の格納先 ( 最適化による削除防止 )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Run( EHalFilter_t mode, unsigned int win );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     フィルタを 4 ch で実行して計測する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    EHalFilter_t    mode,   ///< [in] フィルタの種類
+    unsigned int    win     ///< [in] 窓の大きさ
+){
+    unsigned int        i = 0;
+    unsigned int        reject = 0;
+    unsigned long long  start = 0;
+    unsigned long long  ns = 0;
+    char                name[32];
+    static const char*  modeName[] = { "off", "median", "hampel" };
+
+    for( i = 0; i < FILTER_CH; i++ )
+    {
+        HalCmnFilter_Open( (EHalSensorCh_t)( EN_SEN_CH_DIST_FL + i ), mode, win, 3.0 );
+    }
+
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < FILTER_LOOP; i++ )
+    {
+        g_sink = HalCmnFilter_Apply( (EHalSensorCh_t)( EN_SEN_CH_DIST_FL + ( i & ( FILTER_CH - 1 ) ) ),
+                                     g_input[( i / FILTER_CH ) & ( FILTER_INPUT - 1 )] );
+    }
+    ns = HalCmnClock_GetNsec() - start;
+
+    for( i = 0; i < FILTER_CH; i++ )
+    {
+        reject += HalCmnFilter_GetReject( (EHalSensorCh_t)( EN_SEN_CH_DIST_FL + i ) );
+    }
+
+    snprintf( name, sizeof(name), "filter/%s/%u", modeName[mode], win );
+    Bench_Report( name, FILTER_LOOP, ns );
+    printf( "%-32s %12u rejected %9.4f %% CPU at %d Hz x %d ch \n",
+            "", reject,
+            (double)ns / FILTER_LOOP * FILTER_RATE * FILTER_CH / 1e9 * 100.0,
+            FILTER_RATE, FILTER_CH );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     フィルタのベンチマークを実行する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchFilter_Run(
+    void
+){
+    unsigned int    i = 0;
+
+    // 2000 付近のノイズに、約 1 / 64 の確率で単発のスパイクを加える
+    for( i = 0; i < FILTER_INPUT; i++ )
+    {
+        g_input[i] = 2000 + (int)( Bench_Rand() & 0x1F );
+        if( ( Bench_Rand() & 0x3F ) == 0 )
+        {
+            g_input[i] += 1500;
+        }
+    }
+
+    HalCmnFilter_Init();
+
+    Run( EN_FILTER_OFF,    HAL_FILTER_WIN_MIN );
+    Run( EN_FILTER_MEDIAN, 3 );
+    Run( EN_FILTER_MEDIAN, 7 );
+    Run( EN_FILTER_MEDIAN, 15 );
+    Run( EN_FILTER_HAMPEL, 3 );
+    Run( EN_FILTER_HAMPEL, 7 );
+    Run( EN_FILTER_HAMPEL, 15 );
+
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
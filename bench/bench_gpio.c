@@ -0,0 +1,191 @@
+/**************************************************************************//*!
+ *  @file           bench_gpio.c
+ *  @brief          [BENCH] GPIO ( エミュレータ ) 経由の LED の出力のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             hal/hal_cmn_gpio_sim.c
+ *  @note           1 回の出力あたりの処理時間と GPIO に書き込んだ回数を計る。
+ *                      gpio/write : HalCmnGpio_Write() で 1 ピンを反転する
+ *                      led/set    : HalLed_Set() で 4 個の LED を出力する
+ *                  計る前に、書き込みの記録、SW の入力 ( すぐに変える / 時刻を予約する )、
+ *                  EN_METRIC_GPIO_WRITES が一致することを確かめる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define GPIO_LOOP       (1000000)   // 出力の回数
+#define GPIO_PIN_LED0   (14)        // hal_drv_led.c の LED0_OUT
+#define GPIO_PIN_SW0    (16)        // hal_drv_pushsw.c の PUSH_SW0_IN
+#define GPIO_PIN_SW1    (20)        // hal_drv_pushsw.c の PUSH_SW1_IN
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static unsigned long long   Writes( void );
+static unsigned int         Verify( void );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     EN_METRIC_GPIO_WRITES を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    GPIO に書き込んだ回数
+ *************************************************************************** */
+static unsigned long long
+Writes(
+    void
+){
+    SHalMetric_t        m;
+
+    HalCmnMetric_Get( &m );
+    return m.count[EN_METRIC_GPIO_WRITES];
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き込みの記録と SW の入力が期待通りか確かめる。
+ * @attention SW の読み出しはチャタリング防止で 150 msec 待つ。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    一致しなかった数
+ *************************************************************************** */
+static unsigned int
+Verify(
+    void
+){
+    static const unsigned int   pin[4] = { 14, 15, 23, 24 };
+    SHalGpioEvent_t             ev[4];
+    unsigned long long          count = HalCmnGpioSim_GetCount();
+    unsigned long long          writes = Writes();
+    unsigned long long          now = 0;
+    unsigned int                bad = 0;
+    unsigned int                i = 0;
+
+    // LED ( 0101b ) : 4 ピンの書き込みが順に記録される
+    HalLed_Set( 0x05 );
+    if( HalCmnGpioSim_GetLog( ev, 4 ) != 4 ){ bad++; }
+    for( i = 0; i < 4; i++ )
+    {
+        if( ev[i].pin != pin[i] ){ bad++; }
+        if( ev[i].level != ( ( i % 2 == 0 ) ? EN_HIGH : EN_LOW ) ){ bad++; }
+        if( i > 0 && ev[i].ts < ev[i - 1].ts ){ bad++; }
+    }
+    if( HalCmnGpioSim_GetCount() - count != 4 ){ bad++; }
+    if( Writes() - writes != 4 ){ bad++; }
+
+    // SW0 : すぐに押下 ( Active-Low ) にする
+    if( HalPushSw_Get( EN_PUSH_SW_0 ) != EN_FALSE ){ bad++; }
+    HalCmnGpioSim_SetInput( GPIO_PIN_SW0, EN_LOW );
+    if( HalPushSw_Get( EN_PUSH_SW_0 ) != EN_TRUE ){ bad++; }
+    HalCmnGpioSim_SetInput( GPIO_PIN_SW0, EN_HIGH );
+
+    // SW1 : 2 msec 後に押下し、4 msec 後に離す
+    now = HalCmnClock_GetNsec();
+    HalCmnGpioSim_Inject( GPIO_PIN_SW1, EN_HIGH, now + 4000000 );
+    HalCmnGpioSim_Inject( GPIO_PIN_SW1, EN_LOW,  now + 2000000 );
+    if( HalCmnGpio_Read( GPIO_PIN_SW1 ) != EN_HIGH ){ bad++; }
+    while( HalCmnClock_GetNsec() < now + 3000000 );
+    if( HalCmnGpio_Read( GPIO_PIN_SW1 ) != EN_LOW ){ bad++; }
+    while( HalCmnClock_GetNsec() < now + 5000000 );
+    if( HalCmnGpio_Read( GPIO_PIN_SW1 ) != EN_HIGH ){ bad++; }
+
+    return bad;
+}
+
+
+/**************************************************************************//*!
+ * @brief     GPIO のベンチマークを実行する。
+ * @attention なし。
+ * @note      終了時に入出力の手段を元に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchGpio_Run(
+    void
+){
+    unsigned long long  start = 0;
+    unsigned long long  writes = 0;
+    unsigned int        i = 0;
+
+    HalCmnGpio_SetOps( HalCmnGpioSim_GetOps() );
+    HalCmnGpio_Init();
+    HalLed_Init();
+    HalPushSw_Init();
+
+    printf( "%-32s mismatch %u \n", "gpio/verify", Verify() );
+
+    writes = Writes();
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < GPIO_LOOP; i++ )
+    {
+        HalCmnGpio_Write( GPIO_PIN_LED0, ( i & 1 ) ? EN_HIGH : EN_LOW );
+    }
+    Bench_Report( "gpio/write", GPIO_LOOP, HalCmnClock_GetNsec() - start );
+    printf( "%-32s %12.2f writes/op \n", "gpio/write", (double)( Writes() - writes ) / GPIO_LOOP );
+
+    writes = Writes();
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < GPIO_LOOP; i++ )
+    {
+        HalLed_Set( (unsigned char)i );
+    }
+    Bench_Report( "led/set", GPIO_LOOP, HalCmnClock_GetNsec() - start );
+    printf( "%-32s %12.2f writes/op \n", "led/set", (double)( Writes() - writes ) / GPIO_LOOP );
+
+    HalLed_Set( 0 );
+    HalPushSw_Fini();
+    HalLed_Fini();
+    HalCmnGpio_Fini();
+    HalCmnGpio_SetOps( NULL );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,539 @@
+/**************************************************************************//*!
+ *  @file           bench_hal.c
+ *  @brief          [BENCH] センサの読み出しと出力の経路の 1 回毎の処理時間 ( 分布 ) のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             hal/hal_cmn_spi_sim.c, hal/hal_cmn_i2c_sim.c, hal/hal_cmn_gpio_sim.c
+ *  @note           main.c の各コマンドが呼ぶ API を 1 回ずつ計り、min, p50, p99, max を出力する。
+ *                      clock/overhead      : 時刻を 2 回読むだけ ( 計測自体の処理時間 )
+ *                      spi/mcp3208_get     : HalCmnSpiMcp3208_Get()
+ *                      dist/get_fl - fsr   : HalSensorDist_GetFL() - HalSensorDist_GetFSR()
+ *                      pm/get              : HalSensorPm_Get()
+ *                      bmx055/get_acc ...  : HalSensorBmx055_GetAcc(), GetGyro(), GetMag()
+ *                      cmn/update_sen_data : HalCmn_UpdateSenData()
+ *                      lcd/printf          : AppIfLcd_Printf() ( 1 行 )
+ *                      json/sa_pm, sa_dist : main.c と同じレコードを作り /dev/null に書く
+ *                  既定ではエミュレータ ( 既定のクロック ) を使う。
+ *                  環境変数 BENCH_HAL_DEV=real の場合は実際のデバイスを使う。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "../hal/hal.h"
+#include "../app/if_lcd/if_lcd.h"
+#include "../app/if_ser/if_ser.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define HAL_LOOP        (10000)     // 1 項目の計測回数 ( 速い経路 )
+#define HAL_LOOP_I2C    (1000)      // 1 項目の計測回数 ( I2C の経路 )
+#define HAL_WARMUP      (10)        // 計る前に実行する回数
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+typedef struct {
+    const char*     name;       // 計測項目の名前
+    void            (*func)( void );
+    unsigned int    loop;       // 計測回数
+} SBenchHal_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static unsigned long long   g_ns[HAL_LOOP];     // 1 回毎の処理時間
+static volatile int         g_sink;             // 最適化で読み出しを消さないための書き込み先
+static SHalSensor_t         g_data;             // HalCmn_UpdateSenData() の対象
+static SAppIfSer_t          g_ser;              // json のシリアライザ
+static int                  g_fd = -1;          // json の出力先 ( /dev/null )
+static SHalSensor_t*        g_pm;               // 圧力センサのセンサ変数
+static SHalSensor_t*        g_dist[4];          // 距離センサ ( FL, FR, FSL, FSR ) のセンサ変数
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void Nop( void );
+static void SpiGet( void );
+static void DistFL( void );
+static void DistFR( void );
+static void DistFSL( void );
+static void DistFSR( void );
+static void PmGet( void );
+static void AccGet( void );
+static void GyroGet( void );
+static void MagGet( void );
+static void Update( void );
+static void LcdPrintf( void );
+static void SerTime( const char* key, SHalSensor_t* data );
+static void JsonPm( void );
+static void JsonDist( void );
+static void Run( const char* name, void (*func)( void ), unsigned int loop );
+
+
+// 計測項目
+static const SBenchHal_t    g_item[] = {
+    { "clock/overhead",         Nop,        HAL_LOOP     },
+    { "spi/mcp3208_get",        SpiGet,     HAL_LOOP     },
+    { "dist/get_fl",            DistFL,     HAL_LOOP     },
+    { "dist/get_fr",            DistFR,     HAL_LOOP     },
+    { "dist/get_fsl",           DistFSL,    HAL_LOOP     },
+    { "dist/get_fsr",           DistFSR,    HAL_LOOP     },
+    { "pm/get",                 PmGet,      HAL_LOOP     },
+    { "bmx055/get_acc",         AccGet,     HAL_LOOP_I2C },
+    { "bmx055/get_gyro",        GyroGet,    HAL_LOOP_I2C },
+    { "bmx055/get_mag",         MagGet,     HAL_LOOP_I2C },
+    { "cmn/update_sen_data",    Update,     HAL_LOOP     },
+    { "lcd/printf",             LcdPrintf,  HAL_LOOP_I2C },
+    { "json/sa_pm",             JsonPm,     HAL_LOOP     },
+    { "json/sa_dist",           JsonDist,   HAL_LOOP     },
+    { NULL,                     NULL,       0            },  // termination
+};
+
+
+
+
+/**************************************************************************//*!
+ * @brief     何もしない ( 計測自体の処理時間を計る )。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Nop(
+    void
+){
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     MCP3208 の Ch 0 を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SpiGet(
+    void
+){
+    g_sink = (int)HalCmnSpiMcp3208_Get( EN_MCP3208_CH_0 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ ( FL ) を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+DistFL(
+    void
+){
+    g_sink = HalSensorDist_GetFL()->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ ( FR ) を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+DistFR(
+    void
+){
+    g_sink = HalSensorDist_GetFR()->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ ( FSL ) を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+DistFSL(
+    void
+){
+    g_sink = HalSensorDist_GetFSL()->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ ( FSR ) を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+DistFSR(
+    void
+){
+    g_sink = HalSensorDist_GetFSR()->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     圧力センサを読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+PmGet(
+    void
+){
+    g_sink = HalSensorPm_Get()->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     加速度センサ ( 3 軸 ) を読み出す。
+ * @attention なし。
+ * @note      1 回の呼び出しで 3 軸分を転送する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+AccGet(
+    void
+){
+    g_sink = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X )->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ジャイロセンサ ( 3 軸 ) を読み出す。
+ * @attention なし。
+ * @note      1 回の呼び出しで 3 軸分を転送する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+GyroGet(
+    void
+){
+    g_sink = HalSensorBmx055_GetGyro( EN_SEN_BMX055_X )->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     磁気センサ ( 3 軸 ) を読み出す。
+ * @attention なし。
+ * @note      1 回の呼び出しで 3 軸分を転送する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+MagGet(
+    void
+){
+    g_sink = HalSensorBmx055_GetMag( EN_SEN_BMX055_X )->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサ変数を更新する。
+ * @attention なし。
+ * @note      生値は擬似乱数 ( 12 bit )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Update(
+    void
+){
+    int     raw = (int)( Bench_Rand() & 0x0FFF );
+
+    HalCmn_UpdateSenData( &g_data, raw, (double)raw * 0.1 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     LCD の 2 行目に書式付きで表示する。
+ * @attention なし。
+ * @note      Run_Sa_Pm() と同じ表示。カーソルの移動は計る範囲に含める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+LcdPrintf(
+    void
+){
+    AppIfLcd_CursorSet( 0, 1 );
+    AppIfLcd_Printf( "%3d %%", HalCmn_GetSenRate( HalSensorPm_Get() ) );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     転送の開始時刻と終了時刻を配列で追加する。
+ * @attention なし。
+ * @note      main.c の SerTime() の時刻の基準が monotonic の場合と同じ。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SerTime(
+    const char*     key,    ///< [in] キー
+    SHalSensor_t*   data    ///< [in] センサ変数
+){
+    AppIfSer_ArrBegin( &g_ser, key );
+    AppIfSer_Uint( &g_ser, NULL, HalCmnClock_Export( data->ts_start ) );
+    AppIfSer_Uint( &g_ser, NULL, HalCmnClock_Export( data->ts_end ) );
+    AppIfSer_ArrEnd( &g_ser );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     圧力センサのレコードを json で出力する。
+ * @attention センサは読み出さない ( 最後に読んだ値を使う )。
+ * @note      Run_Sa_Pm() と同じレコード。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+JsonPm(
+    void
+){
+    SHalSensor_t*   data = g_pm;
+
+    AppIfSer_Begin( &g_ser );
+    AppIfSer_Str( &g_ser, "sensor", "sa_pm" );
+    AppIfSer_Str( &g_ser, "unit",   "%" );
+    AppIfSer_Int( &g_ser, "value",  HalCmn_GetSenRate( data ) );
+    SerTime( "ts", data );
+    if( AppIfSer_End( &g_ser ) > 0 )
+    {
+        AppIfSer_Write( &g_ser, g_fd );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサのレコードを json で出力する。
+ * @attention センサは読み出さない ( 最後に読んだ値を使う )。
+ * @note      Run_Sa_Dist() と同じレコード。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+JsonDist(
+    void
+){
+    static const char*  key[4] = { "fl", "fr", "fsl", "fsr" };
+    SHalSensor_t**      data = g_dist;
+    SHalTrack_t*        track = NULL;
+    unsigned int        i = 0;
+
+    AppIfSer_Begin( &g_ser );
+    AppIfSer_Str( &g_ser, "sensor", "sa_dist" );
+    AppIfSer_Str( &g_ser, "unit",   "%" );
+    AppIfSer_ObjBegin( &g_ser, "value" );
+    for( i = 0; i < 4; i++ ){ AppIfSer_Int( &g_ser, key[i], HalCmn_GetSenRate( data[i] ) ); }
+    AppIfSer_ObjEnd( &g_ser );
+    AppIfSer_ObjBegin( &g_ser, "mm" );
+    for( i = 0; i < 4; i++ ){ AppIfSer_Uint( &g_ser, key[i], data[i]->cur_mm ); }
+    AppIfSer_ObjEnd( &g_ser );
+    AppIfSer_ObjBegin( &g_ser, "reject" );
+    for( i = 0; i < 4; i++ ){ AppIfSer_Uint( &g_ser, key[i], HalCmnFilter_GetReject( (EHalSensorCh_t)( EN_SEN_CH_DIST_FL + i ) ) ); }
+    AppIfSer_ObjEnd( &g_ser );
+    AppIfSer_ObjBegin( &g_ser, "track" );
+    for( i = 0; i < 4; i++ )
+    {
+        track = HalSensorDist_GetTrack( (EHalSensorCh_t)( EN_SEN_CH_DIST_FL + i ) );
+        AppIfSer_ObjBegin( &g_ser, key[i] );
+        AppIfSer_Uint( &g_ser, "valid", ( track->valid == EN_TRUE ) ? 1 : 0 );
+        AppIfSer_Fix( &g_ser, "mm",  track->pos, 1 );
+        AppIfSer_Fix( &g_ser, "vel", track->vel, 1 );
+        AppIfSer_Fix( &g_ser, "ttc", track->ttc, 3 );
+        AppIfSer_ObjEnd( &g_ser );
+    }
+    AppIfSer_ObjEnd( &g_ser );
+    AppIfSer_ObjBegin( &g_ser, "ts" );
+    for( i = 0; i < 4; i++ ){ SerTime( key[i], data[i] ); }
+    AppIfSer_ObjEnd( &g_ser );
+    if( AppIfSer_End( &g_ser ) > 0 )
+    {
+        AppIfSer_Write( &g_ser, g_fd );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     func を 1 回ずつ loop 回計り、分布を出力する。
+ * @attention loop は HAL_LOOP 以下にすること。
+ * @note      計る前に HAL_WARMUP 回実行する ( キャッシュ, フィルタの窓を埋める )。
+ * @sa        Bench_ReportDist()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*         name,   ///< [in] 計測項目の名前
+    void                (*func)( void ),    ///< [in] 計る処理
+    unsigned int        loop    ///< [in] 計測回数
+){
+    unsigned long long  start = 0;
+    unsigned int        i = 0;
+
+    for( i = 0; i < HAL_WARMUP; i++ )
+    {
+        func();
+    }
+
+    for( i = 0; i < loop; i++ )
+    {
+        start = HalCmnClock_GetNsec();
+        func();
+        g_ns[i] = HalCmnClock_GetNsec() - start;
+    }
+    Bench_ReportDist( name, g_ns, loop );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサの読み出しと出力の経路のベンチマークを実行する。
+ * @attention 実際のデバイスを使う場合は、Raspberry Pi 上で権限のあるユーザで実行すること。
+ * @note      BMX055 と LCD の初期化で 2 sec 程度待つ。
+ *            終了時に入出力の手段を元に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchHal_Run(
+    void
+){
+    const char*     dev = getenv( "BENCH_HAL_DEV" );
+    int             real = ( dev != NULL && 0 == strcmp( dev, "real" ) ) ? 1 : 0;
+    unsigned int    i = 0;
+
+    if( real == 0 )
+    {
+        HalCmnSpi_SetOps( HalCmnSpiSim_GetOps() );
+        HalCmnI2c_SetOps( HalCmnI2cSim_GetOps() );
+        HalCmnGpio_SetOps( HalCmnGpioSim_GetOps() );
+    }
+    printf( "%-32s %s, %s, %s \n", "hal/device",
+            HalCmnSpi_GetOps()->name, HalCmnI2c_GetOps()->name, HalCmnGpio_GetOps()->name );
+
+    g_fd = open( "/dev/null", O_WRONLY );
+    if( g_fd < 0 )
+    {
+        printf( "%-32s fail to open /dev/null \n", "hal/json" );
+        return;
+    }
+
+    HalCmnHist_Init();
+    HalCmnFilter_Init();
+    HalCmnTrack_Init();
+    HalCmnGpio_Init();
+    HalCmnI2c_Init();
+    HalCmnSpi_Init();
+    HalI2cLcd_Init();
+    HalSensorBmx055_Init();
+    HalSensorPm_Init();
+    HalSensorDist_Init();
+    AppIfSer_Init( &g_ser, EN_SER_JSON );
+    g_pm      = HalSensorPm_Get();
+    g_dist[0] = HalSensorDist_GetFL();
+    g_dist[1] = HalSensorDist_GetFR();
+    g_dist[2] = HalSensorDist_GetFSL();
+    g_dist[3] = HalSensorDist_GetFSR();
+    memset( &g_data, 0, sizeof(g_data) );
+
+    for( i = 0; g_item[i].name != NULL; i++ )
+    {
+        Run( g_item[i].name, g_item[i].func, g_item[i].loop );
+    }
+
+    close( g_fd );
+    g_fd = -1;
+    HalSensorDist_Fini();
+    HalSensorPm_Fini();
+    HalSensorBmx055_Fini();
+    HalI2cLcd_Fini();
+    HalCmnSpi_Fini();
+    HalCmnI2c_Fini();
+    HalCmnGpio_Fini();
+    HalCmnHist_Fini();
+    if( real == 0 )
+    {
+        HalCmnSpi_SetOps( NULL );
+        HalCmnI2c_SetOps( NULL );
+        HalCmnGpio_SetOps( NULL );
+    }
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,220 @@
+/**************************************************************************//*!
+ *  @file           bench_hdr.c
+ *  @brief          [BENCH] HDR ( High Dynamic Range ) ヒストグラムを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             bench_cyclic.c
+ *  @note           サンプルを保持せずに、ns から分単位までの値の分布を固定の領域で数える。
+ *                  値 v のバケット ( B = BENCH_HDR_SUB_BITS ) :
+ *                      v < 2^(B+1) : v ( 1 ns 単位 )
+ *                      それ以外    : e = msb( v ) - B, ( e << B ) + ( v >> e )
+ *                  パーセンタイルはバケットの上限の値を返すので、誤差は +1 / 2^B 以下。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "bench.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define HDR_SUB         ( 1ULL << BENCH_HDR_SUB_BITS )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static unsigned int         Index( unsigned long long value );
+static unsigned long long   Upper( unsigned int idx );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     値のバケットを返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        Upper()
+ * @author    Ryoji Morita
+ * @return    バケット
+ *************************************************************************** */
+static unsigned int
+Index(
+    unsigned long long  value   ///< [in] 値
+){
+    unsigned int        e = 0;
+
+    if( value < ( HDR_SUB << 1 ) )
+    {
+        return (unsigned int)value;
+    }
+
+    e = (unsigned int)( 63 - __builtin_clzll( value ) ) - BENCH_HDR_SUB_BITS;
+    return ( e << BENCH_HDR_SUB_BITS ) + (unsigned int)( value >> e );
+}
+
+
+/**************************************************************************//*!
+ * @brief     バケットの上限の値を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        Index()
+ * @author    Ryoji Morita
+ * @return    バケットに入る最大の値
+ *************************************************************************** */
+static unsigned long long
+Upper(
+    unsigned int        idx     ///< [in] バケット
+){
+    unsigned int        e = 0;
+
+    if( idx < ( HDR_SUB << 1 ) )
+    {
+        return idx;
+    }
+
+    e = ( idx >> BENCH_HDR_SUB_BITS ) - 1;
+    return ( ( (unsigned long long)( idx - ( e << BENCH_HDR_SUB_BITS ) ) + 1 ) << e ) - 1;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ヒストグラムを空にする。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchHdr_Init(
+    SBenchHdr_t*        hdr     ///< [out] ヒストグラム
+){
+    memset( hdr, 0, sizeof(*hdr) );
+    hdr->min = ~0ULL;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     値を 1 つ数える。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchHdr_Add(
+    SBenchHdr_t*        hdr,    ///< [in,out] ヒストグラム
+    unsigned long long  value   ///< [in]     値
+){
+    hdr->count[Index( value )]++;
+    hdr->total++;
+    hdr->sum += (double)value;
+    if( value < hdr->min ){ hdr->min = value; }
+    if( value > hdr->max ){ hdr->max = value; }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     パーセンタイルを返す。
+ * @attention サンプルがない場合は 0 を返す。
+ * @note      Bench_ReportDist() と同じく、昇順で total * pct / 100 番目 ( 0 始まり ) のサンプルの
+ *            バケットの上限 ( min, max の範囲に収める )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    パーセンタイルの値
+ *************************************************************************** */
+unsigned long long
+BenchHdr_Get(
+    const SBenchHdr_t*  hdr,    ///< [in] ヒストグラム
+    unsigned int        pct     ///< [in] パーセント ( 0 - 100 )
+){
+    unsigned long long  rank = 0;
+    unsigned long long  sum = 0;
+    unsigned long long  value = 0;
+    unsigned int        i = 0;
+
+    if( hdr->total == 0 )
+    {
+        return 0;
+    }
+
+    rank = hdr->total * pct / 100;
+    if( rank >= hdr->total ){ rank = hdr->total - 1; }
+
+    for( i = Index( hdr->min ); i < BENCH_HDR_NUM; i++ )
+    {
+        sum += hdr->count[i];
+        if( sum > rank )
+        {
+            break;
+        }
+    }
+
+    value = Upper( i );
+    if( value < hdr->min ){ value = hdr->min; }
+    if( value > hdr->max ){ value = hdr->max; }
+    return value;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ヒストグラムの分布 ( min, p50, p99, max, 平均 ) を表示する。
+ * @attention サンプルがない場合は何も表示しない。
+ * @note      Bench_ReportDist() と同じ書式。
+ * @sa        Bench_ReportPct()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchHdr_Report(
+    const char*         name,   ///< [in] 計測項目の名前
+    const SBenchHdr_t*  hdr     ///< [in] ヒストグラム
+){
+    if( hdr->total == 0 )
+    {
+        return;
+    }
+
+    Bench_ReportPct( name, hdr->total, hdr->min, BenchHdr_Get( hdr, 50 ), BenchHdr_Get( hdr, 99 ), hdr->max,
+                     hdr->sum / (double)hdr->total );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
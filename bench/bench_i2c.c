@@ -0,0 +1,301 @@
+/**************************************************************************//*!
+ *  @file           bench_i2c.c
+ *  @brief          [BENCH] I2C ( BMX055, LCD のエミュレータ ) 経由の読み書きのベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             hal/hal_cmn_i2c_sim.c
+ *  @note           同じデータを転送の回数を変えて読み書きし、バスの時間がどれだけ減るかを計る。
+ *                      bmx055/acc/driver   : HalSensorBmx055_GetAcc() ( アドレスを書いて 6 Byte をまとめて読む )
+ *                      bmx055/acc/per-reg  : 6 レジスタを 1 Byte ずつ読む ( 12 回の転送 )
+ *                      lcd/puts/per-char   : HalI2cLcd_Write() で 1 文字ずつ書く ( 16 回の転送 )
+ *                      lcd/puts/burst      : 制御 Byte 0x40 の後に 16 文字を続けて書く ( 1 回の転送 )
+ *                  clock=0 は転送時間を待たない ( ドライバとエミュレータの処理時間 )。
+ *                  計る前に、ドライバで読んだ生値と LCD の表示が模擬信号 / 書いた文字と一致することを確かめる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "../hal/hal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define I2C_LOOP        (200000)    // 待たない場合の繰り返し回数
+#define I2C_LOOP_CLK    (200)       // クロックを模擬する場合の繰り返し回数
+#define I2C_LCD_TEXT    "0123456789ABCDEF"
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static volatile int     g_sink;     // 最適化で読み出しを消さないための書き込み先
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static unsigned int Verify( void );
+static void         RunAcc( void );
+static void         AccPerReg( void );
+static void         LcdPerChar( void );
+static void         LcdBurst( void );
+static void         Run( const char* name, void (*func)( void ), unsigned int hz, unsigned int loop );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     読み出した値と表示が模擬信号 / 書いた文字と一致するか確かめる。
+ * @attention なし。
+ * @note      軸毎に直流 ( 符号を交互に変えた値 ) を設定し、ドライバで読んだ生値と比べる。
+ *            レジスタの設定はドライバの初期化 ( HalSensorBmx055_Init() ) に任せる
+ *            ( 磁気センサは Power Control を 1 にしないと 0 を返す )。
+ *            終わったら模擬信号を初期値に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    一致しなかった数
+ *************************************************************************** */
+static unsigned int
+Verify(
+    void
+){
+    static const int    val[9] = { 100, -200, 1020, 12345, -23456, 77, -1000, 2000, -9000 };
+    SHalSimSig_t        sig;
+    unsigned char       buff[2];
+    unsigned int        bad = 0;
+    unsigned int        i = 0;
+
+    memset( &sig, 0, sizeof(sig) );
+    sig.wave = EN_SIM_WAVE_DC;
+    for( i = 0; i < 9; i++ )
+    {
+        sig.center = val[i];
+        HalCmnI2cSim_SetSignal( (EHalSensorCh_t)( EN_SEN_CH_ACC_X + i ), &sig );
+    }
+
+    HalSensorBmx055_Init();
+
+    for( i = 0; i < 3; i++ )
+    {
+        if( HalSensorBmx055_GetAcc(  (EHalSensorBMX055_t)i )->raw != val[i]     ){ bad++; }
+        if( HalSensorBmx055_GetGyro( (EHalSensorBMX055_t)i )->raw != val[3 + i] ){ bad++; }
+        if( HalSensorBmx055_GetMag(  (EHalSensorBMX055_t)i )->raw != val[6 + i] ){ bad++; }
+    }
+
+    // CHIPID
+    HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_ACC );
+    buff[0] = 0x00;
+    HalCmnI2c_Write( buff, 1 );
+    HalCmnI2c_Read( buff, 1 );
+    if( buff[0] != 0xFA ){ bad++; }
+
+    // 1 行目の先頭と 2 行目 ( DDRAM 0x20 ) の 3 桁目
+    HalCmnI2c_SetSlave( I2C_SLAVE_LCD );
+    HalI2cLcd_Write( EN_LCD_CMD, 0x01 );
+    for( i = 0; i < 3; i++ ){ HalI2cLcd_Write( EN_LCD_DAT, "I2C"[i] ); }
+    HalI2cLcd_Write( EN_LCD_CMD, 0x80 | 0x22 );
+    for( i = 0; i < 3; i++ ){ HalI2cLcd_Write( EN_LCD_DAT, "SIM"[i] ); }
+    if( 0 != strcmp( HalCmnI2cSim_GetLcd( 0 ), "I2C             " ) ){ bad++; }
+    if( 0 != strcmp( HalCmnI2cSim_GetLcd( 1 ), "  SIM           " ) ){ bad++; }
+
+    for( i = 0; i < 9; i++ )
+    {
+        HalCmnI2cSim_SetSignal( (EHalSensorCh_t)( EN_SEN_CH_ACC_X + i ), NULL );
+    }
+    return bad;
+}
+
+
+/**************************************************************************//*!
+ * @brief     加速度センサを HalSensorBmx055_GetAcc() で読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RunAcc(
+    void
+){
+    g_sink = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X )->raw;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     加速度センサのデータレジスタを 1 Byte ずつ読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+AccPerReg(
+    void
+){
+    unsigned char   buff[6];
+    unsigned char   reg = 0;
+
+    HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_ACC );
+    for( reg = 0; reg < 6; reg++ )
+    {
+        buff[reg] = (unsigned char)( 0x02 + reg );
+        HalCmnI2c_Write( &buff[reg], 1 );
+        HalCmnI2c_Read( &buff[reg], 1 );
+    }
+    g_sink = buff[1];
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     LCD の 1 行を 1 文字ずつ書き込む。
+ * @attention なし。
+ * @note      AppIfLcd_Puts() と同じ転送。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+LcdPerChar(
+    void
+){
+    const char*     str = I2C_LCD_TEXT;
+
+    HalCmnI2c_SetSlave( I2C_SLAVE_LCD );
+    HalI2cLcd_Write( EN_LCD_CMD, 0x80 );
+    while( *str != '\0' )
+    {
+        HalI2cLcd_Write( EN_LCD_DAT, *str++ );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     LCD の 1 行を 1 回の転送で書き込む。
+ * @attention なし。
+ * @note      Co = 0, RS = 1 の制御 Byte の後の Byte はすべて文字になる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+LcdBurst(
+    void
+){
+    unsigned char   buff[1 + HAL_SIM_LCD_COLS];
+
+    buff[0] = 0x40;
+    memcpy( &buff[1], I2C_LCD_TEXT, HAL_SIM_LCD_COLS );
+
+    HalCmnI2c_SetSlave( I2C_SLAVE_LCD );
+    HalI2cLcd_Write( EN_LCD_CMD, 0x80 );
+    HalCmnI2c_Write( buff, sizeof(buff) );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     func を loop 回繰り返して計る。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*         name,   ///< [in] 計測項目の名前
+    void                (*func)( void ),    ///< [in] 計る処理
+    unsigned int        hz,     ///< [in] クロック周波数 ( Hz, 0 = 待たない )
+    unsigned int        loop    ///< [in] 繰り返し回数
+){
+    char                str[64];
+    unsigned long long  start = 0;
+    unsigned int        i = 0;
+
+    HalCmnI2cSim_SetClock( hz );
+    if( hz == 0 ){ snprintf( str, sizeof(str), "%s/clock=0", name ); }
+    else         { snprintf( str, sizeof(str), "%s/%ukHz", name, hz / 1000 ); }
+
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < loop; i++ )
+    {
+        func();
+    }
+    Bench_Report( str, loop, HalCmnClock_GetNsec() - start );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     I2C のベンチマークを実行する。
+ * @attention なし。
+ * @note      終了時にクロック周波数と転送手段を元に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchI2c_Run(
+    void
+){
+    static const unsigned int   hz[] = { 0, 100000, 400000 };
+    unsigned int                i = 0;
+    unsigned int                loop = 0;
+
+    HalCmnI2c_SetOps( HalCmnI2cSim_GetOps() );
+    HalCmnI2c_Init();
+    HalCmnI2cSim_SetClock( 0 );
+
+    printf( "%-32s mismatch %u \n", "i2c/verify", Verify() );
+
+    for( i = 0; i < sizeof(hz) / sizeof(hz[0]); i++ )
+    {
+        loop = ( hz[i] == 0 ) ? I2C_LOOP : I2C_LOOP_CLK;
+        Run( "bmx055/acc/driver",  RunAcc,     hz[i], loop );
+        Run( "bmx055/acc/per-reg", AccPerReg,  hz[i], loop );
+        Run( "lcd/puts/per-char",  LcdPerChar, hz[i], loop );
+        Run( "lcd/puts/burst",     LcdBurst,   hz[i], loop );
+    }
+
+    HalCmnI2cSim_SetClock( HAL_SIM_I2C_HZ );
+    HalSensorBmx055_Fini();
+    HalCmnI2c_Fini();
+    HalCmnI2c_SetOps( NULL );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,179 @@
+/**************************************************************************//*!
+ *  @file           bench_log.c
+ *  @brief          [BENCH] DBG_PRINT_* ( app/log ) のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      出力先は /dev/null。
+ *  @sa             none.
+ *  @note           呼び出し元が DBG_PRINT_* 1 回にかかる時間を計る。
+ *                      fprintf : 比較用に従来通りその場で整形して出力するもの
+ *                      async   : リングバッファに積むだけのもの ( 整形はバックグラウンド )
+ *                      off     : 実行時のレベルで除いたもの
+ *                  リングバッファが溢れないよう LOG_BATCH 回毎に AppLog_Flush() で
+ *                  出力を待つ ( 待ち時間は計測に含めない )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define MY_NAME "BEN"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define LOG_LOOP        (200000)        // 出力する回数
+#define LOG_BATCH       (128)           // AppLog_Flush() までに出力する回数 ( リングバッファより少なく )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void     RunFprintf( const char* name, FILE* fp );
+static void     RunLog( const char* name );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     従来の DBG_PRINT_WARN と同じ出力を fprintf() で行う。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RunFprintf(
+    const char*         name,   ///< [in] 計測項目の名前
+    FILE*               fp      ///< [in] 出力先
+){
+    unsigned long long  start = 0;
+    unsigned int        i = 0;
+
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < LOG_LOOP; i++ )
+    {
+        fprintf( fp, "[%s]" DBG_COLOR_BLUE "[WARN] " DBG_COLOR_WHITE " [%s:%d][" DBG_COLOR_GREEN "%s()" DBG_COLOR_WHITE "] "
+                 "ch = %s, raw = %d, val = %f \n\r",
+                 MY_NAME, __FILE__, __LINE__, __FUNCTION__, "acc_x", (int)( i & 0xFFF ), (double)i * 0.001 );
+    }
+    fflush( fp );
+    Bench_Report( name, i, HalCmnClock_GetNsec() - start );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     DBG_PRINT_WARN で出力する。
+ * @attention なし。
+ * @note      LOG_BATCH 回毎の AppLog_Flush() の時間は除く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RunLog(
+    const char*         name    ///< [in] 計測項目の名前
+){
+    unsigned long long  start = 0;
+    unsigned long long  ns = 0;
+    unsigned int        i = 0;
+    unsigned int        j = 0;
+
+    for( i = 0; i < LOG_LOOP; i += LOG_BATCH )
+    {
+        start = HalCmnClock_GetNsec();
+        for( j = i; j < i + LOG_BATCH; j++ )
+        {
+            DBG_PRINT_WARN( "ch = %s, raw = %d, val = %f \n\r", "acc_x", (int)( j & 0xFFF ), (double)j * 0.001 );
+        }
+        ns += HalCmnClock_GetNsec() - start;
+        AppLog_Flush();
+    }
+    Bench_Report( name, i, ns );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     DBG_PRINT_* のベンチマークを実行する。
+ * @attention 実行中はバックグラウンドでの出力先を /dev/null にする。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchLog_Run(
+    void
+){
+    FILE*               fp = NULL;
+    int                 fd = -1;
+    unsigned long long  drop = 0;
+    EAppLogLevel_t      level = (EAppLogLevel_t)g_appLogLevel;
+
+    fp = fopen( "/dev/null", "w" );
+    fd = open( "/dev/null", O_WRONLY | O_CLOEXEC );
+    if( fp == NULL || fd < 0 )
+    {
+        DBG_PRINT_ERROR( "open() error. \n\r" );
+        goto end;
+    }
+
+    RunFprintf( "log/fprintf", fp );
+
+    drop = AppLog_GetDrop();
+    if( AppLog_Init( fd ) == EN_FALSE )
+    {
+        goto end;
+    }
+    RunLog( "log/async" );
+    AppLog_SetLevel( EN_LOG_OFF );
+    RunLog( "log/off" );
+    AppLog_SetLevel( level );
+    AppLog_Fini();
+    printf( "%-32s %12llu records dropped \n", "log/async", AppLog_GetDrop() - drop );
+
+end :
+    if( fp != NULL ){ fclose( fp ); }
+    if( fd >= 0 ){ close( fd ); }
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
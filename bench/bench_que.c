@@ -0,0 +1,268 @@
+/**************************************************************************//*!
+ *  @file           bench_que.c
+ *  @brief          [BENCH] 遅い読み手に対する送信キューのベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           1 msec 周期でレコードをパイプに書き、読み手の速さが周期に与える影響を比べる。
+ *                  読み手は子プロセスで、書き手の半分の速さでしか読まない ( slow ) か、
+ *                  全く読まない ( stall )。
+ *                  基準 ( base ) は読み手を置かずに /dev/null に書き、この環境の起床の遅れだけを計る。
+ *                  周期毎に「予定時刻から書き込みが終わるまで」の遅れ ( late ) と
+ *                  書き込みの処理時間 ( call ) を計り、分布と、基準との差、
+ *                  周期に間に合わなかった回数 ( miss ), 捨てたレコード数 ( drop ) を表示する。
+ *                      block : 従来のブロッキング write()
+ *                      que   : app/if_que のノンブロッキング送信キュー
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "../app/if_que/if_que.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define QUE_LOOP        (1000)      // 周期数 ( 1 msec 周期 )
+#define QUE_PERIOD      (1000000L)  // 周期 ( nsec )
+#define QUE_REC         (200)       // 1 レコードのサイズ ( Byte )
+#define QUE_READ        (2000)      // 読み手が 1 回に読むサイズ ( Byte )
+#define QUE_READ_MSEC   (20)        // 読み手が読む周期 ( msec ) : 100 KB/s ( 書き手の半分 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// 読み手の動作に使用する型
+typedef enum {
+    EN_READER_NONE = 0,     // 読み手を置かずに /dev/null に書く ( 基準 )
+    EN_READER_SLOW,         // 書き手の半分の速さで読む
+    EN_READER_STALL         // 読まない
+} EBenchQueReader_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SAppIfQue_t          g_que;              // 送信キュー
+static unsigned long long   g_late[QUE_LOOP];   // 周期毎の遅れ ( nsec )
+static unsigned long long   g_call[QUE_LOOP];   // 周期毎の書き込みの処理時間 ( nsec )
+static unsigned long long   g_baseP99 = 0;      // 基準の遅れの p99 ( nsec )
+static unsigned long long   g_baseMax = 0;      // 基準の遅れの最大値 ( nsec )
+static unsigned long long   g_baseMiss = 0;     // 基準の miss
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static pid_t        Reader( int fd[2], EBenchQueReader_t mode );
+static void         Run( const char* name, EBenchQueReader_t mode, int useQue, EAppIfQuePolicy_t policy );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     読み手の子プロセスを起動する。
+ * @attention なし。
+ * @note      書き手がパイプを閉じるまで読む ( stall の場合は SIGTERM まで待つ )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    子プロセスの pid ( -1 : 失敗 )
+ *************************************************************************** */
+static pid_t
+Reader(
+    int                 fd[2],  ///< [in] パイプ
+    EBenchQueReader_t   mode    ///< [in] 読み手の動作
+){
+    char                buf[QUE_READ];
+    pid_t               pid = fork();
+
+    if( pid != 0 ){ return pid; }
+
+    // 書き込み側を閉じないと書き手が閉じても EOF にならない
+    close( fd[1] );
+
+    if( mode == EN_READER_STALL )
+    {
+        pause();
+        _exit( 0 );
+    }
+
+    while( read( fd[0], buf, sizeof(buf) ) > 0 )
+    {
+        usleep( QUE_READ_MSEC * 1000 );
+    }
+    _exit( 0 );
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 msec 周期でレコードを書き、周期の遅れを計る。
+ * @attention なし。
+ * @note      レコードは連番を含む固定長のテキスト行。
+ *            base の遅れを基準として保存し、それ以外は基準との差も表示する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*         name,   ///< [in] 計測項目の名前
+    EBenchQueReader_t   mode,   ///< [in] 読み手の動作
+    int                 useQue, ///< [in] 0 : ブロッキング write(), 1 : 送信キュー
+    EAppIfQuePolicy_t   policy  ///< [in] 送信キューのポリシ
+){
+    int                 fd[2];
+    char                rec[QUE_REC];
+    struct timespec     next;
+    struct timespec     now;
+    struct timespec     done;
+    unsigned long long  deadline = 0;
+    unsigned long long  miss = 0;
+    unsigned int        i = 0;
+    pid_t               pid = 0;
+    char                item[64];
+
+    if( mode == EN_READER_NONE )
+    {
+        fd[1] = open( "/dev/null", O_WRONLY );
+        if( fd[1] < 0 )
+        {
+            printf( "%-32s open() error \n", name );
+            return;
+        }
+    } else
+    {
+        if( pipe( fd ) < 0 )
+        {
+            printf( "%-32s pipe() error \n", name );
+            return;
+        }
+        pid = Reader( fd, mode );
+        close( fd[0] );
+        if( pid < 0 )
+        {
+            close( fd[1] );
+            printf( "%-32s fork() error \n", name );
+            return;
+        }
+    }
+
+    if( useQue )
+    {
+        fcntl( fd[1], F_SETFL, fcntl( fd[1], F_GETFL ) | O_NONBLOCK );
+        AppIfQue_Init( &g_que, policy, 0 );
+    }
+
+    memset( rec, 'x', sizeof(rec) );
+    rec[QUE_REC - 1] = '\n';
+
+    clock_gettime( CLOCK_MONOTONIC, &next );
+    for( i = 0; i < QUE_LOOP; i++ )
+    {
+        next.tv_nsec += QUE_PERIOD;
+        if( next.tv_nsec >= 1000000000L )
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+        deadline = (unsigned long long)next.tv_sec * 1000000000ULL + (unsigned long long)next.tv_nsec;
+
+        snprintf( rec, sizeof(rec), "%08u", i );
+        rec[8] = ',';
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        if( useQue )
+        {
+            AppIfQue_Push( &g_que, rec, sizeof(rec) );
+            AppIfQue_Flush( &g_que, fd[1] );
+        } else if( write( fd[1], rec, sizeof(rec) ) < 0 )
+        {
+            break;
+        }
+
+        clock_gettime( CLOCK_MONOTONIC, &done );
+        g_call[i] = (unsigned long long)( done.tv_sec - now.tv_sec ) * 1000000000ULL + (unsigned long long)done.tv_nsec - (unsigned long long)now.tv_nsec;
+        g_late[i] = (unsigned long long)done.tv_sec * 1000000000ULL + (unsigned long long)done.tv_nsec - deadline;
+        if( g_late[i] >= (unsigned long long)QUE_PERIOD ){ miss++; }
+    }
+
+    close( fd[1] );
+    if( mode == EN_READER_STALL ){ kill( pid, SIGTERM ); }
+    if( mode != EN_READER_NONE ){ waitpid( pid, NULL, 0 ); }
+
+    snprintf( item, sizeof(item), "%s/late", name );
+    Bench_ReportDist( item, g_late, i );
+    snprintf( item, sizeof(item), "%s/call", name );
+    Bench_ReportDist( item, g_call, i );
+
+    if( mode == EN_READER_NONE )
+    {
+        g_baseP99  = g_late[i * 99 / 100];
+        g_baseMax  = g_late[i - 1];
+        g_baseMiss = miss;
+        printf( "%32s miss %5llu \n", "", miss );
+        return;
+    }
+
+    // 基準 ( 読み手なし ) との差 : 読み手の速さで増えた遅れ
+    printf( "%32s base p99 %+9.1f us, max %+9.1f us, miss %5llu ( base %llu ), drop %6llu \n",
+            "",
+            ( (double)g_late[i * 99 / 100] - (double)g_baseP99 ) / 1000.0,
+            ( (double)g_late[i - 1] - (double)g_baseMax ) / 1000.0,
+            miss, g_baseMiss,
+            useQue ? g_que.drop : 0ULL );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     送信キューのベンチマークを実行する。
+ * @attention 実時間で 6 秒ほどかかる。
+ * @note      miss は遅れが 1 周期以上になった回数。
+ *            base を最初に実行して基準にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchQue_Run(
+    void
+){
+    Run( "que/base",             EN_READER_NONE,  0, EN_QUE_DROP_OLDEST );
+    Run( "que/block/slow",       EN_READER_SLOW,  0, EN_QUE_DROP_OLDEST );
+    Run( "que/oldest/slow",      EN_READER_SLOW,  1, EN_QUE_DROP_OLDEST );
+    Run( "que/oldest/stall",     EN_READER_STALL, 1, EN_QUE_DROP_OLDEST );
+    Run( "que/newest/stall",     EN_READER_STALL, 1, EN_QUE_DROP_NEWEST );
+    Run( "que/latest/stall",     EN_READER_STALL, 1, EN_QUE_LATEST );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,313 @@
+/**************************************************************************//*!
+ *  @file           bench_rec.c
+ *  @brief          [BENCH] センサ値の記録 ( app/if_rec ) のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      /tmp にセグメントファイルを作り、終了時に削除する。
+ *  @sa             none.
+ *  @note           1 レコードの記録にかかる時間と、1 kHz で記録した時の CPU 使用率を計る。
+ *                  小さいセグメントで記録し、セグメントを切り替えた書き込みの時間も計る。
+ *                      mmap  : app/if_rec ( memcpy + まとめて msync() )
+ *                      write : 比較用に 1 レコード毎に write() するもの
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "../app/if_rec/if_rec.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define REC_PATH        "/tmp/bench_rec"    // セグメントのパスの接頭辞
+#define REC_SEG_MB      (16)                // セグメントの最大サイズ ( MByte )
+#define REC_LOOP        (1000000)           // 記録するレコード数
+#define REC_HZ_LOOP     (2000)              // 1 kHz で記録する周期数
+#define REC_PERIOD      (1000000L)          // 周期 ( nsec )
+#define REC_ROT_MB      (1)                 // 切り替えを計るセグメントの最大サイズ ( MByte )
+#define REC_ROT_NUM     (16)                // 切り替えを計る回数
+#define REC_ROT_GAP     (100)               // 切り替えた後に待つ時間 ( msec )
+#define REC_ROT_CAP     ( ( REC_ROT_MB * 1024 * 1024 - APP_IF_REC_HDR_SIZE ) / sizeof(SAppIfRecRec_t) )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static short                g_raw[EN_SEN_CH_NUM];       // 記録する生値
+static unsigned long long   g_rot[REC_ROT_NUM];         // 切り替えた書き込みの時間 ( nsec )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static unsigned long long   CpuNsec( void );
+static void                 Remove( void );
+static EHalBool_t           Write( int useRec, int fd, unsigned long long ts );
+static void                 RunThroughput( const char* name, int useRec );
+static void                 RunHz( const char* name, int useRec );
+static void                 RunRotate( const char* name );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     プロセスが使った CPU 時間 ( user + sys ) を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    CPU 時間 ( nsec )
+ *************************************************************************** */
+static unsigned long long
+CpuNsec(
+    void
+){
+    struct rusage   ru;
+
+    getrusage( RUSAGE_SELF, &ru );
+    return (unsigned long long)( ru.ru_utime.tv_sec + ru.ru_stime.tv_sec ) * 1000000000ULL
+         + (unsigned long long)( ru.ru_utime.tv_usec + ru.ru_stime.tv_usec ) * 1000ULL;
+}
+
+
+/**************************************************************************//*!
+ * @brief     作成したセグメントファイルを削除する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Remove(
+    void
+){
+    char            name[64];
+    unsigned int    seg = 0;
+
+    for( seg = 0; ; seg++ )
+    {
+        snprintf( name, sizeof(name), "%s.%04u", REC_PATH, seg );
+        if( unlink( name ) < 0 ){ break; }
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 レコードを記録する。
+ * @attention なし。
+ * @note      比較用は app/if_rec と同じ 40 Byte のレコードを write() する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+Write(
+    int                 useRec, ///< [in] 1 : app/if_rec, 0 : write()
+    int                 fd,     ///< [in] 比較用のファイル
+    unsigned long long  ts      ///< [in] 時刻 ( nsec )
+){
+    SAppIfRecRec_t      rec;
+
+    g_raw[EN_SEN_CH_ACC_X] = (short)Bench_Rand();
+    if( useRec )
+    {
+        return AppIfRec_Write( 0xFFFF, g_raw, ts );
+    }
+
+    memset( &rec, 0, sizeof(rec) );
+    rec.ts   = ts;
+    rec.mask = ( 1U << EN_SEN_CH_NUM ) - 1;
+    memcpy( rec.raw, g_raw, sizeof(rec.raw) );
+    return ( write( fd, &rec, sizeof(rec) ) == sizeof(rec) ) ? EN_TRUE : EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     REC_LOOP 個のレコードを続けて記録する。
+ * @attention なし。
+ * @note      時刻は 1 msec 毎に進めるので、msync() は 1 MByte 毎と 1000 レコード毎に起きる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RunThroughput(
+    const char*         name,   ///< [in] 計測項目の名前
+    int                 useRec  ///< [in] 1 : app/if_rec, 0 : write()
+){
+    unsigned long long  start = 0;
+    unsigned long long  ts = 0;
+    unsigned long long  i = 0;
+    int                 fd = -1;
+
+    if( useRec ){ AppIfRec_Open( REC_PATH, REC_SEG_MB, 0 ); }
+    else        { fd = open( REC_PATH ".0000", O_WRONLY | O_CREAT | O_TRUNC, 0644 ); }
+
+    start = HalCmnClock_GetNsec();
+    ts = start;
+    for( i = 0; i < REC_LOOP; i++ )
+    {
+        ts += REC_PERIOD;
+        if( Write( useRec, fd, ts ) == EN_FALSE ){ break; }
+    }
+
+    if( useRec ){ AppIfRec_Close(); }
+    else        { fdatasync( fd ); close( fd ); }
+    Bench_Report( name, i, HalCmnClock_GetNsec() - start );
+    Remove();
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 kHz で記録し、CPU 使用率を計る。
+ * @attention 実時間で 2 秒かかる。
+ * @note      CPU 使用率は周期待ちを含むプロセス全体の値。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RunHz(
+    const char*         name,   ///< [in] 計測項目の名前
+    int                 useRec  ///< [in] 1 : app/if_rec, 0 : write()
+){
+    struct timespec     next;
+    unsigned long long  start = 0;
+    unsigned long long  cpu = 0;
+    unsigned long long  wall = 0;
+    unsigned int        i = 0;
+    int                 fd = -1;
+
+    if( useRec ){ AppIfRec_Open( REC_PATH, REC_SEG_MB, 0 ); }
+    else        { fd = open( REC_PATH ".0000", O_WRONLY | O_CREAT | O_TRUNC, 0644 ); }
+
+    start = HalCmnClock_GetNsec();
+    cpu = CpuNsec();
+    clock_gettime( CLOCK_MONOTONIC, &next );
+    for( i = 0; i < REC_HZ_LOOP; i++ )
+    {
+        next.tv_nsec += REC_PERIOD;
+        if( next.tv_nsec >= 1000000000L )
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+        Write( useRec, fd, HalCmnClock_GetNsec() );
+    }
+
+    if( useRec ){ AppIfRec_Close(); }
+    else        { fdatasync( fd ); close( fd ); }
+    cpu  = CpuNsec() - cpu;
+    wall = HalCmnClock_GetNsec() - start;
+    printf( "%-32s %12u rec  cpu %6.2f %% \n", name, i, (double)cpu * 100.0 / (double)wall );
+    Remove();
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     セグメントを切り替える書き込みの時間を計る。
+ * @attention なし。
+ * @note      REC_ROT_MB のセグメントに続けて記録し、セグメントが一杯になった次の書き込み
+ *            ( 切り替え ) の時間を REC_ROT_NUM 回計る。
+ *            セグメントの作成と閉じる処理が書き込みに含まれると数 msec になる。
+ *            実際の記録ではセグメントの切り替えは数分毎なので、開始した後と切り替えた後に
+ *            REC_ROT_GAP 待って、セグメント用のスレッドが処理を終える時間を与える。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RunRotate(
+    const char*         name    ///< [in] 計測項目の名前
+){
+    unsigned long long  ts = HalCmnClock_GetNsec();
+    unsigned long long  start = 0;
+    unsigned long long  i = 0;
+    unsigned int        n = 0;
+
+    if( AppIfRec_Open( REC_PATH, REC_ROT_MB, 0 ) == EN_FALSE )
+    {
+        printf( "%-32s AppIfRec_Open() error \n", name );
+        return;
+    }
+    usleep( REC_ROT_GAP * 1000 );
+
+    for( i = 0; n < REC_ROT_NUM; i++ )
+    {
+        ts += REC_PERIOD;
+        if( i > 0 && i % REC_ROT_CAP == 0 )
+        {
+            start = HalCmnClock_GetNsec();
+            if( Write( 1, -1, ts ) == EN_FALSE ){ break; }
+            g_rot[n++] = HalCmnClock_GetNsec() - start;
+            usleep( REC_ROT_GAP * 1000 );
+        } else if( Write( 1, -1, ts ) == EN_FALSE )
+        {
+            break;
+        }
+    }
+
+    AppIfRec_Close();
+    Bench_ReportDist( name, g_rot, n );
+    Remove();
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     記録のベンチマークを実行する。
+ * @attention 実時間で 7 秒ほどかかる。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchRec_Run(
+    void
+){
+    RunThroughput( "rec/mmap",        1 );
+    RunThroughput( "rec/write",       0 );
+    RunHz(         "rec/mmap/1kHz",   1 );
+    RunHz(         "rec/write/1kHz",  0 );
+    RunRotate(     "rec/mmap/rotate" );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
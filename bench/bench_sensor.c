@@ -0,0 +1,190 @@
+/**************************************************************************//*!
+ *  @file           bench_sensor.c
+ *  @brief          [BENCH] SENSOR 変数の更新処理のベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           サンプリングループでの HalCmn_UpdateSenData() のスループットを、
+ *                  派生値 ( err, cur_rate ) を毎回計算する従来の処理と比較する。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "bench.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SENSOR_LOOP     (10000000)  // サンプリング回数
+#define SENSOR_INPUT    (4096)      // 入力データ数 ( 2 のべき乗 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static unsigned short   g_input[SENSOR_INPUT];  // MCP3208 の AD 値を模した入力
+static SHalSensor_t     g_data;
+static volatile int     g_sink;                 // 読み出した値の格納先 ( 最適化による削除防止 )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         InitData( void );
+static void         UpdateEager( SHalSensor_t* curData, double newData ) __attribute__((noinline));
+static void         Run( const char* name, int mode, unsigned int every );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     SENSOR 変数を初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitData(
+    void
+){
+    memset( &g_data, 0, sizeof(g_data) );
+    g_data.max   = MCP3208_MAX_VALE;
+    g_data.min   = MCP3208_MAX_VALE;
+    g_data.vref  = MCP3208_VREF_MV;
+    g_data.cache = ~0U;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     従来の SENSOR 変数の更新処理 ( 派生値を毎回計算する )。
+ * @attention 比較用。
+ * @note      なし。
+ * @sa        HalCmn_UpdateSenData()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+UpdateEager(
+    SHalSensor_t*   curData,    ///< [in] 対象の SENSOR 変数
+    double          newData     ///< [in] 新しい値
+){
+    curData->cur = newData;
+
+    if( curData->max < newData )
+    {
+        curData->max = newData;
+    }
+
+    if( curData->min > newData )
+    {
+        curData->min = newData;
+    }
+
+    curData->err = curData->cur - curData->ofs;
+
+    curData->cur_rate = (int)( (curData->cur / curData->max) * 100 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     サンプリングループを実行して計測する。
+ * @attention なし。
+ * @note      every 回に 1 回、cur_rate を読み出す ( 0 = 読み出さない )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*     name,   ///< [in] 計測項目の名前
+    int             mode,   ///< [in] 0 : 従来の処理, 1 : 派生値を遅延計算する処理
+    unsigned int    every   ///< [in] cur_rate を読み出す間隔 ( サンプル数 )
+){
+    unsigned int        i = 0;
+    unsigned int        raw = 0;
+    unsigned long long  start = 0;
+
+    InitData();
+
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < SENSOR_LOOP; i++ )
+    {
+        raw = g_input[i & ( SENSOR_INPUT - 1 )];
+
+        if( mode == 0 )
+        {
+            UpdateEager( &g_data, (double)raw );
+            if( every != 0 && i % every == 0 ){ g_sink = g_data.cur_rate; }
+        } else
+        {
+            HalCmn_UpdateSenData( &g_data, (int)raw, (double)raw );
+            if( every != 0 && i % every == 0 ){ g_sink = HalCmn_GetSenRate( &g_data ); }
+        }
+    }
+    Bench_Report( name, SENSOR_LOOP, HalCmnClock_GetNsec() - start );
+
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     SENSOR 変数の更新処理のベンチマークを実行する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchSensor_Run(
+    void
+){
+    int     i = 0;
+
+    for( i = 0; i < SENSOR_INPUT; i++ )
+    {
+        g_input[i] = (unsigned short)( Bench_Rand() & 0x0FFF );
+    }
+
+    Run( "update/eager",              0, 0 );
+    Run( "update/lazy",               1, 0 );
+    Run( "update/eager+read/1000",    0, 1000 );
+    Run( "update/lazy+read/1000",     1, 1000 );
+    Run( "update/eager+read/1",       0, 1 );
+    Run( "update/lazy+read/1",        1, 1 );
+
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,593 @@
+/**************************************************************************//*!
+ *  @file           bench_ser.c
+ *  @brief          [BENCH] JSON / CBOR シリアライザのベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           距離センサ, ポテンショメータ, 9 軸 IMU ( BMX055 の 3 センサで 3 レコード ) を
+ *                  従来の書式 ( 変更前の main.c と同じ printf 系呼び出しを FILE* に出力 ) と
+ *                  app/if_ser ( バッファに作成して 1 回の write() ) で /dev/null に出力する時間を比べる。
+ *                  3 種類を順に出力する場合 ( mix ) も比べる。
+ *                  他の処理 ( VM の割り込みなど ) の影響を減らすため、1 回の計測を短くして
+ *                  従来の書式とシリアライザを交互に SER_ROUND 回計測し、それぞれ最も速かった回を報告する。
+ *                  また、同じレコードを app/if_ser の JSON と CBOR で作成した時間と
+ *                  1 レコードの平均サイズを比べる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "../app/if_ser/if_ser.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "BEN"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SER_INPUT       (1024)      // 入力データ数 ( 2 のべき乗 )
+#define SER_LOOP        (SER_INPUT) // 1 回の計測のレコード数 ( 全ての入力を 1 回ずつ )
+#define SER_ROUND       (200)       // 計測の回数
+#define SER_NULL        "/dev/null" // 出力先
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 1 レコード分の入力
+typedef struct {
+    int                 rate[4];    // 距離センサ : 割合 ( % )
+    unsigned int        mm[4];      // 距離センサ : 距離 ( mm )
+    unsigned int        reject[4];  // 距離センサ : 外れ値の数
+    double              pos[4];     // 距離センサ : 推定距離
+    double              vel[4];     // 距離センサ : 推定速度
+    double              ttc[4];     // 距離センサ : 接触までの時間
+    double              imu[9];     // IMU : 加速度, ジャイロ, 磁気 x y z
+    unsigned long long  ts[8];      // 転送開始時刻, 転送終了時刻
+} SBenchSerIn_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SBenchSerIn_t        g_in[SER_INPUT];    // 入力
+static SAppIfSer_t          g_ser;              // シリアライザ
+static FILE*                g_fp = NULL;        // 従来の書式の出力先
+static int                  g_fd = -1;          // シリアライザの出力先
+static EHalBool_t           g_out = EN_FALSE;   // EN_TRUE : シリアライザのレコードを毎回 write() する
+static volatile unsigned    g_sink;             // 出力サイズの格納先 ( 最適化による削除防止 )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static unsigned int LegacyDist( const SBenchSerIn_t* in );
+static unsigned int LegacyPm( const SBenchSerIn_t* in );
+static unsigned int LegacyImu( const SBenchSerIn_t* in );
+static unsigned int SerDist( const SBenchSerIn_t* in );
+static unsigned int SerPm( const SBenchSerIn_t* in );
+static unsigned int SerImu( const SBenchSerIn_t* in );
+static unsigned int SerEnd( SAppIfSer_t* ser );
+static unsigned int LegacyMix( const SBenchSerIn_t* in );
+static unsigned int SerMix( const SBenchSerIn_t* in );
+static unsigned long long Time( unsigned int (*func)( const SBenchSerIn_t* in ) );
+static unsigned long long Run( const char* name, unsigned int (*func)( const SBenchSerIn_t* in ) );
+static double       Size( unsigned int (*func)( const SBenchSerIn_t* in ) );
+static void         Legacy( const char* name, unsigned int (*legacy)( const SBenchSerIn_t* in ), unsigned int (*func)( const SBenchSerIn_t* in ) );
+static void         Compare( const char* name, unsigned int (*func)( const SBenchSerIn_t* in ) );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     距離センサのレコードを従来の書式で出力する。
+ * @attention なし。
+ * @note      変更前の main.c の json 出力と同じ書式と呼び出し回数 ( 最後に改行 )。
+ *            PrintTrack(), PrintTime() もそれぞれ 1 回の呼び出しにする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+LegacyDist(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    static const char*  name[4] = { "fl", "fr", "fsl", "fsr" };
+    int                 len = 0;
+    int                 i = 0;
+
+    len += fprintf( g_fp, "{ " );
+    len += fprintf( g_fp, "  \"sensor\": \"sa_dist\"," );
+    len += fprintf( g_fp, "  \"value\":" );
+    len += fprintf( g_fp, "  { " );
+    for( i = 0; i < 4; i++ ){ len += fprintf( g_fp, "    \"%s\": %-3d,", name[i], in->rate[i] ); }
+    len += fprintf( g_fp, "  }," );
+    len += fprintf( g_fp, "  \"mm\":" );
+    len += fprintf( g_fp, "  { " );
+    for( i = 0; i < 4; i++ ){ len += fprintf( g_fp, ( i < 3 ) ? "    \"%s\": %u," : "    \"%s\": %u", name[i], in->mm[i] ); }
+    len += fprintf( g_fp, "  }," );
+    len += fprintf( g_fp, "  \"reject\":" );
+    len += fprintf( g_fp, "  { " );
+    for( i = 0; i < 4; i++ ){ len += fprintf( g_fp, ( i < 3 ) ? "    \"%s\": %u," : "    \"%s\": %u", name[i], in->reject[i] ); }
+    len += fprintf( g_fp, "  }," );
+    len += fprintf( g_fp, "  \"track\":" );
+    len += fprintf( g_fp, "  { " );
+    for( i = 0; i < 4; i++ )
+    {
+        len += fprintf( g_fp, "    \"%s\": ", name[i] );
+        len += fprintf( g_fp, "{ \"mm\": %.1f, \"vel\": %.1f, \"ttc\": %.3f }", in->pos[i], in->vel[i], in->ttc[i] );
+        if( i < 3 ){ len += fprintf( g_fp, "," ); }
+    }
+    len += fprintf( g_fp, "  }," );
+    len += fprintf( g_fp, "  \"ts\":" );
+    len += fprintf( g_fp, "  { " );
+    for( i = 0; i < 4; i++ )
+    {
+        len += fprintf( g_fp, "    \"%s\": ", name[i] );
+        len += fprintf( g_fp, "[ %llu, %llu ]", in->ts[2 * i], in->ts[2 * i + 1] );
+        if( i < 3 ){ len += fprintf( g_fp, "," ); }
+    }
+    len += fprintf( g_fp, "  }" );
+    len += fprintf( g_fp, "}" );
+    len += fprintf( g_fp, "\n" );
+    return (unsigned int)len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ポテンショメータのレコードを従来の書式で出力する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+LegacyPm(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    int     len = 0;
+
+    len += fprintf( g_fp, "{ " );
+    len += fprintf( g_fp, "  \"sensor\": \"sa_pm\"," );
+    len += fprintf( g_fp, "  \"value\": %3d,", in->rate[0] );
+    len += fprintf( g_fp, "  \"ts\": " );
+    len += fprintf( g_fp, "[ %llu, %llu ]", in->ts[0], in->ts[1] );
+    len += fprintf( g_fp, "}" );
+    len += fprintf( g_fp, "\n" );
+    return (unsigned int)len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     9 軸 IMU ( 加速度, ジャイロ, 磁気 ) のレコードを従来の書式で出力する。
+ * @attention なし。
+ * @note      変更前の main.c と同じく、BMX055 のセンサ毎に 1 レコード ( 計 3 レコード ) を
+ *            同じ書式と呼び出し回数で出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+LegacyImu(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    static const char*  name[3] = { "si_bmx055acc", "si_bmx055gyro", "si_bmx055mag" };
+    int                 len = 0;
+    int                 i = 0;
+
+    for( i = 0; i < 3; i++ )
+    {
+        len += fprintf( g_fp, "{ " );
+        len += fprintf( g_fp, "  \"sensor\": \"%s\",", name[i] );
+        len += fprintf( g_fp, "  \"value\": {" );
+        len += fprintf( g_fp, "    \"x\": %f,", in->imu[3 * i] );
+        len += fprintf( g_fp, "    \"y\": %f,", in->imu[3 * i + 1] );
+        len += fprintf( g_fp, "    \"z\": %f ", in->imu[3 * i + 2] );
+        len += fprintf( g_fp, "  }," );
+        len += fprintf( g_fp, "  \"ts\": " );
+        len += fprintf( g_fp, "[ %llu, %llu ]", in->ts[2 * i], in->ts[2 * i + 1] );
+        len += fprintf( g_fp, "}" );
+        len += fprintf( g_fp, "\n" );
+    }
+    return (unsigned int)len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサのレコードをシリアライザで作成する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+SerDist(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    static const char*  name[4] = { "fl", "fr", "fsl", "fsr" };
+    SAppIfSer_t*        ser = &g_ser;
+    int                 i = 0;
+
+    AppIfSer_Begin( ser );
+    AppIfSer_Str( ser, "sensor", "sa_dist" );
+    AppIfSer_ObjBegin( ser, "value" );
+    for( i = 0; i < 4; i++ ){ AppIfSer_Int( ser, name[i], in->rate[i] ); }
+    AppIfSer_ObjEnd( ser );
+    AppIfSer_ObjBegin( ser, "mm" );
+    for( i = 0; i < 4; i++ ){ AppIfSer_Uint( ser, name[i], in->mm[i] ); }
+    AppIfSer_ObjEnd( ser );
+    AppIfSer_ObjBegin( ser, "reject" );
+    for( i = 0; i < 4; i++ ){ AppIfSer_Uint( ser, name[i], in->reject[i] ); }
+    AppIfSer_ObjEnd( ser );
+    AppIfSer_ObjBegin( ser, "track" );
+    for( i = 0; i < 4; i++ )
+    {
+        AppIfSer_ObjBegin( ser, name[i] );
+        AppIfSer_Fix( ser, "mm",  in->pos[i], 1 );
+        AppIfSer_Fix( ser, "vel", in->vel[i], 1 );
+        AppIfSer_Fix( ser, "ttc", in->ttc[i], 3 );
+        AppIfSer_ObjEnd( ser );
+    }
+    AppIfSer_ObjEnd( ser );
+    AppIfSer_ObjBegin( ser, "ts" );
+    for( i = 0; i < 4; i++ )
+    {
+        AppIfSer_UintArr( ser, name[i], &in->ts[2 * i], 2 );
+    }
+    AppIfSer_ObjEnd( ser );
+    return SerEnd( ser );
+}
+
+
+/**************************************************************************//*!
+ * @brief     ポテンショメータのレコードをシリアライザで作成する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+SerPm(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    SAppIfSer_t*    ser = &g_ser;
+
+    AppIfSer_Begin( ser );
+    AppIfSer_Str( ser, "sensor", "sa_pm" );
+    AppIfSer_Int( ser, "value", in->rate[0] );
+    AppIfSer_UintArr( ser, "ts", &in->ts[0], 2 );
+    return SerEnd( ser );
+}
+
+
+/**************************************************************************//*!
+ * @brief     9 軸 IMU ( 加速度, ジャイロ, 磁気 ) のレコードをシリアライザで作成する。
+ * @attention なし。
+ * @note      main.c と同じく、BMX055 のセンサ毎に 1 レコード ( 計 3 レコード ) を作成する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+SerImu(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    static const char*  name[3] = { "si_bmx055acc", "si_bmx055gyro", "si_bmx055mag" };
+    SAppIfSer_t*        ser = &g_ser;
+    unsigned int        len = 0;
+    int                 i = 0;
+
+    for( i = 0; i < 3; i++ )
+    {
+        AppIfSer_Begin( ser );
+        AppIfSer_Str( ser, "sensor", name[i] );
+        AppIfSer_ObjBegin( ser, "value" );
+        AppIfSer_Fix( ser, "x", in->imu[3 * i],     6 );
+        AppIfSer_Fix( ser, "y", in->imu[3 * i + 1], 6 );
+        AppIfSer_Fix( ser, "z", in->imu[3 * i + 2], 6 );
+        AppIfSer_ObjEnd( ser );
+        AppIfSer_UintArr( ser, "ts", &in->ts[2 * i], 2 );
+        len += SerEnd( ser );
+    }
+    return len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     シリアライザのレコードを終了する。
+ * @attention なし。
+ * @note      g_out が EN_TRUE の場合は main.c と同じく AppIfSer_Write() で 1 回の write() で出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+SerEnd(
+    SAppIfSer_t*    ser     ///< [in] シリアライザ
+){
+    unsigned int    len = AppIfSer_End( ser );
+
+    if( g_out == EN_TRUE ){ AppIfSer_Write( ser, g_fd ); }
+    return len;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ, ポテンショメータ, 9 軸 IMU のレコードを従来の書式で順に出力する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+LegacyMix(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    return LegacyDist( in ) + LegacyPm( in ) + LegacyImu( in );
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサ, ポテンショメータ, 9 軸 IMU のレコードをシリアライザで順に作成する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サイズ
+ *************************************************************************** */
+static unsigned int
+SerMix(
+    const SBenchSerIn_t*    in      ///< [in] 入力
+){
+    return SerDist( in ) + SerPm( in ) + SerImu( in );
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードの作成を SER_LOOP 回実行して計測する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    経過時間 ( nsec )
+ *************************************************************************** */
+static unsigned long long
+Time(
+    unsigned int    (*func)( const SBenchSerIn_t* in )  ///< [in] レコードを作成する関数
+){
+    unsigned int        i = 0;
+    unsigned long long  start = 0;
+
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < SER_LOOP; i++ )
+    {
+        g_sink = func( &g_in[i & ( SER_INPUT - 1 )] );
+    }
+    return HalCmnClock_GetNsec() - start;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レコードの作成を SER_ROUND 回計測して、最も速かった回を報告する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    経過時間 ( nsec )
+ *************************************************************************** */
+static unsigned long long
+Run(
+    const char*     name,                               ///< [in] 計測項目の名前
+    unsigned int    (*func)( const SBenchSerIn_t* in )  ///< [in] レコードを作成する関数
+){
+    unsigned int        r = 0;
+    unsigned long long  ns = 0;
+    unsigned long long  best = ~0ULL;
+
+    for( r = 0; r < SER_ROUND; r++ )
+    {
+        ns = Time( func );
+        if( ns < best ){ best = ns; }
+    }
+
+    Bench_Report( name, SER_LOOP, best );
+    return best;
+}
+
+
+/**************************************************************************//*!
+ * @brief     全ての入力でレコードを作成して平均サイズを求める。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    1 レコードの平均サイズ ( Byte )
+ *************************************************************************** */
+static double
+Size(
+    unsigned int    (*func)( const SBenchSerIn_t* in )  ///< [in] レコードを作成する関数
+){
+    unsigned int        i = 0;
+    unsigned long long  sum = 0;
+
+    for( i = 0; i < SER_INPUT; i++ )
+    {
+        sum += func( &g_in[i] );
+    }
+    return (double)sum / SER_INPUT;
+}
+
+
+/**************************************************************************//*!
+ * @brief     同じレコードを従来の書式とシリアライザ ( JSON ) で出力して時間を比べる。
+ * @attention なし。
+ * @note      従来の書式は stdio のバッファ経由でまとめて write() されるので、
+ *            シリアライザは作成だけの時間 ( 書式変換の比較 ) と、
+ *            1 レコード毎に write() する時間 ( main.c の出力 ) の両方を比べる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Legacy(
+    const char*     name,                                   ///< [in] レコードの名前
+    unsigned int    (*legacy)( const SBenchSerIn_t* in ),   ///< [in] 従来の書式で出力する関数
+    unsigned int    (*func)( const SBenchSerIn_t* in )      ///< [in] シリアライザでレコードを作成する関数
+){
+    static const char*  kind[3] = { "legacy", "if_ser", "if_ser+write" };
+    char                label[64];
+    unsigned long long  best[3] = { ~0ULL, ~0ULL, ~0ULL };
+    unsigned long long  ns = 0;
+    unsigned int        r = 0;
+    unsigned int        k = 0;
+
+    AppIfSer_Init( &g_ser, EN_SER_JSON );
+
+    for( r = 0; r < SER_ROUND; r++ )
+    {
+        for( k = 0; k < 3; k++ )
+        {
+            g_out = ( k == 2 ) ? EN_TRUE : EN_FALSE;
+            ns = Time( ( k == 0 ) ? legacy : func );
+            if( ns < best[k] ){ best[k] = ns; }
+        }
+    }
+    g_out = EN_FALSE;
+    fflush( g_fp );
+
+    for( k = 0; k < 3; k++ )
+    {
+        snprintf( label, sizeof(label), "ser/%s/%s", kind[k], name );
+        Bench_Report( label, SER_LOOP, best[k] );
+    }
+
+    printf( "%-32s format %5.1f x, with write() %5.1f x \n",
+            "", (double)best[0] / (double)best[1], (double)best[0] / (double)best[2] );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     同じレコードを JSON と CBOR で作成して時間とサイズを比べる。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Compare(
+    const char*     name,                               ///< [in] レコードの名前
+    unsigned int    (*func)( const SBenchSerIn_t* in )  ///< [in] レコードを作成する関数
+){
+    char                label[64];
+    unsigned long long  nsJson = 0;
+    unsigned long long  nsCbor = 0;
+    double              sizeJson = 0.0;
+    double              sizeCbor = 0.0;
+
+    AppIfSer_Init( &g_ser, EN_SER_JSON );
+    snprintf( label, sizeof(label), "ser/json/%s", name );
+    nsJson   = Run( label, func );
+    sizeJson = Size( func );
+
+    AppIfSer_Init( &g_ser, EN_SER_CBOR );
+    snprintf( label, sizeof(label), "ser/cbor/%s", name );
+    nsCbor   = Run( label, func );
+    sizeCbor = Size( func );
+
+    printf( "%-32s %8.1f B -> %8.1f B ( %5.1f %% ), time %5.2f x \n",
+            "", sizeJson, sizeCbor, sizeCbor * 100.0 / sizeJson, (double)nsCbor / (double)nsJson );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     シリアライザのベンチマークを実行する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchSer_Run(
+    void
+){
+    unsigned int        i = 0;
+    unsigned int        j = 0;
+
+    for( i = 0; i < SER_INPUT; i++ )
+    {
+        for( j = 0; j < 4; j++ )
+        {
+            g_in[i].rate[j]   = (int)( Bench_Rand() % 101 );
+            g_in[i].mm[j]     = 100 + Bench_Rand() % 700;
+            g_in[i].reject[j] = Bench_Rand() % 1000;
+            g_in[i].pos[j]    = g_in[i].mm[j] + (double)( Bench_Rand() % 1000 ) / 1000.0;
+            g_in[i].vel[j]    = (double)( (int)( Bench_Rand() % 20001 ) - 10000 ) / 10.0;
+            g_in[i].ttc[j]    = ( g_in[i].vel[j] < 0.0 ) ? g_in[i].pos[j] / -g_in[i].vel[j] : -1.0;
+        }
+        for( j = 0; j < 9; j++ )
+        {
+            g_in[i].imu[j] = (double)( (int)( Bench_Rand() % 400001 ) - 200000 ) / 10000.0;
+        }
+        for( j = 0; j < 8; j++ )
+        {
+            g_in[i].ts[j] = 1700000000000000000ULL + (unsigned long long)i * 1000000ULL + j * 500ULL;
+        }
+    }
+
+    g_fp = fopen( SER_NULL, "w" );
+    g_fd = open( SER_NULL, O_WRONLY );
+    if( g_fp == NULL || g_fd < 0 )
+    {
+        DBG_PRINT_ERROR( "fail to open %s. \n\r", SER_NULL );
+        goto err;
+    }
+
+    Legacy( "dist", LegacyDist, SerDist );
+    Legacy( "pm",   LegacyPm,   SerPm );
+    Legacy( "imu",  LegacyImu,  SerImu );
+    Legacy( "mix",  LegacyMix,  SerMix );
+
+    Compare( "dist", SerDist );
+    Compare( "pm",   SerPm );
+    Compare( "imu",  SerImu );
+
+err :
+    if( g_fp != NULL ){ fclose( g_fp ); g_fp = NULL; }
+    if( g_fd >= 0 )   { close( g_fd );  g_fd = -1; }
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
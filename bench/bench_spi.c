@@ -0,0 +1,180 @@
+/**************************************************************************//*!
+ *  @file           bench_spi.c
+ *  @brief          [BENCH] SPI ( MCP3208 のエミュレータ ) 経由の AD 値の読み出しのベンチマークを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             hal/hal_cmn_spi_sim.c
+ *  @note           HalCmnSpiMcp3208_Get() を SPI の転送手段ごと計る ( 転送時間の計測を含む )。
+ *                      clock=0 : 転送時間を待たない ( ドライバとエミュレータの処理時間 )
+ *                      1MHz    : MCP3208 の 2.7 V での最大クロック
+ *                      8MHz    : spidev の設定 ( HAL_SIM_SPI_HZ )
+ *                  計る前に、全 ch のシングルエンドと差動の変換結果が模擬信号と一致することを確かめる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SPI_LOOP        (1000000)   // 待たない場合の読み出し回数
+#define SPI_LOOP_CLK    (20000)     // クロックを模擬する場合の読み出し回数
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static volatile unsigned int    g_sink;     // 最適化で読み出しを消さないための書き込み先
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static unsigned int Verify( void );
+static void         Run( const char* name, unsigned int hz, unsigned int loop );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     変換結果が模擬信号と一致するか確かめる。
+ * @attention なし。
+ * @note      ch 毎に直流 ( 100 + ch * 500 ) を設定し、シングルエンドと差動 ( Ch 0 - Ch 1 ) を読む。
+ *            終わったら模擬信号を初期値に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    一致しなかった数
+ *************************************************************************** */
+static unsigned int
+Verify(
+    void
+){
+    SHalSimSig_t        sig;
+    unsigned char       send[3];
+    unsigned char       recv[3];
+    unsigned int        bad = 0;
+    unsigned int        ch = 0;
+
+    memset( &sig, 0, sizeof(sig) );
+    sig.wave = EN_SIM_WAVE_DC;
+    for( ch = 0; ch < 8; ch++ )
+    {
+        sig.center = 100.0 + ch * 500.0;
+        HalCmnSpiSim_SetSignal( (EHalSensorMcp3208_t)ch, &sig );
+    }
+
+    for( ch = 0; ch < 8; ch++ )
+    {
+        if( HalCmnSpiMcp3208_Get( (EHalSensorMcp3208_t)ch ) != 100 + ch * 500 ){ bad++; }
+    }
+
+    // 差動 : IN+ = Ch 1, IN- = Ch 0 ( D2 D1 D0 = 001 )
+    send[0] = 0x04;
+    send[1] = 0x40;
+    send[2] = 0;
+    HalCmnSpi_RecvN( send, recv, 3 );
+    if( ( ( ( recv[1] & 0x0F ) << 8 ) | recv[2] ) != 500 ){ bad++; }
+
+    // 逆の極性は 0 に丸める ( D2 D1 D0 = 000 )
+    send[1] = 0x00;
+    HalCmnSpi_RecvN( send, recv, 3 );
+    if( ( ( ( recv[1] & 0x0F ) << 8 ) | recv[2] ) != 0 ){ bad++; }
+
+    for( ch = 0; ch < 8; ch++ )
+    {
+        HalCmnSpiSim_SetSignal( (EHalSensorMcp3208_t)ch, NULL );
+    }
+    return bad;
+}
+
+
+/**************************************************************************//*!
+ * @brief     Ch 0 - 3, 7 を順に読み出して計る。
+ * @attention なし。
+ * @note      距離センサ 4 ch とポテンショメータの読み出しと同じ順。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run(
+    const char*         name,   ///< [in] 計測項目の名前
+    unsigned int        hz,     ///< [in] クロック周波数 ( Hz, 0 = 待たない )
+    unsigned int        loop    ///< [in] 読み出し回数
+){
+    static const EHalSensorMcp3208_t    ch[] = {
+        EN_MCP3208_CH_0, EN_MCP3208_CH_1, EN_MCP3208_CH_2, EN_MCP3208_CH_3, EN_MCP3208_CH_7
+    };
+    unsigned long long  start = 0;
+    unsigned int        i = 0;
+
+    HalCmnSpiSim_SetClock( hz );
+
+    start = HalCmnClock_GetNsec();
+    for( i = 0; i < loop; i++ )
+    {
+        g_sink = HalCmnSpiMcp3208_Get( ch[i % ( sizeof(ch) / sizeof(ch[0]) )] );
+    }
+    Bench_Report( name, loop, HalCmnClock_GetNsec() - start );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     SPI のベンチマークを実行する。
+ * @attention なし。
+ * @note      終了時にクロック周波数と転送手段を元に戻す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+BenchSpi_Run(
+    void
+){
+    HalCmnSpi_SetOps( HalCmnSpiSim_GetOps() );
+    HalCmnSpi_Init();
+    HalCmnSpiSim_SetClock( 0 );
+
+    printf( "%-32s mismatch %u \n", "mcp3208/verify", Verify() );
+
+    Run( "mcp3208/get/clock=0", 0,       SPI_LOOP );
+    Run( "mcp3208/get/1MHz",    1000000, SPI_LOOP_CLK );
+    Run( "mcp3208/get/8MHz",    8000000, SPI_LOOP_CLK );
+
+    HalCmnSpiSim_SetClock( HAL_SIM_SPI_HZ );
+    HalCmnSpi_Fini();
+    HalCmnSpi_SetOps( NULL );
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
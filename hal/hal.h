@@ -52,6 +52,12 @@
   #define EOF               (-1)
 #endif
 
+/* HalTime_Format() が出力する文字列長 ( "YYYY-MM-DDTHH:MM:SS.uuuuuu" + '\0' ) */
+#define HAL_TIME_FMT_LEN    (27)
+
+/* 距離換算テーブルの要素数 ( MCP3208 の AD 値 12 bit ) */
+#define HAL_DIST_LUT_SIZE   (4096)
+
 
 //********************************************************
 /*! @enum                                                */
@@ -93,6 +99,16 @@ typedef enum tagEHalSensorBMX055
 } EHalSensorBMX055_t;
 
 
+// SENSOR (ADC) 距離センサの型番の区別に使用する型
+typedef enum tagEHalDistModel
+{
+    EN_DIST_GP2Y0A21YK = 0, ///< @var : SHARP GP2Y0A21YK0F ( 10 -  80 cm )
+    EN_DIST_GP2Y0A02YK,     ///< @var : SHARP GP2Y0A02YK0F ( 20 - 150 cm )
+    EN_DIST_GP2Y0A41SK,     ///< @var : SHARP GP2Y0A41SK0F (  4 -  30 cm )
+    EN_DIST_MODEL_NUM       ///< @var : 型番の数
+} EHalDistModel_t;
+
+
 // プッシュ・スイッチの区別に使用する型
 typedef enum tagEHalPushSw
 {
@@ -121,6 +137,16 @@ typedef struct tagSHalTime
 } SHalTime_t;
 
 
+// 時刻の文字列変換に使用する型 ( 呼び出し元が確保する。変換結果をキャッシュする )
+typedef struct tagSHalTimeFmt
+{
+    EHalBool_t          utc;    ///< @var : EN_TRUE : UTC, EN_FALSE : 地方時
+    long long           base;   ///< @var : キャッシュしている分の 0 秒の時刻 ( UNIX 時間, -1 = 無効 )
+    long long           sec;    ///< @var : キャッシュしている秒             ( UNIX 時間 )
+    char                text[HAL_TIME_FMT_LEN]; ///< @var : "YYYY-MM-DDTHH:MM:SS" までのキャッシュ
+} SHalTimeFmt_t;
+
+
 //********************************************************
 /* 関数プロトタイプ宣言                                  */
 //********************************************************
@@ -178,10 +204,13 @@ SHalSensor_t*   HalSensorDist_GetFL( void );
 SHalSensor_t*   HalSensorDist_GetFR( void );
 SHalSensor_t*   HalSensorDist_GetFSL( void );
 SHalSensor_t*   HalSensorDist_GetFSR( void );
+EHalBool_t      HalSensorDist_SetModel( EHalSensorCh_t ch, EHalDistModel_t model );
+SHalTrack_t*    HalSensorDist_GetTrack( EHalSensorCh_t ch );
 
 // SENSOR (I2C) BMX055 ACC API
 EHalBool_t      HalSensorBmx055_Init( void );
 void            HalSensorBmx055_Fini( void );
+void            HalSensorBmx055_OpenHist( void );
 SHalSensor_t*   HalSensorBmx055_GetAcc( EHalSensorBMX055_t which );
 SHalSensor_t*   HalSensorBmx055_GetGyro( EHalSensorBMX055_t which );
 SHalSensor_t*   HalSensorBmx055_GetMag( EHalSensorBMX055_t which );
@@ -190,6 +219,10 @@ SHalSensor_t*   HalSensorBmx055_GetMag( EHalSensorBMX055_t which );
 EHalBool_t      HalTime_Init( void );
 SHalTime_t*     HalTime_GetLocaltime( void );
 SHalTime_t*     HalTime_GetUTC( void );
+EHalBool_t      HalTime_GetLocaltimeR( SHalTime_t* time );
+EHalBool_t      HalTime_GetUTCR( SHalTime_t* time );
+void            HalTime_FmtInit( SHalTimeFmt_t* fmt, EHalBool_t utc );
+int             HalTime_Format( SHalTimeFmt_t* fmt, unsigned long long ns, char* buf );
 
 
 #endif /* _HAL_H_ */
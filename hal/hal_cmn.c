@@ -46,21 +46,63 @@
 //********************************************************
 /* モジュールグローバル変数                              */
 //********************************************************
-// なし
+// EHalSensorCh_t の順に並べる
+static const char*  g_chName[EN_SEN_CH_NUM] = {
+    "dist_fl", "dist_fr", "dist_fsl", "dist_fsr",
+    "pm",
+    "acc_x",  "acc_y",  "acc_z",
+    "gyro_x", "gyro_y", "gyro_z",
+    "mag_x",  "mag_y",  "mag_z",
+};
 
 
 //********************************************************
 /* 関数プロトタイプ宣言                                  */
 //********************************************************
-// なし
+static void         UpdateCache( SHalSensor_t* curData );
 
 
 
 
+/**************************************************************************//*!
+ * @brief     SENSOR 変数の派生値 ( err, cur_rate, cur_vol ) を計算する。
+ * @attention なし。
+ * @note      前回計算した後に更新されていなければ何もしない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+UpdateCache(
+    SHalSensor_t*   curData     ///< [in] 対象の SENSOR 変数
+){
+    if( curData->cache == curData->ver )
+    {
+        return;
+    }
+
+    curData->err = curData->cur - curData->ofs;
+
+    curData->cur_rate = (int)( (curData->cur / curData->max) * 100 );
+
+    if( curData->vref != 0 )
+    {
+        curData->cur_vol = (unsigned int)( ( (unsigned long long)curData->raw * curData->vref ) >> 12 );   // raw * vref / 4096
+    } else
+    {
+        curData->cur_vol = 0;
+    }
+
+    curData->cache = curData->ver;
+    return;
+}
+
+
 /**************************************************************************//*!
  * @brief     SENSOR 変数を更新する。
  * @attention なし。
- * @note      なし。
+ * @note      サンプリングの度に呼ばれるので、生値と現在値の格納、最大値/最小値の更新
+ *            だけを行う。err, cur_rate, cur_vol は HalCmn_GetSen*() で必要な時に計算する。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    なし。
@@ -68,10 +110,12 @@
 void
 HalCmn_UpdateSenData(
     SHalSensor_t*   curData,    ///< [in] 対象の SENSOR 変数
+    int             raw,        ///< [in] 新しい生値
     double          newData     ///< [in] 新しい値
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
+    curData->raw = raw;
     curData->cur = newData;
 
     if( curData->max < newData )
@@ -84,13 +128,105 @@ HalCmn_UpdateSenData(
         curData->min = newData;
     }
 
-    curData->err = curData->cur - curData->ofs;
+    curData->ver++;
+    return;
+}
 
-    curData->cur_rate = (int)( (curData->cur / curData->max) * 100 );
+
+/**************************************************************************//*!
+ * @brief     SENSOR 変数の cur - ofs を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    cur - ofs
+ *************************************************************************** */
+double
+HalCmn_GetSenErr(
+    SHalSensor_t*   curData     ///< [in] 対象の SENSOR 変数
+){
+    UpdateCache( curData );
+    return curData->err;
+}
+
+
+/**************************************************************************//*!
+ * @brief     SENSOR 変数の現在値を割合に換算して返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    ( cur / max ) * 100 ( % )
+ *************************************************************************** */
+int
+HalCmn_GetSenRate(
+    SHalSensor_t*   curData     ///< [in] 対象の SENSOR 変数
+){
+    UpdateCache( curData );
+    return curData->cur_rate;
+}
+
+
+/**************************************************************************//*!
+ * @brief     SENSOR 変数の生値を電圧に換算して返す。
+ * @attention AD 変換値以外 ( vref = 0 ) の場合は 0 を返す。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    電圧 ( mV )
+ *************************************************************************** */
+unsigned int
+HalCmn_GetSenVol(
+    SHalSensor_t*   curData     ///< [in] 対象の SENSOR 変数
+){
+    UpdateCache( curData );
+    return curData->cur_vol;
+}
+
+
+/**************************************************************************//*!
+ * @brief     SENSOR 変数に転送の開始時刻と終了時刻をセットする。
+ * @attention なし。
+ * @note      時刻は HalCmnClock_GetNsec() で取得した値を渡すこと。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmn_SetSenTime(
+    SHalSensor_t*       curData,    ///< [in] 対象の SENSOR 変数
+    unsigned long long  start,      ///< [in] 転送を開始した時刻 ( nsec )
+    unsigned long long  end         ///< [in] 転送が終了した時刻 ( nsec )
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    curData->ts_start = start;
+    curData->ts_end   = end;
     return;
 }
 
 
+/**************************************************************************//*!
+ * @brief     ch の名前を返す。
+ * @attention なし。
+ * @note      JSON などの出力でキーに使用する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    ch の名前 ( 範囲外の場合は "unknown" )
+ *************************************************************************** */
+const char*
+HalCmn_GetChName(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    if( ch >= EN_SEN_CH_NUM )
+    {
+        return "unknown";
+    }
+
+    return g_chName[ch];
+}
+
+
 #ifdef __cplusplus
     }
 #endif
@@ -37,6 +37,28 @@
 #define I2C_SLAVE_BMX055_MAG    (0x13)
 
 #define MCP3208_MAX_VALE        (0x0F60)
+#define MCP3208_VREF_MV         (3300)      ///< @def : MCP3208 の基準電圧 ( mV )
+
+#define HAL_HIST_SEC            (600)       ///< @def : 履歴に保持する時間の初期値 ( sec, -H オプションで変更する )
+#define HAL_HIST_HZ_DIST        (1000)      ///< @def : 距離センサの履歴の容量を決める周波数 ( Hz, -i 1 で読み出す上限 )
+#define HAL_HIST_HZ_PM          (100)       ///< @def : 圧力センサの履歴の容量を決める周波数 ( Hz )
+#define HAL_HIST_HZ_ACC         (1000)      ///< @def : 加速度センサの履歴の容量を決める周波数 ( Hz, I2C 100 kHz で 3 軸を読む上限 )
+#define HAL_HIST_HZ_GYRO        (200)       ///< @def : ジャイロセンサの履歴の容量を決める周波数 ( Hz, 帯域 100 Hz の ODR )
+#define HAL_HIST_HZ_MAG         (10)        ///< @def : 磁気センサの履歴の容量を決める周波数 ( Hz, ODR 10 Hz )
+#define HAL_STATS_WIN_MAX       (4)         ///< @def : 区間統計の 1 ch あたりの時間窓の最大数
+
+#define HAL_FILTER_WIN_MIN      (3)         ///< @def : メディアン / Hampel フィルタの窓の最小値
+#define HAL_FILTER_WIN_MAX      (15)        ///< @def : メディアン / Hampel フィルタの窓の最大値
+
+#define HAL_METRIC_BUCKET_NUM   (11)        ///< @def : 転送時間のヒストグラムの区間数 ( 最後は +Inf )
+
+#define HAL_SIM_SPI_HZ          (8000000)   ///< @def : SPI エミュレータのクロックの初期値 ( Hz, spidev の設定と同じ )
+#define HAL_SIM_I2C_HZ          (100000)    ///< @def : I2C エミュレータのクロックの初期値 ( Hz, Raspberry Pi の既定と同じ )
+#define HAL_SIM_LCD_ROWS        (2)         ///< @def : LCD エミュレータの表示の行数
+#define HAL_SIM_LCD_COLS        (16)        ///< @def : LCD エミュレータの表示の桁数
+#define HAL_SIM_GPIO_PIN_NUM    (64)        ///< @def : GPIO エミュレータのピン数 ( BCM 番号 )
+#define HAL_SIM_GPIO_LOG_NUM    (4096)      ///< @def : GPIO エミュレータが記録する書き込みの数 ( 2 の累乗 )
+#define HAL_SIM_GPIO_EDGE_NUM   (64)        ///< @def : GPIO エミュレータが予約できる入力の変化の数
 
 
 //********************************************************
@@ -67,6 +89,80 @@ typedef enum tagEHalState
 } EHalState_t;
 
 
+// 出力する時刻の基準に使用する型
+typedef enum tagEHalClockBase
+{
+    EN_CLOCK_MONO = 0,      ///< @var : CLOCK_MONOTONIC_RAW (= 初期値 )
+    EN_CLOCK_REAL,          ///< @var : CLOCK_REALTIME ( UNIX 時間 )
+    EN_CLOCK_LOCAL,         ///< @var : CLOCK_REALTIME ( 地方時の文字列で出力 )
+    EN_CLOCK_UTC            ///< @var : CLOCK_REALTIME ( UTC の文字列で出力 )
+} EHalClockBase_t;
+
+
+// センサ値のフィルタの種類に使用する型
+typedef enum tagEHalFilter
+{
+    EN_FILTER_OFF = 0,      ///< @var : フィルタなし (= 初期値 )
+    EN_FILTER_MEDIAN,       ///< @var : メディアンフィルタ
+    EN_FILTER_HAMPEL        ///< @var : Hampel フィルタ ( MAD で外れ値を判定して中央値に置き換える )
+} EHalFilter_t;
+
+
+// GPIO の入出力の設定に使用する型
+typedef enum tagEHalGpioMode
+{
+    EN_GPIO_IN = 0,         ///< @var : 入力
+    EN_GPIO_OUT             ///< @var : 出力
+} EHalGpioMode_t;
+
+
+// 動作状況の計測値 ( カウンタ ) の区別に使用する型
+typedef enum tagEHalMetric
+{
+    EN_METRIC_LCD_BYTES = 0,    ///< @var : LCD に書き込んだ Byte 数
+    EN_METRIC_DEADLINE_MISS,    ///< @var : 読み出し周期に間に合わなかった回数
+    EN_METRIC_GPIO_WRITES,      ///< @var : GPIO に書き込んだ回数
+    EN_METRIC_NUM               ///< @var : カウンタの数
+} EHalMetric_t;
+
+
+// 動作状況の計測値 ( ゲージ ) の区別に使用する型
+typedef enum tagEHalMetricGauge
+{
+    EN_METRIC_GAUGE_SHM_FILL = 0,   ///< @var : 共有メモリのリングバッファに入っているレコード数
+    EN_METRIC_GAUGE_QUE_FILL,       ///< @var : 標準出力の送信キューに積んでいるサイズ ( Byte )
+    EN_METRIC_GAUGE_SRV_QUE_FILL,   ///< @var : 配信サーバの送信キューに積んでいるサイズの合計 ( Byte )
+    EN_METRIC_GAUGE_NUM             ///< @var : ゲージの数
+} EHalMetricGauge_t;
+
+
+// 記録したセンサ値の再生の速さに使用する型
+typedef enum tagEHalReplay
+{
+    EN_REPLAY_REAL = 0,     ///< @var : 記録した時の間隔で再生する (= 初期値 )
+    EN_REPLAY_FAST          ///< @var : 待たずに再生する ( 時刻は記録した間隔で進める )
+} EHalReplay_t;
+
+
+// 転送時間を計測するバスの区別に使用する型
+typedef enum tagEHalMetricBus
+{
+    EN_METRIC_BUS_SPI = 0,  ///< @var : SPI
+    EN_METRIC_BUS_I2C,      ///< @var : I2C
+    EN_METRIC_BUS_NUM       ///< @var : バスの数
+} EHalMetricBus_t;
+
+
+// 模擬信号の波形に使用する型
+typedef enum tagEHalSimWave
+{
+    EN_SIM_WAVE_DC = 0,     ///< @var : 直流 ( center のみ )
+    EN_SIM_WAVE_SINE,       ///< @var : 正弦波
+    EN_SIM_WAVE_SQUARE,     ///< @var : 矩形波
+    EN_SIM_WAVE_RAMP        ///< @var : のこぎり波 ( -amp から +amp まで増加 )
+} EHalSimWave_t;
+
+
 //*************************************
 // デバイスを区別するための型
 //*************************************
@@ -84,38 +180,235 @@ typedef enum tagEHalSensorMcp3208
 } EHalSensorMcp3208_t;
 
 
+// センサの ch の区別に使用する型 ( 履歴などで ch を識別する )
+typedef enum tagEHalSensorCh
+{
+    EN_SEN_CH_DIST_FL = 0,  ///< @var : 距離センサ Front Left
+    EN_SEN_CH_DIST_FR,      ///< @var : 距離センサ Front Right
+    EN_SEN_CH_DIST_FSL,     ///< @var : 距離センサ Front Side Left
+    EN_SEN_CH_DIST_FSR,     ///< @var : 距離センサ Front Side Right
+    EN_SEN_CH_PM,           ///< @var : ポテンショメータ
+    EN_SEN_CH_ACC_X,        ///< @var : BMX055 加速度センサ   X-axis
+    EN_SEN_CH_ACC_Y,        ///< @var : BMX055 加速度センサ   Y-axis
+    EN_SEN_CH_ACC_Z,        ///< @var : BMX055 加速度センサ   Z-axis
+    EN_SEN_CH_GYRO_X,       ///< @var : BMX055 ジャイロセンサ X-axis
+    EN_SEN_CH_GYRO_Y,       ///< @var : BMX055 ジャイロセンサ Y-axis
+    EN_SEN_CH_GYRO_Z,       ///< @var : BMX055 ジャイロセンサ Z-axis
+    EN_SEN_CH_MAG_X,        ///< @var : BMX055 磁気センサ     X-axis
+    EN_SEN_CH_MAG_Y,        ///< @var : BMX055 磁気センサ     Y-axis
+    EN_SEN_CH_MAG_Z,        ///< @var : BMX055 磁気センサ     Z-axis
+    EN_SEN_CH_NUM           ///< @var : ch の数
+} EHalSensorCh_t;
+
+
 //********************************************************
 /*! @struct                                              */
 //********************************************************
 // センサ変数に使用する型
+// err, cur_rate, cur_vol は HalCmn_GetSen*() を呼んだ時に計算し、次の更新までキャッシュする。
+// 直接参照せずに HalCmn_GetSenErr(), HalCmn_GetSenRate(), HalCmn_GetSenVol() を使うこと。
 typedef struct tagSHalSensor
 {
     double              cur;        ///< @var : 現在値
     double              ofs;        ///< @var : 初期化時に設定するセンサのオフセット値
     double              max;        ///< @var : 最大値
     double              min;        ///< @var : 最小値
-    double              err;        ///< @var : cur - ofs
-    int                 cur_rate;   ///< @var : 割合に換算した現在値 ( %     )
-    unsigned int        cur_vol;    ///< @var : 電圧に換算した現在値 ( mV    )
+    double              err;        ///< @var : cur - ofs                        ( キャッシュ )
+    int                 cur_rate;   ///< @var : 割合に換算した現在値 ( %     )  ( キャッシュ )
+    unsigned int        cur_vol;    ///< @var : 電圧に換算した現在値 ( mV    )  ( キャッシュ )
+    unsigned int        cur_mm;     ///< @var : 距離に換算した現在値 ( mm    )  ( 距離センサのみ )
+    int                 raw;        ///< @var : 生値 ( AD 値 / レジスタ値 )
+    unsigned int        ver;        ///< @var : 更新回数 ( 新しい値を受け取る度に加算 )
+    unsigned int        vref;       ///< @var : 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+    unsigned int        cache;      ///< @var : err, cur_rate, cur_vol を計算した時の ver
+    unsigned long long  ts_start;   ///< @var : 転送を開始した時刻   ( CLOCK_MONOTONIC_RAW, nsec )
+    unsigned long long  ts_end;     ///< @var : 転送が終了した時刻   ( CLOCK_MONOTONIC_RAW, nsec )
 } SHalSensor_t;
 
 
+// 区間統計に使用する型 ( 値は物理量に換算済み )
+typedef struct tagSHalStats
+{
+    unsigned int        ms;         ///< @var : 時間窓の長さ ( msec )
+    unsigned int        n;          ///< @var : 時間窓に入っているサンプル数
+    double              mean;       ///< @var : 平均
+    double              sd;         ///< @var : 標準偏差 ( 不偏分散の平方根 )
+    double              min;        ///< @var : 最小値
+    double              max;        ///< @var : 最大値
+} SHalStats_t;
+
+
+// α-β トラッカの推定値に使用する型 ( 単位は入力した観測値に従う )
+typedef struct tagSHalTrack
+{
+    EHalBool_t          valid;      ///< @var : EN_TRUE : 速度を推定済み ( EN_FALSE の間 vel は未収束, ttc = -1 )
+    double              pos;        ///< @var : 推定した位置 ( 距離 )
+    double              vel;        ///< @var : 推定した速度 ( / sec, 負 = 接近 )
+    double              ttc;        ///< @var : 接触までの時間 ( sec, -1 = 接近していない )
+    unsigned long long  ts;         ///< @var : 最後に観測した時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+} SHalTrack_t;
+
+
+// バス毎の転送の計測値に使用する型
+typedef struct tagSHalMetricBus
+{
+    unsigned long long  xfer;                           ///< @var : 転送回数
+    unsigned long long  err;                            ///< @var : 失敗した転送回数
+    unsigned long long  sum;                            ///< @var : 転送時間の合計 ( nsec )
+    unsigned long long  bucket[HAL_METRIC_BUCKET_NUM];  ///< @var : 転送時間の区間毎の回数 ( 累積ではない )
+} SHalMetricBus_t;
+
+
+// SPI の転送手段 ( spidev, エミュレータ ) に使用する型
+// xfer は send を size Byte 送り、同時に受け取った size Byte を recv に格納する ( recv = NULL : 捨てる )。
+typedef struct tagSHalSpiOps
+{
+    const char*         name;                                                               ///< @var : 名前
+    EHalBool_t          (*open)( void );                                                    ///< @var : 開く
+    void                (*close)( void );                                                   ///< @var : 閉じる
+    EHalBool_t          (*xfer)( const unsigned char* send, unsigned char* recv, unsigned int size );  ///< @var : 全二重で転送する
+} SHalSpiOps_t;
+
+
+// I2C の転送手段 ( i2c-dev, エミュレータ ) に使用する型
+// write / read は slave で選んだデバイスとの 1 回の転送 ( START - STOP ) で size Byte を送る / 受け取る。
+typedef struct tagSHalI2cOps
+{
+    const char*         name;                                                   ///< @var : 名前
+    EHalBool_t          (*open)( void );                                        ///< @var : 開く
+    void                (*close)( void );                                       ///< @var : 閉じる
+    EHalBool_t          (*slave)( unsigned char address );                      ///< @var : スレーブデバイスを選ぶ
+    EHalBool_t          (*write)( const unsigned char* data, unsigned int size );  ///< @var : 送る
+    EHalBool_t          (*read)( unsigned char* data, unsigned int size );      ///< @var : 受け取る
+} SHalI2cOps_t;
+
+
+// GPIO の転送手段 ( wiringPi, エミュレータ ) に使用する型
+typedef struct tagSHalGpioOps
+{
+    const char*         name;                                                   ///< @var : 名前
+    EHalBool_t          (*open)( void );                                        ///< @var : 開く
+    void                (*close)( void );                                       ///< @var : 閉じる
+    void                (*mode)( unsigned int pin, EHalGpioMode_t mode );       ///< @var : 入出力を設定する
+    void                (*write)( unsigned int pin, EHalOputputLevel_t level ); ///< @var : 出力する
+    EHalOputputLevel_t  (*read)( unsigned int pin );                            ///< @var : 入力する
+} SHalGpioOps_t;
+
+
+// GPIO エミュレータが記録する書き込みに使用する型
+typedef struct tagSHalGpioEvent
+{
+    unsigned long long  ts;         ///< @var : 書き込んだ時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+    unsigned int        pin;        ///< @var : ピン ( BCM 番号 )
+    EHalOputputLevel_t  level;      ///< @var : 値
+} SHalGpioEvent_t;
+
+
+// 模擬信号に使用する型 ( 値 = center + amp * 波形( 時刻 / period + phase ) + 一様雑音 [-noise, +noise] )
+typedef struct tagSHalSimSig
+{
+    EHalSimWave_t       wave;       ///< @var : 波形
+    double              center;     ///< @var : 中心値
+    double              amp;        ///< @var : 振幅
+    unsigned int        period_ms;  ///< @var : 周期 ( msec, 0 = 直流 )
+    double              phase;      ///< @var : 位相 ( 周期に対する割合, 0.0 - 1.0 )
+    double              noise;      ///< @var : 雑音の振幅
+} SHalSimSig_t;
+
+
+// 動作状況の計測値のスナップショットに使用する型
+typedef struct tagSHalMetric
+{
+    unsigned long long  sample[EN_SEN_CH_NUM];          ///< @var : ch 毎のサンプル数
+    unsigned long long  count[EN_METRIC_NUM];           ///< @var : カウンタ
+    unsigned long long  gauge[EN_METRIC_GAUGE_NUM];     ///< @var : ゲージ
+    SHalMetricBus_t     bus[EN_METRIC_BUS_NUM];         ///< @var : バス毎の転送
+} SHalMetric_t;
+
+
 //********************************************************
 /* 関数プロトタイプ宣言                                  */
 //********************************************************
-void            HalCmn_UpdateSenData( SHalSensor_t* curData, double newData );
+void            HalCmn_UpdateSenData( SHalSensor_t* curData, int raw, double newData );
+double          HalCmn_GetSenErr( SHalSensor_t* curData );
+int             HalCmn_GetSenRate( SHalSensor_t* curData );
+unsigned int    HalCmn_GetSenVol( SHalSensor_t* curData );
+void            HalCmn_SetSenTime( SHalSensor_t* curData, unsigned long long start, unsigned long long end );
+const char*     HalCmn_GetChName( EHalSensorCh_t ch );
+
+EHalBool_t          HalCmnClock_Init( void );
+unsigned long long  HalCmnClock_GetNsec( void );
+void                HalCmnClock_SetBase( EHalClockBase_t base );
+EHalClockBase_t     HalCmnClock_GetBase( void );
+unsigned long long  HalCmnClock_ToReal( unsigned long long ns );
+unsigned long long  HalCmnClock_Export( unsigned long long ns );
+
+EHalBool_t          HalCmnHist_Init( void );
+void                HalCmnHist_Fini( void );
+void                HalCmnHist_SetSec( unsigned int sec );
+unsigned int        HalCmnHist_CapOf( unsigned int hz );
+EHalBool_t          HalCmnHist_Open( EHalSensorCh_t ch, unsigned int cap, double scale );
+void                HalCmnHist_Push( EHalSensorCh_t ch, short raw, unsigned long long ts );
+unsigned long long  HalCmnHist_Head( EHalSensorCh_t ch );
+unsigned int        HalCmnHist_Count( EHalSensorCh_t ch );
+unsigned int        HalCmnHist_Cap( EHalSensorCh_t ch );
+short               HalCmnHist_Raw( EHalSensorCh_t ch, unsigned int seq );
+unsigned long long  HalCmnHist_Time( EHalSensorCh_t ch, unsigned int seq );
+double              HalCmnHist_Value( EHalSensorCh_t ch, unsigned int seq );
+double              HalCmnHist_Scale( EHalSensorCh_t ch );
+unsigned int        HalCmnHist_Span( EHalSensorCh_t ch, unsigned int seq, unsigned int n, const short** raw );
+
+EHalBool_t          HalCmnStats_Init( void );
+void                HalCmnStats_Fini( void );
+EHalBool_t          HalCmnStats_SetWindow( const unsigned int* ms, unsigned int num );
+unsigned int        HalCmnStats_GetWindowNum( void );
+void                HalCmnStats_Update( EHalSensorCh_t ch, unsigned int seq, short raw, unsigned long long ts );
+EHalBool_t          HalCmnStats_Get( EHalSensorCh_t ch, unsigned int idx, SHalStats_t* out );
+
+EHalBool_t          HalCmnFilter_Init( void );
+EHalBool_t          HalCmnFilter_Open( EHalSensorCh_t ch, EHalFilter_t mode, unsigned int win, double k );
+int                 HalCmnFilter_Apply( EHalSensorCh_t ch, int raw );
+unsigned int        HalCmnFilter_GetReject( EHalSensorCh_t ch );
+
+EHalBool_t          HalCmnTrack_Init( void );
+EHalBool_t          HalCmnTrack_Open( EHalSensorCh_t ch, double tau );
+void                HalCmnTrack_Update( EHalSensorCh_t ch, double z, unsigned long long ts );
+SHalTrack_t*        HalCmnTrack_Get( EHalSensorCh_t ch );
+
+void                HalCmnMetric_Add( EHalMetric_t id, unsigned long long n );
+void                HalCmnMetric_Set( EHalMetricGauge_t id, unsigned long long value );
+void                HalCmnMetric_Sample( EHalSensorCh_t ch );
+void                HalCmnMetric_Xfer( EHalMetricBus_t bus, unsigned long long start, EHalBool_t ok );
+void                HalCmnMetric_Get( SHalMetric_t* out );
+unsigned long long  HalCmnMetric_GetBound( unsigned int idx );
+
+EHalBool_t          HalCmnReplay_Open( const char* path, EHalReplay_t mode );
+void                HalCmnReplay_Close( void );
+EHalBool_t          HalCmnReplay_IsOpen( void );
+EHalBool_t          HalCmnReplay_IsEnd( void );
+int                 HalCmnReplay_Get( EHalSensorCh_t ch );
+void                HalCmnReplay_Shift( EHalSensorCh_t ch, unsigned long long* start, unsigned long long* end );
 
 EHalBool_t      HalCmnGpio_Init( void );
 void            HalCmnGpio_Fini( void );
+EHalBool_t      HalCmnGpio_SetOps( const SHalGpioOps_t* ops );
+const SHalGpioOps_t* HalCmnGpio_GetOps( void );
+void            HalCmnGpio_Mode( unsigned int pin, EHalGpioMode_t mode );
+void            HalCmnGpio_Write( unsigned int pin, EHalOputputLevel_t level );
+EHalOputputLevel_t HalCmnGpio_Read( unsigned int pin );
 
 EHalBool_t      HalCmnI2c_Init( void );
 void            HalCmnI2c_Fini( void );
+EHalBool_t      HalCmnI2c_SetOps( const SHalI2cOps_t* ops );
+const SHalI2cOps_t* HalCmnI2c_GetOps( void );
 EHalBool_t      HalCmnI2c_SetSlave( unsigned char address );
 EHalBool_t      HalCmnI2c_Write( unsigned char* data, unsigned int size );
 EHalBool_t      HalCmnI2c_Read( unsigned char* data, unsigned int size );
 
 EHalBool_t      HalCmnSpi_Init( void );
 void            HalCmnSpi_Fini( void );
+EHalBool_t      HalCmnSpi_SetOps( const SHalSpiOps_t* ops );
+const SHalSpiOps_t* HalCmnSpi_GetOps( void );
 EHalBool_t      HalCmnSpi_Send( unsigned char data );
 EHalBool_t      HalCmnSpi_SendN( unsigned char* data, int );
 EHalBool_t      HalCmnSpi_SendBuffer( unsigned char* data, int size );
@@ -123,6 +416,26 @@ EHalBool_t      HalCmnSpi_RecvN( unsigned char*  send, unsigned char*  recv, uns
 
 unsigned int    HalCmnSpiMcp3208_Get( EHalSensorMcp3208_t which );
 
+double              HalCmnSim_Value( const SHalSimSig_t* sig, unsigned long long ns );
+
+const SHalSpiOps_t* HalCmnSpiSim_GetOps( void );
+void                HalCmnSpiSim_SetSignal( EHalSensorMcp3208_t ch, const SHalSimSig_t* sig );
+void                HalCmnSpiSim_SetClock( unsigned int hz );
+unsigned long long  HalCmnSpiSim_GetCount( void );
+
+const SHalI2cOps_t* HalCmnI2cSim_GetOps( void );
+void                HalCmnI2cSim_SetSignal( EHalSensorCh_t ch, const SHalSimSig_t* sig );
+void                HalCmnI2cSim_SetClock( unsigned int hz );
+const char*         HalCmnI2cSim_GetLcd( unsigned int row );
+unsigned long long  HalCmnI2cSim_GetCount( void );
+
+const SHalGpioOps_t* HalCmnGpioSim_GetOps( void );
+void                HalCmnGpioSim_SetInput( unsigned int pin, EHalOputputLevel_t level );
+EHalBool_t          HalCmnGpioSim_Inject( unsigned int pin, EHalOputputLevel_t level, unsigned long long ts );
+EHalOputputLevel_t  HalCmnGpioSim_GetOutput( unsigned int pin );
+unsigned int        HalCmnGpioSim_GetLog( SHalGpioEvent_t* buf, unsigned int num );
+unsigned long long  HalCmnGpioSim_GetCount( void );
+
 
 #endif /* _HAL_CMN_H_ */
 
@@ -0,0 +1,276 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_clock.c
+ *  @brief          [HAL] 高分解能クロックの共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <time.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define CLOCK_NSEC_PER_SEC      (1000000000ULL)
+#define CLOCK_SYNC_TRY          (5)                     // オフセット推定の試行回数
+#define CLOCK_SYNC_PERIOD       (CLOCK_NSEC_PER_SEC)    // オフセットを再推定する周期 ( nsec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+typedef struct {
+    EHalClockBase_t     base;       // 出力に使用する時刻の基準
+    long long           ofs;        // CLOCK_REALTIME - CLOCK_MONOTONIC_RAW ( nsec )
+    unsigned long long  sync;       // 最後にオフセットを推定した時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+} SHalCmnClock_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SHalCmnClock_t   g_param;
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void                 InitParam( void );
+static unsigned long long   ReadClock( clockid_t id );
+static void                 Sync( void );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ファイルスコープ内のグローバル変数を初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitParam(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    g_param.base = EN_CLOCK_MONO;
+    g_param.ofs  = 0;
+    g_param.sync = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     指定したクロックの現在値を nsec 単位で読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    クロックの現在値 ( nsec )
+ *************************************************************************** */
+static unsigned long long
+ReadClock(
+    clockid_t       id      ///< [in] 対象のクロック
+){
+    struct timespec ts;
+
+    clock_gettime( id, &ts );
+    return (unsigned long long)ts.tv_sec * CLOCK_NSEC_PER_SEC + (unsigned long long)ts.tv_nsec;
+}
+
+
+/**************************************************************************//*!
+ * @brief     CLOCK_REALTIME と CLOCK_MONOTONIC_RAW のオフセットを推定する。
+ * @attention なし。
+ * @note      CLOCK_REALTIME の読み出しを CLOCK_MONOTONIC_RAW の 2 回の読み出しで挟み、
+ *            最も間隔が短かった試行の中点をオフセットとして採用する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Sync(
+    void  ///< [in] ナシ
+){
+    int                 i = 0;
+    unsigned long long  mono0 = 0;
+    unsigned long long  mono1 = 0;
+    unsigned long long  real = 0;
+    unsigned long long  gap = 0;
+    unsigned long long  best = ~0ULL;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < CLOCK_SYNC_TRY; i++ )
+    {
+        mono0 = ReadClock( CLOCK_MONOTONIC_RAW );
+        real  = ReadClock( CLOCK_REALTIME );
+        mono1 = ReadClock( CLOCK_MONOTONIC_RAW );
+
+        gap = mono1 - mono0;
+        if( gap < best )
+        {
+            best = gap;
+            g_param.ofs = (long long)real - (long long)( mono0 + gap / 2 );
+        }
+    }
+
+    g_param.sync = mono1;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     クロックを初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnClock_Init(
+    void  ///< [in] ナシ
+){
+    struct timespec ts;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    InitParam();
+
+    if( clock_gettime( CLOCK_MONOTONIC_RAW, &ts ) != 0 )
+    {
+        DBG_PRINT_ERROR( "CLOCK_MONOTONIC_RAW is not available. \n\r" );
+        return EN_FALSE;
+    }
+
+    Sync();
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     単調増加する現在時刻を返す。
+ * @attention なし。
+ * @note      CLOCK_MONOTONIC_RAW を使用するので NTP による補正の影響を受けない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    現在時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+ *************************************************************************** */
+unsigned long long
+HalCmnClock_GetNsec(
+    void  ///< [in] ナシ
+){
+    return ReadClock( CLOCK_MONOTONIC_RAW );
+}
+
+
+/**************************************************************************//*!
+ * @brief     出力に使用する時刻の基準をセットする。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnClock_SetBase(
+    EHalClockBase_t base    ///< [in] 時刻の基準
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    g_param.base = base;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     出力に使用する時刻の基準を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    時刻の基準
+ *************************************************************************** */
+EHalClockBase_t
+HalCmnClock_GetBase(
+    void  ///< [in] ナシ
+){
+    return g_param.base;
+}
+
+
+/**************************************************************************//*!
+ * @brief     CLOCK_MONOTONIC_RAW の時刻を CLOCK_REALTIME の時刻に変換する。
+ * @attention なし。
+ * @note      2 つのクロックは NTP の補正で少しずつずれるので、
+ *            前回の推定から CLOCK_SYNC_PERIOD 以上経過していればオフセットを再推定する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    CLOCK_REALTIME の時刻 ( UNIX 時間, nsec )
+ *************************************************************************** */
+unsigned long long
+HalCmnClock_ToReal(
+    unsigned long long  ns  ///< [in] CLOCK_MONOTONIC_RAW の時刻 ( nsec )
+){
+    if( ns > g_param.sync && ns - g_param.sync > CLOCK_SYNC_PERIOD )
+    {
+        Sync();
+    }
+
+    return (unsigned long long)( (long long)ns + g_param.ofs );
+}
+
+
+/**************************************************************************//*!
+ * @brief     CLOCK_MONOTONIC_RAW の時刻を出力用の時刻の基準に変換する。
+ * @attention なし。
+ * @note      EN_CLOCK_MONO 以外の基準では UNIX 時間を返す。
+ * @sa        HalCmnClock_SetBase()
+ * @author    Ryoji Morita
+ * @return    出力用の時刻 ( nsec )
+ *************************************************************************** */
+unsigned long long
+HalCmnClock_Export(
+    unsigned long long  ns  ///< [in] CLOCK_MONOTONIC_RAW の時刻 ( nsec )
+){
+    if( g_param.base != EN_CLOCK_MONO )
+    {
+        return HalCmnClock_ToReal( ns );
+    }
+
+    return ns;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,325 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_filter.c
+ *  @brief          [HAL] センサ値のメディアン / Hampel フィルタの共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           ch 毎に直近 win 個 ( 3 - 15 ) のサンプルを、到着順のリングバッファと
+ *                  昇順に並べた配列の 2 つで保持する。1 サンプルあたりの処理は
+ *                  二分探索 + memmove ( 最大 15 要素 ) で、中央値は配列の中央を読むだけ。
+ *                  MAD ( 中央値からの絶対偏差の中央値 ) は、昇順の配列を中央から
+ *                  左右に広げながらマージすることで win / 2 ステップで求める。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define FILTER_MAD_SCALE    (1.4826)    // 正規分布で MAD を標準偏差に換算する係数
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+typedef struct {
+    EHalFilter_t    mode;                       // フィルタの種類
+    unsigned int    win;                        // 窓の大きさ
+    double          thr;                        // 外れ値と判定する閾値 ( k x FILTER_MAD_SCALE )
+    unsigned int    n;                          // 窓に入っているサンプル数
+    unsigned int    pos;                        // 次に書き込むリングバッファの位置
+    unsigned int    reject;                     // 外れ値として置き換えたサンプル数
+    int             ring[HAL_FILTER_WIN_MAX];   // 到着順のサンプル
+    int             sorted[HAL_FILTER_WIN_MAX]; // 昇順に並べたサンプル
+} SHalCmnFilter_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SHalCmnFilter_t  g_filter[EN_SEN_CH_NUM];
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         InitParam( void );
+static unsigned int Search( const int* sorted, unsigned int n, int value );
+static int          Mad( const int* sorted, unsigned int n, unsigned int mid );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ファイルスコープ内のグローバル変数を初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitParam(
+    void  ///< [in] ナシ
+){
+    int     i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    memset( g_filter, 0, sizeof(g_filter) );
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        g_filter[i].mode = EN_FILTER_OFF;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     昇順の配列で value 以上の値が最初に現れる位置を返す。
+ * @attention なし。
+ * @note      二分探索。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    位置 ( 全て value より小さい場合は n )
+ *************************************************************************** */
+static unsigned int
+Search(
+    const int*      sorted, ///< [in] 昇順の配列
+    unsigned int    n,      ///< [in] 要素数
+    int             value   ///< [in] 探す値
+){
+    unsigned int    lo = 0;
+    unsigned int    hi = n;
+    unsigned int    mid = 0;
+
+    while( lo < hi )
+    {
+        mid = ( lo + hi ) / 2;
+        if( sorted[mid] < value ){ lo = mid + 1; }
+        else                     { hi = mid; }
+    }
+    return lo;
+}
+
+
+/**************************************************************************//*!
+ * @brief     MAD ( 中央値からの絶対偏差の中央値 ) を返す。
+ * @attention なし。
+ * @note      中央より左の偏差は左へ、右の偏差は右へ進むほど大きくなるので、
+ *            2 つの列をマージして ( n - 1 ) / 2 番目に小さい偏差を求める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    MAD
+ *************************************************************************** */
+static int
+Mad(
+    const int*      sorted, ///< [in] 昇順の配列
+    unsigned int    n,      ///< [in] 要素数
+    unsigned int    mid     ///< [in] 中央値の位置
+){
+    int             med = sorted[mid];
+    int             l = (int)mid;
+    unsigned int    r = mid + 1;
+    unsigned int    k = 0;
+    int             dev = 0;
+
+    for( k = 0; k <= ( n - 1 ) / 2; k++ )
+    {
+        if( l >= 0 && ( r >= n || med - sorted[l] <= sorted[r] - med ) )
+        {
+            dev = med - sorted[l];
+            l--;
+        } else
+        {
+            dev = sorted[r] - med;
+            r++;
+        }
+    }
+    return dev;
+}
+
+
+/**************************************************************************//*!
+ * @brief     フィルタを初期化する。
+ * @attention なし。
+ * @note      全 ch のフィルタを無効にする。
+ * @sa        HalCmnFilter_Open()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnFilter_Init(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    InitParam();
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch のフィルタを設定する。
+ * @attention それまでの窓と外れ値の数はクリアする。
+ * @note      EN_FILTER_MEDIAN : 窓の中央値を出力する。
+ *            EN_FILTER_HAMPEL : | x - 中央値 | > k x 1.4826 x MAD のサンプルを
+ *                               外れ値として中央値に置き換え、それ以外はそのまま出力する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnFilter_Open(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    EHalFilter_t    mode,   ///< [in] フィルタの種類
+    unsigned int    win,    ///< [in] 窓の大きさ ( HAL_FILTER_WIN_MIN - HAL_FILTER_WIN_MAX )
+    double          k       ///< [in] 外れ値と判定する閾値 ( EN_FILTER_HAMPEL のみ, 通常 3.0 )
+){
+    SHalCmnFilter_t*    filter = NULL;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( ch >= EN_SEN_CH_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid channel. : %d \n\r", ch );
+        return EN_FALSE;
+    }
+
+    if( mode != EN_FILTER_OFF && ( win < HAL_FILTER_WIN_MIN || win > HAL_FILTER_WIN_MAX ) )
+    {
+        DBG_PRINT_ERROR( "invalid window. : %u \n\r", win );
+        return EN_FALSE;
+    }
+
+    if( mode == EN_FILTER_HAMPEL && k <= 0.0 )
+    {
+        DBG_PRINT_ERROR( "invalid threshold. : %f \n\r", k );
+        return EN_FALSE;
+    }
+
+    filter = &g_filter[ch];
+    filter->mode   = mode;
+    filter->win    = win;
+    filter->thr    = k * FILTER_MAD_SCALE;
+    filter->n      = 0;
+    filter->pos    = 0;
+    filter->reject = 0;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     サンプルにフィルタをかける。
+ * @attention フィルタが無効の ch では raw をそのまま返す。
+ * @note      窓が埋まるまでは、それまでのサンプルで処理する。
+ *            Hampel フィルタは窓にサンプルが 3 つ以上ある時だけ判定し、
+ *            MAD は AD 値の分解能 ( 1 ) を下限にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    フィルタをかけた値
+ *************************************************************************** */
+int
+HalCmnFilter_Apply(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    int             raw     ///< [in] 生値
+){
+    SHalCmnFilter_t*    filter = &g_filter[ch];
+    unsigned int        idx = 0;
+    unsigned int        mid = 0;
+    int                 med = 0;
+    int                 mad = 0;
+    int                 dev = 0;
+
+    if( filter->mode == EN_FILTER_OFF )
+    {
+        return raw;
+    }
+
+    // 最も古いサンプルを昇順の配列から削除する
+    if( filter->n == filter->win )
+    {
+        idx = Search( filter->sorted, filter->n, filter->ring[filter->pos] );
+        memmove( &filter->sorted[idx], &filter->sorted[idx + 1], ( filter->n - idx - 1 ) * sizeof(int) );
+        filter->n--;
+    }
+
+    // 新しいサンプルを昇順の配列に挿入する
+    idx = Search( filter->sorted, filter->n, raw );
+    memmove( &filter->sorted[idx + 1], &filter->sorted[idx], ( filter->n - idx ) * sizeof(int) );
+    filter->sorted[idx] = raw;
+    filter->n++;
+
+    filter->ring[filter->pos] = raw;
+    filter->pos = ( filter->pos + 1 == filter->win ) ? 0 : filter->pos + 1;
+
+    mid = ( filter->n - 1 ) / 2;
+    med = filter->sorted[mid];
+    if( filter->mode == EN_FILTER_MEDIAN )
+    {
+        return med;
+    }
+
+    if( filter->n < HAL_FILTER_WIN_MIN )
+    {
+        return raw;
+    }
+
+    mad = Mad( filter->sorted, filter->n, mid );
+    if( mad < 1 ){ mad = 1; }
+
+    dev = ( raw > med ) ? raw - med : med - raw;
+    if( (double)dev > filter->thr * mad )
+    {
+        filter->reject++;
+        return med;
+    }
+
+    return raw;
+}
+
+
+/**************************************************************************//*!
+ * @brief     外れ値として置き換えたサンプル数を返す。
+ * @attention なし。
+ * @note      HalCmnFilter_Open() でクリアする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サンプル数
+ *************************************************************************** */
+unsigned int
+HalCmnFilter_GetReject(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    return g_filter[ch].reject;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -3,7 +3,10 @@
  *  @brief          [HAL] GPIO の共通 API を定義したファイル。
  *  @author         Ryoji Morita
  *  @attention      none.
- *  @sa             none.
+ *  @sa             hal_cmn_gpio_sim.c ( GPIO のエミュレータ )
+ *  @note           入出力は SHalGpioOps_t の関数テーブルを経由する。既定は wiringPi で、
+ *                  HalCmnGpio_SetOps() でエミュレータなどに差し替えられる。
+ *                  wiringPi がない環境 ( HAVE_WIRINGPI が未定義 ) では、既定がエミュレータになる。
  *  @bug            none.
  *  @warning        none.
  *  @version        1.00
@@ -17,7 +20,9 @@
 //********************************************************
 /* include                                               */
 //********************************************************
+#ifdef HAVE_WIRINGPI
 #include <wiringPi.h>
+#endif
 
 #include "hal_cmn.h"
 
@@ -48,18 +53,28 @@
 //********************************************************
 /* モジュールグローバル変数                              */
 //********************************************************
-// なし
+static const SHalGpioOps_t* g_ops = NULL;       // 入出力の手段 ( NULL : 既定 )
+static EHalBool_t       g_open = EN_FALSE;      // 入出力の手段を開いている
 
 
 //********************************************************
 /* 関数プロトタイプ宣言                                  */
 //********************************************************
+#ifdef HAVE_WIRINGPI
 static void         InitParam( void );
 static EHalBool_t   InitReg( void );
+static EHalBool_t   WpiOpen( void );
+static void         WpiClose( void );
+static void         WpiMode( unsigned int pin, EHalGpioMode_t mode );
+static void         WpiWrite( unsigned int pin, EHalOputputLevel_t level );
+static EHalOputputLevel_t WpiRead( unsigned int pin );
+#endif
+static const SHalGpioOps_t* DefaultOps( void );
 
 
 
 
+#ifdef HAVE_WIRINGPI
 /**************************************************************************//*!
  * @brief     ファイルスコープ内のグローバル変数を初期化する。
  * @attention なし。
@@ -105,32 +120,142 @@ InitReg(
 
 
 /**************************************************************************//*!
- * @brief     GPIO 設定レジスタへアクセスするためにメモリアドレスを mmap する。
+ * @brief     wiringPi を開く。
  * @attention なし。
- * @note      mmap で GPIO(物理メモリ) を gpio->map(仮想メモリ) に対応づける。
+ * @note      なし。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    EN_TRUE : 成功, EN_FALSE : 失敗
  *************************************************************************** */
-EHalBool_t
-HalCmnGpio_Init(
+static EHalBool_t
+WpiOpen(
     void
 ){
-    EHalBool_t      ret = EN_FALSE;
+    InitParam();
+    return InitReg();
+}
 
-    DBG_PRINT_TRACE( "\n\r" );
 
-    InitParam();
-    ret = InitReg();
+/**************************************************************************//*!
+ * @brief     wiringPi を閉じる。
+ * @attention なし。
+ * @note      wiringPi に終了処理はない。
+ * @sa        InitReg()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+WpiClose(
+    void
+){
+    return;
+}
 
-    return ret;
+
+/**************************************************************************//*!
+ * @brief     wiringPi でピンの入出力を設定する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+WpiMode(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalGpioMode_t      mode    ///< [in] 入出力
+){
+    pinMode( pin, ( mode == EN_GPIO_OUT ) ? OUTPUT : INPUT );
+    return;
 }
 
 
 /**************************************************************************//*!
- * @brief     GPIO レジスタのメモリアドレスを munmap する。
+ * @brief     wiringPi でピンに出力する。
  * @attention なし。
- * @note      OpenGPIO() で呼んだ open()/mmap() を munmap()/close() する。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+WpiWrite(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalOputputLevel_t  level   ///< [in] 値
+){
+    digitalWrite( pin, level );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     wiringPi でピンから入力する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    値
+ *************************************************************************** */
+static EHalOputputLevel_t
+WpiRead(
+    unsigned int        pin     ///< [in] ピン ( BCM 番号 )
+){
+    return ( digitalRead( pin ) == 0 ) ? EN_LOW : EN_HIGH;
+}
+
+
+// wiringPi の入出力の手段
+static const SHalGpioOps_t  g_wpi = { "wiringPi", WpiOpen, WpiClose, WpiMode, WpiWrite, WpiRead };
+#endif
+
+
+/**************************************************************************//*!
+ * @brief     既定の入出力の手段を返す。
+ * @attention なし。
+ * @note      wiringPi がない環境ではエミュレータ。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    入出力の手段
+ *************************************************************************** */
+static const SHalGpioOps_t*
+DefaultOps(
+    void
+){
+#ifdef HAVE_WIRINGPI
+    return &g_wpi;
+#else
+    return HalCmnGpioSim_GetOps();
+#endif
+}
+
+
+/**************************************************************************//*!
+ * @brief     GPIO を初期化する。
+ * @attention なし。
+ * @note      HalCmnGpio_SetOps() で設定した入出力の手段を開く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnGpio_Init(
+    void
+){
+    if( g_ops == NULL )
+    {
+        g_ops = DefaultOps();
+    }
+    DBG_PRINT_TRACE( "%s \n\r", g_ops->name );
+
+    g_open = g_ops->open();
+    return g_open;
+}
+
+
+/**************************************************************************//*!
+ * @brief     GPIO を終了する。
+ * @attention なし。
+ * @note      なし。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    なし。
@@ -140,10 +265,121 @@ HalCmnGpio_Fini(
     void
 ){
     DBG_PRINT_TRACE( "\n\r" );
+
+    if( g_open == EN_TRUE )
+    {
+        g_ops->close();
+        g_open = EN_FALSE;
+    }
     return;
 }
 
 
+/**************************************************************************//*!
+ * @brief     入出力の手段を差し替える。
+ * @attention 入出力中に呼ばないこと。
+ * @note      NULL の場合は既定に戻す。
+ *            開いている場合は、今の手段を閉じて新しい手段を開く ( ピンの入出力の設定は引き継がない )。
+ * @sa        HalCmnGpioSim_GetOps()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 新しい手段を開けなかった )
+ *************************************************************************** */
+EHalBool_t
+HalCmnGpio_SetOps(
+    const SHalGpioOps_t* ops    ///< [in] 入出力の手段
+){
+    EHalBool_t          open = g_open;
+
+    HalCmnGpio_Fini();
+    g_ops = ( ops != NULL ) ? ops : DefaultOps();
+    DBG_PRINT_TRACE( "%s \n\r", g_ops->name );
+    if( open == EN_TRUE )
+    {
+        return HalCmnGpio_Init();
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     入出力の手段を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnGpio_SetOps()
+ * @author    Ryoji Morita
+ * @return    入出力の手段
+ *************************************************************************** */
+const SHalGpioOps_t*
+HalCmnGpio_GetOps(
+    void
+){
+    return ( g_ops != NULL ) ? g_ops : DefaultOps();
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンの入出力を設定する。
+ * @attention なし。
+ * @note      開いていない場合は何もしない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnGpio_Mode(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalGpioMode_t      mode    ///< [in] 入出力
+){
+    if( g_open == EN_TRUE )
+    {
+        g_ops->mode( pin, mode );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンに出力する。
+ * @attention なし。
+ * @note      開いていない場合は何もしない。書き込んだ回数を EN_METRIC_GPIO_WRITES に数える。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnGpio_Write(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalOputputLevel_t  level   ///< [in] 値
+){
+    if( g_open == EN_TRUE )
+    {
+        g_ops->write( pin, level );
+        HalCmnMetric_Add( EN_METRIC_GPIO_WRITES, 1 );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンから入力する。
+ * @attention なし。
+ * @note      開いていない場合は EN_HIGH ( プルアップの入力が開放 ) を返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    値
+ *************************************************************************** */
+EHalOputputLevel_t
+HalCmnGpio_Read(
+    unsigned int        pin     ///< [in] ピン ( BCM 番号 )
+){
+    if( g_open == EN_TRUE )
+    {
+        return g_ops->read( pin );
+    }
+    return EN_HIGH;
+}
+
+
 #ifdef __cplusplus
     }
 #endif
@@ -0,0 +1,390 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_gpio_sim.c
+ *  @brief          [HAL] GPIO の入出力の手段として動くエミュレータを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      HalCmnGpio_SetOps( HalCmnGpioSim_GetOps() ) で使う ( wiringPi がない環境では既定 )。
+ *  @sa             hal_cmn_gpio.c, hal_drv_led.c, hal_drv_pushsw.c
+ *  @note           出力 : 書き込みを時刻付きで最新の HAL_SIM_GPIO_LOG_NUM 個まで記録する。
+ *                  入力 : 初期値は EN_HIGH ( プルアップで SW が押されていない )。
+ *                         HalCmnGpioSim_SetInput() ですぐに、HalCmnGpioSim_Inject() で指定した時刻に変える
+ *                         ( 予約した変化は、その時刻以降に読み出した時に反映する )。
+ *                  出力に設定したピンを読み出すと、最後に書き込んだ値を返す。
+ *                  スレッドセーフではない ( ドライバと同じスレッドから呼ぶこと )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SIM_LOG_MASK        (HAL_SIM_GPIO_LOG_NUM - 1)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static EHalGpioMode_t       g_mode[HAL_SIM_GPIO_PIN_NUM];   // ピン毎の入出力
+static EHalOputputLevel_t   g_out[HAL_SIM_GPIO_PIN_NUM];    // ピン毎の出力の値
+static EHalOputputLevel_t   g_in[HAL_SIM_GPIO_PIN_NUM];     // ピン毎の入力の値
+static EHalBool_t           g_init = EN_FALSE;              // g_in を初期値にした
+static SHalGpioEvent_t      g_log[HAL_SIM_GPIO_LOG_NUM];    // 書き込みの記録 ( リングバッファ )
+static unsigned long long   g_count = 0;                    // 書き込んだ回数
+static SHalGpioEvent_t      g_edge[HAL_SIM_GPIO_EDGE_NUM];  // 予約した入力の変化 ( 時刻の昇順 )
+static unsigned int         g_edgeNum = 0;                  // 予約した入力の変化の数
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   Open( void );
+static void         Close( void );
+static void         Mode( unsigned int pin, EHalGpioMode_t mode );
+static void         Write( unsigned int pin, EHalOputputLevel_t level );
+static EHalOputputLevel_t Read( unsigned int pin );
+static void         InitPin( void );
+static void         ApplyEdge( unsigned long long now );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     入力を初期値にする。
+ * @attention なし。
+ * @note      初めて呼んだ時だけ行う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitPin(
+    void
+){
+    unsigned int    i = 0;
+
+    if( g_init == EN_FALSE )
+    {
+        for( i = 0; i < HAL_SIM_GPIO_PIN_NUM; i++ )
+        {
+            g_mode[i] = EN_GPIO_IN;
+            g_out[i] = EN_LOW;
+            g_in[i] = EN_HIGH;
+        }
+        g_init = EN_TRUE;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時刻 now までに予約した入力の変化を反映する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnGpioSim_Inject()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+ApplyEdge(
+    unsigned long long  now     ///< [in] 時刻 ( nsec )
+){
+    unsigned int        n = 0;
+
+    while( n < g_edgeNum && g_edge[n].ts <= now )
+    {
+        g_in[g_edge[n].pin] = g_edge[n].level;
+        n++;
+    }
+
+    if( n > 0 )
+    {
+        memmove( &g_edge[0], &g_edge[n], ( g_edgeNum - n ) * sizeof(g_edge[0]) );
+        g_edgeNum -= n;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータを開く。
+ * @attention なし。
+ * @note      記録と入力の値は変えない ( 前に開いていた時のまま )。
+ * @sa        Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功
+ *************************************************************************** */
+static EHalBool_t
+Open(
+    void
+){
+    DBG_PRINT_TRACE( "\n\r" );
+    InitPin();
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータを閉じる。
+ * @attention なし。
+ * @note      なし。
+ * @sa        Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Close(
+    void
+){
+    DBG_PRINT_TRACE( "count = %llu \n\r", g_count );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンの入出力を設定する。
+ * @attention なし。
+ * @note      範囲外のピンは無視する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Mode(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalGpioMode_t      mode    ///< [in] 入出力
+){
+    if( pin < HAL_SIM_GPIO_PIN_NUM )
+    {
+        g_mode[pin] = mode;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンに出力し、時刻と一緒に記録する。
+ * @attention なし。
+ * @note      範囲外のピンは無視する。記録がいっぱいの場合は古いものから上書きする。
+ * @sa        HalCmnGpioSim_GetLog()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Write(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalOputputLevel_t  level   ///< [in] 値
+){
+    SHalGpioEvent_t*    ev = NULL;
+
+    if( pin < HAL_SIM_GPIO_PIN_NUM )
+    {
+        g_out[pin] = level;
+
+        ev = &g_log[g_count & SIM_LOG_MASK];
+        ev->ts = HalCmnClock_GetNsec();
+        ev->pin = pin;
+        ev->level = level;
+        g_count++;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンから入力する。
+ * @attention なし。
+ * @note      範囲外のピンは EN_HIGH を返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    値
+ *************************************************************************** */
+static EHalOputputLevel_t
+Read(
+    unsigned int        pin     ///< [in] ピン ( BCM 番号 )
+){
+    if( pin >= HAL_SIM_GPIO_PIN_NUM )
+    {
+        return EN_HIGH;
+    }
+
+    if( g_edgeNum > 0 )
+    {
+        ApplyEdge( HalCmnClock_GetNsec() );
+    }
+    return ( g_mode[pin] == EN_GPIO_OUT ) ? g_out[pin] : g_in[pin];
+}
+
+
+// GPIO のエミュレータの入出力の手段
+static const SHalGpioOps_t  g_ops = { "gpio-sim", Open, Close, Mode, Write, Read };
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータの入出力の手段を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnGpio_SetOps()
+ * @author    Ryoji Morita
+ * @return    入出力の手段
+ *************************************************************************** */
+const SHalGpioOps_t*
+HalCmnGpioSim_GetOps(
+    void
+){
+    InitPin();
+    return &g_ops;
+}
+
+
+/**************************************************************************//*!
+ * @brief     入力の値をすぐに変える。
+ * @attention なし。
+ * @note      範囲外のピンは無視する。
+ * @sa        HalCmnGpioSim_Inject()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnGpioSim_SetInput(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalOputputLevel_t  level   ///< [in] 値
+){
+    InitPin();
+    if( pin < HAL_SIM_GPIO_PIN_NUM )
+    {
+        g_in[pin] = level;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     入力の変化 ( エッジ ) を予約する。
+ * @attention なし。
+ * @note      ts は HalCmnClock_GetNsec() の時刻。同じ時刻の変化は予約した順に反映する。
+ *            SW の押下 ( Active-Low ) は EN_LOW、離すのは EN_HIGH を予約する。
+ * @sa        HalCmnGpioSim_SetInput()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 範囲外のピン, 予約がいっぱい )
+ *************************************************************************** */
+EHalBool_t
+HalCmnGpioSim_Inject(
+    unsigned int        pin,    ///< [in] ピン ( BCM 番号 )
+    EHalOputputLevel_t  level,  ///< [in] 値
+    unsigned long long  ts      ///< [in] 変える時刻 ( nsec )
+){
+    unsigned int        n = g_edgeNum;
+
+    InitPin();
+    if( pin >= HAL_SIM_GPIO_PIN_NUM || g_edgeNum >= HAL_SIM_GPIO_EDGE_NUM )
+    {
+        DBG_PRINT_ERROR( "fail to inject an edge. : pin = %u \n\r", pin );
+        return EN_FALSE;
+    }
+
+    while( n > 0 && g_edge[n - 1].ts > ts )
+    {
+        g_edge[n] = g_edge[n - 1];
+        n--;
+    }
+    g_edge[n].ts = ts;
+    g_edge[n].pin = pin;
+    g_edge[n].level = level;
+    g_edgeNum++;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ピンに最後に書き込んだ値を返す。
+ * @attention なし。
+ * @note      範囲外のピンは EN_LOW を返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    値
+ *************************************************************************** */
+EHalOputputLevel_t
+HalCmnGpioSim_GetOutput(
+    unsigned int        pin     ///< [in] ピン ( BCM 番号 )
+){
+    InitPin();
+    return ( pin < HAL_SIM_GPIO_PIN_NUM ) ? g_out[pin] : EN_LOW;
+}
+
+
+/**************************************************************************//*!
+ * @brief     最新の書き込みの記録を古い順に取り出す。
+ * @attention なし。
+ * @note      記録は消さない ( 何度でも取り出せる )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    取り出した数
+ *************************************************************************** */
+unsigned int
+HalCmnGpioSim_GetLog(
+    SHalGpioEvent_t*    buf,    ///< [out] 記録を格納するバッファ
+    unsigned int        num     ///< [in]  buf の要素数
+){
+    unsigned long long  avail = ( g_count < HAL_SIM_GPIO_LOG_NUM ) ? g_count : HAL_SIM_GPIO_LOG_NUM;
+    unsigned long long  from = 0;
+    unsigned int        i = 0;
+
+    if( num > avail ){ num = (unsigned int)avail; }
+    from = g_count - num;
+    for( i = 0; i < num; i++ )
+    {
+        buf[i] = g_log[( from + i ) & SIM_LOG_MASK];
+    }
+    return num;
+}
+
+
+/**************************************************************************//*!
+ * @brief     書き込んだ回数を返す。
+ * @attention なし。
+ * @note      記録から溢れた分も数える。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    書き込んだ回数
+ *************************************************************************** */
+unsigned long long
+HalCmnGpioSim_GetCount(
+    void
+){
+    return g_count;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,511 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_hist.c
+ *  @brief          [HAL] センサ値の履歴 ( リングバッファ ) の共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           ch 毎に生値 ( short ) の配列とタイムスタンプの配列を別々に持つ
+ *                  ( Structure of Arrays )。統計処理で生値だけを走査する時に
+ *                  キャッシュに載るデータが生値だけになる。
+ *                  タイムスタンプは HIST_BLOCK 個毎の基準時刻 ( nsec ) と
+ *                  基準時刻からの差分 ( usec, 32bit ) で保持する。
+ *                  1 サンプルあたり 6 Byte なので、1 kHz で 1 時間分
+ *                  ( 3,600,000 サンプル ) は 1 ch あたり約 21 MB になる。
+ *                  容量は ch 毎に HalCmnHist_CapOf( センサのサンプリング周波数 ) で決める
+ *                  ( 保持する時間は HalCmnHist_SetSec() ( -H オプション ) で変える )。
+ *                  通し番号は 64 bit で数える。統計処理 ( hal_cmn_stats.c ) に渡す通し番号は
+ *                  下位 32 bit で、差分 ( 2^32 を法とする ) だけを使うので一周しても正しく動く。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdlib.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define HIST_BLOCK_SHIFT    (10)                        // 基準時刻を持つ単位 ( 2^n サンプル )
+#define HIST_BLOCK          (1 << HIST_BLOCK_SHIFT)
+#define HIST_OFS_MAX        (0xFFFFFFFFULL)             // 基準時刻からの差分の最大値 ( usec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+typedef struct {
+    short*              raw;    // 生値                       ( cap 個 )
+    unsigned int*       ofs;    // 基準時刻からの差分 ( usec ) ( cap 個 )
+    unsigned long long* base;   // 基準時刻           ( nsec ) ( cap / HIST_BLOCK 個 )
+    unsigned char*      shift;  // 差分の単位         ( usec x 2^n ) ( cap / HIST_BLOCK 個 )
+    unsigned int        mask;   // cap - 1 ( cap は 2 のべき乗 )
+    unsigned long long  head;   // 次に書き込むサンプルの通し番号
+    double              scale;  // 生値から物理量への換算係数
+} SHalCmnHist_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SHalCmnHist_t    g_hist[EN_SEN_CH_NUM];
+static unsigned int     g_sec = HAL_HIST_SEC;       // 履歴に保持する時間 ( sec )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         InitParam( void );
+static void         Close( SHalCmnHist_t* hist );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ファイルスコープ内のグローバル変数を初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitParam(
+    void  ///< [in] ナシ
+){
+    int     i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        g_hist[i].raw   = NULL;
+        g_hist[i].ofs   = NULL;
+        g_hist[i].base  = NULL;
+        g_hist[i].shift = NULL;
+        g_hist[i].mask  = 0;
+        g_hist[i].head  = 0;
+        g_hist[i].scale = 1.0;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴の領域を解放する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Close(
+    SHalCmnHist_t*  hist    ///< [in] 対象の履歴
+){
+    free( hist->raw );
+    free( hist->ofs );
+    free( hist->base );
+    free( hist->shift );
+
+    hist->raw   = NULL;
+    hist->ofs   = NULL;
+    hist->base  = NULL;
+    hist->shift = NULL;
+    hist->mask = 0;
+    hist->head = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴を初期化する。
+ * @attention なし。
+ * @note      領域は HalCmnHist_Open() で ch 毎に確保する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnHist_Init(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    InitParam();
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     全 ch の履歴の領域を解放する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnHist_Fini(
+    void  ///< [in] ナシ
+){
+    int     i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        Close( &g_hist[i] );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴に保持する時間を設定する。
+ * @attention HalCmnHist_Open() ( 各センサの初期化 ) の前に呼ぶこと。
+ * @note      HalCmnHist_Init() では変わらない。0 は初期値 ( HAL_HIST_SEC ) に戻す。
+ * @sa        HalCmnHist_CapOf()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnHist_SetSec(
+    unsigned int    sec     ///< [in] 保持する時間 ( sec )
+){
+    DBG_PRINT_TRACE( "sec = %u \n\r", sec );
+
+    g_sec = ( sec == 0 ) ? HAL_HIST_SEC : sec;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     サンプリング周波数から、設定した時間分の履歴のサンプル数を返す。
+ * @attention なし。
+ * @note      HalCmnHist_Open() の cap に渡す ( 2 のべき乗への切り上げは HalCmnHist_Open() で行う )。
+ *            初期値 ( 600 sec ) では 1 kHz の ch が約 6 MB、10 Hz の ch が約 48 KB になる。
+ * @sa        HalCmnHist_SetSec()
+ * @author    Ryoji Morita
+ * @return    サンプル数
+ *************************************************************************** */
+unsigned int
+HalCmnHist_CapOf(
+    unsigned int    hz      ///< [in] サンプリング周波数 ( Hz )
+){
+    unsigned long long  cap = (unsigned long long)hz * g_sec;
+
+    return ( cap > 0x80000000ULL ) ? 0x80000000U : (unsigned int)cap;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch の履歴の領域を確保する。
+ * @attention 既に確保済みの場合は、それまでの履歴を破棄する。
+ * @note      cap は 2 のべき乗 ( 最小 HIST_BLOCK ) に切り上げる。
+ *            calloc() で確保するので、書き込まれるまで物理メモリは消費しない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnHist_Open(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    unsigned int    cap,    ///< [in] 保持するサンプル数
+    double          scale   ///< [in] 生値から物理量への換算係数
+){
+    SHalCmnHist_t*  hist = NULL;
+    unsigned int    size = HIST_BLOCK;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( ch >= EN_SEN_CH_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid channel. : %d \n\r", ch );
+        return EN_FALSE;
+    }
+
+    while( size < cap && size < 0x80000000U )
+    {
+        size <<= 1;
+    }
+
+    hist = &g_hist[ch];
+    Close( hist );
+
+    hist->raw  = calloc( size, sizeof(short) );
+    hist->ofs  = calloc( size, sizeof(unsigned int) );
+    hist->base  = calloc( size >> HIST_BLOCK_SHIFT, sizeof(unsigned long long) );
+    hist->shift = calloc( size >> HIST_BLOCK_SHIFT, sizeof(unsigned char) );
+    if( hist->raw == NULL || hist->ofs == NULL || hist->base == NULL || hist->shift == NULL )
+    {
+        DBG_PRINT_ERROR( "fail to allocate history. : ch = %d, cap = %u \n\r", ch, size );
+        Close( hist );
+        return EN_FALSE;
+    }
+
+    hist->mask  = size - 1;
+    hist->head  = 0;
+    hist->scale = scale;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴にサンプルを追加する。
+ * @attention 領域を確保していない ch では何もしない。
+ * @note      ブロック先頭のサンプルの時刻を基準時刻にし、それ以外のサンプルは
+ *            基準時刻からの差分 ( usec ) を保持する。差分が 32bit を超える
+ *            ( ブロック内で約 71 分以上間隔があく ) 場合は、そのブロックの差分の単位を
+ *            2 倍ずつ広げて、書き込み済みのサンプルの差分も換算し直す ( 時刻は潰れない )。
+ *            追加したサンプルで区間統計 ( hal_cmn_stats.c ) も更新する。
+ *            サンプル数は履歴を確保していない ch でも数える ( hal_cmn_metric.c )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnHist_Push(
+    EHalSensorCh_t      ch,     ///< [in] 対象の ch
+    short               raw,    ///< [in] 生値
+    unsigned long long  ts      ///< [in] 時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    SHalCmnHist_t*      hist = &g_hist[ch];
+    unsigned int        idx = 0;
+    unsigned int        blk = 0;
+    unsigned int        i = 0;
+    unsigned char       sft = 0;
+    unsigned long long  ofs = 0;
+
+    HalCmnMetric_Sample( ch );
+
+    if( hist->raw == NULL )
+    {
+        return;
+    }
+
+    idx = hist->head & hist->mask;
+    blk = idx >> HIST_BLOCK_SHIFT;
+    if( ( idx & ( HIST_BLOCK - 1 ) ) == 0 )
+    {
+        hist->base[blk]  = ts;
+        hist->shift[blk] = 0;
+    }
+
+    ofs = ( ts - hist->base[blk] ) / 1000;
+    sft = hist->shift[blk];
+    if( ( ofs >> sft ) > HIST_OFS_MAX )
+    {
+        while( ( ofs >> sft ) > HIST_OFS_MAX ){ sft++; }
+        for( i = idx & ~( HIST_BLOCK - 1 ); i < idx; i++ )
+        {
+            hist->ofs[i] >>= ( sft - hist->shift[blk] );
+        }
+        hist->shift[blk] = sft;
+    }
+
+    hist->raw[idx] = raw;
+    hist->ofs[idx] = (unsigned int)( ofs >> sft );
+    hist->head++;
+
+    HalCmnStats_Update( ch, (unsigned int)( hist->head - 1 ), raw, ts );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     次に書き込むサンプルの通し番号を返す。
+ * @attention なし。
+ * @note      最新のサンプルの通し番号は HalCmnHist_Head() - 1 になる。
+ *            HalCmnHist_Raw() などには下位 32 bit を渡してよい ( 容量は 2^31 以下なので位置は同じ )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    通し番号
+ *************************************************************************** */
+unsigned long long
+HalCmnHist_Head(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    return g_hist[ch].head;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴に残っているサンプル数を返す。
+ * @attention 最大で ( 確保したサンプル数 - HIST_BLOCK ) 個。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    サンプル数
+ *************************************************************************** */
+unsigned int
+HalCmnHist_Count(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    SHalCmnHist_t*  hist = &g_hist[ch];
+
+    if( hist->raw == NULL )
+    {
+        return 0;
+    }
+
+    // 先頭のブロックを上書きし始めると基準時刻が変わるので、
+    // 1 ブロック分を除いた範囲を有効な履歴とする
+    if( hist->head > (unsigned long long)( hist->mask + 1 - HIST_BLOCK ) )
+    {
+        return hist->mask + 1 - HIST_BLOCK;
+    }
+
+    return (unsigned int)hist->head;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴に残せるサンプル数を返す。
+ * @attention 領域を確保していない ch では 0 を返す。
+ * @note      HalCmnHist_Count() の最大値。
+ * @sa        HalCmnHist_Count()
+ * @author    Ryoji Morita
+ * @return    サンプル数
+ *************************************************************************** */
+unsigned int
+HalCmnHist_Cap(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    SHalCmnHist_t*  hist = &g_hist[ch];
+
+    if( hist->raw == NULL )
+    {
+        return 0;
+    }
+
+    return hist->mask + 1 - HIST_BLOCK;
+}
+
+
+/**************************************************************************//*!
+ * @brief     指定した通し番号のサンプルの生値を返す。
+ * @attention 通し番号が履歴に残っているかは呼び出し元で確認すること。
+ * @note      なし。
+ * @sa        HalCmnHist_Count()
+ * @author    Ryoji Morita
+ * @return    生値
+ *************************************************************************** */
+short
+HalCmnHist_Raw(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    unsigned int    seq     ///< [in] 通し番号
+){
+    SHalCmnHist_t*  hist = &g_hist[ch];
+
+    return hist->raw[seq & hist->mask];
+}
+
+
+/**************************************************************************//*!
+ * @brief     指定した通し番号のサンプルの時刻を返す。
+ * @attention 通し番号が履歴に残っているかは呼び出し元で確認すること。
+ * @note      分解能は usec ( ブロック先頭のサンプルのみ nsec )。
+ *            ブロック内で約 71 分以上間隔があいた場合は、そのブロックだけ usec x 2^n になる。
+ * @sa        HalCmnHist_Count()
+ * @author    Ryoji Morita
+ * @return    時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+ *************************************************************************** */
+unsigned long long
+HalCmnHist_Time(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    unsigned int    seq     ///< [in] 通し番号
+){
+    SHalCmnHist_t*  hist = &g_hist[ch];
+    unsigned int    idx = seq & hist->mask;
+
+    unsigned int    blk = idx >> HIST_BLOCK_SHIFT;
+
+    return hist->base[blk] + ( (unsigned long long)hist->ofs[idx] << hist->shift[blk] ) * 1000;
+}
+
+
+/**************************************************************************//*!
+ * @brief     指定した通し番号のサンプルを物理量に換算して返す。
+ * @attention 通し番号が履歴に残っているかは呼び出し元で確認すること。
+ * @note      換算はこの関数を呼んだ時に行う。
+ * @sa        HalCmnHist_Open()
+ * @author    Ryoji Morita
+ * @return    物理量 ( 生値 x 換算係数 )
+ *************************************************************************** */
+double
+HalCmnHist_Value(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    unsigned int    seq     ///< [in] 通し番号
+){
+    SHalCmnHist_t*  hist = &g_hist[ch];
+
+    return (double)hist->raw[seq & hist->mask] * hist->scale;
+}
+
+
+/**************************************************************************//*!
+ * @brief     生値から物理量への換算係数を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnHist_Open()
+ * @author    Ryoji Morita
+ * @return    換算係数
+ *************************************************************************** */
+double
+HalCmnHist_Scale(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    return g_hist[ch].scale;
+}
+
+
+/**************************************************************************//*!
+ * @brief     指定した通し番号から連続して並んでいる生値の配列を返す。
+ * @attention 通し番号が履歴に残っているかは呼び出し元で確認すること。
+ * @note      リングバッファの終端で配列が途切れるので、n 個を走査する場合は
+ *            戻り値の個数だけ処理し、残りを続きの通し番号で再度取得する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    *raw から連続して読める個数 ( 最大 n )
+ *************************************************************************** */
+unsigned int
+HalCmnHist_Span(
+    EHalSensorCh_t  ch,     ///< [in]  対象の ch
+    unsigned int    seq,    ///< [in]  先頭の通し番号
+    unsigned int    n,      ///< [in]  読みたい個数
+    const short**   raw     ///< [out] 生値の配列の先頭
+){
+    SHalCmnHist_t*  hist = &g_hist[ch];
+    unsigned int    idx = seq & hist->mask;
+    unsigned int    len = hist->mask + 1 - idx;
+
+    *raw = &hist->raw[idx];
+    return ( n < len ) ? n : len;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
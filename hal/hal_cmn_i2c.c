@@ -3,7 +3,9 @@
  *  @brief          [HAL] I2C の共通 API を定義したファイル。
  *  @author         Ryoji Morita
  *  @attention      none.
- *  @sa             none.
+ *  @sa             hal_cmn_i2c_sim.c ( BMX055, LCD のエミュレータ )
+ *  @note           転送は SHalI2cOps_t の関数テーブルを経由する。既定は /dev/i2c-1 で、
+ *                  HalCmnI2c_SetOps() でエミュレータなどに差し替えられる。
  *  @bug            none.
  *  @warning        none.
  *  @version        1.00
@@ -55,6 +57,8 @@ typedef struct {
 /* モジュールグローバル変数                              */
 //********************************************************
 static SHalCmnI2c_t     g_param;
+static const SHalI2cOps_t*  g_ops = NULL;       // 転送手段 ( NULL : /dev/i2c-1 )
+static EHalBool_t       g_open = EN_FALSE;      // 転送手段を開いている
 
 
 //********************************************************
@@ -62,6 +66,11 @@ static SHalCmnI2c_t     g_param;
 //********************************************************
 static void         InitParam( void );
 static EHalBool_t   InitReg( void );
+static EHalBool_t   DevOpen( void );
+static void         DevClose( void );
+static EHalBool_t   DevSlave( unsigned char address );
+static EHalBool_t   DevWrite( const unsigned char* data, unsigned int size );
+static EHalBool_t   DevRead( unsigned char* data, unsigned int size );
 
 
 
@@ -114,9 +123,106 @@ InitReg(
 
 
 /**************************************************************************//*!
- * @brief     I2C デバイスをオープンする。
+ * @brief     /dev/i2c-1 を開く。
  * @attention なし。
  * @note      なし。
+ * @sa        DevClose()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+DevOpen(
+    void
+){
+    InitParam();
+    return InitReg();
+}
+
+
+/**************************************************************************//*!
+ * @brief     /dev/i2c-1 を閉じる。
+ * @attention なし。
+ * @note      なし。
+ * @sa        DevOpen()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+DevClose(
+    void
+){
+    if( g_param.fd >= 0 )
+    {
+        close( g_param.fd );
+        g_param.fd = -1;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     /dev/i2c-1 のスレーブデバイスのアドレスをセットする。
+ * @attention なし。
+ * @note      失敗した場合は /dev/i2c-1 を閉じる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+DevSlave(
+    unsigned char   address   ///< [in] スレーブデバイスのアドレス
+){
+    if( ioctl( g_param.fd, I2C_SLAVE, address ) < 0 )
+    {
+        DevClose();
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     /dev/i2c-1 のスレーブデバイスに値を書き込む。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+DevWrite(
+    const unsigned char*    data,   ///< [in] スレーブデバイスへ送るデータ
+    unsigned int            size    ///< [in] 送るデータサイズ
+){
+    return ( write( g_param.fd, data, size ) == (ssize_t)size ) ? EN_TRUE : EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     /dev/i2c-1 のスレーブデバイスから値を読み出す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+DevRead(
+    unsigned char*  data,   ///< [out] スレーブデバイスからのデータを格納するバッファ
+    unsigned int    size    ///< [in]  受け取るデータサイズ
+){
+    return ( read( g_param.fd, data, size ) == (ssize_t)size ) ? EN_TRUE : EN_FALSE;
+}
+
+
+// /dev/i2c-1 の転送手段
+static const SHalI2cOps_t   g_i2cdev = { "i2c-dev", DevOpen, DevClose, DevSlave, DevWrite, DevRead };
+
+
+/**************************************************************************//*!
+ * @brief     I2C デバイスをオープンする。
+ * @attention なし。
+ * @note      HalCmnI2c_SetOps() で設定した転送手段を開く。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    EN_TRUE : 成功, EN_FALSE : 失敗
@@ -125,14 +231,14 @@ EHalBool_t
 HalCmnI2c_Init(
     void
 ){
-    EHalBool_t      ret = EN_FALSE;
-
-    DBG_PRINT_TRACE( "\n\r" );
-
-    InitParam();
-    ret = InitReg();
+    if( g_ops == NULL )
+    {
+        g_ops = &g_i2cdev;
+    }
+    DBG_PRINT_TRACE( "%s \n\r", g_ops->name );
 
-    return ret;
+    g_open = g_ops->open();
+    return g_open;
 }
 
 
@@ -150,11 +256,59 @@ HalCmnI2c_Fini(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
-    close( g_param.fd );
+    if( g_open == EN_TRUE )
+    {
+        g_ops->close();
+        g_open = EN_FALSE;
+    }
     return;
 }
 
 
+/**************************************************************************//*!
+ * @brief     転送手段を差し替える。
+ * @attention 転送中に呼ばないこと。
+ * @note      NULL の場合は /dev/i2c-1 に戻す。
+ *            開いている場合は、今の転送手段を閉じて新しい転送手段を開く。
+ *            スレーブデバイスの選択は引き継がない ( 差し替えた後に HalCmnI2c_SetSlave() を呼ぶ )。
+ * @sa        HalCmnI2cSim_GetOps()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 新しい転送手段を開けなかった )
+ *************************************************************************** */
+EHalBool_t
+HalCmnI2c_SetOps(
+    const SHalI2cOps_t* ops     ///< [in] 転送手段
+){
+    EHalBool_t          open = g_open;
+
+    DBG_PRINT_TRACE( "%s \n\r", ( ops != NULL ) ? ops->name : g_i2cdev.name );
+
+    HalCmnI2c_Fini();
+    g_ops = ( ops != NULL ) ? ops : &g_i2cdev;
+    if( open == EN_TRUE )
+    {
+        return HalCmnI2c_Init();
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     転送手段を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnI2c_SetOps()
+ * @author    Ryoji Morita
+ * @return    転送手段
+ *************************************************************************** */
+const SHalI2cOps_t*
+HalCmnI2c_GetOps(
+    void
+){
+    return ( g_ops != NULL ) ? g_ops : &g_i2cdev;
+}
+
+
 /**************************************************************************//*!
  * @brief     I2C スレーブデバイスのアドレスをセットする。
  * @attention なし。
@@ -168,18 +322,14 @@ HalCmnI2c_SetSlave(
     unsigned char   address   ///< [in] スレーブデバイスのアドレス
 ){
     EHalBool_t      ret = EN_FALSE;
-    int             res;
 
     DBG_PRINT_TRACE( "\n\r" );
 
-    res = ioctl( g_param.fd, I2C_SLAVE, address );
-    if( res < 0) {
+    ret = ( g_open == EN_TRUE ) ? g_ops->slave( address ) : EN_FALSE;
+    if( ret == EN_FALSE )
+    {
         DBG_PRINT_WARN( "Unable to get bus access to talk to i2c slave. \n\r" );
-        close( g_param.fd );
-        return ret;
     }
-
-    ret = EN_TRUE;
     return ret;
 }
 
@@ -197,19 +347,18 @@ HalCmnI2c_Write(
     unsigned char*  data,   ///< [in] スレーブデバイスへ送るデータ
     unsigned int    size    ///< [in] 送るデータサイズ
 ){
-    EHalBool_t      ret = EN_FALSE;
-    int             res = -1;
+    EHalBool_t          ret = EN_FALSE;
+    unsigned long long  start = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
 
-    res = write( g_param.fd, data, size );
-    if( res != size )
+    start = HalCmnClock_GetNsec();
+    ret = ( g_open == EN_TRUE ) ? g_ops->write( data, size ) : EN_FALSE;
+    HalCmnMetric_Xfer( EN_METRIC_BUS_I2C, start, ret );
+    if( ret == EN_FALSE )
     {
         DBG_PRINT_WARN( "fail to write data to i2c slave. \n\r" );
-        return ret;
     }
-
-    ret = EN_TRUE;
     return ret;
 }
 
@@ -227,19 +376,18 @@ HalCmnI2c_Read(
     unsigned char*  data,   ///< [out] スレーブデバイスからのデータを格納するバッファ
     unsigned int    size    ///< [in]  受け取るデータサイズ
 ){
-    EHalBool_t      ret = EN_FALSE;
-    int             res = -1;
+    EHalBool_t          ret = EN_FALSE;
+    unsigned long long  start = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
 
-    res = read( g_param.fd, data, size );
-    if( res != size )
+    start = HalCmnClock_GetNsec();
+    ret = ( g_open == EN_TRUE ) ? g_ops->read( data, size ) : EN_FALSE;
+    HalCmnMetric_Xfer( EN_METRIC_BUS_I2C, start, ret );
+    if( ret == EN_FALSE )
     {
         DBG_PRINT_WARN( "fail to read data from i2c slave. \n\r" );
-        return ret;
     }
-
-    ret = EN_TRUE;
     return ret;
 }
 
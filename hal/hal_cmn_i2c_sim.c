@@ -0,0 +1,692 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_i2c_sim.c
+ *  @brief          [HAL] I2C の転送手段として動く BMX055 と LCD のエミュレータを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      HalCmnI2c_SetOps( HalCmnI2cSim_GetOps() ) で使う。
+ *  @sa             hal_cmn_i2c.c, hal_drv_sensor_i2c_bmx055.c, hal_drv_i2c_lcd.c, hal_cmn_sim.c
+ *  @note           バス上に次のデバイスを置く ( それ以外のアドレスは NACK = 転送の失敗 )。
+ *                      0x19 : BMX055 加速度センサ   ( 12 bit, DATA 0x02 - 0x07, CHIPID 0x00 = 0xFA )
+ *                      0x69 : BMX055 ジャイロセンサ ( 16 bit, DATA 0x02 - 0x07, CHIPID 0x00 = 0x0F )
+ *                      0x13 : BMX055 磁気センサ     ( X, Y 13 bit, Z 15 bit, DATA 0x42 - 0x49, CHIPID 0x40 = 0x32 )
+ *                      0x3C : LCD コントローラ      ( SO1602A 互換, 2 行目の DDRAM は 0x20 から )
+ *                  BMX055 は 256 Byte のレジスタマップで、書き込みの先頭 1 Byte がレジスタのアドレス、
+ *                  続く Byte はアドレスを 1 つずつ進めながら書き込む ( 読み出しも同じ )。
+ *                  データレジスタは読み出しの転送を始めた時刻の模擬信号の値 ( 生値 = LSB ) で更新する。
+ *                  そのため 1 回の転送でまとめて読んだ軸は同じ時刻の値になり、分けて読むと時刻がずれる。
+ *                  磁気センサは 0x4B の bit 0 ( Power Control ) が 0 の間、0x4B 以外を読むと 0 を返す。
+ *                  LCD は制御 Byte ( Co, RS ) を解釈し、DDRAM に書かれた文字を記録する。
+ *                  表示のシフトと CGRAM は記録しない。
+ *                  転送時間は START + ( アドレス + データ ) * 9 ビット + STOP として、
+ *                  クロック周波数から求めた時間だけ待つ ( ビジーウェイト )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SIM_REG_NUM         (256)           // レジスタマップの大きさ
+#define SIM_DDRAM_NUM       (128)           // LCD の DDRAM の大きさ
+#define SIM_DDRAM_ROW       (0x20)          // LCD の 1 行あたりの DDRAM のアドレス
+#define SIM_AXIS_NUM        (9)             // 模擬信号の数 ( ACC, GYRO, MAG の X, Y, Z )
+#define SIM_NSEC_PER_SEC    (1000000000ULL)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// バス上のデバイスの区別に使用する型
+typedef enum {
+    EN_DEV_ACC = 0,     // BMX055 加速度センサ
+    EN_DEV_GYRO,        // BMX055 ジャイロセンサ
+    EN_DEV_MAG,         // BMX055 磁気センサ
+    EN_DEV_NUM
+} EDev_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// レジスタマップを持つデバイス
+typedef struct {
+    unsigned char       reg[SIM_REG_NUM];   // レジスタ
+    unsigned char       ptr;                // 次に読み書きするレジスタのアドレス
+} SDev_t;
+
+// LCD コントローラ
+typedef struct {
+    unsigned char       ddram[SIM_DDRAM_NUM];   // 表示データ
+    unsigned char       ac;                     // アドレスカウンタ
+    int                 inc;                    // 書き込み後のアドレスカウンタの増減 ( +1 or -1 )
+    EHalBool_t          cgram;                  // CGRAM を選んでいる ( 書き込みは記録しない )
+} SLcd_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// 軸毎の模擬信号の初期値 ( 生値, 加速度の Z は 1 g を加えた値 )
+static const SHalSimSig_t   g_def[SIM_AXIS_NUM] = {
+    { EN_SIM_WAVE_SINE,    0.0,  200.0,  2000, 0.00,  4.0 },   // ACC  X
+    { EN_SIM_WAVE_SINE,    0.0,  200.0,  2000, 0.25,  4.0 },   // ACC  Y
+    { EN_SIM_WAVE_DC,   1020.0,    0.0,     0, 0.00,  4.0 },   // ACC  Z
+    { EN_SIM_WAVE_SINE,    0.0, 3000.0,  5000, 0.00, 20.0 },   // GYRO X
+    { EN_SIM_WAVE_SINE,    0.0, 3000.0,  5000, 0.33, 20.0 },   // GYRO Y
+    { EN_SIM_WAVE_SINE,    0.0, 3000.0,  5000, 0.67, 20.0 },   // GYRO Z
+    { EN_SIM_WAVE_SINE,    0.0,  400.0, 20000, 0.00,  3.0 },   // MAG  X
+    { EN_SIM_WAVE_SINE,    0.0,  400.0, 20000, 0.25,  3.0 },   // MAG  Y
+    { EN_SIM_WAVE_DC,   -600.0,    0.0,     0, 0.00,  3.0 }    // MAG  Z
+};
+
+static SHalSimSig_t         g_sig[SIM_AXIS_NUM];    // 軸毎の模擬信号
+static EHalBool_t           g_init = EN_FALSE;      // g_sig を初期値にした
+static SDev_t               g_dev[EN_DEV_NUM];      // BMX055
+static SLcd_t               g_lcd;                  // LCD
+static char                 g_line[HAL_SIM_LCD_ROWS][HAL_SIM_LCD_COLS + 1]; // HalCmnI2cSim_GetLcd() の戻り値
+static unsigned char        g_slave = 0;            // 選んでいるスレーブデバイスのアドレス
+static unsigned int         g_hz = HAL_SIM_I2C_HZ;  // クロック周波数 ( Hz, 0 = 待たない )
+static unsigned long long   g_count = 0;            // 転送した回数
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   Open( void );
+static void         Close( void );
+static EHalBool_t   Slave( unsigned char address );
+static EHalBool_t   Write( const unsigned char* data, unsigned int size );
+static EHalBool_t   Read( unsigned char* data, unsigned int size );
+static void         InitSig( void );
+static void         Reset( EDev_t dev );
+static int          Sample( unsigned int axis, unsigned long long ns, int min, int max );
+static void         Update( EDev_t dev, unsigned long long ns );
+static void         SetReg( EDev_t dev, unsigned char reg, unsigned char val );
+static void         LcdCmd( unsigned char code );
+static void         LcdData( unsigned char code );
+static void         Wait( unsigned long long start, unsigned int size );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     模擬信号とデバイスを初期値にする。
+ * @attention なし。
+ * @note      初めて呼んだ時だけ行う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitSig(
+    void
+){
+    unsigned int    i = 0;
+
+    if( g_init == EN_FALSE )
+    {
+        memcpy( g_sig, g_def, sizeof(g_sig) );
+        for( i = 0; i < EN_DEV_NUM; i++ )
+        {
+            Reset( (EDev_t)i );
+        }
+        memset( g_lcd.ddram, ' ', sizeof(g_lcd.ddram) );
+        g_lcd.ac = 0;
+        g_lcd.inc = 1;
+        g_lcd.cgram = EN_FALSE;
+        g_init = EN_TRUE;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     デバイスのレジスタをリセット直後の値にする。
+ * @attention なし。
+ * @note      磁気センサの Power Control ( 0x4B の bit 0 ) はソフトリセットでは変わらない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Reset(
+    EDev_t          dev     ///< [in] デバイス
+){
+    SDev_t*         p = &g_dev[dev];
+    unsigned char   power = p->reg[0x4B] & 0x01;
+
+    memset( p, 0, sizeof(*p) );
+    switch( dev )
+    {
+    case EN_DEV_ACC:
+        p->reg[0x00] = 0xFA;        // BGW_CHIPID
+        p->reg[0x0F] = 0x03;        // PMU_RANGE = +/- 2g
+        p->reg[0x10] = 0x0F;        // PMU_BW = 1kHz
+        break;
+    case EN_DEV_GYRO:
+        p->reg[0x00] = 0x0F;        // CHIP_ID
+        break;
+    case EN_DEV_MAG:
+        p->reg[0x40] = 0x32;        // Chip ID
+        p->reg[0x4B] = power;       // Power Control
+        p->reg[0x4C] = 0x06;        // Opmode = Sleep
+        break;
+    default:
+        break;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     軸の時刻 ns の値を生値に丸めて返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    生値 ( min - max )
+ *************************************************************************** */
+static int
+Sample(
+    unsigned int        axis,   ///< [in] 軸 ( 0 - 8 )
+    unsigned long long  ns,     ///< [in] 時刻 ( nsec )
+    int                 min,    ///< [in] 最小値
+    int                 max     ///< [in] 最大値
+){
+    double              v = HalCmnSim_Value( &g_sig[axis], ns );
+
+    v += ( v < 0.0 ) ? -0.5 : 0.5;
+    if( v < min ){ return min; }
+    if( v > max ){ return max; }
+    return (int)v;
+}
+
+
+/**************************************************************************//*!
+ * @brief     データレジスタを時刻 ns の模擬信号の値で更新する。
+ * @attention なし。
+ * @note      加速度   : LSB の bit 7-4 = 下位 4 bit, bit 0 = new_data, MSB = 上位 8 bit
+ *            ジャイロ : LSB, MSB の順
+ *            磁気     : X, Y は LSB の bit 7-3 = 下位 5 bit, Z は LSB の bit 7-1 = 下位 7 bit,
+ *                       RHALL の LSB の bit 0 = Data Ready
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Update(
+    EDev_t              dev,    ///< [in] デバイス
+    unsigned long long  ns      ///< [in] 時刻 ( nsec )
+){
+    unsigned char*      reg = g_dev[dev].reg;
+    unsigned int        v = 0;
+    unsigned int        i = 0;
+
+    switch( dev )
+    {
+    case EN_DEV_ACC:
+        for( i = 0; i < 3; i++ )
+        {
+            v = (unsigned int)Sample( i, ns, -2048, 2047 ) & 0x0FFF;
+            reg[0x02 + i * 2] = (unsigned char)( ( ( v & 0x0F ) << 4 ) | 0x01 );
+            reg[0x03 + i * 2] = (unsigned char)( v >> 4 );
+        }
+        break;
+    case EN_DEV_GYRO:
+        for( i = 0; i < 3; i++ )
+        {
+            v = (unsigned int)Sample( 3 + i, ns, -32768, 32767 ) & 0xFFFF;
+            reg[0x02 + i * 2] = (unsigned char)( v & 0xFF );
+            reg[0x03 + i * 2] = (unsigned char)( v >> 8 );
+        }
+        break;
+    case EN_DEV_MAG:
+        for( i = 0; i < 2; i++ )
+        {
+            v = (unsigned int)Sample( 6 + i, ns, -4096, 4095 ) & 0x1FFF;
+            reg[0x42 + i * 2] = (unsigned char)( ( v & 0x1F ) << 3 );
+            reg[0x43 + i * 2] = (unsigned char)( v >> 5 );
+        }
+        v = (unsigned int)Sample( 8, ns, -16384, 16383 ) & 0x7FFF;
+        reg[0x46] = (unsigned char)( ( v & 0x7F ) << 1 );
+        reg[0x47] = (unsigned char)( v >> 7 );
+        reg[0x48] = 0x01;
+        reg[0x49] = 0x00;
+        break;
+    default:
+        break;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     レジスタに書き込む。
+ * @attention なし。
+ * @note      読み出し専用のレジスタ ( CHIPID, データ ) への書き込みは無視する。
+ *            ソフトリセット ( 加速度, ジャイロ : 0x14 = 0xB6, 磁気 : 0x4B の bit 7, 1 ) を行う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SetReg(
+    EDev_t          dev,    ///< [in] デバイス
+    unsigned char   reg,    ///< [in] レジスタのアドレス
+    unsigned char   val     ///< [in] 値
+){
+    SDev_t*         p = &g_dev[dev];
+
+    switch( dev )
+    {
+    case EN_DEV_ACC:
+    case EN_DEV_GYRO:
+        if( reg <= 0x09 ){ return; }
+        if( reg == 0x14 )
+        {
+            if( val == 0xB6 ){ Reset( dev ); }
+            return;
+        }
+        break;
+    case EN_DEV_MAG:
+        if( reg == 0x4B )
+        {
+            p->reg[0x4B] = val & 0x01;
+            if( val & 0x82 ){ Reset( dev ); }
+            return;
+        }
+        if( ( p->reg[0x4B] & 0x01 ) == 0 || reg <= 0x4A ){ return; }
+        break;
+    default:
+        break;
+    }
+    p->reg[reg] = val;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     LCD のコマンドを実行する。
+ * @attention なし。
+ * @note      0x01 : Clear Display, 0x02 : Return Home, 0x04 - 0x07 : Entry Mode Set,
+ *            0x10 - 0x1F : Cursor Shift, 0x40 - 0x7F : Set CGRAM Address, 0x80 - : Set DDRAM Address
+ *            それ以外 ( Display ON/OFF, Function Set, 表示のシフト ) は表示の記録に影響しない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+LcdCmd(
+    unsigned char   code    ///< [in] コマンド
+){
+    if( code & 0x80 )
+    {
+        g_lcd.ac = code & 0x7F;
+        g_lcd.cgram = EN_FALSE;
+    } else if( code & 0x40 )
+    {
+        g_lcd.cgram = EN_TRUE;
+    } else if( code & 0x10 )
+    {
+        if( ( code & 0x08 ) == 0 )
+        {
+            g_lcd.ac = (unsigned char)( ( g_lcd.ac + ( ( code & 0x04 ) ? 1 : -1 ) ) & 0x7F );
+        }
+    } else if( ( code & 0xFC ) == 0x04 )
+    {
+        g_lcd.inc = ( code & 0x02 ) ? 1 : -1;
+    } else if( ( code & 0xFE ) == 0x02 )
+    {
+        g_lcd.ac = 0;
+        g_lcd.cgram = EN_FALSE;
+    } else if( code == 0x01 )
+    {
+        memset( g_lcd.ddram, ' ', sizeof(g_lcd.ddram) );
+        g_lcd.ac = 0;
+        g_lcd.inc = 1;
+        g_lcd.cgram = EN_FALSE;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     LCD の DDRAM に 1 文字を書き込む。
+ * @attention なし。
+ * @note      書き込んだ後にアドレスカウンタを進める ( Entry Mode Set の向き )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+LcdData(
+    unsigned char   code    ///< [in] 文字
+){
+    if( g_lcd.cgram == EN_FALSE )
+    {
+        g_lcd.ddram[g_lcd.ac & 0x7F] = code;
+        g_lcd.ac = (unsigned char)( ( g_lcd.ac + g_lcd.inc ) & 0x7F );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 回の転送の時間が経つまで待つ。
+ * @attention なし。
+ * @note      START + ( アドレス + size ) * 9 ビット ( 8 ビット + ACK ) + STOP
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Wait(
+    unsigned long long  start,  ///< [in] 転送を始めた時刻 ( nsec )
+    unsigned int        size    ///< [in] データの Byte 数
+){
+    unsigned long long  end = 0;
+
+    g_count++;
+    if( g_hz > 0 )
+    {
+        end = start + ( ( size + 1 ) * 9ULL + 2 ) * SIM_NSEC_PER_SEC / g_hz;
+        while( HalCmnClock_GetNsec() < end );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータを開く。
+ * @attention なし。
+ * @note      レジスタと表示は変えない ( 前に開いていた時のまま )。
+ * @sa        Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功
+ *************************************************************************** */
+static EHalBool_t
+Open(
+    void
+){
+    DBG_PRINT_TRACE( "clock = %u Hz \n\r", g_hz );
+    InitSig();
+    g_slave = 0;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータを閉じる。
+ * @attention なし。
+ * @note      なし。
+ * @sa        Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Close(
+    void
+){
+    DBG_PRINT_TRACE( "count = %llu \n\r", g_count );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     スレーブデバイスを選ぶ。
+ * @attention なし。
+ * @note      i2c-dev と同じく、アドレスの確認は転送の時に行う ( ここでは失敗しない )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功
+ *************************************************************************** */
+static EHalBool_t
+Slave(
+    unsigned char   address   ///< [in] スレーブデバイスのアドレス
+){
+    g_slave = address;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     選んでいるスレーブデバイスに書き込む。
+ * @attention なし。
+ * @note      BMX055 : 先頭 1 Byte がレジスタのアドレス、続く Byte をそこから順に書き込む。
+ *            LCD    : 制御 Byte ( bit 7 = Co, bit 6 = RS ) の後にコマンド or 文字。
+ *                     Co = 1 の場合は 1 Byte 毎に制御 Byte が続き、Co = 0 の場合は残りすべてが同じ RS。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( NACK )
+ *************************************************************************** */
+static EHalBool_t
+Write(
+    const unsigned char*    data,   ///< [in] 送るデータ
+    unsigned int            size    ///< [in] 送るデータサイズ
+){
+    unsigned long long      start = HalCmnClock_GetNsec();
+    EDev_t                  dev = EN_DEV_NUM;
+    unsigned int            i = 0;
+    unsigned char           ctrl = 0;           // LCD の制御 Byte
+    EHalBool_t              next = EN_TRUE;     // LCD の次の Byte が制御 Byte
+
+    switch( g_slave )
+    {
+    case I2C_SLAVE_BMX055_ACC:  dev = EN_DEV_ACC;  break;
+    case I2C_SLAVE_BMX055_GYRO: dev = EN_DEV_GYRO; break;
+    case I2C_SLAVE_BMX055_MAG:  dev = EN_DEV_MAG;  break;
+    case I2C_SLAVE_LCD:
+        for( i = 0; i < size; i++ )
+        {
+            if( next == EN_TRUE )
+            {
+                ctrl = data[i];
+                next = EN_FALSE;
+                continue;
+            }
+            if( ctrl & 0x40 ){ LcdData( data[i] ); }
+            else             { LcdCmd( data[i] );  }
+            if( ctrl & 0x80 ){ next = EN_TRUE; }
+        }
+        Wait( start, size );
+        return EN_TRUE;
+    default:
+        Wait( start, 0 );
+        return EN_FALSE;
+    }
+
+    if( size > 0 )
+    {
+        g_dev[dev].ptr = data[0];
+    }
+    for( i = 1; i < size; i++ )
+    {
+        SetReg( dev, g_dev[dev].ptr++, data[i] );
+    }
+    Wait( start, size );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     選んでいるスレーブデバイスから読み出す。
+ * @attention なし。
+ * @note      BMX055 : 最後に書き込んだレジスタのアドレスから順に読み出す。
+ *            LCD    : Busy Flag ( 常に 0 ) とアドレスカウンタを返す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( NACK )
+ *************************************************************************** */
+static EHalBool_t
+Read(
+    unsigned char*  data,   ///< [out] 受け取ったデータ
+    unsigned int    size    ///< [in]  受け取るデータサイズ
+){
+    unsigned long long  start = HalCmnClock_GetNsec();
+    EDev_t              dev = EN_DEV_NUM;
+    SDev_t*             p = NULL;
+    unsigned int        i = 0;
+
+    switch( g_slave )
+    {
+    case I2C_SLAVE_BMX055_ACC:  dev = EN_DEV_ACC;  break;
+    case I2C_SLAVE_BMX055_GYRO: dev = EN_DEV_GYRO; break;
+    case I2C_SLAVE_BMX055_MAG:  dev = EN_DEV_MAG;  break;
+    case I2C_SLAVE_LCD:
+        memset( data, g_lcd.ac & 0x7F, size );
+        Wait( start, size );
+        return EN_TRUE;
+    default:
+        Wait( start, 0 );
+        return EN_FALSE;
+    }
+
+    p = &g_dev[dev];
+    Update( dev, start );
+    for( i = 0; i < size; i++, p->ptr++ )
+    {
+        if( dev == EN_DEV_MAG && ( p->reg[0x4B] & 0x01 ) == 0 && p->ptr != 0x4B )
+        {
+            data[i] = 0;
+        } else
+        {
+            data[i] = p->reg[p->ptr];
+        }
+    }
+    Wait( start, size );
+    return EN_TRUE;
+}
+
+
+// BMX055 と LCD のエミュレータの転送手段
+static const SHalI2cOps_t   g_ops = { "bmx055-lcd-sim", Open, Close, Slave, Write, Read };
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータの転送手段を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnI2c_SetOps()
+ * @author    Ryoji Morita
+ * @return    転送手段
+ *************************************************************************** */
+const SHalI2cOps_t*
+HalCmnI2cSim_GetOps(
+    void
+){
+    InitSig();
+    return &g_ops;
+}
+
+
+/**************************************************************************//*!
+ * @brief     軸の模擬信号を設定する。
+ * @attention なし。
+ * @note      ch は EN_SEN_CH_ACC_X - EN_SEN_CH_MAG_Z ( それ以外は無視する )。NULL の場合は初期値に戻す。
+ *            値は生値 ( LSB ) で与え、各データレジスタのビット数に丸めて返す。
+ * @sa        HalCmnSim_Value()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnI2cSim_SetSignal(
+    EHalSensorCh_t      ch,     ///< [in] ch
+    const SHalSimSig_t* sig     ///< [in] 模擬信号
+){
+    unsigned int        axis = (unsigned int)ch - EN_SEN_CH_ACC_X;
+
+    InitSig();
+    if( ch < EN_SEN_CH_ACC_X || ch > EN_SEN_CH_MAG_Z )
+    {
+        return;
+    }
+    g_sig[axis] = ( sig != NULL ) ? *sig : g_def[axis];
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     クロック周波数を設定する。
+ * @attention なし。
+ * @note      0 の場合は転送時間を待たない ( ドライバの処理時間だけを計る場合 )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnI2cSim_SetClock(
+    unsigned int    hz      ///< [in] クロック周波数 ( Hz )
+){
+    g_hz = hz;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     LCD の表示 ( 1 行 ) を返す。
+ * @attention 次に呼ぶまで有効。
+ * @note      DDRAM の行の先頭から HAL_SIM_LCD_COLS 文字。制御文字は空白にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    表示の文字列 ( row が範囲外の場合は NULL )
+ *************************************************************************** */
+const char*
+HalCmnI2cSim_GetLcd(
+    unsigned int    row     ///< [in] 行 ( 0 - HAL_SIM_LCD_ROWS - 1 )
+){
+    unsigned int    col = 0;
+    unsigned char   c = 0;
+
+    if( row >= HAL_SIM_LCD_ROWS )
+    {
+        return NULL;
+    }
+
+    InitSig();
+    for( col = 0; col < HAL_SIM_LCD_COLS; col++ )
+    {
+        c = g_lcd.ddram[row * SIM_DDRAM_ROW + col];
+        g_line[row][col] = ( c < 0x20 ) ? ' ' : (char)c;
+    }
+    g_line[row][HAL_SIM_LCD_COLS] = '\0';
+    return g_line[row];
+}
+
+
+/**************************************************************************//*!
+ * @brief     転送した回数を返す。
+ * @attention なし。
+ * @note      NACK になった転送も数える。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    転送した回数
+ *************************************************************************** */
+unsigned long long
+HalCmnI2cSim_GetCount(
+    void
+){
+    return g_count;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
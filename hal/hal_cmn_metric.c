@@ -0,0 +1,209 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_metric.c
+ *  @brief          [HAL] 動作状況の計測値 ( カウンタ, ゲージ, 転送時間 ) の共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           センサを読み出すスレッドが更新し、別のスレッド ( app/if_metric ) が読み出す。
+ *                  書き込むスレッドは 1 つなので、更新は relaxed の load + store で行い、
+ *                  ロック命令 ( lock 付き命令 / LL-SC のループ ) を使わない。
+ *                  読み出し側も relaxed の load なので、計測値同士の整合性は保証しない
+ *                  ( 転送回数とヒストグラムの合計が一時的にずれる場合がある )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define METRIC_INC(p, n)    __atomic_store_n( (p), __atomic_load_n( (p), __ATOMIC_RELAXED ) + (n), __ATOMIC_RELAXED )
+#define METRIC_LOAD(p)      __atomic_load_n( (p), __ATOMIC_RELAXED )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SHalMetric_t     g_metric;
+
+// 転送時間のヒストグラムの区間の上限 ( nsec, 最後の区間は +Inf )
+static const unsigned long long g_bound[HAL_METRIC_BUCKET_NUM - 1] = {
+       10000ULL,    20000ULL,    50000ULL,
+      100000ULL,   200000ULL,   500000ULL,
+     1000000ULL,  2000000ULL,  5000000ULL,
+    10000000ULL
+};
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+// なし
+
+
+
+
+/**************************************************************************//*!
+ * @brief     カウンタを加算する。
+ * @attention 呼び出すスレッドは 1 つであること。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnMetric_Add(
+    EHalMetric_t        id,     ///< [in] カウンタ
+    unsigned long long  n       ///< [in] 加算する値
+){
+    METRIC_INC( &g_metric.count[id], n );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ゲージに値をセットする。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnMetric_Set(
+    EHalMetricGauge_t   id,     ///< [in] ゲージ
+    unsigned long long  value   ///< [in] 値
+){
+    __atomic_store_n( &g_metric.gauge[id], value, __ATOMIC_RELAXED );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch のサンプル数を 1 加算する。
+ * @attention 呼び出すスレッドは 1 つであること。
+ * @note      HalCmnHist_Push() から呼ばれる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnMetric_Sample(
+    EHalSensorCh_t      ch      ///< [in] 対象の ch
+){
+    METRIC_INC( &g_metric.sample[ch], 1 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     バスの転送を 1 回記録する。
+ * @attention 呼び出すスレッドは 1 つであること。
+ * @note      転送開始時刻から現在までを転送時間としてヒストグラムに加える。
+ * @sa        HalCmnMetric_GetBound()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnMetric_Xfer(
+    EHalMetricBus_t     bus,    ///< [in] バス
+    unsigned long long  start,  ///< [in] 転送開始時刻 ( HalCmnClock_GetNsec() )
+    EHalBool_t          ok      ///< [in] EN_TRUE : 成功, EN_FALSE : 失敗
+){
+    SHalMetricBus_t*    m = &g_metric.bus[bus];
+    unsigned long long  ns = HalCmnClock_GetNsec() - start;
+    unsigned int        i = 0;
+
+    while( i < HAL_METRIC_BUCKET_NUM - 1 && ns > g_bound[i] ){ i++; }
+
+    METRIC_INC( &m->xfer, 1 );
+    METRIC_INC( &m->sum, ns );
+    METRIC_INC( &m->bucket[i], 1 );
+    if( ok == EN_FALSE ){ METRIC_INC( &m->err, 1 ); }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     全ての計測値をコピーする。
+ * @attention 計測値同士の整合性は保証しない。
+ * @note      どのスレッドから呼んでもよい。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnMetric_Get(
+    SHalMetric_t*       out     ///< [out] 計測値
+){
+    unsigned int        i = 0;
+    unsigned int        j = 0;
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ ){ out->sample[i] = METRIC_LOAD( &g_metric.sample[i] ); }
+    for( i = 0; i < EN_METRIC_NUM; i++ ){ out->count[i] = METRIC_LOAD( &g_metric.count[i] ); }
+    for( i = 0; i < EN_METRIC_GAUGE_NUM; i++ ){ out->gauge[i] = METRIC_LOAD( &g_metric.gauge[i] ); }
+    for( i = 0; i < EN_METRIC_BUS_NUM; i++ )
+    {
+        out->bus[i].xfer = METRIC_LOAD( &g_metric.bus[i].xfer );
+        out->bus[i].err  = METRIC_LOAD( &g_metric.bus[i].err );
+        out->bus[i].sum  = METRIC_LOAD( &g_metric.bus[i].sum );
+        for( j = 0; j < HAL_METRIC_BUCKET_NUM; j++ )
+        {
+            out->bus[i].bucket[j] = METRIC_LOAD( &g_metric.bus[i].bucket[j] );
+        }
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     転送時間のヒストグラムの区間の上限を返す。
+ * @attention なし。
+ * @note      最後の区間 ( HAL_METRIC_BUCKET_NUM - 1 ) は上限なし ( 0 を返す )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    上限 ( nsec ), 0 : +Inf
+ *************************************************************************** */
+unsigned long long
+HalCmnMetric_GetBound(
+    unsigned int        idx     ///< [in] 区間
+){
+    if( idx >= HAL_METRIC_BUCKET_NUM - 1 )
+    {
+        return 0;
+    }
+    return g_bound[idx];
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
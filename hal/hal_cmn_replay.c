@@ -0,0 +1,313 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_replay.c
+ *  @brief          [HAL] 記録したセンサ値 ( app/if_rec ) を再生する共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             app/if_rec/if_rec.h
+ *  @note           再生中は HalCmnSpiMcp3208_Get() と BMX055 の読み出しが、SPI / I2C の代わりに
+ *                  記録したセンサ値を返す。フィルタ, 統計, 出力など HAL より上の処理は
+ *                  ハードウェアがなくてもそのまま動く。
+ *                  ch 毎に読み出し位置を持ち、その ch を含むレコードを記録順に返す。
+ *                  時刻は記録した最初のレコードを再生を開始した時刻に合わせてずらす。
+ *                      EN_REPLAY_REAL : レコードの時刻になるまで待ってから返す
+ *                      EN_REPLAY_FAST : 待たずに返す ( 時刻は実時間より先に進む )
+ *                  どれかの ch が記録の最後に達したら HalCmnReplay_IsEnd() が EN_TRUE になり、
+ *                  その ch は最後の値を返し続ける。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal_cmn.h"
+#include "../app/if_rec/if_rec.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define REPLAY_NSEC_PER_SEC     (1000000000ULL)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// ch 毎の読み出し位置に使用する型
+typedef struct tagSHalCmnReplayCh
+{
+    unsigned int        seg;        // セグメントの番号
+    unsigned long long  idx;        // セグメント内のレコードの番号
+    int                 raw;        // 最後に返した生値
+    unsigned long long  ts;         // 最後に返した生値の時刻 ( 再生の時間軸, nsec )
+    unsigned long long  woke;       // 最後に待ち終えた時刻 ( nsec, 0 = 待っていない )
+} SHalCmnReplayCh_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SAppIfRecFile_t*     g_file = NULL;          // 開いたセグメント
+static unsigned int         g_fileNum = 0;          // 開いたセグメントの数
+static EHalReplay_t         g_mode = EN_REPLAY_REAL;
+static EHalBool_t           g_end = EN_FALSE;       // どれかの ch が最後に達した
+static unsigned long long   g_first = 0;            // 最初のレコードの時刻 ( 記録の時間軸, nsec )
+static unsigned long long   g_base = 0;             // 再生を開始した時刻 ( nsec )
+static SHalCmnReplayCh_t    g_ch[EN_SEN_CH_NUM];
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Wait( unsigned long long ts );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     指定した時刻まで待つ。
+ * @attention なし。
+ * @note      HalCmnClock_GetNsec() の CLOCK_MONOTONIC_RAW は clock_nanosleep() で
+ *            指定できないので、残り時間を nanosleep() で待つ。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Wait(
+    unsigned long long  ts      ///< [in] 時刻 ( nsec )
+){
+    unsigned long long  now = HalCmnClock_GetNsec();
+    struct timespec     rem;
+
+    if( ts <= now )
+    {
+        return;
+    }
+
+    rem.tv_sec  = (time_t)( ( ts - now ) / REPLAY_NSEC_PER_SEC );
+    rem.tv_nsec = (long)( ( ts - now ) % REPLAY_NSEC_PER_SEC );
+    while( nanosleep( &rem, &rem ) != 0 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     記録したセンサ値の再生を開始する。
+ * @attention 既に再生中の場合は閉じてから開始する。
+ * @note      path.0000 から続く全てのセグメントを開く。
+ * @sa        HalCmnReplay_Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnReplay_Open(
+    const char*         path,   ///< [in] セグメントのパスの接頭辞 ( -F rec -o で指定したもの )
+    EHalReplay_t        mode    ///< [in] 再生の速さ
+){
+    SAppIfRecFile_t     file;
+    SAppIfRecFile_t*    tmp = NULL;
+    unsigned int        ch = 0;
+
+    DBG_PRINT_TRACE( "path = %s, mode = %d \n\r", path, mode );
+
+    HalCmnReplay_Close();
+
+    while( AppIfRecReader_Open( &file, path, g_fileNum ) == EN_TRUE )
+    {
+        tmp = (SAppIfRecFile_t*)realloc( g_file, sizeof(SAppIfRecFile_t) * ( g_fileNum + 1 ) );
+        if( tmp == NULL )
+        {
+            DBG_PRINT_ERROR( "realloc() error. \n\r" );
+            AppIfRecReader_Close( &file );
+            goto err;
+        }
+        g_file = tmp;
+        g_file[g_fileNum++] = file;
+    }
+
+    if( g_fileNum == 0 || g_file[0].count == 0 )
+    {
+        DBG_PRINT_ERROR( "no records. : %s \n\r", path );
+        goto err;
+    }
+
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        if( g_file[0].hdr->h.scale[ch] != HalCmnHist_Scale( (EHalSensorCh_t)ch ) )
+        {
+            DBG_PRINT_WARN( "the scale of %s differs from the recording. \n\r", HalCmn_GetChName( (EHalSensorCh_t)ch ) );
+        }
+    }
+
+    memset( g_ch, 0, sizeof(g_ch) );
+    g_mode  = mode;
+    g_end   = EN_FALSE;
+    g_first = g_file[0].rec[0].ts;
+    g_base  = HalCmnClock_GetNsec();
+    return EN_TRUE;
+
+err :
+    HalCmnReplay_Close();
+    return EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     記録したセンサ値の再生を終了する。
+ * @attention なし。
+ * @note      再生していない場合は何もしない。
+ * @sa        HalCmnReplay_Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnReplay_Close(
+    void
+){
+    unsigned int    i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < g_fileNum; i++ )
+    {
+        AppIfRecReader_Close( &g_file[i] );
+    }
+    free( g_file );
+    g_file = NULL;
+    g_fileNum = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     再生中かを返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 再生中, EN_FALSE : 再生していない
+ *************************************************************************** */
+EHalBool_t
+HalCmnReplay_IsOpen(
+    void
+){
+    return ( g_fileNum != 0 ) ? EN_TRUE : EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     どれかの ch が記録の最後に達したかを返す。
+ * @attention なし。
+ * @note      センサを繰り返し読み出す処理の終了条件に使う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 最後に達した, EN_FALSE : 再生中 / 再生していない
+ *************************************************************************** */
+EHalBool_t
+HalCmnReplay_IsEnd(
+    void
+){
+    return ( g_fileNum != 0 ) ? g_end : EN_FALSE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch の次の生値を返す。
+ * @attention 再生中に呼ぶこと。
+ * @note      その ch を含まないレコードは読み飛ばす。
+ *            EN_REPLAY_REAL の場合はレコードの時刻になるまで待つ。
+ * @sa        HalCmnReplay_Shift()
+ * @author    Ryoji Morita
+ * @return    生値 ( 最後に達した場合は最後の値 )
+ *************************************************************************** */
+int
+HalCmnReplay_Get(
+    EHalSensorCh_t          ch      ///< [in] 対象の ch
+){
+    SHalCmnReplayCh_t*      cur = &g_ch[ch];
+    const SAppIfRecRec_t*   rec = NULL;
+
+    while( cur->seg < g_fileNum )
+    {
+        if( cur->idx >= g_file[cur->seg].count )
+        {
+            cur->seg++;
+            cur->idx = 0;
+            continue;
+        }
+
+        rec = &g_file[cur->seg].rec[cur->idx++];
+        if( rec->mask & ( 1U << ch ) )
+        {
+            cur->raw = rec->raw[ch];
+            cur->ts  = g_base + ( rec->ts - g_first );
+            if( g_mode == EN_REPLAY_REAL )
+            {
+                Wait( cur->ts );
+                cur->woke = HalCmnClock_GetNsec();
+            }
+            return cur->raw;
+        }
+    }
+
+    g_end = EN_TRUE;
+    return cur->raw;
+}
+
+
+/**************************************************************************//*!
+ * @brief     転送の開始 / 終了時刻を、最後に返した生値の時刻に合わせてずらす。
+ * @attention なし。
+ * @note      転送にかかった時間 ( end - start ) は変えない。
+ *            ただし HalCmnReplay_Get() で待った時間は含めない。
+ *            再生していない場合は何もしない。
+ * @sa        HalCmnReplay_Get()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnReplay_Shift(
+    EHalSensorCh_t      ch,     ///< [in]     対象の ch
+    unsigned long long* start,  ///< [in,out] 転送を開始した時刻 ( nsec )
+    unsigned long long* end     ///< [in,out] 転送が終了した時刻 ( nsec )
+){
+    if( g_fileNum == 0 || g_ch[ch].ts == 0 )
+    {
+        return;
+    }
+
+    if( g_ch[ch].woke > *start && g_ch[ch].woke <= *end )
+    {
+        *start = g_ch[ch].woke;
+    }
+    *end   = g_ch[ch].ts + ( *end - *start );
+    *start = g_ch[ch].ts;
+    return;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,123 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_sim.c
+ *  @brief          [HAL] デバイスのエミュレータが返す模擬信号の共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             hal_cmn_spi_sim.c
+ *  @note           値は時刻だけで決まる ( 雑音を除く ) ので、読み出す間隔が変わっても波形は崩れない。
+ *                  雑音は xorshift32 の一様乱数で、シードは固定 ( 実行毎に同じ系列 )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <math.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SIM_NSEC_PER_MSEC   (1000000.0)
+#define SIM_PI              (3.14159265358979323846)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static unsigned int     g_seed = 0x2545F491;    // 雑音の乱数の状態
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static double       Noise( void );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     -1.0 から 1.0 までの一様乱数を返す。
+ * @attention なし。
+ * @note      xorshift32
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    乱数
+ *************************************************************************** */
+static double
+Noise(
+    void
+){
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+    return (double)g_seed / 2147483647.5 - 1.0;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時刻 ns の模擬信号の値を返す。
+ * @attention なし。
+ * @note      period_ms が 0 の場合は波形によらず center ( + 雑音 ) を返す。
+ * @sa        SHalSimSig_t
+ * @author    Ryoji Morita
+ * @return    値
+ *************************************************************************** */
+double
+HalCmnSim_Value(
+    const SHalSimSig_t* sig,    ///< [in] 模擬信号
+    unsigned long long  ns      ///< [in] 時刻 ( nsec )
+){
+    double              x = 0.0;
+    double              v = 0.0;
+
+    if( sig->wave != EN_SIM_WAVE_DC && sig->period_ms > 0 )
+    {
+        x = fmod( (double)ns / ( sig->period_ms * SIM_NSEC_PER_MSEC ) + sig->phase, 1.0 );
+        switch( sig->wave )
+        {
+        case EN_SIM_WAVE_SINE:   v = sin( 2.0 * SIM_PI * x ); break;
+        case EN_SIM_WAVE_SQUARE: v = ( x < 0.5 ) ? 1.0 : -1.0; break;
+        case EN_SIM_WAVE_RAMP:   v = 2.0 * x - 1.0; break;
+        default:                 v = 0.0; break;
+        }
+    }
+
+    v = sig->center + sig->amp * v;
+    if( sig->noise > 0.0 )
+    {
+        v += sig->noise * Noise();
+    }
+    return v;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -3,7 +3,9 @@
  *  @brief          [HAL] SPI の共通 API を定義したファイル。
  *  @author         Ryoji Morita
  *  @attention      none.
- *  @sa             none.
+ *  @sa             hal_cmn_spi_sim.c ( MCP3208 のエミュレータ )
+ *  @note           転送は SHalSpiOps_t の関数テーブルを経由する。既定は /dev/spidev0.0 で、
+ *                  HalCmnSpi_SetOps() でエミュレータなどに差し替えられる。
  *  @bug            none.
  *  @warning        none.
  *  @version        1.00
@@ -18,6 +20,7 @@
 /* include                                               */
 //********************************************************
 #include <fcntl.h>
+#include <stdint.h>
 #include <sys/mman.h>
 
 #include <sys/ioctl.h>
@@ -59,6 +62,8 @@ typedef struct {
 /* モジュールグローバル変数                              */
 //********************************************************
 static SHalCmnSpi_t     g_param;
+static const SHalSpiOps_t*  g_ops = NULL;       // 転送手段 ( NULL : /dev/spidev0.0 )
+static EHalBool_t       g_open = EN_FALSE;      // 転送手段を開いている
 
 
 //********************************************************
@@ -66,6 +71,10 @@ static SHalCmnSpi_t     g_param;
 //********************************************************
 static void         InitParam( void );
 static EHalBool_t   InitReg( void );
+static EHalBool_t   SpidevOpen( void );
+static void         SpidevClose( void );
+static EHalBool_t   SpidevXfer( const unsigned char* send, unsigned char* recv, unsigned int size );
+static EHalBool_t   Xfer( const unsigned char* send, unsigned char* recv, unsigned int size );
 
 
 
@@ -86,8 +95,8 @@ InitParam(
 
     g_param.fd = -1;
 
-    g_param.tr.tx_buf        = (unsigned int)0;
-    g_param.tr.rx_buf        = (unsigned int)NULL;
+    g_param.tr.tx_buf        = 0;
+    g_param.tr.rx_buf        = 0;
     g_param.tr.len           = 1;
     g_param.tr.speed_hz      = SPI_SPEED;
     g_param.tr.delay_usecs   = SPI_DELAY;
@@ -182,28 +191,124 @@ InitReg(
 
 
 /**************************************************************************//*!
- * @brief     SPI デバイスをオープンする。
+ * @brief     /dev/spidev0.0 を開く。
  * @attention なし。
  * @note      なし。
- * @sa        なし。
+ * @sa        SpidevClose()
  * @author    Ryoji Morita
  * @return    EN_TRUE : 成功, EN_FALSE : 失敗
  *************************************************************************** */
-EHalBool_t
-HalCmnSpi_Init(
+static EHalBool_t
+SpidevOpen(
     void
 ){
-    EHalBool_t      ret = EN_FALSE;
+    InitParam();
+    return InitReg();
+}
 
-    DBG_PRINT_TRACE( "\n\r" );
 
-    InitParam();
-    ret = InitReg();
+/**************************************************************************//*!
+ * @brief     /dev/spidev0.0 を閉じる。
+ * @attention なし。
+ * @note      なし。
+ * @sa        SpidevOpen()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SpidevClose(
+    void
+){
+    if( g_param.fd >= 0 )
+    {
+        close( g_param.fd );
+        g_param.fd = -1;
+    }
+    return;
+}
 
+
+/**************************************************************************//*!
+ * @brief     /dev/spidev0.0 で全二重の転送を行う。
+ * @attention なし。
+ * @note      tx_buf, rx_buf は 64 bit のアドレスなので、ポインタは uintptr_t を経由して渡す。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+SpidevXfer(
+    const unsigned char*    send,   ///< [in]  送るデータ
+    unsigned char*          recv,   ///< [out] 受け取ったデータ ( NULL : 捨てる )
+    unsigned int            size    ///< [in]  転送する Byte 数
+){
+    g_param.tr.tx_buf = (unsigned long long)(uintptr_t)send;
+    g_param.tr.rx_buf = (unsigned long long)(uintptr_t)recv;
+    g_param.tr.len    = size;
+
+    if( ioctl( g_param.fd, SPI_IOC_MESSAGE(1), &g_param.tr ) < 0 )
+    {
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+// /dev/spidev0.0 の転送手段
+static const SHalSpiOps_t   g_spidev = { "spidev", SpidevOpen, SpidevClose, SpidevXfer };
+
+
+/**************************************************************************//*!
+ * @brief     転送手段で転送し、転送時間を計測する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+Xfer(
+    const unsigned char*    send,   ///< [in]  送るデータ
+    unsigned char*          recv,   ///< [out] 受け取ったデータ ( NULL : 捨てる )
+    unsigned int            size    ///< [in]  転送する Byte 数
+){
+    EHalBool_t              ret = EN_FALSE;
+    unsigned long long      start = 0;
+
+    start = HalCmnClock_GetNsec();
+    ret = ( g_open == EN_TRUE ) ? g_ops->xfer( send, recv, size ) : EN_FALSE;
+    HalCmnMetric_Xfer( EN_METRIC_BUS_SPI, start, ret );
+    if( ret == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "error: cannot send spi message. \n\r" );
+    }
     return ret;
 }
 
 
+/**************************************************************************//*!
+ * @brief     SPI デバイスをオープンする。
+ * @attention なし。
+ * @note      HalCmnSpi_SetOps() で設定した転送手段を開く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnSpi_Init(
+    void
+){
+    if( g_ops == NULL )
+    {
+        g_ops = &g_spidev;
+    }
+    DBG_PRINT_TRACE( "%s \n\r", g_ops->name );
+
+    g_open = g_ops->open();
+    return g_open;
+}
+
+
 /**************************************************************************//*!
  * @brief     SPI デバイスをクローズする。
  * @attention なし。
@@ -218,11 +323,58 @@ HalCmnSpi_Fini(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
-    close( g_param.fd );
+    if( g_open == EN_TRUE )
+    {
+        g_ops->close();
+        g_open = EN_FALSE;
+    }
     return;
 }
 
 
+/**************************************************************************//*!
+ * @brief     転送手段を差し替える。
+ * @attention 転送中に呼ばないこと。
+ * @note      NULL の場合は /dev/spidev0.0 に戻す。
+ *            開いている場合は、今の転送手段を閉じて新しい転送手段を開く。
+ * @sa        HalCmnSpiSim_GetOps()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 新しい転送手段を開けなかった )
+ *************************************************************************** */
+EHalBool_t
+HalCmnSpi_SetOps(
+    const SHalSpiOps_t* ops     ///< [in] 転送手段
+){
+    EHalBool_t          open = g_open;
+
+    DBG_PRINT_TRACE( "%s \n\r", ( ops != NULL ) ? ops->name : g_spidev.name );
+
+    HalCmnSpi_Fini();
+    g_ops = ( ops != NULL ) ? ops : &g_spidev;
+    if( open == EN_TRUE )
+    {
+        return HalCmnSpi_Init();
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     転送手段を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnSpi_SetOps()
+ * @author    Ryoji Morita
+ * @return    転送手段
+ *************************************************************************** */
+const SHalSpiOps_t*
+HalCmnSpi_GetOps(
+    void
+){
+    return ( g_ops != NULL ) ? g_ops : &g_spidev;
+}
+
+
 /**************************************************************************//*!
  * @brief     SPI スレーブデバイスに 1 Byte データを単発送信する。
  * @attention なし。
@@ -235,24 +387,9 @@ EHalBool_t
 HalCmnSpi_Send(
     unsigned char   data    ///< [in] スレーブデバイスへ送るデータ
 ){
-    EHalBool_t      ret = EN_FALSE;
-    int             res = -1;
-
     DBG_PRINT_TRACE( "\n\r" );
 
-    g_param.tr.tx_buf = (unsigned int)data;
-    g_param.tr.rx_buf = (unsigned int)NULL;
-    g_param.tr.len    = 1;
-
-    res = ioctl( g_param.fd, SPI_IOC_MESSAGE(1), &g_param.tr );
-    if( res < 0 )
-    {
-        DBG_PRINT_ERROR( "error: cannot send spi message. \n\r" );
-        return ret;
-    }
-
-    ret = EN_TRUE;
-    return ret;
+    return Xfer( &data, NULL, 1 );
 }
 
 
@@ -269,24 +406,9 @@ HalCmnSpi_SendN(
     unsigned char*  data,   ///< [in] スレーブデバイスへ送るデータ
     int             size    ///< [in] 送信する Byte 数 ( n <= SPI_BUFFERSIZE )
 ){
-    EHalBool_t      ret = EN_FALSE;
-    int             res = -1;
-
     DBG_PRINT_TRACE( "\n\r" );
 
-    g_param.tr.tx_buf = (unsigned int)data;
-    g_param.tr.rx_buf = (unsigned int)NULL;
-    g_param.tr.len    = size;
-
-    res = ioctl( g_param.fd, SPI_IOC_MESSAGE(1), &g_param.tr );
-    if( res < 0 )
-    {
-        DBG_PRINT_ERROR( "error: cannot send spi message. \n\r" );
-        return ret;
-    }
-
-    ret = EN_TRUE;
-    return ret;
+    return Xfer( data, NULL, (unsigned int)size );
 }
 
 
@@ -314,10 +436,6 @@ HalCmnSpi_SendBuffer(
     numBlock  = size / SPI_BLOCKSIZE;
     lastBlock = size % SPI_BLOCKSIZE;
 
-    g_param.tr.tx_buf = (unsigned int)data;
-    g_param.tr.rx_buf = (unsigned int)NULL;
-    g_param.tr.len    = size;
-
     for( i = 0; i < numBlock; i++ )
     {
         ret = HalCmnSpi_SendN( data, SPI_BLOCKSIZE );
@@ -360,28 +478,12 @@ HalCmnSpi_RecvN(
     unsigned char*  recv,   ///< [out] スレーブデバイスからのデータを格納するバッファ
     unsigned int    size    ///< [in]  受け取るデータサイズ
 ){
-    EHalBool_t      ret = EN_FALSE;
-    int             res = -1;
-
     DBG_PRINT_TRACE( "\n\r" );
 
-    g_param.tr.tx_buf = (unsigned int)send;
-    g_param.tr.rx_buf = (unsigned int)recv;
-    g_param.tr.len    = size;
-
-    res = ioctl( g_param.fd, SPI_IOC_MESSAGE(1), &g_param.tr );
-    if( res < 0 )
-    {
-        DBG_PRINT_ERROR( "error: cannot send spi message. \n\r" );
-        return ret;
-    }
-
-    ret = EN_TRUE;
-    return ret;
+    return Xfer( send, recv, size );
 }
 
 
 #ifdef __cplusplus
     }
 #endif
-
@@ -47,7 +47,11 @@
 //********************************************************
 /* モジュールグローバル変数                              */
 //********************************************************
-// なし
+// 再生時に MCP3208 の Ch に対応する ch ( EN_SEN_CH_NUM : 接続なし )
+static const EHalSensorCh_t g_replayCh[] = {
+    EN_SEN_CH_DIST_FL,  EN_SEN_CH_DIST_FR,  EN_SEN_CH_DIST_FSL, EN_SEN_CH_DIST_FSR,
+    EN_SEN_CH_NUM,      EN_SEN_CH_NUM,      EN_SEN_CH_NUM,      EN_SEN_CH_PM
+};
 
 
 //********************************************************
@@ -61,7 +65,7 @@
 /**************************************************************************//*!
  * @brief     MCP3208 の対象の ch の AD 値を読み出す
  * @attention なし。
- * @note      なし。
+ * @note      再生中 ( HalCmnReplay_Open() ) は記録した AD 値を返す。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    MCP3208 の AD 値
@@ -76,6 +80,12 @@ HalCmnSpiMcp3208_Get(
 
     DBG_PRINT_TRACE( "\n\r" );
 
+    if( HalCmnReplay_IsOpen() == EN_TRUE )
+    {
+        if( g_replayCh[which & 0x07] == EN_SEN_CH_NUM ){ return 0; }
+        return (unsigned int)HalCmnReplay_Get( g_replayCh[which & 0x07] );
+    }
+
     send[0] = ( which & 0x04 ) ? 0x07 : 0x06;
     send[1] = ( which & 0x03 ) << 6;
     send[2] = 0;
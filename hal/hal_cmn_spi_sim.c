@@ -0,0 +1,359 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_spi_sim.c
+ *  @brief          [HAL] SPI の転送手段として動く MCP3208 のエミュレータを定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      HalCmnSpi_SetOps( HalCmnSpiSim_GetOps() ) で使う。
+ *  @sa             hal_cmn_spi.c, hal_cmn_spi_mcp3208.c, hal_cmn_sim.c
+ *  @note           送られたビット列をデータシートの通りに解釈する ( 1 回の転送 = CS の 1 回のアサート )。
+ *                      最初の 1 のビット        : スタートビット ( 位置 s )
+ *                      s+1                      : SGL/DIFF ( 1 = シングルエンド )
+ *                      s+2 - s+4                : D2 D1 D0 ( ch )
+ *                      s+5                      : サンプリング ( この時刻の模擬信号の値を変換する )
+ *                      s+6                      : ヌルビット ( 0 )
+ *                      s+7 - s+18               : B11 - B0 ( MSB ファースト )
+ *                      s+19 - s+29              : B1 - B11 ( 続けてクロックを送った場合は LSB ファースト )
+ *                  それ以外の受信ビットは 0 ( Hi-Z )。スタートビットがない転送は何も変換しない。
+ *                  差動入力 ( SGL/DIFF = 0 ) は IN+ - IN- を 0 - 4095 に丸める。
+ *                  転送時間は 1 Byte = 8 クロックとして、クロック周波数から求めた時間だけ待つ
+ *                  ( usec 未満なのでビジーウェイト )。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <string.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define SIM_CH_NUM          (8)             // MCP3208 の ch 数
+#define SIM_ADC_MAX         (4095)          // 12 bit
+#define SIM_NSEC_PER_SEC    (1000000000ULL)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// ch 毎の模擬信号の初期値 ( Ch 0 - 3 : 距離センサ, Ch 7 : ポテンショメータ )
+static const SHalSimSig_t   g_def[SIM_CH_NUM] = {
+    { EN_SIM_WAVE_SINE, 2048.0, 1200.0, 10000, 0.00, 3.0 },
+    { EN_SIM_WAVE_SINE, 2048.0, 1200.0, 10000, 0.25, 3.0 },
+    { EN_SIM_WAVE_SINE, 2048.0, 1200.0, 10000, 0.50, 3.0 },
+    { EN_SIM_WAVE_SINE, 2048.0, 1200.0, 10000, 0.75, 3.0 },
+    { EN_SIM_WAVE_DC,      0.0,    0.0,     0, 0.00, 0.0 },
+    { EN_SIM_WAVE_DC,      0.0,    0.0,     0, 0.00, 0.0 },
+    { EN_SIM_WAVE_DC,      0.0,    0.0,     0, 0.00, 0.0 },
+    { EN_SIM_WAVE_SINE, 1024.0,  512.0, 60000, 0.00, 2.0 }
+};
+
+static SHalSimSig_t         g_sig[SIM_CH_NUM];      // ch 毎の模擬信号
+static EHalBool_t           g_init = EN_FALSE;      // g_sig を初期値にした
+static unsigned int         g_hz = HAL_SIM_SPI_HZ;  // クロック周波数 ( Hz, 0 = 待たない )
+static unsigned long long   g_count = 0;            // 変換した回数
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static EHalBool_t   Open( void );
+static void         Close( void );
+static EHalBool_t   Xfer( const unsigned char* send, unsigned char* recv, unsigned int size );
+static void         InitSig( void );
+static unsigned int Bit( const unsigned char* buf, unsigned int pos );
+static unsigned int Sample( unsigned int ch, unsigned long long ns );
+static unsigned int Convert( unsigned int sgl, unsigned int ch, unsigned long long ns );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     模擬信号を初期値にする。
+ * @attention なし。
+ * @note      初めて呼んだ時だけ行う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitSig(
+    void
+){
+    if( g_init == EN_FALSE )
+    {
+        memcpy( g_sig, g_def, sizeof(g_sig) );
+        g_init = EN_TRUE;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ビット列の pos ビット目 ( MSB ファースト ) を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    0 または 1
+ *************************************************************************** */
+static unsigned int
+Bit(
+    const unsigned char*    buf,    ///< [in] ビット列
+    unsigned int            pos     ///< [in] 位置
+){
+    return ( buf[pos >> 3] >> ( 7 - ( pos & 7 ) ) ) & 1;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch の時刻 ns の値を AD 値に丸めて返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    AD 値 ( 0 - 4095 )
+ *************************************************************************** */
+static unsigned int
+Sample(
+    unsigned int        ch,     ///< [in] ch
+    unsigned long long  ns      ///< [in] 時刻 ( nsec )
+){
+    double              v = HalCmnSim_Value( &g_sig[ch], ns ) + 0.5;
+
+    if( v < 0.0 ){ return 0; }
+    if( v > SIM_ADC_MAX ){ return SIM_ADC_MAX; }
+    return (unsigned int)v;
+}
+
+
+/**************************************************************************//*!
+ * @brief     1 回の変換を行う。
+ * @attention なし。
+ * @note      差動入力の組は ( Ch 0, Ch 1 ), ( Ch 2, Ch 3 ), ... で、D0 が 1 の場合は極性が逆。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    AD 値 ( 0 - 4095 )
+ *************************************************************************** */
+static unsigned int
+Convert(
+    unsigned int        sgl,    ///< [in] 1 : シングルエンド, 0 : 差動
+    unsigned int        ch,     ///< [in] D2 D1 D0
+    unsigned long long  ns      ///< [in] サンプリングの時刻 ( nsec )
+){
+    int                 pos = 0;
+    int                 neg = 0;
+
+    g_count++;
+    if( sgl )
+    {
+        return Sample( ch, ns );
+    }
+
+    pos = (int)Sample( ch,     ns );
+    neg = (int)Sample( ch ^ 1, ns );
+    return ( pos > neg ) ? (unsigned int)( pos - neg ) : 0;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータを開く。
+ * @attention なし。
+ * @note      模擬信号は変えない ( HalCmnSpiSim_SetSignal() で設定したまま )。
+ * @sa        Close()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功
+ *************************************************************************** */
+static EHalBool_t
+Open(
+    void
+){
+    DBG_PRINT_TRACE( "clock = %u Hz \n\r", g_hz );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータを閉じる。
+ * @attention なし。
+ * @note      なし。
+ * @sa        Open()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Close(
+    void
+){
+    DBG_PRINT_TRACE( "count = %llu \n\r", g_count );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     全二重の転送を行う。
+ * @attention なし。
+ * @note      送られたビット列からコマンドを取り出し、同じ位置に変換結果を返す。
+ *            転送時間 ( size * 8 クロック ) が経つまで戻らない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功
+ *************************************************************************** */
+static EHalBool_t
+Xfer(
+    const unsigned char*    send,   ///< [in]  送るデータ
+    unsigned char*          recv,   ///< [out] 受け取ったデータ ( NULL : 捨てる )
+    unsigned int            size    ///< [in]  転送する Byte 数
+){
+    unsigned long long      start = HalCmnClock_GetNsec();
+    unsigned long long      clk = 0;
+    unsigned int            bits = size * 8;
+    unsigned int            s = 0;
+    unsigned int            b = 0;
+    unsigned int            v = 0;
+    unsigned int            sgl = 0;
+    unsigned int            ch = 0;
+    unsigned int            out = 0;
+
+    if( g_hz > 0 )
+    {
+        clk = SIM_NSEC_PER_SEC / g_hz;
+    }
+
+    if( recv != NULL )
+    {
+        memset( recv, 0, size );
+    }
+
+    // スタートビット
+    for( s = 0; s < bits && Bit( send, s ) == 0; s++ );
+
+    if( s + 5 < bits )
+    {
+        sgl = Bit( send, s + 1 );
+        ch  = ( Bit( send, s + 2 ) << 2 ) | ( Bit( send, s + 3 ) << 1 ) | Bit( send, s + 4 );
+        v   = Convert( sgl, ch, start + clk * ( s + 5 ) );
+
+        for( b = s + 7; b < bits && b <= s + 29 && recv != NULL; b++ )
+        {
+            if( b <= s + 18 )
+            {
+                out = ( v >> ( 11 - ( b - s - 7 ) ) ) & 1;      // B11 - B0
+            } else
+            {
+                out = ( v >> ( b - s - 18 ) ) & 1;              // B1 - B11
+            }
+            recv[b >> 3] |= (unsigned char)( out << ( 7 - ( b & 7 ) ) );
+        }
+    }
+
+    if( clk > 0 )
+    {
+        while( HalCmnClock_GetNsec() < start + clk * bits );
+    }
+    return EN_TRUE;
+}
+
+
+// MCP3208 のエミュレータの転送手段
+static const SHalSpiOps_t   g_ops = { "mcp3208-sim", Open, Close, Xfer };
+
+
+/**************************************************************************//*!
+ * @brief     エミュレータの転送手段を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalCmnSpi_SetOps()
+ * @author    Ryoji Morita
+ * @return    転送手段
+ *************************************************************************** */
+const SHalSpiOps_t*
+HalCmnSpiSim_GetOps(
+    void
+){
+    InitSig();
+    return &g_ops;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch の模擬信号を設定する。
+ * @attention なし。
+ * @note      NULL の場合は初期値に戻す。値は 0 - 4095 に丸めて返す。
+ * @sa        HalCmnSim_Value()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnSpiSim_SetSignal(
+    EHalSensorMcp3208_t ch,     ///< [in] ch
+    const SHalSimSig_t* sig     ///< [in] 模擬信号
+){
+    InitSig();
+    g_sig[ch & 0x07] = ( sig != NULL ) ? *sig : g_def[ch & 0x07];
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     クロック周波数を設定する。
+ * @attention なし。
+ * @note      0 の場合は転送時間を待たない ( ドライバの処理時間だけを計る場合 )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnSpiSim_SetClock(
+    unsigned int    hz      ///< [in] クロック周波数 ( Hz )
+){
+    g_hz = hz;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     変換した回数を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    変換した回数
+ *************************************************************************** */
+unsigned long long
+HalCmnSpiSim_GetCount(
+    void
+){
+    return g_count;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,638 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_stats.c
+ *  @brief          [HAL] センサ値の区間統計 ( 移動窓 ) の共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             hal_cmn_hist.c
+ *  @note           ch 毎に最大 HAL_STATS_WIN_MAX 個の時間窓 ( 例 : 100 ms, 1 s, 10 s ) を持ち、
+ *                  HalCmnHist_Push() の度に次の値を 1 サンプルあたり償却 O(1) で更新する。
+ *                      平均 / 分散 : Welford 法でサンプルを追加・削除する
+ *                      最小 / 最大 : 単調キュー ( 通し番号の deque ) で保持する
+ *                  窓から外れるサンプルの値は履歴 ( hal_cmn_hist.c ) から読むので、
+ *                  窓の長さは履歴に残っている範囲までに制限される。
+ *                  単調キューは時間窓の設定時に ch の最大周波数から確保し、サンプル毎には確保しない。
+ *                  溢れた ( 最大周波数を大きく超えて読み出した ) 窓は、窓の長さ分たまり直すまで無効にする。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdlib.h>
+#include <math.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define STATS_NSEC_PER_MSEC     (1000000ULL)
+#define STATS_DEQUE_MIN         (64)        // 単調キューの最小サイズ ( 2 のべき乗 )
+#define STATS_DEQUE_MAX         (0x80000000U)
+#define STATS_DEQUE_HEADROOM    (2)         // 最大周波数に対する余裕 ( 倍 )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 単調キュー ( 通し番号のリングバッファ )
+typedef struct {
+    unsigned int*       seq;    // 通し番号
+    unsigned int        mask;   // 確保したサイズ - 1 ( 未確保の時は 0 )
+    unsigned int        front;  // 先頭の位置
+    unsigned int        back;   // 末尾の次の位置
+} SHalCmnDeque_t;
+
+
+// 1 つの時間窓の統計
+typedef struct {
+    unsigned int        ms;     // 窓の長さ ( msec )
+    unsigned long long  span;   // 窓の長さ ( nsec )
+    unsigned int        tail;   // 窓に入っている最も古いサンプルの通し番号
+    unsigned int        n;      // 窓に入っているサンプル数
+    EHalBool_t          valid;  // EN_FALSE : 単調キューが溢れてから窓の長さ分たまっていない
+    double              mean;   // 平均 ( 生値 )
+    double              m2;     // 偏差平方和 ( 生値 )
+    SHalCmnDeque_t      dmin;   // 最小値の候補 ( 生値が単調増加 )
+    SHalCmnDeque_t      dmax;   // 最大値の候補 ( 生値が単調減少 )
+} SHalCmnStatsWin_t;
+
+
+// ch 毎の統計
+typedef struct {
+    unsigned int        num;    // 時間窓の数
+    SHalCmnStatsWin_t   win[HAL_STATS_WIN_MAX];
+} SHalCmnStats_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SHalCmnStats_t   g_stats[EN_SEN_CH_NUM];
+
+static const unsigned int   g_winDefault[] = { 100, 1000, 10000 };  // 初期化時の時間窓 ( msec )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         InitParam( void );
+static void         ResetWin( SHalCmnStatsWin_t* win, unsigned int ms );
+static void         FreeWin( SHalCmnStatsWin_t* win );
+static unsigned int MaxHz( EHalSensorCh_t ch );
+static EHalBool_t   AllocWin( SHalCmnStatsWin_t* win, EHalSensorCh_t ch );
+
+static EHalBool_t   Deque_Alloc( SHalCmnDeque_t* dq, unsigned int size );
+static EHalBool_t   Deque_Push( SHalCmnDeque_t* dq, unsigned int seq );
+static void         Deque_Free( SHalCmnDeque_t* dq );
+
+static EHalBool_t   AddSample( SHalCmnStatsWin_t* win, EHalSensorCh_t ch, unsigned int seq, short raw );
+static void         RemoveSample( SHalCmnStatsWin_t* win, EHalSensorCh_t ch );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ファイルスコープ内のグローバル変数を初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitParam(
+    void  ///< [in] ナシ
+){
+    int             i = 0;
+    unsigned int    w = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        g_stats[i].num = 0;
+        for( w = 0; w < HAL_STATS_WIN_MAX; w++ )
+        {
+            g_stats[i].win[w].dmin.seq  = NULL;
+            g_stats[i].win[w].dmin.mask = 0;
+            g_stats[i].win[w].dmax.seq  = NULL;
+            g_stats[i].win[w].dmax.mask = 0;
+            ResetWin( &g_stats[i].win[w], 0 );
+        }
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間窓の統計をクリアする。
+ * @attention なし。
+ * @note      単調キューの領域は解放せずに再利用する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+ResetWin(
+    SHalCmnStatsWin_t*  win,    ///< [in] 対象の時間窓
+    unsigned int        ms      ///< [in] 窓の長さ ( msec )
+){
+    win->ms   = ms;
+    win->span = (unsigned long long)ms * STATS_NSEC_PER_MSEC;
+    win->tail = 0;
+    win->n    = 0;
+    win->valid = EN_TRUE;
+    win->mean = 0.0;
+    win->m2   = 0.0;
+
+    win->dmin.front = 0;
+    win->dmin.back  = 0;
+    win->dmax.front = 0;
+    win->dmax.back  = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間窓の領域を解放する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+FreeWin(
+    SHalCmnStatsWin_t*  win     ///< [in] 対象の時間窓
+){
+    Deque_Free( &win->dmin );
+    Deque_Free( &win->dmax );
+    ResetWin( win, 0 );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch の最大のサンプリング周波数を返す。
+ * @attention なし。
+ * @note      履歴の容量と同じ値 ( HAL_HIST_HZ_* ) を使う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    周波数 ( Hz )
+ *************************************************************************** */
+static unsigned int
+MaxHz(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    if( ch <= EN_SEN_CH_DIST_FSR ){ return HAL_HIST_HZ_DIST; }
+    if( ch == EN_SEN_CH_PM )      { return HAL_HIST_HZ_PM; }
+    if( ch <= EN_SEN_CH_ACC_Z )   { return HAL_HIST_HZ_ACC; }
+    if( ch <= EN_SEN_CH_GYRO_Z )  { return HAL_HIST_HZ_GYRO; }
+    return HAL_HIST_HZ_MAG;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間窓の単調キューを確保する。
+ * @attention なし。
+ * @note      窓に入るサンプル数 ( 窓の長さ x 最大周波数 x 余裕 ) 分を確保する。
+ *            履歴の容量 ( 設定した保持時間 x 最大周波数 ) より多くは窓に入らない。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+AllocWin(
+    SHalCmnStatsWin_t*  win,    ///< [in] 対象の時間窓
+    EHalSensorCh_t      ch      ///< [in] 対象の ch
+){
+    unsigned long long  num = (unsigned long long)win->ms * MaxHz( ch ) * STATS_DEQUE_HEADROOM / 1000 + 1;
+    unsigned long long  cap = (unsigned long long)HalCmnHist_CapOf( MaxHz( ch ) ) + 1;
+    unsigned int        size = STATS_DEQUE_MIN;
+
+    if( num > cap ){ num = cap; }
+    while( size < num && size < STATS_DEQUE_MAX )
+    {
+        size <<= 1;
+    }
+
+    if( Deque_Alloc( &win->dmin, size ) == EN_FALSE
+    ||  Deque_Alloc( &win->dmax, size ) == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "fail to allocate deque. : ch = %d, ms = %u, size = %u \n\r", ch, win->ms, size );
+        FreeWin( win );
+        return EN_FALSE;
+    }
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     単調キューの領域を確保する。
+ * @attention なし。
+ * @note      同じサイズを確保済みの場合は再利用する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+static EHalBool_t
+Deque_Alloc(
+    SHalCmnDeque_t* dq,     ///< [in] 対象の単調キュー
+    unsigned int    size    ///< [in] サイズ ( 2 のべき乗 )
+){
+    if( dq->seq == NULL || dq->mask != size - 1 )
+    {
+        Deque_Free( dq );
+        dq->seq = malloc( size * sizeof(unsigned int) );
+        if( dq->seq == NULL )
+        {
+            return EN_FALSE;
+        }
+        dq->mask = size - 1;
+    }
+
+    dq->front = 0;
+    dq->back  = 0;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     単調キューの末尾に通し番号を追加する。
+ * @attention なし。
+ * @note      領域は拡張しない ( サンプル毎に確保しない )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 満杯 / 未確保 )
+ *************************************************************************** */
+static EHalBool_t
+Deque_Push(
+    SHalCmnDeque_t* dq,     ///< [in] 対象の単調キュー
+    unsigned int    seq     ///< [in] 通し番号
+){
+    if( dq->seq == NULL || dq->back - dq->front > dq->mask )
+    {
+        return EN_FALSE;
+    }
+
+    dq->seq[dq->back & dq->mask] = seq;
+    dq->back++;
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     単調キューの領域を解放する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Deque_Free(
+    SHalCmnDeque_t* dq      ///< [in] 対象の単調キュー
+){
+    free( dq->seq );
+    dq->seq   = NULL;
+    dq->mask  = 0;
+    dq->front = 0;
+    dq->back  = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間窓に最新のサンプルを追加する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 単調キューが満杯 )
+ *************************************************************************** */
+static EHalBool_t
+AddSample(
+    SHalCmnStatsWin_t*  win,    ///< [in] 対象の時間窓
+    EHalSensorCh_t      ch,     ///< [in] 対象の ch
+    unsigned int        seq,    ///< [in] サンプルの通し番号
+    short               raw     ///< [in] 生値
+){
+    SHalCmnDeque_t* dq = NULL;
+    double          delta = 0.0;
+
+    if( win->n == 0 )
+    {
+        win->tail = seq;
+    }
+
+    win->n++;
+    delta = (double)raw - win->mean;
+    win->mean += delta / win->n;
+    win->m2   += delta * ( (double)raw - win->mean );
+
+    // 新しいサンプル以上 ( 以下 ) の候補は、窓から外れるまで最小 ( 最大 ) になり得ない
+    dq = &win->dmin;
+    while( dq->back != dq->front && HalCmnHist_Raw( ch, dq->seq[( dq->back - 1 ) & dq->mask] ) >= raw )
+    {
+        dq->back--;
+    }
+    if( Deque_Push( dq, seq ) == EN_FALSE ){ return EN_FALSE; }
+
+    dq = &win->dmax;
+    while( dq->back != dq->front && HalCmnHist_Raw( ch, dq->seq[( dq->back - 1 ) & dq->mask] ) <= raw )
+    {
+        dq->back--;
+    }
+    return Deque_Push( dq, seq );
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間窓から最も古いサンプルを削除する。
+ * @attention 窓にサンプルが 1 つ以上あること。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+RemoveSample(
+    SHalCmnStatsWin_t*  win,    ///< [in] 対象の時間窓
+    EHalSensorCh_t      ch      ///< [in] 対象の ch
+){
+    double          x = (double)HalCmnHist_Raw( ch, win->tail );
+    double          delta = 0.0;
+
+    win->n--;
+    if( win->n == 0 )
+    {
+        win->mean = 0.0;
+        win->m2   = 0.0;
+    } else
+    {
+        delta = x - win->mean;
+        win->mean -= delta / win->n;
+        win->m2   -= delta * ( x - win->mean );
+        if( win->m2 < 0.0 ){ win->m2 = 0.0; }
+    }
+
+    if( win->dmin.back != win->dmin.front && win->dmin.seq[win->dmin.front & win->dmin.mask] == win->tail )
+    {
+        win->dmin.front++;
+    }
+
+    if( win->dmax.back != win->dmax.front && win->dmax.seq[win->dmax.front & win->dmax.mask] == win->tail )
+    {
+        win->dmax.front++;
+    }
+
+    win->tail++;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     区間統計を初期化する。
+ * @attention HalCmnHist_Init() の後に呼ぶこと。
+ * @note      全 ch に 100 ms, 1 s, 10 s の時間窓を設定する。
+ * @sa        HalCmnStats_SetWindow()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnStats_Init(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    InitParam();
+    return HalCmnStats_SetWindow( g_winDefault, sizeof(g_winDefault) / sizeof(g_winDefault[0]) );
+}
+
+
+/**************************************************************************//*!
+ * @brief     区間統計の領域を解放する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnStats_Fini(
+    void  ///< [in] ナシ
+){
+    int             i = 0;
+    unsigned int    w = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        for( w = 0; w < HAL_STATS_WIN_MAX; w++ )
+        {
+            FreeWin( &g_stats[i].win[w] );
+        }
+        g_stats[i].num = 0;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     全 ch の時間窓を設定する。
+ * @attention それまでの統計はクリアする。
+ * @note      以降に HalCmnHist_Push() したサンプルから統計をとる。
+ *            単調キューはここで確保する ( 履歴の保持時間も反映する )。
+ *            確保できなかった窓は統計をとらない ( HalCmnStats_Get() が失敗する )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnStats_SetWindow(
+    const unsigned int* ms,     ///< [in] 窓の長さ ( msec ) の配列
+    unsigned int        num     ///< [in] 配列の要素数 ( 最大 HAL_STATS_WIN_MAX )
+){
+    int             i = 0;
+    unsigned int    w = 0;
+    EHalBool_t      ret = EN_TRUE;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( num > HAL_STATS_WIN_MAX )
+    {
+        DBG_PRINT_ERROR( "too many windows. : %u \n\r", num );
+        return EN_FALSE;
+    }
+
+    for( w = 0; w < num; w++ )
+    {
+        if( ms[w] == 0 )
+        {
+            DBG_PRINT_ERROR( "invalid window. : %u \n\r", ms[w] );
+            return EN_FALSE;
+        }
+    }
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        for( w = 0; w < HAL_STATS_WIN_MAX; w++ )
+        {
+            if( w >= num )
+            {
+                FreeWin( &g_stats[i].win[w] );
+                continue;
+            }
+
+            ResetWin( &g_stats[i].win[w], ms[w] );
+            if( AllocWin( &g_stats[i].win[w], (EHalSensorCh_t)i ) == EN_FALSE )
+            {
+                g_stats[i].win[w].ms = ms[w];
+                ret = EN_FALSE;
+            }
+        }
+        g_stats[i].num = num;
+    }
+    return ret;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間窓の数を返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    時間窓の数
+ *************************************************************************** */
+unsigned int
+HalCmnStats_GetWindowNum(
+    void  ///< [in] ナシ
+){
+    return g_stats[0].num;
+}
+
+
+/**************************************************************************//*!
+ * @brief     最新のサンプルで区間統計を更新する。
+ * @attention HalCmnHist_Push() から呼ばれる。
+ * @note      窓から外れたサンプルと、履歴から上書きされたサンプルを削除する。
+ *            単調キューが溢れた窓はクリアし、窓の長さ分 ( または履歴の範囲分 ) たまり直して
+ *            古いサンプルを削除するまで無効にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnStats_Update(
+    EHalSensorCh_t      ch,     ///< [in] 対象の ch
+    unsigned int        seq,    ///< [in] サンプルの通し番号
+    short               raw,    ///< [in] 生値
+    unsigned long long  ts      ///< [in] 時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    SHalCmnStats_t*     stats = &g_stats[ch];
+    SHalCmnStatsWin_t*  win = NULL;
+    unsigned int        count = HalCmnHist_Count( ch );
+    unsigned int        w = 0;
+
+    for( w = 0; w < stats->num; w++ )
+    {
+        win = &stats->win[w];
+        if( win->dmin.seq == NULL ){ continue; }
+
+        if( AddSample( win, ch, seq, raw ) == EN_FALSE )
+        {
+            if( win->valid == EN_TRUE )
+            {
+                DBG_PRINT_ERROR( "deque overflow. : ch = %d, ms = %u \n\r", ch, win->ms );
+            }
+            ResetWin( win, win->ms );
+            win->valid = EN_FALSE;
+            AddSample( win, ch, seq, raw );
+            continue;
+        }
+
+        while( win->n > 1
+        &&     ( seq - win->tail >= count || ts - HalCmnHist_Time( ch, win->tail ) > win->span ) )
+        {
+            RemoveSample( win, ch );
+            win->valid = EN_TRUE;
+        }
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     区間統計を返す。
+ * @attention なし。
+ * @note      値は HalCmnHist_Open() で指定した換算係数で物理量に換算する。
+ *            標準偏差は不偏分散から計算する ( サンプルが 1 つの時は 0 )。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗 ( 範囲外 / サンプルなし / 無効な窓 )
+ *************************************************************************** */
+EHalBool_t
+HalCmnStats_Get(
+    EHalSensorCh_t  ch,     ///< [in]  対象の ch
+    unsigned int    idx,    ///< [in]  時間窓の番号
+    SHalStats_t*    out     ///< [out] 区間統計
+){
+    SHalCmnStatsWin_t*  win = NULL;
+    double              scale = 0.0;
+    double              lo = 0.0;
+    double              hi = 0.0;
+
+    if( ch >= EN_SEN_CH_NUM || idx >= g_stats[ch].num )
+    {
+        return EN_FALSE;
+    }
+
+    win = &g_stats[ch].win[idx];
+    out->ms   = win->ms;
+    out->n    = ( win->valid == EN_TRUE ) ? win->n : 0;
+    out->mean = 0.0;
+    out->sd   = 0.0;
+    out->min  = 0.0;
+    out->max  = 0.0;
+    if( out->n == 0 || win->dmin.back == win->dmin.front || win->dmax.back == win->dmax.front )
+    {
+        return EN_FALSE;
+    }
+
+    scale = HalCmnHist_Scale( ch );
+    lo = (double)HalCmnHist_Raw( ch, win->dmin.seq[win->dmin.front & win->dmin.mask] ) * scale;
+    hi = (double)HalCmnHist_Raw( ch, win->dmax.seq[win->dmax.front & win->dmax.mask] ) * scale;
+
+    out->mean = win->mean * scale;
+    out->sd   = ( win->n > 1 ) ? sqrt( win->m2 / ( win->n - 1 ) ) * fabs( scale ) : 0.0;
+    out->min  = ( scale < 0.0 ) ? hi : lo;
+    out->max  = ( scale < 0.0 ) ? lo : hi;
+    return EN_TRUE;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
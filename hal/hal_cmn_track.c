@@ -0,0 +1,274 @@
+/**************************************************************************//*!
+ *  @file           hal_cmn_track.c
+ *  @brief          [HAL] センサ値の α-β トラッカの共通 API を定義したファイル。
+ *  @author         Ryoji Morita
+ *  @attention      none.
+ *  @sa             none.
+ *  @note           等速度モデルの α-β フィルタ ( 定常状態の Kalman フィルタと等価 ) で、
+ *                  ch 毎に位置 ( 距離 ) と速度を推定する。サンプル間隔は
+ *                  タイムスタンプから求めるので、取得周期が揺らいでも速度の単位は変わらない。
+ *                  ゲインは時定数と観測したサンプル間隔 ( 平滑化した周期 ) から毎回求める
+ *                  ( 臨界制動 ) ので、-i で周期を変えても応答の速さ ( 秒 ) は変わらない。
+ *                  1 サンプルあたり exp() 1 回と乗算 10 回程度なので、全 ch を取得周期で実行できる。
+ *                  推定をやり直す間隔は、平滑化した周期の TRACK_RESET_RATIO 倍にするので、
+ *                  -i で周期を長くしても推定は続く。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <math.h>
+
+#include "hal_cmn.h"
+
+
+//#define DBG_PRINT
+#define MY_NAME "HAL"
+#include "../app/log/log.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define TRACK_NSEC_PER_SEC  (1e9)
+#define TRACK_RESET_RATIO   (4.0)               // 周期のこの倍以上サンプルの間隔があいたら推定をやり直す
+#define TRACK_PERIOD_SHIFT  (3)                 // 周期の平滑化係数 ( 1 / 2^n )
+#define TRACK_VALID_N       (3)                 // 推定値を有効にする最小のサンプル数 ( 速度の推定に 2 区間 )
+#define TRACK_VALID_TAU     (5.0)               // 推定値を有効にする経過時間 ( 時定数の倍数, 速度の誤差は 5 % 以下 )
+#define TRACK_VEL_MIN       (1e-3)              // 接近していると判定する速度の下限 ( 単位 / sec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+typedef struct {
+    EHalBool_t          enable; // EN_TRUE : 推定する
+    double              tau;    // 時定数 ( nsec )
+    unsigned int        n;      // 受け取ったサンプル数
+    double              period; // 平滑化したサンプル間隔 ( nsec, 0 = 未観測 )
+    double              elapse; // 推定をやり直してからの経過時間 ( nsec )
+    SHalTrack_t         out;    // 推定値
+} SHalCmnTrack_t;
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SHalCmnTrack_t   g_track[EN_SEN_CH_NUM];
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         InitParam( void );
+static void         Reset( SHalCmnTrack_t* track );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     ファイルスコープ内のグローバル変数を初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+InitParam(
+    void  ///< [in] ナシ
+){
+    int     i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < EN_SEN_CH_NUM; i++ )
+    {
+        g_track[i].enable = EN_FALSE;
+        g_track[i].tau    = 0.0;
+        Reset( &g_track[i] );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     推定値をクリアする。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Reset(
+    SHalCmnTrack_t* track   ///< [in] 対象のトラッカ
+){
+    track->n         = 0;
+    track->period    = 0.0;
+    track->elapse    = 0.0;
+    track->out.valid = EN_FALSE;
+    track->out.pos   = 0.0;
+    track->out.vel   = 0.0;
+    track->out.ttc   = -1.0;
+    track->out.ts    = 0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     トラッカを初期化する。
+ * @attention なし。
+ * @note      全 ch のトラッカを無効にする。
+ * @sa        HalCmnTrack_Open()
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnTrack_Init(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    InitParam();
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     ch のトラッカを設定する。
+ * @attention それまでの推定値はクリアする。
+ * @note      時定数が短いほど速く追従し、長いほど雑音を抑える。
+ *            ゲインはサンプル間隔から HalCmnTrack_Update() で求める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalCmnTrack_Open(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch
+    double          tau     ///< [in] 時定数 ( sec )
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( ch >= EN_SEN_CH_NUM )
+    {
+        DBG_PRINT_ERROR( "invalid channel. : %d \n\r", ch );
+        return EN_FALSE;
+    }
+
+    if( !( tau > 0.0 ) )
+    {
+        DBG_PRINT_ERROR( "invalid time constant. : tau = %f \n\r", tau );
+        return EN_FALSE;
+    }
+
+    g_track[ch].enable = EN_TRUE;
+    g_track[ch].tau    = tau * TRACK_NSEC_PER_SEC;
+    Reset( &g_track[ch] );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     観測値で推定値を更新する。
+ * @attention トラッカが無効の ch では何もしない。
+ * @note      最初のサンプルと、間隔が周期の TRACK_RESET_RATIO 倍以上あいたサンプルでは
+ *            観測値をそのまま位置にし、速度を 0 にする ( 周期も観測し直す )。
+ *            ゲインは極を θ = exp( -周期 / 時定数 ) の重根に置いて、alpha = 1 - θ^2, beta = ( 1 - θ )^2 とする。
+ *            そこから時定数の TRACK_VALID_TAU 倍の時間が経ち、TRACK_VALID_N サンプル以上受け取るまでは
+ *            速度が収束していないので無効 ( valid = EN_FALSE ) にする。
+ *            接触までの時間は 位置 / 接近速度。接近していない / 無効の場合は -1 にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalCmnTrack_Update(
+    EHalSensorCh_t      ch,     ///< [in] 対象の ch
+    double              z,      ///< [in] 観測値
+    unsigned long long  ts      ///< [in] 観測した時刻 ( CLOCK_MONOTONIC_RAW, nsec )
+){
+    SHalCmnTrack_t*     track = &g_track[ch];
+    SHalTrack_t*        out = &track->out;
+    double              gap = 0.0;
+    double              dt = 0.0;
+    double              r = 0.0;
+    double              theta = 0.0;
+    double              alpha = 0.0;
+    double              beta = 0.0;
+
+    if( track->enable == EN_FALSE )
+    {
+        return;
+    }
+
+    gap = ( ts > out->ts ) ? (double)( ts - out->ts ) : 0.0;
+    if( track->n == 0 || gap <= 0.0 || ( track->period > 0.0 && gap >= track->period * TRACK_RESET_RATIO ) )
+    {
+        track->n      = 0;
+        track->period = 0.0;
+        track->elapse = 0.0;
+        out->pos = z;
+        out->vel = 0.0;
+    } else
+    {
+        // 最初の間隔はそのまま、以降は指数移動平均で周期を求める
+        track->period += ( track->period > 0.0 ) ? ( gap - track->period ) / ( 1 << TRACK_PERIOD_SHIFT ) : gap;
+        track->elapse += gap;
+        dt = gap / TRACK_NSEC_PER_SEC;
+
+        theta = exp( -track->period / track->tau );
+        alpha = 1.0 - theta * theta;
+        beta  = ( 1.0 - theta ) * ( 1.0 - theta );
+
+        // 予測
+        out->pos += out->vel * dt;
+
+        // 補正
+        r = z - out->pos;
+        out->pos += alpha * r;
+        out->vel += beta * r / dt;
+    }
+
+    track->n++;
+    out->ts    = ts;
+    out->valid = ( track->n >= TRACK_VALID_N && track->elapse >= track->tau * TRACK_VALID_TAU ) ? EN_TRUE : EN_FALSE;
+    out->ttc   = ( out->valid == EN_TRUE && out->vel < -TRACK_VEL_MIN && out->pos > 0.0 ) ? out->pos / -out->vel : -1.0;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     推定値のアドレスを返す。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    推定値のアドレス
+ *************************************************************************** */
+SHalTrack_t*
+HalCmnTrack_Get(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    return &g_track[ch].out;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,76 @@
+/**************************************************************************//*!
+ *  @file           hal_dist_cal.h
+ *  @brief          [HAL] 距離センサの校正点を定義したヘッダファイル。
+ *  @author         Ryoji Morita
+ *  @attention      tools/gen_dist_lut.c だけがインクルードする。
+ *                  ここから ADC 値 -> 距離 ( mm ) の変換テーブルをビルド時に生成する。
+ *  @sa             none.
+ *  @note           校正点は各センサのデータシートの代表特性 ( 出力電圧 - 距離 ) を
+ *                  読み取ったもの。個体差を補正する場合は実測値に置き換えること。
+ *                  電圧の高い順 ( 距離の近い順 ) に並べる。
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+
+// 多重コンパイル抑止
+#ifndef _HAL_DIST_CAL_H_
+#define _HAL_DIST_CAL_H_
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include "hal.h"
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// 校正点に使用する型
+typedef struct tagSHalDistCal
+{
+    unsigned int        mv;     ///< @var : センサの出力電圧 ( mV )
+    unsigned int        mm;     ///< @var : 距離         ( mm )
+} SHalDistCal_t;
+
+
+//********************************************************
+/* 校正点                                                */
+//********************************************************
+// SHARP GP2Y0A21YK0F ( 10 - 80 cm )
+static const SHalDistCal_t  g_calGp2y0a21yk[] = {
+    { 3150,  60 }, { 2750,  80 }, { 2300, 100 }, { 1650, 150 }, { 1300, 200 },
+    { 1080, 250 }, {  920, 300 }, {  740, 400 }, {  610, 500 }, {  520, 600 },
+    {  450, 700 }, {  400, 800 },
+};
+
+// SHARP GP2Y0A02YK0F ( 20 - 150 cm )
+static const SHalDistCal_t  g_calGp2y0a02yk[] = {
+    { 2750,  150 }, { 2500,  200 }, { 2000,  300 }, { 1550,  400 }, { 1250,  500 },
+    { 1050,  600 }, {  930,  700 }, {  820,  800 }, {  730,  900 }, {  660, 1000 },
+    {  550, 1200 }, {  430, 1500 },
+};
+
+// SHARP GP2Y0A41SK0F ( 4 - 30 cm )
+static const SHalDistCal_t  g_calGp2y0a41sk[] = {
+    { 3000,  30 }, { 2750,  40 }, { 2300,  50 }, { 2000,  60 }, { 1550,  80 },
+    { 1300, 100 }, { 1100, 120 }, {  900, 150 }, {  680, 200 }, {  550, 250 },
+    {  450, 300 },
+};
+
+
+// EHalDistModel_t の順に並べる
+static const struct {
+    const SHalDistCal_t*    cal;    // 校正点
+    unsigned int            num;    // 校正点の数
+    const char*             name;   // センサ名
+} g_calTable[EN_DIST_MODEL_NUM] = {
+    { g_calGp2y0a21yk, sizeof(g_calGp2y0a21yk) / sizeof(g_calGp2y0a21yk[0]), "GP2Y0A21YK0F" },
+    { g_calGp2y0a02yk, sizeof(g_calGp2y0a02yk) / sizeof(g_calGp2y0a02yk[0]), "GP2Y0A02YK0F" },
+    { g_calGp2y0a41sk, sizeof(g_calGp2y0a41sk) / sizeof(g_calGp2y0a41sk[0]), "GP2Y0A41SK0F" },
+};
+
+
+#endif /* _HAL_DIST_CAL_H_ */
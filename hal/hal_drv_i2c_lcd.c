@@ -205,6 +205,7 @@ HalI2cLcd_Write(
         DBG_PRINT_ERROR( "fail to write data to i2c slave. \n\r" );
         return ret;
     }
+    HalCmnMetric_Add( EN_METRIC_LCD_BYTES, 2 );
 
     ret = EN_TRUE;
     return ret;
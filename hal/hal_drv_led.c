@@ -17,8 +17,6 @@
 //********************************************************
 /* include                                               */
 //********************************************************
-#include <wiringPi.h>
-
 #include "hal_cmn.h"
 #include "hal.h"
 
@@ -95,10 +93,10 @@ InitReg(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
-    pinMode( LED0_OUT, OUTPUT );
-    pinMode( LED1_OUT, OUTPUT );
-    pinMode( LED2_OUT, OUTPUT );
-    pinMode( LED3_OUT, OUTPUT );
+    HalCmnGpio_Mode( LED0_OUT, EN_GPIO_OUT );
+    HalCmnGpio_Mode( LED1_OUT, EN_GPIO_OUT );
+    HalCmnGpio_Mode( LED2_OUT, EN_GPIO_OUT );
+    HalCmnGpio_Mode( LED3_OUT, EN_GPIO_OUT );
 
     return EN_TRUE;
 }
@@ -167,20 +165,20 @@ HalLed_Set(
     DBG_PRINT_TRACE( "\n\r" );
 
     flg = ( value & 0x01 ) >> 0;
-    if( flg == 1 ){ digitalWrite( LED0_OUT, EN_HIGH ); }
-    else          { digitalWrite( LED0_OUT, EN_LOW  ); }
+    if( flg == 1 ){ HalCmnGpio_Write( LED0_OUT, EN_HIGH ); }
+    else          { HalCmnGpio_Write( LED0_OUT, EN_LOW  ); }
 
     flg = ( value & 0x02 ) >> 1;
-    if( flg == 1 ){ digitalWrite( LED1_OUT, EN_HIGH ); }
-    else          { digitalWrite( LED1_OUT, EN_LOW  ); }
+    if( flg == 1 ){ HalCmnGpio_Write( LED1_OUT, EN_HIGH ); }
+    else          { HalCmnGpio_Write( LED1_OUT, EN_LOW  ); }
 
     flg = ( value & 0x04 ) >> 2;
-    if( flg == 1 ){ digitalWrite( LED2_OUT, EN_HIGH ); }
-    else          { digitalWrite( LED2_OUT, EN_LOW  ); }
+    if( flg == 1 ){ HalCmnGpio_Write( LED2_OUT, EN_HIGH ); }
+    else          { HalCmnGpio_Write( LED2_OUT, EN_LOW  ); }
 
     flg = ( value & 0x08 ) >> 3;
-    if( flg == 1 ){ digitalWrite( LED3_OUT, EN_HIGH ); }
-    else          { digitalWrite( LED3_OUT, EN_LOW  ); }
+    if( flg == 1 ){ HalCmnGpio_Write( LED3_OUT, EN_HIGH ); }
+    else          { HalCmnGpio_Write( LED3_OUT, EN_LOW  ); }
 
     return;
 }
@@ -17,8 +17,6 @@
 //********************************************************
 /* include                                               */
 //********************************************************
-#include <wiringPi.h>
-
 #include "hal_cmn.h"
 #include "hal.h"
 
@@ -94,9 +92,9 @@ InitReg(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
-    pinMode( PUSH_SW0_IN, INPUT );
-    pinMode( PUSH_SW1_IN, INPUT );
-    pinMode( PUSH_SW2_IN, INPUT );
+    HalCmnGpio_Mode( PUSH_SW0_IN, EN_GPIO_IN );
+    HalCmnGpio_Mode( PUSH_SW1_IN, EN_GPIO_IN );
+    HalCmnGpio_Mode( PUSH_SW2_IN, EN_GPIO_IN );
 
     return EN_TRUE;
 }
@@ -167,9 +165,9 @@ HalPushSw_Get(
 
     switch( which )
     {
-    case EN_PUSH_SW_0 : state = digitalRead( PUSH_SW0_IN ); break;
-    case EN_PUSH_SW_1 : state = digitalRead( PUSH_SW1_IN ); break;
-    case EN_PUSH_SW_2 : state = digitalRead( PUSH_SW2_IN ); break;
+    case EN_PUSH_SW_0 : state = HalCmnGpio_Read( PUSH_SW0_IN ); break;
+    case EN_PUSH_SW_1 : state = HalCmnGpio_Read( PUSH_SW1_IN ); break;
+    case EN_PUSH_SW_2 : state = HalCmnGpio_Read( PUSH_SW2_IN ); break;
     default           : break;
     }
 
@@ -17,8 +17,6 @@
 //********************************************************
 /* include                                               */
 //********************************************************
-#include <wiringPi.h>
-
 #include "hal_cmn.h"
 #include "hal.h"
 
@@ -34,6 +32,14 @@
 #define LED0_OUT    (19)
 #define LED1_OUT    (26)
 
+#define DIST_MODEL_DEFAULT  (EN_DIST_GP2Y0A21YK)    // 初期化時に設定する型番
+
+#define DIST_FILTER_MODE    (EN_FILTER_HAMPEL)      // 初期化時に設定するフィルタ
+#define DIST_FILTER_WIN     (5)                     // 初期化時に設定するフィルタの窓の大きさ
+#define DIST_FILTER_K       (3.0)                   // 初期化時に設定する外れ値の閾値
+
+#define DIST_TRACK_TAU      (0.05)                  // 接近速度の推定の時定数 ( sec )
+
 
 //********************************************************
 /*! @enum                                                */
@@ -55,6 +61,14 @@ static SHalSensor_t     g_dataFR;     // センサの値 : Front Right
 static SHalSensor_t     g_dataFSL;    // センサの値 : Front Side Left
 static SHalSensor_t     g_dataFSR;    // センサの値 : Front Side Right
 
+static const unsigned short*    g_lutFL;    // 距離換算テーブル : Front Left
+static const unsigned short*    g_lutFR;    // 距離換算テーブル : Front Right
+static const unsigned short*    g_lutFSL;   // 距離換算テーブル : Front Side Left
+static const unsigned short*    g_lutFSR;   // 距離換算テーブル : Front Side Right
+
+// AD 値 -> 距離 ( mm ) の変換テーブル ( ビルド時に tools/gen_dist_lut.c が生成する )
+extern const unsigned short     g_halDistLut[EN_DIST_MODEL_NUM][HAL_DIST_LUT_SIZE];
+
 
 //********************************************************
 /* 関数プロトタイプ宣言                                  */
@@ -88,6 +102,13 @@ InitParam(
     g_dataFL.err = 0;                 // err = cur - ofs
     g_dataFL.cur_rate = 0;            // cur_rate = ( cur / max ) * 100 ( %  )
     g_dataFL.cur_vol = 0;             // cur_vol = 電圧に換算した現在値 ( mV )
+    g_dataFL.raw = 0;                 // raw = センサの生値
+    g_dataFL.ver = 0;                 // ver = 更新回数
+    g_dataFL.vref = MCP3208_VREF_MV;  // vref = 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+    g_dataFL.cache = ~0U;             // cache = err, cur_rate, cur_vol を計算した時の ver
+    g_dataFL.ts_start = 0;            // ts_start = 転送を開始した時刻 ( nsec )
+    g_dataFL.ts_end = 0;              // ts_end   = 転送が終了した時刻 ( nsec )
+    g_dataFL.cur_mm = 0;              // cur_mm = 距離に換算した現在値 ( mm )
 
     g_dataFR.cur = 0;                 // cur = センサの現在値 ( MCP3208 の AD 値 )
     g_dataFR.ofs = 0;                 // ofs = 初期化時に設定したセンサのオフセット値
@@ -96,6 +117,13 @@ InitParam(
     g_dataFR.err = 0;                 // err = cur - ofs
     g_dataFR.cur_rate = 0;            // cur_rate = ( cur / max ) * 100 ( %  )
     g_dataFR.cur_vol = 0;             // cur_vol = 電圧に換算した現在値 ( mV )
+    g_dataFR.raw = 0;                 // raw = センサの生値
+    g_dataFR.ver = 0;                 // ver = 更新回数
+    g_dataFR.vref = MCP3208_VREF_MV;  // vref = 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+    g_dataFR.cache = ~0U;             // cache = err, cur_rate, cur_vol を計算した時の ver
+    g_dataFR.ts_start = 0;            // ts_start = 転送を開始した時刻 ( nsec )
+    g_dataFR.ts_end = 0;              // ts_end   = 転送が終了した時刻 ( nsec )
+    g_dataFR.cur_mm = 0;              // cur_mm = 距離に換算した現在値 ( mm )
 
     g_dataFSL.cur = 0;                 // cur = センサの現在値 ( MCP3208 の AD 値 )
     g_dataFSL.ofs = 0;                 // ofs = 初期化時に設定したセンサのオフセット値
@@ -104,6 +132,13 @@ InitParam(
     g_dataFSL.err = 0;                 // err = cur - ofs
     g_dataFSL.cur_rate = 0;            // cur_rate = ( cur / max ) * 100 ( %  )
     g_dataFSL.cur_vol = 0;             // cur_vol = 電圧に換算した現在値 ( mV )
+    g_dataFSL.raw = 0;                 // raw = センサの生値
+    g_dataFSL.ver = 0;                 // ver = 更新回数
+    g_dataFSL.vref = MCP3208_VREF_MV;  // vref = 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+    g_dataFSL.cache = ~0U;             // cache = err, cur_rate, cur_vol を計算した時の ver
+    g_dataFSL.ts_start = 0;            // ts_start = 転送を開始した時刻 ( nsec )
+    g_dataFSL.ts_end = 0;              // ts_end   = 転送が終了した時刻 ( nsec )
+    g_dataFSL.cur_mm = 0;              // cur_mm = 距離に換算した現在値 ( mm )
 
     g_dataFSR.cur = 0;                 // cur = センサの現在値 ( MCP3208 の AD 値 )
     g_dataFSR.ofs = 0;                 // ofs = 初期化時に設定したセンサのオフセット値
@@ -112,6 +147,18 @@ InitParam(
     g_dataFSR.err = 0;                 // err = cur - ofs
     g_dataFSR.cur_rate = 0;            // cur_rate = ( cur / max ) * 100 ( %  )
     g_dataFSR.cur_vol = 0;             // cur_vol = 電圧に換算した現在値 ( mV )
+    g_dataFSR.raw = 0;                 // raw = センサの生値
+    g_dataFSR.ver = 0;                 // ver = 更新回数
+    g_dataFSR.vref = MCP3208_VREF_MV;  // vref = 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+    g_dataFSR.cache = ~0U;             // cache = err, cur_rate, cur_vol を計算した時の ver
+    g_dataFSR.ts_start = 0;            // ts_start = 転送を開始した時刻 ( nsec )
+    g_dataFSR.ts_end = 0;              // ts_end   = 転送が終了した時刻 ( nsec )
+    g_dataFSR.cur_mm = 0;              // cur_mm = 距離に換算した現在値 ( mm )
+
+    g_lutFL  = g_halDistLut[DIST_MODEL_DEFAULT];
+    g_lutFR  = g_halDistLut[DIST_MODEL_DEFAULT];
+    g_lutFSL = g_halDistLut[DIST_MODEL_DEFAULT];
+    g_lutFSR = g_halDistLut[DIST_MODEL_DEFAULT];
 
     return;
 }
@@ -131,8 +178,20 @@ InitReg(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
-    pinMode( LED0_OUT, OUTPUT );
-    pinMode( LED1_OUT, OUTPUT );
+    HalCmnGpio_Mode( LED0_OUT, EN_GPIO_OUT );
+    HalCmnGpio_Mode( LED1_OUT, EN_GPIO_OUT );
+
+    // 単発のスパイクを除去する ( 履歴には除去する前の AD 値を残す )
+    HalCmnFilter_Open( EN_SEN_CH_DIST_FL,  DIST_FILTER_MODE, DIST_FILTER_WIN, DIST_FILTER_K );
+    HalCmnFilter_Open( EN_SEN_CH_DIST_FR,  DIST_FILTER_MODE, DIST_FILTER_WIN, DIST_FILTER_K );
+    HalCmnFilter_Open( EN_SEN_CH_DIST_FSL, DIST_FILTER_MODE, DIST_FILTER_WIN, DIST_FILTER_K );
+    HalCmnFilter_Open( EN_SEN_CH_DIST_FSR, DIST_FILTER_MODE, DIST_FILTER_WIN, DIST_FILTER_K );
+
+    // 距離 ( mm ) から接近速度と接触までの時間を推定する
+    HalCmnTrack_Open( EN_SEN_CH_DIST_FL,  DIST_TRACK_TAU );
+    HalCmnTrack_Open( EN_SEN_CH_DIST_FR,  DIST_TRACK_TAU );
+    HalCmnTrack_Open( EN_SEN_CH_DIST_FSL, DIST_TRACK_TAU );
+    HalCmnTrack_Open( EN_SEN_CH_DIST_FSR, DIST_TRACK_TAU );
 
     return EN_TRUE;
 }
@@ -195,6 +254,12 @@ HalSensorDist_Init(
     }
 
     SetOffset();
+
+    // 履歴は MCP3208 の AD 値のまま保持する ( オフセットを読んだ値は履歴と統計に含めない )
+    HalCmnHist_Open( EN_SEN_CH_DIST_FL,  HalCmnHist_CapOf( HAL_HIST_HZ_DIST ), 1.0 );
+    HalCmnHist_Open( EN_SEN_CH_DIST_FR,  HalCmnHist_CapOf( HAL_HIST_HZ_DIST ), 1.0 );
+    HalCmnHist_Open( EN_SEN_CH_DIST_FSL, HalCmnHist_CapOf( HAL_HIST_HZ_DIST ), 1.0 );
+    HalCmnHist_Open( EN_SEN_CH_DIST_FSR, HalCmnHist_CapOf( HAL_HIST_HZ_DIST ), 1.0 );
     ret = EN_TRUE;
     return ret;
 }
@@ -234,12 +299,12 @@ Led_Set(
     DBG_PRINT_TRACE( "\n\r" );
 
     flg = ( value & 0x01 ) >> 0;
-    if( flg == 1 ){ digitalWrite( LED0_OUT, EN_HIGH ); }
-    else          { digitalWrite( LED0_OUT, EN_LOW  ); }
+    if( flg == 1 ){ HalCmnGpio_Write( LED0_OUT, EN_HIGH ); }
+    else          { HalCmnGpio_Write( LED0_OUT, EN_LOW  ); }
 
     flg = ( value & 0x02 ) >> 1;
-    if( flg == 1 ){ digitalWrite( LED1_OUT, EN_HIGH ); }
-    else          { digitalWrite( LED1_OUT, EN_LOW  ); }
+    if( flg == 1 ){ HalCmnGpio_Write( LED1_OUT, EN_HIGH ); }
+    else          { HalCmnGpio_Write( LED1_OUT, EN_LOW  ); }
 
     return;
 }
@@ -257,12 +322,23 @@ SHalSensor_t*
 HalSensorDist_GetFL(
     void  ///< [in] ナシ
 ){
-    unsigned int    data = 0;
+    unsigned int        data = 0;
+    unsigned int        filt = 0;
+    unsigned long long  start = 0;
+    unsigned long long  end = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
     Led_Set( 0x03 );
+    start = HalCmnClock_GetNsec();
     data = HalCmnSpiMcp3208_Get( EN_MCP3208_CH_0 );
-    HalCmn_UpdateSenData( &g_dataFL, (double)data );
+    end = HalCmnClock_GetNsec();
+    HalCmnReplay_Shift( EN_SEN_CH_DIST_FL, &start, &end );
+    HalCmn_SetSenTime( &g_dataFL, start, end );
+    HalCmnHist_Push( EN_SEN_CH_DIST_FL, (short)data, start );
+    filt = HalCmnFilter_Apply( EN_SEN_CH_DIST_FL, (int)data );
+    HalCmn_UpdateSenData( &g_dataFL, (int)data, (double)filt );
+    g_dataFL.cur_mm = g_lutFL[filt & ( HAL_DIST_LUT_SIZE - 1 )];
+    HalCmnTrack_Update( EN_SEN_CH_DIST_FL, (double)g_dataFL.cur_mm, start );
     Led_Set( 0x00 );
     return &g_dataFL;
 }
@@ -272,12 +348,23 @@ SHalSensor_t*
 HalSensorDist_GetFR(
     void  ///< [in] ナシ
 ){
-    unsigned int    data = 0;
+    unsigned int        data = 0;
+    unsigned int        filt = 0;
+    unsigned long long  start = 0;
+    unsigned long long  end = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
     Led_Set( 0x03 );
+    start = HalCmnClock_GetNsec();
     data = HalCmnSpiMcp3208_Get( EN_MCP3208_CH_1 );
-    HalCmn_UpdateSenData( &g_dataFR, (double)data );
+    end = HalCmnClock_GetNsec();
+    HalCmnReplay_Shift( EN_SEN_CH_DIST_FR, &start, &end );
+    HalCmn_SetSenTime( &g_dataFR, start, end );
+    HalCmnHist_Push( EN_SEN_CH_DIST_FR, (short)data, start );
+    filt = HalCmnFilter_Apply( EN_SEN_CH_DIST_FR, (int)data );
+    HalCmn_UpdateSenData( &g_dataFR, (int)data, (double)filt );
+    g_dataFR.cur_mm = g_lutFR[filt & ( HAL_DIST_LUT_SIZE - 1 )];
+    HalCmnTrack_Update( EN_SEN_CH_DIST_FR, (double)g_dataFR.cur_mm, start );
     Led_Set( 0x00 );
     return &g_dataFR;
 }
@@ -286,12 +373,23 @@ SHalSensor_t*
 HalSensorDist_GetFSL(
     void  ///< [in] ナシ
 ){
-    unsigned int    data = 0;
+    unsigned int        data = 0;
+    unsigned int        filt = 0;
+    unsigned long long  start = 0;
+    unsigned long long  end = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
     Led_Set( 0x03 );
+    start = HalCmnClock_GetNsec();
     data = HalCmnSpiMcp3208_Get( EN_MCP3208_CH_2 );
-    HalCmn_UpdateSenData( &g_dataFSL, (double)data );
+    end = HalCmnClock_GetNsec();
+    HalCmnReplay_Shift( EN_SEN_CH_DIST_FSL, &start, &end );
+    HalCmn_SetSenTime( &g_dataFSL, start, end );
+    HalCmnHist_Push( EN_SEN_CH_DIST_FSL, (short)data, start );
+    filt = HalCmnFilter_Apply( EN_SEN_CH_DIST_FSL, (int)data );
+    HalCmn_UpdateSenData( &g_dataFSL, (int)data, (double)filt );
+    g_dataFSL.cur_mm = g_lutFSL[filt & ( HAL_DIST_LUT_SIZE - 1 )];
+    HalCmnTrack_Update( EN_SEN_CH_DIST_FSL, (double)g_dataFSL.cur_mm, start );
     Led_Set( 0x00 );
     return &g_dataFSL;
 }
@@ -301,17 +399,90 @@ SHalSensor_t*
 HalSensorDist_GetFSR(
     void  ///< [in] ナシ
 ){
-    unsigned int    data = 0;
+    unsigned int        data = 0;
+    unsigned int        filt = 0;
+    unsigned long long  start = 0;
+    unsigned long long  end = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
     Led_Set( 0x03 );
+    start = HalCmnClock_GetNsec();
     data = HalCmnSpiMcp3208_Get( EN_MCP3208_CH_3 );
-    HalCmn_UpdateSenData( &g_dataFSR, (double)data );
+    end = HalCmnClock_GetNsec();
+    HalCmnReplay_Shift( EN_SEN_CH_DIST_FSR, &start, &end );
+    HalCmn_SetSenTime( &g_dataFSR, start, end );
+    HalCmnHist_Push( EN_SEN_CH_DIST_FSR, (short)data, start );
+    filt = HalCmnFilter_Apply( EN_SEN_CH_DIST_FSR, (int)data );
+    HalCmn_UpdateSenData( &g_dataFSR, (int)data, (double)filt );
+    g_dataFSR.cur_mm = g_lutFSR[filt & ( HAL_DIST_LUT_SIZE - 1 )];
+    HalCmnTrack_Update( EN_SEN_CH_DIST_FSR, (double)g_dataFSR.cur_mm, start );
     Led_Set( 0x00 );
     return &g_dataFSR;
 }
 
 
+/**************************************************************************//*!
+ * @brief     距離の推定値のアドレスを返す。
+ * @attention なし。
+ * @note      pos : 距離 ( mm ), vel : 速度 ( mm/sec, 負 = 接近 ), ttc : 接触までの時間 ( sec )。
+ *            HalSensorDist_GetFL() などでサンプルを取得する度に更新する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    推定値のアドレス ( 距離センサ以外の ch では NULL )
+ *************************************************************************** */
+SHalTrack_t*
+HalSensorDist_GetTrack(
+    EHalSensorCh_t  ch      ///< [in] 対象の ch ( EN_SEN_CH_DIST_FL - EN_SEN_CH_DIST_FSR )
+){
+    if( ch > EN_SEN_CH_DIST_FSR )
+    {
+        DBG_PRINT_ERROR( "Invalid ch. : %d \n\r", ch );
+        return NULL;
+    }
+
+    return HalCmnTrack_Get( ch );
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサの型番をセットする。
+ * @attention HalSensorDist_Init() の後に呼ぶこと。
+ * @note      型番ごとの変換テーブルを選択し、以降の cur_mm の計算に使用する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalSensorDist_SetModel(
+    EHalSensorCh_t  ch,     ///< [in] 対象の ch ( EN_SEN_CH_DIST_FL - EN_SEN_CH_DIST_FSR )
+    EHalDistModel_t model   ///< [in] 型番
+){
+    const unsigned short*   lut = NULL;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    if( model >= EN_DIST_MODEL_NUM )
+    {
+        DBG_PRINT_ERROR( "Invalid model. : %d \n\r", model );
+        return EN_FALSE;
+    }
+
+    lut = g_halDistLut[model];
+    switch( ch )
+    {
+    case EN_SEN_CH_DIST_FL  : g_lutFL  = lut; break;
+    case EN_SEN_CH_DIST_FR  : g_lutFR  = lut; break;
+    case EN_SEN_CH_DIST_FSL : g_lutFSL = lut; break;
+    case EN_SEN_CH_DIST_FSR : g_lutFSR = lut; break;
+    default :
+        DBG_PRINT_ERROR( "Invalid ch. : %d \n\r", ch );
+        return EN_FALSE;
+    }
+
+    return EN_TRUE;
+}
+
+
 #ifdef __cplusplus
     }
 #endif
@@ -81,6 +81,13 @@ InitParam(
     g_data.err = 0;                 // err = cur - ofs
     g_data.cur_rate = 0;            // cur_rate = ( cur / max ) * 100 ( %  )
     g_data.cur_vol = 0;             // cur_vol = 電圧に換算した現在値 ( mV )
+    g_data.raw = 0;                 // raw = センサの生値
+    g_data.ver = 0;                 // ver = 更新回数
+    g_data.vref = MCP3208_VREF_MV;  // vref = 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+    g_data.cache = ~0U;             // cache = err, cur_rate, cur_vol を計算した時の ver
+    g_data.ts_start = 0;            // ts_start = 転送を開始した時刻 ( nsec )
+    g_data.ts_end = 0;              // ts_end   = 転送が終了した時刻 ( nsec )
+    g_data.cur_mm = 0;              // cur_mm = 距離センサ以外は使用しない
 
     return;
 }
@@ -151,6 +158,9 @@ HalSensorPm_Init(
     }
 
     SetOffset();
+
+    // 履歴は MCP3208 の AD 値のまま保持する ( オフセットを読んだ値は履歴と統計に含めない )
+    HalCmnHist_Open( EN_SEN_CH_PM, HalCmnHist_CapOf( HAL_HIST_HZ_PM ), 1.0 );
     ret = EN_TRUE;
     return ret;
 }
@@ -185,13 +195,20 @@ SHalSensor_t*
 HalSensorPm_Get(
     void  ///< [in] ナシ
 ){
-    unsigned int    data = 0;
+    unsigned int        data = 0;
+    unsigned long long  start = 0;
+    unsigned long long  end = 0;
 
     DBG_PRINT_TRACE( "\n\r" );
 
+    start = HalCmnClock_GetNsec();
     data = HalCmnSpiMcp3208_Get( EN_MCP3208_CH_7 );
+    end = HalCmnClock_GetNsec();
+    HalCmnReplay_Shift( EN_SEN_CH_PM, &start, &end );
+    HalCmn_SetSenTime( &g_data, start, end );
+    HalCmnHist_Push( EN_SEN_CH_PM, (short)data, start );
 
-    HalCmn_UpdateSenData( &g_data, (double)data );
+    HalCmn_UpdateSenData( &g_data, (int)data, (double)data );
 
     return &g_data;
 }
@@ -31,7 +31,9 @@
 //********************************************************
 /*! @def                                                 */
 //********************************************************
-// なし
+#define BMX055_ACC_SCALE    (0.0098)    // 加速度センサ   : 生値から物理量への換算係数 ( range +-2g )
+#define BMX055_GYRO_SCALE   (0.0038)    // ジャイロセンサ : 生値から物理量への換算係数 ( Full scale = +/- 125 degree/s )
+#define BMX055_MAG_SCALE    (1.0)       // 磁気センサ     : 生値から物理量への換算係数
 
 
 //********************************************************
@@ -95,6 +97,13 @@ InitParam(
         g_dataAcc[i].err = 0;           // err = cur - ofs
         g_dataAcc[i].cur_rate = 0;      // cur_rate = ( cur / max ) * 100 ( %  )
         g_dataAcc[i].cur_vol = 0;       // cur_vol = 電圧に換算した現在値 ( mV )
+        g_dataAcc[i].raw = 0;           // raw = センサの生値
+        g_dataAcc[i].ver = 0;           // ver = 更新回数
+        g_dataAcc[i].vref = 0;          // vref = 生値 4096 に相当する電圧 ( mV, 0 = 電圧換算しない )
+        g_dataAcc[i].cache = ~0U;       // cache = err, cur_rate, cur_vol を計算した時の ver
+        g_dataAcc[i].ts_start = 0;      // ts_start = 転送を開始した時刻 ( nsec )
+        g_dataAcc[i].ts_end = 0;        // ts_end   = 転送が終了した時刻 ( nsec )
+        g_dataAcc[i].cur_mm = 0;        // cur_mm = 距離センサ以外は使用しない
 
         g_dataGyro[i].cur = 0;
         g_dataGyro[i].ofs = 0;
@@ -103,6 +112,13 @@ InitParam(
         g_dataGyro[i].err = 0;
         g_dataGyro[i].cur_rate = 0;
         g_dataGyro[i].cur_vol = 0;
+        g_dataGyro[i].raw = 0;
+        g_dataGyro[i].ver = 0;
+        g_dataGyro[i].vref = 0;
+        g_dataGyro[i].cache = ~0U;
+        g_dataGyro[i].ts_start = 0;
+        g_dataGyro[i].ts_end = 0;
+        g_dataGyro[i].cur_mm = 0;
 
         g_dataMag[i].cur = 0;
         g_dataMag[i].ofs = 0;
@@ -111,6 +127,13 @@ InitParam(
         g_dataMag[i].err = 0;
         g_dataMag[i].cur_rate = 0;
         g_dataMag[i].cur_vol = 0;
+        g_dataMag[i].raw = 0;
+        g_dataMag[i].ver = 0;
+        g_dataMag[i].vref = 0;
+        g_dataMag[i].cache = ~0U;
+        g_dataMag[i].ts_start = 0;
+        g_dataMag[i].ts_end = 0;
+        g_dataMag[i].cur_mm = 0;
     }
     return;
 }
@@ -190,6 +213,33 @@ HalSensorBmx055_Init(
 }
 
 
+/**************************************************************************//*!
+ * @brief     I2C SENSOR BMX055 の履歴の領域を確保する。
+ * @attention HalCmnHist_Init() の後に呼ぶこと。
+ * @note      デバイスの初期化 ( HalSensorBmx055_Init() ) とは別に、Sys_Init() で必ず呼ぶ。
+ *            履歴は各レジスタの生値のまま保持する。
+ * @sa        HalSensorBmx055_Init()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalSensorBmx055_OpenHist(
+    void  ///< [in] ナシ
+){
+    int   i = 0;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    for( i = 0; i < 3; i++ )
+    {
+        HalCmnHist_Open( EN_SEN_CH_ACC_X  + i, HalCmnHist_CapOf( HAL_HIST_HZ_ACC ),  BMX055_ACC_SCALE );
+        HalCmnHist_Open( EN_SEN_CH_GYRO_X + i, HalCmnHist_CapOf( HAL_HIST_HZ_GYRO ), BMX055_GYRO_SCALE );
+        HalCmnHist_Open( EN_SEN_CH_MAG_X  + i, HalCmnHist_CapOf( HAL_HIST_HZ_MAG ),  BMX055_MAG_SCALE );
+    }
+    return;
+}
+
+
 /**************************************************************************//*!
  * @brief     I2C SENSOR BMX055 ACC を終了する。
  * @attention なし。
@@ -390,7 +440,7 @@ SetOffsetAcc(
 /**************************************************************************//*!
  * @brief     BMX055 加速度センサ値を読み出す
  * @attention なし。
- * @note      なし。
+ * @note      再生中 ( HalCmnReplay_Open() ) は I2C の代わりに記録した生値を使う。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    センサ変数へのポインタ
@@ -405,46 +455,70 @@ HalSensorBmx055_GetAcc(
     double              dataX = 0;     // センサの計測値
     double              dataY = 0;     // センサの計測値
     double              dataZ = 0;     // センサの計測値
+    int                 rawX = 0;      // センサの生値
+    int                 rawY = 0;      // センサの生値
+    int                 rawZ = 0;      // センサの生値
+    unsigned long long  start = 0;     // 転送を開始した時刻
+    unsigned long long  end = 0;       // 転送が終了した時刻
 
     DBG_PRINT_TRACE( "\n\r" );
 
-    // I2C スレーブデバイスを BMX055 ACC に変える
-    HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_ACC );
-
-    // Read 6 bytes of data from register
-    buff[0] = 0x02;
-    ret = HalCmnI2c_Write( buff, 1 );
-    if( ret == EN_FALSE )
+    if( HalCmnReplay_IsOpen() == EN_TRUE )
     {
-        DBG_PRINT_ERROR( "fail to write 0x2 to i2c slave. \n\r" );
-        goto err;
-    }
-
-    ret = HalCmnI2c_Read( buff, 6 );
-    if( ret == EN_FALSE )
+        start = HalCmnClock_GetNsec();
+        rawX = HalCmnReplay_Get( EN_SEN_CH_ACC_X );
+        rawY = HalCmnReplay_Get( EN_SEN_CH_ACC_Y );
+        rawZ = HalCmnReplay_Get( EN_SEN_CH_ACC_Z );
+        end = HalCmnClock_GetNsec();
+        HalCmnReplay_Shift( EN_SEN_CH_ACC_X, &start, &end );
+    } else
     {
-        DBG_PRINT_ERROR( "fail to read data from i2c slave. \n\r" );
-        goto err;
+        // I2C スレーブデバイスを BMX055 ACC に変える
+        HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_ACC );
+
+        // Read 6 bytes of data from register
+        start = HalCmnClock_GetNsec();
+        buff[0] = 0x02;
+        ret = HalCmnI2c_Write( buff, 1 );
+        if( ret == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "fail to write 0x2 to i2c slave. \n\r" );
+            goto err;
+        }
+
+        ret = HalCmnI2c_Read( buff, 6 );
+        if( ret == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "fail to read data from i2c slave. \n\r" );
+            goto err;
+        }
+        end = HalCmnClock_GetNsec();
+
+        // Convert the data
+        rawX = (buff[1] * 256 + (buff[0] & 0xF0)) / 16;
+        if( rawX > 2047 ){ rawX -= 4096; }
+
+        rawY = (buff[3] * 256 + (buff[2] & 0xF0)) / 16;
+        if( rawY > 2047 ){ rawY -= 4096; }
+
+        rawZ = (buff[5] * 256 + (buff[4] & 0xF0)) / 16;
+        if( rawZ > 2047 ){ rawZ -= 4096; }
     }
 
-    // Convert the data
-    dataX = (double)((buff[1] * 256 + (buff[0] & 0xF0)) / 16);
-    if( dataX > 2047 ){ dataX -= 4096; }
-
-    dataY = (double)((buff[3] * 256 + (buff[2] & 0xF0)) / 16);
-    if( dataY > 2047 ){ dataY -= 4096; }
-
-    dataZ = (double)((buff[5] * 256 + (buff[4] & 0xF0)) / 16);
-    if( dataZ > 2047 ){ dataZ -= 4096; }
-
-    dataX = dataX * 0.0098; // renge +-2g
-    dataY = dataY * 0.0098; // renge +-2g
-    dataZ = dataZ * 0.0098; // renge +-2g
+    dataX = rawX * BMX055_ACC_SCALE; // renge +-2g
+    dataY = rawY * BMX055_ACC_SCALE; // renge +-2g
+    dataZ = rawZ * BMX055_ACC_SCALE; // renge +-2g
 
     // グローバル変数を更新する
-    HalCmn_UpdateSenData( &g_dataAcc[0], dataX );
-    HalCmn_UpdateSenData( &g_dataAcc[1], dataY );
-    HalCmn_UpdateSenData( &g_dataAcc[2], dataZ );
+    HalCmn_UpdateSenData( &g_dataAcc[0], rawX, dataX );
+    HalCmn_UpdateSenData( &g_dataAcc[1], rawY, dataY );
+    HalCmn_UpdateSenData( &g_dataAcc[2], rawZ, dataZ );
+    HalCmn_SetSenTime( &g_dataAcc[0], start, end );
+    HalCmn_SetSenTime( &g_dataAcc[1], start, end );
+    HalCmn_SetSenTime( &g_dataAcc[2], start, end );
+    HalCmnHist_Push( EN_SEN_CH_ACC_X, (short)rawX, start );
+    HalCmnHist_Push( EN_SEN_CH_ACC_Y, (short)rawY, start );
+    HalCmnHist_Push( EN_SEN_CH_ACC_Z, (short)rawZ, start );
 
 err:
     switch( which )
@@ -462,7 +536,7 @@ err:
 /**************************************************************************//*!
  * @brief     BMX055 ジャイロセンサ値を読み出す
  * @attention なし。
- * @note      なし。
+ * @note      再生中 ( HalCmnReplay_Open() ) は I2C の代わりに記録した生値を使う。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    センサ変数へのポインタ
@@ -477,46 +551,70 @@ HalSensorBmx055_GetGyro(
     double              dataX = 0;     // センサの計測値
     double              dataY = 0;     // センサの計測値
     double              dataZ = 0;     // センサの計測値
+    int                 rawX = 0;      // センサの生値
+    int                 rawY = 0;      // センサの生値
+    int                 rawZ = 0;      // センサの生値
+    unsigned long long  start = 0;     // 転送を開始した時刻
+    unsigned long long  end = 0;       // 転送が終了した時刻
 
     DBG_PRINT_TRACE( "\n\r" );
 
-    // I2C スレーブデバイスを BMX055 GYRO に変える
-    HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_GYRO );
-
-    // Read 6 bytes of data from register
-    buff[0] = 0x02;
-    ret = HalCmnI2c_Write( buff, 1 );
-    if( ret == EN_FALSE )
+    if( HalCmnReplay_IsOpen() == EN_TRUE )
     {
-        DBG_PRINT_ERROR( "fail to write 0x2 to i2c slave. \n\r" );
-        goto err;
-    }
-
-    ret = HalCmnI2c_Read( buff, 6 );
-    if( ret == EN_FALSE )
+        start = HalCmnClock_GetNsec();
+        rawX = HalCmnReplay_Get( EN_SEN_CH_GYRO_X );
+        rawY = HalCmnReplay_Get( EN_SEN_CH_GYRO_Y );
+        rawZ = HalCmnReplay_Get( EN_SEN_CH_GYRO_Z );
+        end = HalCmnClock_GetNsec();
+        HalCmnReplay_Shift( EN_SEN_CH_GYRO_X, &start, &end );
+    } else
     {
-        DBG_PRINT_ERROR( "fail to read data from i2c slave. \n\r" );
-        goto err;
+        // I2C スレーブデバイスを BMX055 GYRO に変える
+        HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_GYRO );
+
+        // Read 6 bytes of data from register
+        start = HalCmnClock_GetNsec();
+        buff[0] = 0x02;
+        ret = HalCmnI2c_Write( buff, 1 );
+        if( ret == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "fail to write 0x2 to i2c slave. \n\r" );
+            goto err;
+        }
+
+        ret = HalCmnI2c_Read( buff, 6 );
+        if( ret == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "fail to read data from i2c slave. \n\r" );
+            goto err;
+        }
+        end = HalCmnClock_GetNsec();
+
+        // Convert the data
+        rawX = buff[1] * 256 + buff[0];
+        if( rawX > 32767 ){ rawX -= 65536; }
+
+        rawY = buff[3] * 256 + buff[2];
+        if( rawY > 32767 ){ rawY -= 65536; }
+
+        rawZ = buff[5] * 256 + buff[4];
+        if( rawZ > 32767 ){ rawZ -= 65536; }
     }
 
-    // Convert the data
-    dataX = (double)(buff[1] * 256 + buff[0]);
-    if( dataX > 32767 ){ dataX -= 65536; }
-
-    dataY = (double)(buff[3] * 256 + buff[2]);
-    if( dataY > 32767 ){ dataY -= 65536; }
-
-    dataZ = (double)(buff[5] * 256 + buff[4]);
-    if( dataZ > 32767 ){ dataZ -= 65536; }
-
-    dataX = dataX * 0.0038; //  Full scale = +/- 125 degree/s
-    dataY = dataY * 0.0038; //  Full scale = +/- 125 degree/s
-    dataZ = dataZ * 0.0038; //  Full scale = +/- 125 degree/s
+    dataX = rawX * BMX055_GYRO_SCALE; //  Full scale = +/- 125 degree/s
+    dataY = rawY * BMX055_GYRO_SCALE; //  Full scale = +/- 125 degree/s
+    dataZ = rawZ * BMX055_GYRO_SCALE; //  Full scale = +/- 125 degree/s
 
     // グローバル変数を更新する
-    HalCmn_UpdateSenData( &g_dataGyro[0], dataX );
-    HalCmn_UpdateSenData( &g_dataGyro[1], dataY );
-    HalCmn_UpdateSenData( &g_dataGyro[2], dataZ );
+    HalCmn_UpdateSenData( &g_dataGyro[0], rawX, dataX );
+    HalCmn_UpdateSenData( &g_dataGyro[1], rawY, dataY );
+    HalCmn_UpdateSenData( &g_dataGyro[2], rawZ, dataZ );
+    HalCmn_SetSenTime( &g_dataGyro[0], start, end );
+    HalCmn_SetSenTime( &g_dataGyro[1], start, end );
+    HalCmn_SetSenTime( &g_dataGyro[2], start, end );
+    HalCmnHist_Push( EN_SEN_CH_GYRO_X, (short)rawX, start );
+    HalCmnHist_Push( EN_SEN_CH_GYRO_Y, (short)rawY, start );
+    HalCmnHist_Push( EN_SEN_CH_GYRO_Z, (short)rawZ, start );
 
 err:
     switch( which )
@@ -534,7 +632,7 @@ err:
 /**************************************************************************//*!
  * @brief     BMX055 磁気センサ値を読み出す
  * @attention なし。
- * @note      なし。
+ * @note      再生中 ( HalCmnReplay_Open() ) は I2C の代わりに記録した生値を使う。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    センサ変数へのポインタ
@@ -549,42 +647,70 @@ HalSensorBmx055_GetMag(
     double              dataX = 0;     // センサの計測値
     double              dataY = 0;     // センサの計測値
     double              dataZ = 0;     // センサの計測値
+    int                 rawX = 0;      // センサの生値
+    int                 rawY = 0;      // センサの生値
+    int                 rawZ = 0;      // センサの生値
+    unsigned long long  start = 0;     // 転送を開始した時刻
+    unsigned long long  end = 0;       // 転送が終了した時刻
 
     DBG_PRINT_TRACE( "\n\r" );
 
-    // I2C スレーブデバイスを BMX055 MAG に変える
-    HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_MAG );
-
-    // Read 6 bytes of data from register
-    buff[0] = 0x42;
-    ret = HalCmnI2c_Write( buff, 1 );
-    if( ret == EN_FALSE )
+    if( HalCmnReplay_IsOpen() == EN_TRUE )
     {
-        DBG_PRINT_ERROR( "fail to write 0x42 to i2c slave. \n\r" );
-        goto err;
-    }
-
-    ret = HalCmnI2c_Read( buff, 8 );
-    if( ret == EN_FALSE )
+        start = HalCmnClock_GetNsec();
+        rawX = HalCmnReplay_Get( EN_SEN_CH_MAG_X );
+        rawY = HalCmnReplay_Get( EN_SEN_CH_MAG_Y );
+        rawZ = HalCmnReplay_Get( EN_SEN_CH_MAG_Z );
+        end = HalCmnClock_GetNsec();
+        HalCmnReplay_Shift( EN_SEN_CH_MAG_X, &start, &end );
+    } else
     {
-        DBG_PRINT_ERROR( "fail to read data from i2c slave. \n\r" );
-        goto err;
+        // I2C スレーブデバイスを BMX055 MAG に変える
+        HalCmnI2c_SetSlave( I2C_SLAVE_BMX055_MAG );
+
+        // Read 6 bytes of data from register
+        start = HalCmnClock_GetNsec();
+        buff[0] = 0x42;
+        ret = HalCmnI2c_Write( buff, 1 );
+        if( ret == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "fail to write 0x42 to i2c slave. \n\r" );
+            goto err;
+        }
+
+        ret = HalCmnI2c_Read( buff, 8 );
+        if( ret == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "fail to read data from i2c slave. \n\r" );
+            goto err;
+        }
+        end = HalCmnClock_GetNsec();
+
+        // Convert the data ( X, Y : 13 bit, Z : 15 bit )
+        rawX = (buff[1] << 5) | (buff[0] >> 3);
+        if( rawX > 4095 ){ rawX -= 8192; }
+
+        rawY = (buff[3] << 5) | (buff[2] >> 3);
+        if( rawY > 4095 ){ rawY -= 8192; }
+
+        rawZ = (buff[5] << 7) | (buff[4] >> 1);
+        if( rawZ > 16383 ){ rawZ -= 32768; }
     }
 
-    // Convert the data
-    dataX = (double)( (buff[1] << 8) | (buff[0] >> 3) );
-    if( dataX > 4095 ){ dataX -= 8192; }
-
-    dataY = (double)( (buff[3] << 8) | (buff[2] >> 3) );
-    if( dataY > 4095 ){ dataY -= 8192; }
-
-    dataZ = (double)( (buff[5] << 8) | (buff[4] >> 3) );
-    if( dataZ > 4095 ){ dataZ -= 8192; }
+    dataX = rawX * BMX055_MAG_SCALE;
+    dataY = rawY * BMX055_MAG_SCALE;
+    dataZ = rawZ * BMX055_MAG_SCALE;
 
     // グローバル変数を更新する
-    HalCmn_UpdateSenData( &g_dataMag[0], dataX );
-    HalCmn_UpdateSenData( &g_dataMag[1], dataY );
-    HalCmn_UpdateSenData( &g_dataMag[2], dataZ );
+    HalCmn_UpdateSenData( &g_dataMag[0], rawX, dataX );
+    HalCmn_UpdateSenData( &g_dataMag[1], rawY, dataY );
+    HalCmn_UpdateSenData( &g_dataMag[2], rawZ, dataZ );
+    HalCmn_SetSenTime( &g_dataMag[0], start, end );
+    HalCmn_SetSenTime( &g_dataMag[1], start, end );
+    HalCmn_SetSenTime( &g_dataMag[2], start, end );
+    HalCmnHist_Push( EN_SEN_CH_MAG_X, (short)rawX, start );
+    HalCmnHist_Push( EN_SEN_CH_MAG_Y, (short)rawY, start );
+    HalCmnHist_Push( EN_SEN_CH_MAG_Z, (short)rawZ, start );
 
 err:
     switch( which )
@@ -17,6 +17,7 @@
 //********************************************************
 /* include                                               */
 //********************************************************
+#include <string.h>
 #include <time.h>
 
 #include "hal_cmn.h"
@@ -31,7 +32,9 @@
 //********************************************************
 /*! @def                                                 */
 //********************************************************
-// なし
+#define TIME_NSEC_PER_SEC   (1000000000ULL)
+#define TIME_FMT_SEC_POS    (17)    // "YYYY-MM-DDTHH:MM:SS" の秒の位置
+#define TIME_FMT_SEC_LEN    (19)    // "YYYY-MM-DDTHH:MM:SS" の長さ
 
 
 //********************************************************
@@ -49,7 +52,8 @@
 //********************************************************
 /* モジュールグローバル変数                              */
 //********************************************************
-static SHalTime_t   g_data;
+static __thread SHalTime_t  g_local;    // HalTime_GetLocaltime() の戻り値 ( スレッド毎 )
+static __thread SHalTime_t  g_utc;      // HalTime_GetUTC()       の戻り値 ( スレッド毎 )
 
 
 //********************************************************
@@ -57,6 +61,8 @@ static SHalTime_t   g_data;
 //********************************************************
 static void         InitParam( void );
 static EHalBool_t   InitReg( void );
+static void         SetTime( SHalTime_t* time, const struct tm* tm, long nsec );
+static void         Put2( char* buf, int value );
 
 
 
@@ -75,15 +81,8 @@ InitParam(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
-    g_data.wait  = 0;
-    g_data.usec  = 0;
-    g_data.msec  = 0;
-    g_data.sec   = 0;
-    g_data.min   = 0;
-    g_data.hour  = 0;
-    g_data.day   = 0;
-    g_data.month = 0;
-    g_data.year  = 0;
+    memset( &g_local, 0, sizeof(g_local) );
+    memset( &g_utc,   0, sizeof(g_utc) );
     return;
 }
 
@@ -135,100 +134,238 @@ HalTime_Init(
 
 
 /**************************************************************************//*!
- * @brief     時間変数のアドレスを返す。( 地方時 ( Local time ) )
+ * @brief     struct tm から時間変数をセットする。
  * @attention なし。
  * @note      なし。
  * @sa        なし。
  * @author    Ryoji Morita
- * @return    時間変数のアドレス
+ * @return    なし。
  *************************************************************************** */
-SHalTime_t*
-HalTime_GetLocaltime(
-    void  ///< [in] ナシ
+static void
+SetTime(
+    SHalTime_t*         time,   ///< [out] 時間変数
+    const struct tm*    tm,     ///< [in]  変換済みの時刻
+    long                nsec    ///< [in]  1 秒未満の時刻 ( nsec )
 ){
-    time_t      timer;
-    struct tm*  local;
+    time->wait  = 0;
+    time->usec  = ( nsec / 1000 ) % 1000;
+    time->msec  = nsec / 1000000;
+    time->sec   = tm->tm_sec;
+    time->min   = tm->tm_min;
+    time->hour  = tm->tm_hour;
+    time->day   = tm->tm_mday;
+    time->month = tm->tm_mon + 1;
+    time->year  = tm->tm_year + 1900;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     現在時刻を時間変数に格納する。( 地方時 ( Local time ) )
+ * @attention なし。
+ * @note      localtime_r() を使用するのでリエントラント。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalTime_GetLocaltimeR(
+    SHalTime_t*     time    ///< [out] 時間変数
+){
+    struct timespec ts;
+    struct tm       local;
 
     DBG_PRINT_TRACE( "\n\r" );
 
     // 現在時刻を取得
-    timer = time( NULL );
-
-     // 地方時に変換
-    local = localtime( &timer );
-
-    g_data.wait  = 0;
-    g_data.usec  = 0;
-    g_data.msec  = 0;
-    g_data.sec   = local->tm_sec;
-    g_data.min   = local->tm_min;
-    g_data.hour  = local->tm_hour;
-    g_data.day   = local->tm_mday;
-    g_data.month = local->tm_mon + 1;
-    g_data.year  = local->tm_year + 1900;
-
-#if 0
-    // 表示
-    AppIfPc_Printf( "local time : " );
-    AppIfPc_Printf( "%04d/", g_data.year  );
-    AppIfPc_Printf( "%02d/", g_data.month );
-    AppIfPc_Printf( "%02d ", g_data.day   );
-    AppIfPc_Printf( "%02d:", g_data.hour  );
-    AppIfPc_Printf( "%02d:", g_data.min   );
-    AppIfPc_Printf( "%02d" , g_data.sec   );
-    AppIfPc_Printf( "\n" );
-#endif
+    clock_gettime( CLOCK_REALTIME, &ts );
+
+    // 地方時に変換
+    if( localtime_r( &ts.tv_sec, &local ) == NULL )
+    {
+        DBG_PRINT_ERROR( "fail to convert to local time. \n\r" );
+        return EN_FALSE;
+    }
 
-    return &g_data;
+    SetTime( time, &local, ts.tv_nsec );
+    return EN_TRUE;
 }
 
 
 /**************************************************************************//*!
- * @brief     時間変数のアドレスを返す。( 協定世界時 ( UTC ) )
+ * @brief     現在時刻を時間変数に格納する。( 協定世界時 ( UTC ) )
  * @attention なし。
- * @note      なし。
+ * @note      gmtime_r() を使用するのでリエントラント。
  * @sa        なし。
  * @author    Ryoji Morita
+ * @return    EN_TRUE : 成功, EN_FALSE : 失敗
+ *************************************************************************** */
+EHalBool_t
+HalTime_GetUTCR(
+    SHalTime_t*     time    ///< [out] 時間変数
+){
+    struct timespec ts;
+    struct tm       utc;
+
+    DBG_PRINT_TRACE( "\n\r" );
+
+    // 現在時刻を取得
+    clock_gettime( CLOCK_REALTIME, &ts );
+
+    // UTC に変換
+    if( gmtime_r( &ts.tv_sec, &utc ) == NULL )
+    {
+        DBG_PRINT_ERROR( "fail to convert to UTC. \n\r" );
+        return EN_FALSE;
+    }
+
+    SetTime( time, &utc, ts.tv_nsec );
+    return EN_TRUE;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間変数のアドレスを返す。( 地方時 ( Local time ) )
+ * @attention 戻り値はスレッド毎の変数を指し、次の呼び出しで上書きされる。
+ * @note      HalTime_GetUTC() とは別の変数を返す。
+ * @sa        HalTime_GetLocaltimeR()
+ * @author    Ryoji Morita
+ * @return    時間変数のアドレス
+ *************************************************************************** */
+SHalTime_t*
+HalTime_GetLocaltime(
+    void  ///< [in] ナシ
+){
+    DBG_PRINT_TRACE( "\n\r" );
+
+    HalTime_GetLocaltimeR( &g_local );
+    return &g_local;
+}
+
+
+/**************************************************************************//*!
+ * @brief     時間変数のアドレスを返す。( 協定世界時 ( UTC ) )
+ * @attention 戻り値はスレッド毎の変数を指し、次の呼び出しで上書きされる。
+ * @note      HalTime_GetLocaltime() とは別の変数を返す。
+ * @sa        HalTime_GetUTCR()
+ * @author    Ryoji Morita
  * @return    時間変数のアドレス
  *************************************************************************** */
 SHalTime_t*
 HalTime_GetUTC(
     void  ///< [in] ナシ
 ){
-    time_t      timer;
-    struct tm*  utc;
+    DBG_PRINT_TRACE( "\n\r" );
+
+    HalTime_GetUTCR( &g_utc );
+    return &g_utc;
+}
+
+
+/**************************************************************************//*!
+ * @brief     0 - 99 の値を 2 桁の 10 進文字列で書き込む。
+ * @attention '\0' は書き込まない。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Put2(
+    char*           buf,    ///< [out] 書き込み先
+    int             value   ///< [in]  書き込む値 ( 0 - 99 )
+){
+    buf[0] = (char)( '0' + value / 10 );
+    buf[1] = (char)( '0' + value % 10 );
+    return;
+}
 
+
+/**************************************************************************//*!
+ * @brief     時刻の文字列変換のキャッシュを初期化する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        HalTime_Format()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+void
+HalTime_FmtInit(
+    SHalTimeFmt_t*  fmt,    ///< [out] 変換のキャッシュ
+    EHalBool_t      utc     ///< [in]  EN_TRUE : UTC, EN_FALSE : 地方時
+){
     DBG_PRINT_TRACE( "\n\r" );
 
-    // 現在時刻を取得
-    timer = time( NULL );
-
-     // UTC に変換
-    utc = gmtime( &timer );
-
-    g_data.wait  = 0;
-    g_data.usec  = 0;
-    g_data.msec  = 0;
-    g_data.sec   = utc->tm_sec;
-    g_data.min   = utc->tm_min;
-    g_data.hour  = utc->tm_hour;
-    g_data.day   = utc->tm_mday;
-    g_data.month = utc->tm_mon + 1;
-    g_data.year  = utc->tm_year + 1900;
-
-#if 0
-    // 表示
-    AppIfPc_Printf( "UTC : " );
-    AppIfPc_Printf( "%04d/", g_data.year  );
-    AppIfPc_Printf( "%02d/", g_data.month );
-    AppIfPc_Printf( "%02d ", g_data.day   );
-    AppIfPc_Printf( "%02d:", g_data.hour  );
-    AppIfPc_Printf( "%02d:", g_data.min   );
-    AppIfPc_Printf( "%02d" , g_data.sec   );
-    AppIfPc_Printf( "\n" );
-#endif
+    fmt->utc  = utc;
+    fmt->base = -1;
+    fmt->sec  = -1;
+    memset( fmt->text, '\0', sizeof(fmt->text) );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     UNIX 時間を "YYYY-MM-DDTHH:MM:SS.uuuuuu" 形式の文字列に変換する。
+ * @attention buf には HAL_TIME_FMT_LEN Byte 以上の領域が必要。
+ * @note      "YYYY-MM-DDTHH:MM:" までを分単位でキャッシュし、分が変わった時だけ
+ *            localtime_r() / gmtime_r() で変換し直す。同じ分の中で秒が変わった時は
+ *            秒の 2 桁だけを書き換える。夏時間の切り替えは分の境界で起こるので、
+ *            この方法で地方時も正しく変換できる。
+ *            fmt を呼び出し元で確保するのでリエントラントで、メモリ確保もしない。
+ * @sa        HalTime_FmtInit()
+ * @author    Ryoji Morita
+ * @return    書き込んだ文字数 ( '\0' を含まない ), 失敗時 = -1
+ *************************************************************************** */
+int
+HalTime_Format(
+    SHalTimeFmt_t*      fmt,    ///< [in/out] 変換のキャッシュ
+    unsigned long long  ns,     ///< [in]     UNIX 時間 ( nsec )
+    char*               buf     ///< [out]    書き込み先
+){
+    time_t          sec  = (time_t)( ns / TIME_NSEC_PER_SEC );
+    unsigned int    usec = (unsigned int)( ( ns % TIME_NSEC_PER_SEC ) / 1000 );
+    struct tm       tm;
+    int             i = 0;
+
+    if( (long long)sec != fmt->sec )
+    {
+        if( fmt->base < 0 || (long long)sec < fmt->base || (long long)sec >= fmt->base + 60 )
+        {
+            // 分が変わったので変換し直す
+            if( fmt->utc == EN_TRUE ){ if( gmtime_r( &sec, &tm ) == NULL ){ return -1; } }
+            else                     { if( localtime_r( &sec, &tm ) == NULL ){ return -1; } }
+
+            Put2( &fmt->text[0],  ( tm.tm_year + 1900 ) / 100 );
+            Put2( &fmt->text[2],  ( tm.tm_year + 1900 ) % 100 );
+            Put2( &fmt->text[5],  tm.tm_mon + 1 );
+            Put2( &fmt->text[8],  tm.tm_mday );
+            Put2( &fmt->text[11], tm.tm_hour );
+            Put2( &fmt->text[14], tm.tm_min );
+            Put2( &fmt->text[TIME_FMT_SEC_POS], tm.tm_sec );
+            fmt->text[4]  = '-';
+            fmt->text[7]  = '-';
+            fmt->text[10] = 'T';
+            fmt->text[13] = ':';
+            fmt->text[16] = ':';
+            fmt->base = (long long)sec - tm.tm_sec;
+        } else
+        {
+            // 同じ分の中なので秒だけを書き換える
+            Put2( &fmt->text[TIME_FMT_SEC_POS], (int)( (long long)sec - fmt->base ) );
+        }
+        fmt->sec = (long long)sec;
+    }
+
+    memcpy( buf, fmt->text, TIME_FMT_SEC_LEN );
+    buf[TIME_FMT_SEC_LEN] = '.';
+    for( i = TIME_FMT_SEC_LEN + 6; i > TIME_FMT_SEC_LEN; i-- )
+    {
+        buf[i] = (char)( '0' + usec % 10 );
+        usec /= 10;
+    }
+    buf[TIME_FMT_SEC_LEN + 7] = '\0';
 
-    return &g_data;
+    return TIME_FMT_SEC_LEN + 7;
 }
 
 
@@ -18,12 +18,24 @@
 /* include                                               */
 //********************************************************
 #include <ctype.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <getopt.h>
+#include <time.h>
+#include <unistd.h>
 
+#include "./app/if_frame/if_frame.h"
 #include "./app/if_lcd/if_lcd.h"
+#include "./app/if_metric/if_metric.h"
+#include "./app/if_que/if_que.h"
+#include "./app/if_ser/if_ser.h"
+#include "./app/if_rec/if_rec.h"
+#include "./app/if_arc/if_arc.h"
+#include "./app/if_aio/if_aio.h"
+#include "./app/if_shm/if_shm.h"
+#include "./app/if_srv/if_srv.h"
 #include "./hal/hal.h"
 #include "./sys/sys.h"
 
@@ -36,122 +48,1238 @@
 //********************************************************
 /*! @def                                                 */
 //********************************************************
+#define NSEC_PER_SEC    (1000000000L)
+#define NSEC_PER_MSEC   (1000000L)
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// センサ値の出力形式に使用する型
+typedef enum tagEMainFormat
+{
+    EN_FORMAT_TEXT = 0,     ///< @var : テキスト (= 初期値 )
+    EN_FORMAT_JSON,         ///< @var : json
+    EN_FORMAT_CSV,          ///< @var : csv
+    EN_FORMAT_CBOR,         ///< @var : cbor
+    EN_FORMAT_BIN,          ///< @var : バイナリフレーム ( app/if_frame ) : これ以降はフレーム単位で出力する
+    EN_FORMAT_SHM,          ///< @var : 共有メモリ       ( app/if_shm )
+    EN_FORMAT_REC,          ///< @var : ファイルに記録   ( app/if_rec )
+    EN_FORMAT_ARC           ///< @var : アーカイブに記録 ( app/if_arc )
+} EMainFormat_t;
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
 // なし
 
 
-//********************************************************
-/*! @enum                                                */
-//********************************************************
-// なし
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// getopt() で使用
+extern char *optarg;
+extern int  optind, opterr, optopt;
+
+// タイムスタンプの文字列変換で使用
+static SHalTimeFmt_t    g_timeFmt;
+
+// センサを繰り返し読み出す時に使用
+static unsigned int     g_repeat = 1;       // 読み出す回数
+static unsigned int     g_interval = 0;     // 読み出す周期 ( msec, 0 = 待たない )
+
+// センサ値の出力で使用
+static EMainFormat_t    g_format = EN_FORMAT_TEXT;  // 出力形式
+static unsigned int     g_baud = 0;                 // バイナリフレームの出力先のボーレート ( 0 = 変更しない )
+static SAppIfSer_t      g_ser;                      // json, csv, cbor のシリアライザ
+static SAppIfQue_t      g_que;                      // 標準出力の送信キュー ( -Q オプション )
+static int              g_queFl = -1;               // 標準出力のファイル状態フラグ ( -1 = キューを使わない )
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Run_Help( void );
+static void         Run_Version( void );
+static void         Run_TimeBase( char* str );
+
+static void         PrintSpan( unsigned long long tsStart, unsigned long long tsEnd );
+static void         PrintTime( SHalSensor_t* data );
+static EMainFormat_t GetFormat( const char* str );
+static SAppIfSer_t* SerBegin( EMainFormat_t fmt );
+static void         SerEnd( SAppIfSer_t* ser );
+static void         SerTime( SAppIfSer_t* ser, const char* key, SHalSensor_t* data );
+static void         SerTrack( SAppIfSer_t* ser, const char* key, EHalSensorCh_t ch );
+static void         SendFrame( EHalSensorCh_t first, unsigned int num, SHalSensor_t* data[] );
+static void         Run_Format( char* str );
+static void         Run_Output( char* str );
+static void         Run_Listen( char* str );
+static void         Run_Queue( char* str );
+static void         Run_Metrics( char* str );
+static void         Run_Replay( char* str );
+static void         Run_Log( char* str );
+static void         Run_Sim( const char* str );
+static void         Run_History( const char* str );
+static void         ScanEarly( int argc, char* argv[] );
+static void         QueFini( void );
+static void         Run_Repeat( void (*func)( char* str ), char* str );
+static void         Run_Window( char* str );
+static void         Run_Stats( char* str );
+static void         Run_Filter( char* str );
+
+static void         Run_I2cLcd( int argc, char *argv[] );
+static void         Run_Led( char* str );
+
+static void         Run_Sa_Pm( char* str );
+static void         Run_Sa_Dist( char* str );
+
+static void         Run_Si_BMX055_Acc( char* str );
+static void         Run_Si_BMX055_Gyro( char* str );
+static void         Run_Si_BMX055_Mag( char* str );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     HELP を表示する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Help(
+    void
+){
+    DBG_PRINT_TRACE( "\n\r" );
+    printf( "  -h, --help                  display the help menu. \n\r" );
+    printf( "  -v, --version               display the version information. \n\r" );
+    printf( "                                                               \n\r" );
+    printf( "  -c, --i2clcd                control the (I2C) LCD.           \n\r" );
+    printf( "    -x number, --dir_x=number                                  \n\r" );
+    printf( "                              the value of x-axis.             \n\r" );
+    printf( "    -y number, --dir_y=number                                  \n\r" );
+    printf( "                              the value of y-axis.             \n\r" );
+    printf( "    -s string, --string=string                                 \n\r" );
+    printf( "                              the string to display on LCD.    \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -c        -x      <number>  -y      <number>  -s       <string> \n\r" );
+    printf( "                                  --i2clcd  --dir_x=<number>  --dir_y=<number>  --string=<string> \n\r" );
+    printf("\x1b[39m");
+    printf( "                                                               \n\r" );
+    printf( "  -l number, --led=number     control the LED.                 \n\r" );
+    printf( "  -p [json|csv], --sa_pm=[json|csv]                                          \n\r" );
+    printf( "                              get the value of a sensor(A/D), Potentiometer. \n\r" );
+    printf( "                              json : get the all values of json format.      \n\r" );
+    printf( "                              csv  : get the all values of csv format.       \n\r" );
+    printf( "  -q [json|csv], --sa_dist=[json|csv]                                        \n\r" );
+    printf( "                              get the value of a sensor(A/D), Distance.      \n\r" );
+    printf( "                              json : get the all values of json format.      \n\r" );
+    printf( "                              csv  : get the all values of csv format.       \n\r" );
+    printf( "  -x {x|y|z|json|csv}, --si_bmx055acc={x|y|z|json|csv}                  \n\r" );
+    printf( "                              get ACC of a sensor(I2C), BMX055.         \n\r" );
+    printf( "                              x    : get the value of x-axis.           \n\r" );
+    printf( "                              y    : get the value of y-axis.           \n\r" );
+    printf( "                              z    : get the value of z-axis.           \n\r" );
+    printf( "                              json : get the all values of json format. \n\r" );
+    printf( "                              csv  : get the all values of csv format.  \n\r" );
+    printf( "  -y {x|y|z|json|csv}, --si_bmx055gyro={x|y|z|json|csv}                 \n\r" );
+    printf( "                              get GYRO of a sensor(I2C), BMX055.        \n\r" );
+    printf( "                              x    : get the value of x-axis.           \n\r" );
+    printf( "                              y    : get the value of y-axis.           \n\r" );
+    printf( "                              z    : get the value of z-axis.           \n\r" );
+    printf( "                              json : get the all values of json format. \n\r" );
+    printf( "                              csv  : get the all values of csv format.  \n\r" );
+    printf( "  -z {x|y|z|json|csv}, --si_bmx055mag={x|y|z|json|csv}                  \n\r" );
+    printf( "                              get MAG of a sensor(I2C), BMX055.         \n\r" );
+    printf( "                              x    : get the value of x-axis.           \n\r" );
+    printf( "                              y    : get the value of y-axis.           \n\r" );
+    printf( "                              z    : get the value of z-axis.           \n\r" );
+    printf( "                              json : get the all values of json format. \n\r" );
+    printf( "                              csv  : get the all values of csv format.  \n\r" );
+    printf( "  -t {mono|real|local|utc}, --timebase={mono|real|local|utc}           \n\r" );
+    printf( "                              select the clock of timestamps.           \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "                              mono  : CLOCK_MONOTONIC_RAW [nsec] (default). \n\r" );
+    printf( "                              real  : CLOCK_REALTIME, UNIX time [nsec]. \n\r" );
+    printf( "                              local : local time, YYYY-MM-DDTHH:MM:SS.uuuuuu \n\r" );
+    printf( "                              utc   : UTC,        YYYY-MM-DDTHH:MM:SS.uuuuuu \n\r" );
+    printf( "  -r number, --repeat=number  read the sensor number times.      \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "  -i msec, --interval=msec    the period of reading the sensor. \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "  -w msec[,msec...], --window=msec[,msec...]                            \n\r" );
+    printf( "                              set the windows of statistics. ( max 4 )  \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "                              default : 100,1000,10000                  \n\r" );
+    printf( "  -f {off|median|hampel}[,win[,k]], --filter={off|median|hampel}[,win[,k]] \n\r" );
+    printf( "                              set the filter of the distance sensors.   \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "                              off    : no filter.                       \n\r" );
+    printf( "                              median : the median of win samples.       \n\r" );
+    printf( "                              hampel : replace outliers ( > k * MAD ) with the median. \n\r" );
+    printf( "                              default : hampel,5,3.0  ( win : 3 - 15 )  \n\r" );
+    printf( "  -F {text|json|csv|cbor|bin|shm|rec|arc}, --format={text|json|csv|cbor|bin|shm|rec|arc} \n\r" );
+    printf( "                              select the output format of sensors.      \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "                              text : text (default).                    \n\r" );
+    printf( "                              json : same as the json argument. ( 1 record per line ) \n\r" );
+    printf( "                              csv  : same as the csv argument.  ( header line when the columns change ) \n\r" );
+    printf( "                              cbor : same records as json in CBOR ( RFC 8949 ), concatenated without separators. \n\r" );
+    printf( "                              bin  : COBS framed binary with CRC ( see app/if_frame/if_frame.h ). \n\r" );
+    printf( "                              shm  : shared memory ring ( see app/if_shm/if_shm.h, tools/shm_dump.c ). \n\r" );
+    printf( "                              rec  : append-only segment files ( see app/if_rec/if_rec.h, tools/rec_dump.c ). \n\r" );
+    printf( "                              arc  : delta coded columnar archive ( see app/if_arc/if_arc.h, tools/arc_dump.c ). \n\r" );
+    printf( "  -o path, --output=path      the output of bin format. ( default : stdout ) \n\r" );
+    printf( "                              a file, a pty or a serial device.         \n\r" );
+    printf( "                              the name of shm format. ( default : /board_sensor ) \n\r" );
+    printf( "                              path[,MB[,sec]] of rec format : path.0000, path.0001, ... \n\r" );
+    printf( "                              a new segment every MB ( default : 64 ) or sec ( default : off ). \n\r" );
+    printf( "                              path[,lz4][,uring|thread|sync] of arc format : lz4 compresses the blocks. \n\r" );
+    printf( "                              the blocks are written by io_uring or a writer thread. ( default : io_uring if available ) \n\r" );
+    printf( "  -b number, --baud=number    the baud rate of the serial device.       \n\r" );
+    printf( "                              ( specify before -o. )                    \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -F bin -b 921600 -o /dev/ttyAMA0 -r 1000 -i 1 -q \n\r" );
+    printf("\x1b[39m");
+    printf( "  -L path[,Hz], --listen=path[,Hz]                                      \n\r" );
+    printf( "                              serve the sensors on a unix domain socket until SIGINT. \n\r" );
+    printf( "                              Hz : the acquisition rate. ( default : 1000 ) \n\r" );
+    printf( "                              client : sub <ch>[,<ch>...] <Hz> [json|csv|cbor|bin] [oldest|newest|latest] \n\r" );
+    printf( "                                       unsub  ( see app/if_srv/if_srv.h ) \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -L /tmp/board.sock,1000               \n\r" );
+    printf( "                                  echo 'sub dist 10' | socat - UNIX-CONNECT:/tmp/board.sock \n\r" );
+    printf("\x1b[39m");
+    printf( "  -Q policy[,bytes], --queue=policy[,bytes]                             \n\r" );
+    printf( "                              write json, csv, cbor records to stdout without blocking. \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "                              records are dropped when the reader is slow. \n\r" );
+    printf( "                              oldest : drop the oldest queued records.  \n\r" );
+    printf( "                              newest : drop the new record.             \n\r" );
+    printf( "                              latest : keep only the latest record.     \n\r" );
+    printf( "                              bytes  : the queue size. ( default / max : 16384 ) \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -Q oldest -F json -r 100000 -i 1 -q | slow_reader \n\r" );
+    printf("\x1b[39m");
+    printf( "  -R path[,fast], --replay=path[,fast]                                  \n\r" );
+    printf( "                              read the sensors from a recording of -F rec instead of SPI / I2C. \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf( "                              the samples come at the recorded timing, or at once with fast. \n\r" );
+    printf( "                              -r stops at the end of the recording.     \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -F rec -o /tmp/run -r 60000 -i 1 -q       \n\r" );
+    printf( "                                  -R /tmp/run,fast -r 1000000 -i 0 -qjson   \n\r" );
+    printf("\x1b[39m");
+    printf( "  -E bus, --sim=bus           use the emulated devices instead of the hardware. \n\r" );
+    printf( "                              spi : MCP3208 ( distance sensors, potentiometer ). \n\r" );
+    printf( "                              i2c : BMX055 ( acc, gyro, mag ) and the LCD.        \n\r" );
+    printf( "                              gpio: LEDs and push switches ( default without wiringPi ). \n\r" );
+    printf( "                              ( comma separated, e.g. spi,i2c )                   \n\r" );
+    printf( "                              ( applied before the devices are initialized. ) \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -E spi -F json -r 10 -i 100 -q        \n\r" );
+    printf( "                                  -E spi,i2c -x json                    \n\r" );
+    printf("\x1b[39m");
+    printf( "  -H sec, --history=sec       keep sec seconds of samples per channel in memory. ( default : 600 ) \n\r" );
+    printf( "                              sized by the rate of each sensor : dist, acc 1 kHz, gyro 200 Hz, pm 100 Hz, mag 10 Hz. \n\r" );
+    printf( "                              ( about 6 MB per 1 kHz channel at 600 sec. applied before the devices are initialized. ) \n\r" );
+    printf( "  -V level, --log=level       the level of the log messages. ( stderr / stdout ) \n\r" );
+    printf( "                              off, error, warn, trace, debug ( default ). \n\r" );
+    printf( "                              trace and debug need DBG_PRINT in the source file. \n\r" );
+    printf( "  -M port, --metrics=port     serve the metrics ( OpenMetrics ) on http://127.0.0.1:port/metrics \n\r" );
+    printf( "                              while the other options run. ( 0 : 9464 ) \n\r" );
+    printf( "                              ( specify before the sensor options. )    \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -M 9464 -L /tmp/board.sock,1000       \n\r" );
+    printf( "                                  curl http://127.0.0.1:9464/metrics    \n\r" );
+    printf("\x1b[39m");
+    printf( "  -S [json|csv], --stats=[json|csv]                                     \n\r" );
+    printf( "                              display the statistics of each window.    \n\r" );
+    printf( "                              ( specify after the sensor options. )     \n\r" );
+    printf( "                              json : get the all values of json format. \n\r" );
+    printf( "                              csv  : get the all values of csv format.  \n\r" );
+    printf("\x1b[32m");
+    printf( "                              Ex) -r 1000 -i 10 -q -Sjson               \n\r" );
+    printf("\x1b[39m");
+    printf( "\n\r" );
+
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     VERSION を表示する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Version(
+    void
+){
+    DBG_PRINT_TRACE( "\n\r" );
+    printf( "Copyright (C) 2019 Uz Foundation, Inc. \n\r" );
+    printf( "Licence: Free. \n\r" );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     タイムスタンプの時刻の基準を設定する
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_TimeBase(
+    char*           str     ///< [in] 文字列
+){
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    if( 0 == strncmp( str, "mono", strlen("mono") ) )
+    {
+        HalCmnClock_SetBase( EN_CLOCK_MONO );
+    } else if( 0 == strncmp( str, "real", strlen("real") ) )
+    {
+        HalCmnClock_SetBase( EN_CLOCK_REAL );
+    } else if( 0 == strncmp( str, "local", strlen("local") ) )
+    {
+        HalCmnClock_SetBase( EN_CLOCK_LOCAL );
+        HalTime_FmtInit( &g_timeFmt, EN_FALSE );
+    } else if( 0 == strncmp( str, "utc", strlen("utc") ) )
+    {
+        HalCmnClock_SetBase( EN_CLOCK_UTC );
+        HalTime_FmtInit( &g_timeFmt, EN_TRUE );
+    } else
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+    }
+
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     開始時刻と終了時刻を表示する
+ * @attention なし。
+ * @note      時刻は -t オプションで指定した基準 ( nsec, local / utc は書式付き ) で表示する。
+ * @sa        PrintTime()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+PrintSpan(
+    unsigned long long  tsStart,    ///< [in] 開始時刻 ( HalCmnClock_GetNsec() )
+    unsigned long long  tsEnd       ///< [in] 終了時刻 ( HalCmnClock_GetNsec() )
+){
+    unsigned long long  start = HalCmnClock_Export( tsStart );
+    unsigned long long  end   = HalCmnClock_Export( tsEnd );
+    EHalClockBase_t     base  = HalCmnClock_GetBase();
+    char                strStart[HAL_TIME_FMT_LEN];
+    char                strEnd[HAL_TIME_FMT_LEN];
+
+    if( base == EN_CLOCK_LOCAL || base == EN_CLOCK_UTC )
+    {
+        HalTime_Format( &g_timeFmt, start, strStart );
+        HalTime_Format( &g_timeFmt, end,   strEnd );
+        printf( " %s %s", strStart, strEnd );
+    } else
+    {
+        printf( " %llu %llu", start, end );
+    }
+
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサ値の転送開始時刻と転送終了時刻を表示する
+ * @attention なし。
+ * @note      時刻は -t オプションで指定した基準 ( nsec ) で表示する。
+ * @sa        PrintSpan()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+PrintTime(
+    SHalSensor_t*   data    ///< [in] センサ変数
+){
+    PrintSpan( data->ts_start, data->ts_end );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサ値の出力形式を返す
+ * @attention なし。
+ * @note      -F オプションで text 以外を指定した場合はそれに従い、
+ *            text の場合はセンサのオプションの引数 ( json, csv ) に従う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    出力形式
+ *************************************************************************** */
+static EMainFormat_t
+GetFormat(
+    const char*     str     ///< [in] センサのオプションの引数
+){
+    if( g_format != EN_FORMAT_TEXT || str == NULL )
+    {
+        return g_format;
+    }
+
+    if( 0 == strncmp( str, "json", strlen("json") ) ){ return EN_FORMAT_JSON; }
+    if( 0 == strncmp( str, "csv",  strlen("csv")  ) ){ return EN_FORMAT_CSV; }
+    return EN_FORMAT_TEXT;
+}
+
+
+/**************************************************************************//*!
+ * @brief     json, csv, cbor のレコードを開始する
+ * @attention なし。
+ * @note      出力形式が変わった場合はシリアライザを初期化する。
+ *            ( g_ser は 0 で初期化されているので、最初は json として使える )
+ * @sa        SerEnd()
+ * @author    Ryoji Morita
+ * @return    シリアライザ
+ *************************************************************************** */
+static SAppIfSer_t*
+SerBegin(
+    EMainFormat_t   fmt     ///< [in] 出力形式 ( EN_FORMAT_JSON, EN_FORMAT_CSV, EN_FORMAT_CBOR )
+){
+    EAppIfSerFmt_t  serFmt = EN_SER_JSON;
+
+    if( fmt == EN_FORMAT_CSV ) { serFmt = EN_SER_CSV; }
+    if( fmt == EN_FORMAT_CBOR ){ serFmt = EN_SER_CBOR; }
+
+    if( g_ser.fmt != serFmt )
+    {
+        AppIfSer_Init( &g_ser, serFmt );
+    }
+
+    AppIfSer_Begin( &g_ser );
+    return &g_ser;
+}
+
+
+/**************************************************************************//*!
+ * @brief     json, csv, cbor のレコードを終了して標準出力に出力する
+ * @attention なし。
+ * @note      1 レコードを 1 回の write() で出力する。
+ *            -Q オプションを指定した場合は送信キューに積み、書けるだけ書いて戻る。
+ * @sa        Run_Queue()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SerEnd(
+    SAppIfSer_t*    ser     ///< [in] シリアライザ
+){
+    struct iovec        iov[2];
+    unsigned long long  drop = g_que.drop;
+    int                 num = 0;
+
+    if( AppIfSer_End( ser ) > 0 )
+    {
+        if( g_queFl < 0 )
+        {
+            AppIfSer_Write( ser, STDOUT_FILENO );
+            return;
+        }
+
+        num = AppIfSer_Iov( ser, iov );
+        if( num > 0 ){ AppIfQue_Pushv( &g_que, iov, num ); }
+
+        // 列名の行を含むレコードを捨てた可能性があるので、次のレコードに列名の行を付け直す
+        if( g_que.drop != drop ){ ser->hlenPrev = 0; }
+        AppIfQue_Flush( &g_que, STDOUT_FILENO );
+        HalCmnMetric_Set( EN_METRIC_GAUGE_QUE_FILL, g_que.len );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサ値の転送開始時刻と転送終了時刻を [ 開始, 終了 ] で書き込む
+ * @attention なし。
+ * @note      時刻は -t オプションで指定した基準 ( nsec ) で書き込む。
+ *            local, utc の場合は文字列にする。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SerTime(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    SHalSensor_t*   data    ///< [in] センサ変数
+){
+    unsigned long long  ts[2];
+    EHalClockBase_t     base  = HalCmnClock_GetBase();
+    char                strTime[HAL_TIME_FMT_LEN];
+
+    ts[0] = HalCmnClock_Export( data->ts_start );
+    ts[1] = HalCmnClock_Export( data->ts_end );
+    if( base == EN_CLOCK_LOCAL || base == EN_CLOCK_UTC )
+    {
+        AppIfSer_ArrBegin( ser, key );
+        HalTime_Format( &g_timeFmt, ts[0], strTime );
+        AppIfSer_Str( ser, NULL, strTime );
+        HalTime_Format( &g_timeFmt, ts[1], strTime );
+        AppIfSer_Str( ser, NULL, strTime );
+        AppIfSer_ArrEnd( ser );
+    } else
+    {
+        AppIfSer_UintArr( ser, key, ts, 2 );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサの推定値 ( 距離, 速度, 接触までの時間 ) を書き込む
+ * @attention なし。
+ * @note      mm : 距離 ( mm ), vel : 速度 ( mm/sec, 負 = 接近 ), ttc : 接触までの時間 ( sec, -1 = 接近していない )
+ *            valid : 1 = 速度を推定済み, 0 = 推定をやり直した直後 ( vel, ttc は未確定 )
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SerTrack(
+    SAppIfSer_t*    ser,    ///< [in] シリアライザ
+    const char*     key,    ///< [in] キー
+    EHalSensorCh_t  ch      ///< [in] 対象の ch
+){
+    SHalTrack_t*    track = HalSensorDist_GetTrack( ch );
+
+    AppIfSer_ObjBegin( ser, key );
+    AppIfSer_Uint( ser, "valid", ( track->valid == EN_TRUE ) ? 1 : 0 );
+    AppIfSer_Fix( ser, "mm",  track->pos, 1 );
+    AppIfSer_Fix( ser, "vel", track->vel, 1 );
+    AppIfSer_Fix( ser, "ttc", track->ttc, 3 );
+    AppIfSer_ObjEnd( ser );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサ値の生値をバイナリフレームで送信する / 共有メモリに書き込む / ファイルに記録する
+ * @attention なし。
+ * @note      data[0] - data[num - 1] を ch first から順に並んだ ch として送信する。
+ *            時刻は data[0] の転送開始時刻 ( -t オプションで指定した基準 )。
+ * @sa        AppIfFrame_Send(), AppIfShm_Publish(), AppIfRec_Write(), AppIfArc_Write()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+SendFrame(
+    EHalSensorCh_t  first,  ///< [in] 先頭の ch
+    unsigned int    num,    ///< [in] ch の数
+    SHalSensor_t*   data[]  ///< [in] センサ変数
+){
+    short           raw[EN_SEN_CH_NUM];
+    unsigned int    mask = 0;
+    unsigned int    i = 0;
+
+    memset( raw, 0, sizeof(raw) );
+    for( i = 0; i < num; i++ )
+    {
+        raw[first + i] = (short)data[i]->raw;
+        mask |= 1U << ( first + i );
+    }
+
+    if( g_format == EN_FORMAT_SHM )
+    {
+        AppIfShm_Publish( mask, raw, HalCmnClock_Export( data[0]->ts_start ) );
+    } else if( g_format == EN_FORMAT_REC )
+    {
+        AppIfRec_Write( mask, raw, data[0]->ts_start );
+    } else if( g_format == EN_FORMAT_ARC )
+    {
+        AppIfArc_Write( mask, raw, data[0]->ts_start );
+    } else
+    {
+        AppIfFrame_Send( mask, raw, HalCmnClock_Export( data[0]->ts_start ) );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     センサ値の出力形式を設定する
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Format(
+    char*           str     ///< [in] 文字列
+){
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    if( 0 == strncmp( str, "text", strlen("text") ) )
+    {
+        g_format = EN_FORMAT_TEXT;
+    } else if( 0 == strncmp( str, "json", strlen("json") ) )
+    {
+        g_format = EN_FORMAT_JSON;
+    } else if( 0 == strncmp( str, "csv", strlen("csv") ) )
+    {
+        g_format = EN_FORMAT_CSV;
+    } else if( 0 == strncmp( str, "cbor", strlen("cbor") ) )
+    {
+        g_format = EN_FORMAT_CBOR;
+    } else if( 0 == strncmp( str, "bin", strlen("bin") ) )
+    {
+        g_format = EN_FORMAT_BIN;
+    } else if( 0 == strncmp( str, "shm", strlen("shm") ) )
+    {
+        g_format = EN_FORMAT_SHM;
+    } else if( 0 == strncmp( str, "rec", strlen("rec") ) )
+    {
+        g_format = EN_FORMAT_REC;
+    } else if( 0 == strncmp( str, "arc", strlen("arc") ) )
+    {
+        g_format = EN_FORMAT_ARC;
+    } else
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+    }
+
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     バイナリフレームの出力先 / 共有メモリ / 記録するファイルを開く
+ * @attention なし。
+ * @note      端末の場合は -b オプションで指定したボーレートを設定する。
+ *            -F shm の場合は共有メモリの名前 ( "/" で始まる ) として扱う。
+ *            -F rec の場合は "path[,MB[,sec]]" ( セグメントの接頭辞, 最大サイズ, 最大時間 ) として扱う。
+ *            -F arc の場合は "path[,lz4][,uring|thread|sync]" ( アーカイブのパス, LZ4 で圧縮する,
+ *            ブロックの書き出し方法 ) として扱う。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Output(
+    char*           str     ///< [in] 文字列
+){
+    char*           comma = NULL;
+    unsigned int    mb = 0;
+    unsigned int    sec = 0;
+    unsigned int    flags = 0;
+    char*           opt = NULL;
+    EAppIfAioMode_t mode = EN_AIO_AUTO;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    if( g_format == EN_FORMAT_SHM )
+    {
+        if( AppIfShm_Open( str ) == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        }
+    } else if( g_format == EN_FORMAT_REC )
+    {
+        comma = strchr( str, ',' );
+        if( comma != NULL )
+        {
+            *comma = '\0';
+            mb = (unsigned int)strtoul( comma + 1, &comma, 10 );
+            if( *comma == ',' )
+            {
+                sec = (unsigned int)strtoul( comma + 1, NULL, 10 );
+            }
+        }
+        if( AppIfRec_Open( str, mb, sec ) == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        }
+    } else if( g_format == EN_FORMAT_ARC )
+    {
+        comma = strchr( str, ',' );
+        while( comma != NULL )
+        {
+            *comma = '\0';
+            opt   = comma + 1;
+            comma = strchr( opt, ',' );
+            if( comma != NULL ){ *comma = '\0'; }
+
+            if(      0 == strcmp( opt, "lz4" )    ){ flags |= APP_IF_ARC_FLAG_LZ4; }
+            else if( 0 == strcmp( opt, "uring" )  ){ mode = EN_AIO_URING; }
+            else if( 0 == strcmp( opt, "thread" ) ){ mode = EN_AIO_THREAD; }
+            else if( 0 == strcmp( opt, "sync" )   ){ mode = EN_AIO_SYNC; }
+            else{ DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", opt ); }
+        }
+        if( AppIfAio_Open( mode ) == EN_FALSE )
+        {
+            DBG_PRINT_WARN( "the blocks are written in the acquisition thread. \n\r" );
+        }
+        if( AppIfArc_Open( str, flags ) == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        }
+    } else if( AppIfFrame_Open( str, g_baud ) == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+    }
+
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     Unix ドメインソケットでセンサ値を配信する
+ * @attention SIGINT / SIGTERM を受け取るまで戻らない。
+ * @note      "path[,Hz]" で指定する。Hz は取得周期 ( 省略時 APP_IF_SRV_HZ )。
+ *            コマンドとレコードの形式は app/if_srv/if_srv.h を参照。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Listen(
+    char*           str     ///< [in] 文字列
+){
+    char*           comma = NULL;
+    unsigned int    hz = 0;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    comma = strrchr( str, ',' );
+    if( comma != NULL )
+    {
+        *comma = '\0';
+        hz = (unsigned int)strtoul( comma + 1, NULL, 10 );
+    }
+
+    if( AppIfSrv_Open( str, hz ) == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        return;
+    }
+
+    AppIfSrv_Run();
+    AppIfSrv_Close();
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     標準出力を送信キュー経由のノンブロッキング出力にする
+ * @attention json, csv, cbor の出力だけがキューを通る ( text の printf() は対象外 )。
+ * @note      "policy[,bytes]" で指定する。policy は oldest, newest, latest ( app/if_que/if_que.h )。
+ *            標準出力を O_NONBLOCK にし、終了時に QueFini() で元に戻す。
+ * @sa        QueFini()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Queue(
+    char*               str     ///< [in] 文字列
+){
+    char*               comma = NULL;
+    unsigned int        limit = 0;
+    EAppIfQuePolicy_t   policy = EN_QUE_DROP_OLDEST;
+    int                 fl = 0;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    comma = strchr( str, ',' );
+    if( comma != NULL )
+    {
+        *comma = '\0';
+        limit = (unsigned int)strtoul( comma + 1, NULL, 10 );
+    }
+
+    if( AppIfQue_Policy( str, &policy ) == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        return;
+    }
+
+    fflush( stdout );
+    fl = fcntl( STDOUT_FILENO, F_GETFL );
+    if( fl < 0 || fcntl( STDOUT_FILENO, F_SETFL, fl | O_NONBLOCK ) < 0 )
+    {
+        DBG_PRINT_ERROR( "fcntl() error. \n\r" );
+        return;
+    }
+
+    if( g_queFl < 0 ){ g_queFl = fl; }
+    AppIfQue_Init( &g_que, policy, limit );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     送信キューの残りを書いて標準出力を元に戻す
+ * @attention なし。
+ * @note      残りはブロッキングで書き、捨てたレコード数を標準エラー出力に表示する。
+ * @sa        Run_Queue()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+QueFini(
+    void
+){
+    if( g_queFl < 0 ){ return; }
+
+    fcntl( STDOUT_FILENO, F_SETFL, g_queFl );
+    AppIfQue_Flush( &g_que, STDOUT_FILENO );
+    if( g_que.drop > 0 )
+    {
+        fprintf( stderr, "queue : push = %llu, drop = %llu \n", g_que.push, g_que.drop );
+    }
+    g_queFl = -1;
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     動作状況の計測値を HTTP で公開する
+ * @attention 127.0.0.1 だけで待ち受ける。
+ * @note      "port" で指定する ( 0 の場合は APP_IF_METRIC_PORT )。
+ *            別スレッドで応答するので、以降のオプションの処理と並行して動く。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Metrics(
+    char*           str     ///< [in] 文字列
+){
+    unsigned long   port = 0;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    port = strtoul( str, NULL, 10 );
+    if( port > 65535 || AppIfMetric_Open( (unsigned short)port ) == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     記録したセンサ値を再生する
+ * @attention 再生中は SPI / I2C のセンサを読み出さない。
+ * @note      "path[,fast]" で指定する。path は -F rec -o で指定したもの。
+ *            fast の場合は記録した間隔を待たずに再生する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Replay(
+    char*           str     ///< [in] 文字列
+){
+    char*           comma = NULL;
+    EHalReplay_t    mode = EN_REPLAY_REAL;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    comma = strrchr( str, ',' );
+    if( comma != NULL && 0 == strcmp( comma + 1, "fast" ) )
+    {
+        *comma = '\0';
+        mode = EN_REPLAY_FAST;
+    }
+
+    if( HalCmnReplay_Open( str, mode ) == EN_FALSE )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     デバイスをエミュレータに差し替える
+ * @attention Sys_Init() の前に呼ぶこと ( 初期化でオフセット値を読み出すため )。
+ * @note      spi, i2c, gpio をカンマで区切って複数指定できる。
+ * @sa        ScanEarly()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Sim(
+    const char*     str     ///< [in] 文字列
+){
+    const char*     p = str;
+    size_t          len = 0;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    while( *p != '\0' )
+    {
+        len = strcspn( p, "," );
+        if( len == 3 && 0 == strncmp( p, "spi", len ) )
+        {
+            HalCmnSpi_SetOps( HalCmnSpiSim_GetOps() );
+        } else if( len == 3 && 0 == strncmp( p, "i2c", len ) )
+        {
+            HalCmnI2c_SetOps( HalCmnI2cSim_GetOps() );
+        } else if( len == 4 && 0 == strncmp( p, "gpio", len ) )
+        {
+            HalCmnGpio_SetOps( HalCmnGpioSim_GetOps() );
+        } else
+        {
+            DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        }
+        p += ( p[len] == ',' ) ? len + 1 : len;
+    }
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     履歴に保持する時間を設定する
+ * @attention Sys_Init() の前に呼ぶこと ( 初期化で履歴の領域を確保するため )。
+ * @note      ch 毎の容量は、この時間とセンサのサンプリング周波数 ( HAL_HIST_HZ_* ) で決める。
+ * @sa        ScanEarly()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_History(
+    const char*     str     ///< [in] 文字列
+){
+    char*           end = NULL;
+    unsigned long   sec = strtoul( str, &end, 10 );
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    if( end == str || *end != '\0' || sec == 0 || sec > 86400 )
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        return;
+    }
+
+    HalCmnHist_SetSec( (unsigned int)sec );
+    return;
+}
+
 
+/**************************************************************************//*!
+ * @brief     -E / --sim, -H / --history を探して、Sys_Init() の前に処理する
+ * @attention なし。
+ * @note      getopt_long() で処理する時は何もしない。
+ * @sa        Run_Sim(), Run_History()
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+ScanEarly(
+    int             argc,   ///< [in] 引数の数
+    char*           argv[]  ///< [in] 引数
+){
+    static const struct {
+        const char* opt;    // 短いオプション
+        const char* name;   // 長いオプション
+        void        (*func)( const char* str );
+    } early[] = {
+        { "-E", "--sim",     Run_Sim     },
+        { "-H", "--history", Run_History },
+    };
+    size_t          len = 0;
+    int             i = 0;
+    unsigned int    k = 0;
 
-//********************************************************
-/*! @struct                                              */
-//********************************************************
-// なし
+    for( i = 1; i < argc; i++ )
+    {
+        for( k = 0; k < sizeof(early) / sizeof(early[0]); k++ )
+        {
+            len = strlen( early[k].name );
+            if( 0 == strncmp( argv[i], early[k].name, len ) && argv[i][len] == '=' )
+            {
+                early[k].func( argv[i] + len + 1 );
+            } else if( ( 0 == strcmp( argv[i], early[k].opt ) || 0 == strcmp( argv[i], early[k].name ) ) && i + 1 < argc )
+            {
+                early[k].func( argv[++i] );
+            } else if( 0 == strncmp( argv[i], early[k].opt, strlen( early[k].opt ) ) && argv[i][2] != '\0' )
+            {
+                early[k].func( argv[i] + strlen( early[k].opt ) );
+            } else
+            {
+                continue;
+            }
+            break;
+        }
+    }
+    return;
+}
 
 
-//********************************************************
-/* モジュールグローバル変数                              */
-//********************************************************
-// getopt() で使用
-extern char *optarg;
-extern int  optind, opterr, optopt;
+/**************************************************************************//*!
+ * @brief     ログの出力レベルを設定する
+ * @attention なし。
+ * @note      off, error, warn, trace, debug のどれか。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Log(
+    char*           str     ///< [in] 文字列
+){
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
 
+    if(      0 == strcmp( str, "off"   ) ){ AppLog_SetLevel( EN_LOG_OFF   ); }
+    else if( 0 == strcmp( str, "error" ) ){ AppLog_SetLevel( EN_LOG_ERROR ); }
+    else if( 0 == strcmp( str, "warn"  ) ){ AppLog_SetLevel( EN_LOG_WARN  ); }
+    else if( 0 == strcmp( str, "trace" ) ){ AppLog_SetLevel( EN_LOG_TRACE ); }
+    else if( 0 == strcmp( str, "debug" ) ){ AppLog_SetLevel( EN_LOG_DEBUG ); }
+    else
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+    }
+    return;
+}
 
-//********************************************************
-/* 関数プロトタイプ宣言                                  */
-//********************************************************
-static void         Run_Help( void );
-static void         Run_Version( void );
 
-static void         Run_I2cLcd( int argc, char *argv[] );
-static void         Run_Led( char* str );
+/**************************************************************************//*!
+ * @brief     センサの読み出しを -r, -i オプションの指定に従って繰り返す
+ * @attention なし。
+ * @note      2 回目以降は前回の出力を改行で区切る ( テキスト形式のみ。json, csv は 1 レコード 1 行 )。
+ *            周期は初回の読み出し時刻を基準にするので、読み出しの処理時間で遅れない。
+ *            再生中 ( -R ) は記録の最後に達したら終了する。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Repeat(
+    void            (*func)( char* str ),   ///< [in] センサを読み出す関数
+    char*           str                     ///< [in] 関数に渡す文字列
+){
+    unsigned int    i = 0;
+    struct timespec next;
+    struct timespec now;
+    EMainFormat_t   fmt = GetFormat( str );
 
-static void         Run_Sa_Pm( char* str );
-static void         Run_Sa_Dist( char* str );
+    DBG_PRINT_TRACE( "repeat = %u, interval = %u \n\r", g_repeat, g_interval );
 
-static void         Run_Si_BMX055_Acc( char* str );
-static void         Run_Si_BMX055_Gyro( char* str );
-static void         Run_Si_BMX055_Mag( char* str );
+    clock_gettime( CLOCK_MONOTONIC, &next );
+    for( i = 0; i < g_repeat; i++ )
+    {
+        if( i > 0 )
+        {
+            if( fmt == EN_FORMAT_TEXT ){ printf( "\n" ); }
+            if( g_interval > 0 )
+            {
+                next.tv_nsec += (long)( g_interval % 1000 ) * NSEC_PER_MSEC;
+                next.tv_sec  += g_interval / 1000;
+                if( next.tv_nsec >= NSEC_PER_SEC )
+                {
+                    next.tv_nsec -= NSEC_PER_SEC;
+                    next.tv_sec++;
+                }
+
+                // 前回の読み出しが周期内に終わらなかった
+                clock_gettime( CLOCK_MONOTONIC, &now );
+                if( now.tv_sec > next.tv_sec || ( now.tv_sec == next.tv_sec && now.tv_nsec > next.tv_nsec ) )
+                {
+                    HalCmnMetric_Add( EN_METRIC_DEADLINE_MISS, 1 );
+                }
+                clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+            }
+        }
+        func( str );
 
+        if( HalCmnReplay_IsEnd() == EN_TRUE ){ break; }
+    }
 
+    return;
+}
 
 
 /**************************************************************************//*!
- * @brief     HELP を表示する。
+ * @brief     区間統計の時間窓を設定する
  * @attention なし。
- * @note      なし。
+ * @note      "100,1000,10000" のようにカンマ区切りで指定する。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    なし。
  *************************************************************************** */
 static void
-Run_Help(
-    void
+Run_Window(
+    char*           str     ///< [in] 文字列
 ){
-    DBG_PRINT_TRACE( "\n\r" );
-    printf( "  -h, --help                  display the help menu. \n\r" );
-    printf( "  -v, --version               display the version information. \n\r" );
-    printf( "                                                               \n\r" );
-    printf( "  -c, --i2clcd                control the (I2C) LCD.           \n\r" );
-    printf( "    -x number, --dir_x=number                                  \n\r" );
-    printf( "                              the value of x-axis.             \n\r" );
-    printf( "    -y number, --dir_y=number                                  \n\r" );
-    printf( "                              the value of y-axis.             \n\r" );
-    printf( "    -s string, --string=string                                 \n\r" );
-    printf( "                              the string to display on LCD.    \n\r" );
-    printf("\x1b[32m");
-    printf( "                              Ex) -c        -x      <number>  -y      <number>  -s       <string> \n\r" );
-    printf( "                                  --i2clcd  --dir_x=<number>  --dir_y=<number>  --string=<string> \n\r" );
-    printf("\x1b[39m");
-    printf( "                                                               \n\r" );
-    printf( "  -l number, --led=number     control the LED.                 \n\r" );
-    printf( "  -p [json], --sa_pm=[json]                                                  \n\r" );
-    printf( "                              get the value of a sensor(A/D), Potentiometer. \n\r" );
-    printf( "                              json : get the all values of json format.      \n\r" );
-    printf( "  -q [json], --sa_dist=[json]                                                \n\r" );
-    printf( "                              get the value of a sensor(A/D), Distance.      \n\r" );
-    printf( "                              json : get the all values of json format.      \n\r" );
-    printf( "  -x {x|y|z|json}, --si_bmx055acc={x|y|z|json}                          \n\r" );
-    printf( "                              get ACC of a sensor(I2C), BMX055.         \n\r" );
-    printf( "                              x    : get the value of x-axis.           \n\r" );
-    printf( "                              y    : get the value of y-axis.           \n\r" );
-    printf( "                              z    : get the value of z-axis.           \n\r" );
-    printf( "                              json : get the all values of json format. \n\r" );
-    printf( "  -y {x|y|z|json}, --si_bmx055gyro={x|y|z|json}                         \n\r" );
-    printf( "                              get GYRO of a sensor(I2C), BMX055.        \n\r" );
-    printf( "                              x    : get the value of x-axis.           \n\r" );
-    printf( "                              y    : get the value of y-axis.           \n\r" );
-    printf( "                              z    : get the value of z-axis.           \n\r" );
-    printf( "                              json : get the all values of json format. \n\r" );
-    printf( "  -z {x|y|z|json}, --si_bmx055mag={x|y|z|json}                          \n\r" );
-    printf( "                              get MAG of a sensor(I2C), BMX055.         \n\r" );
-    printf( "                              x    : get the value of x-axis.           \n\r" );
-    printf( "                              y    : get the value of y-axis.           \n\r" );
-    printf( "                              z    : get the value of z-axis.           \n\r" );
-    printf( "                              json : get the all values of json format. \n\r" );
-    printf( "\n\r" );
+    unsigned int    ms[HAL_STATS_WIN_MAX];
+    unsigned int    num = 0;
+    char*           p = str;
+    char*           end = NULL;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    while( *p != '\0' )
+    {
+        if( num >= HAL_STATS_WIN_MAX )
+        {
+            DBG_PRINT_ERROR( "too many windows. : %s \n\r", str );
+            goto err;
+        }
+
+        ms[num] = (unsigned int)strtoul( p, &end, 10 );
+        if( end == p || ( *end != ',' && *end != '\0' ) )
+        {
+            DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+            goto err;
+        }
+
+        num++;
+        p = ( *end == ',' ) ? end + 1 : end;
+    }
 
+    HalCmnStats_SetWindow( ms, num );
+
+err :
     return;
 }
 
 
 /**************************************************************************//*!
- * @brief     VERSION を表示する。
+ * @brief     区間統計を表示する
  * @attention なし。
- * @note      なし。
+ * @note      サンプルを読み出した ch だけを表示する。
+ *            json, csv, cbor は 1 レコードの大きさに収まるように ch 毎に 1 レコードを出力する。
  * @sa        なし。
  * @author    Ryoji Morita
  * @return    なし。
  *************************************************************************** */
 static void
-Run_Version(
-    void
+Run_Stats(
+    char*           str     ///< [in] 文字列
 ){
-    DBG_PRINT_TRACE( "\n\r" );
-    printf( "Copyright (C) 2019 Uz Foundation, Inc. \n\r" );
-    printf( "Licence: Free. \n\r" );
+    EHalSensorCh_t  ch;
+    unsigned int    w = 0;
+    unsigned int    num = HalCmnStats_GetWindowNum();
+    SHalStats_t     stats;
+    SAppIfSer_t*    ser;
+    EMainFormat_t   fmt = GetFormat( str );
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    if( fmt >= EN_FORMAT_JSON && fmt <= EN_FORMAT_CBOR )
+    {
+        for( ch = EN_SEN_CH_DIST_FL; ch < EN_SEN_CH_NUM; ch++ )
+        {
+            if( HalCmnHist_Count( ch ) == 0 ){ continue; }
+
+            ser = SerBegin( fmt );
+            AppIfSer_ObjBegin( ser, "stats" );
+            AppIfSer_ArrBegin( ser, HalCmn_GetChName( ch ) );
+            for( w = 0; w < num; w++ )
+            {
+                HalCmnStats_Get( ch, w, &stats );
+                AppIfSer_ObjBegin( ser, NULL );
+                AppIfSer_Uint( ser, "ms",   stats.ms );
+                AppIfSer_Uint( ser, "n",    stats.n );
+                AppIfSer_Fix(  ser, "mean", stats.mean, 6 );
+                AppIfSer_Fix(  ser, "sd",   stats.sd,   6 );
+                AppIfSer_Fix(  ser, "min",  stats.min,  6 );
+                AppIfSer_Fix(  ser, "max",  stats.max,  6 );
+                AppIfSer_ObjEnd( ser );
+            }
+            AppIfSer_ArrEnd( ser );
+            AppIfSer_ObjEnd( ser );
+            SerEnd( ser );
+        }
+    } else if( str == NULL )
+    {
+        for( ch = EN_SEN_CH_DIST_FL; ch < EN_SEN_CH_NUM; ch++ )
+        {
+            if( HalCmnHist_Count( ch ) == 0 ){ continue; }
+
+            for( w = 0; w < num; w++ )
+            {
+                if( HalCmnStats_Get( ch, w, &stats ) == EN_FALSE ){ continue; }
+
+                printf( "\n%-8s %6ums n=%-6u mean=%f sd=%f min=%f max=%f",
+                        HalCmn_GetChName( ch ), stats.ms, stats.n, stats.mean, stats.sd, stats.min, stats.max );
+            }
+        }
+    } else
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        goto err;
+    }
+
+err :
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     距離センサのフィルタを設定する
+ * @attention なし。
+ * @note      "hampel,5,3.0" のように種類, 窓の大きさ, 閾値をカンマ区切りで指定する。
+ *            窓の大きさと閾値は省略できる。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Run_Filter(
+    char*           str     ///< [in] 文字列
+){
+    EHalFilter_t    mode = EN_FILTER_OFF;
+    unsigned int    win = 5;
+    double          k = 3.0;
+    char*           p = NULL;
+    EHalSensorCh_t  ch;
+
+    DBG_PRINT_TRACE( "str = %s \n\r", str );
+
+    if( 0 == strncmp( str, "off", strlen("off") ) )
+    {
+        mode = EN_FILTER_OFF;
+    } else if( 0 == strncmp( str, "median", strlen("median") ) )
+    {
+        mode = EN_FILTER_MEDIAN;
+    } else if( 0 == strncmp( str, "hampel", strlen("hampel") ) )
+    {
+        mode = EN_FILTER_HAMPEL;
+    } else
+    {
+        DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+        goto err;
+    }
+
+    p = strchr( str, ',' );
+    if( p != NULL )
+    {
+        win = (unsigned int)strtoul( p + 1, &p, 10 );
+        if( *p == ',' )
+        {
+            k = strtod( p + 1, NULL );
+        }
+    }
+
+    for( ch = EN_SEN_CH_DIST_FL; ch <= EN_SEN_CH_DIST_FSR; ch++ )
+    {
+        if( HalCmnFilter_Open( ch, mode, win, k ) == EN_FALSE )
+        {
+            DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
+            goto err;
+        }
+    }
+
+err :
     return;
 }
 
@@ -268,26 +1396,35 @@ Run_Sa_Pm(
     char*           str     ///< [in] 文字列
 ){
     SHalSensor_t*   data;
+    SAppIfSer_t*    ser;
+    EMainFormat_t   fmt = GetFormat( str );
 
     DBG_PRINT_TRACE( "str = %s \n\r", str );
 
-    if( str == NULL )
+    if( fmt >= EN_FORMAT_BIN )
     {
         data = HalSensorPm_Get();
-        AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "%3d %%", data->cur_rate );
-        printf( "%3d", data->cur_rate );
-    } else if( 0 == strncmp( str, "json", strlen("json") ) )
+        SendFrame( EN_SEN_CH_PM, 1, &data );
+    } else if( fmt >= EN_FORMAT_JSON && fmt <= EN_FORMAT_CBOR )
     {
         data = HalSensorPm_Get();
 
         AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "%3d %%", data->cur_rate );
-
-        printf( "{ " );
-        printf( "  \"sensor\": \"sa_pm\"," );
-        printf( "  \"value\": %3d,", data->cur_rate );
-        printf( "}" );
+        AppIfLcd_Printf( "%3d %%", HalCmn_GetSenRate( data ) );
+
+        ser = SerBegin( fmt );
+        AppIfSer_Str( ser, "sensor", "sa_pm" );
+        AppIfSer_Str( ser, "unit",   "%" );
+        AppIfSer_Int( ser, "value", HalCmn_GetSenRate( data ) );
+        SerTime( ser, "ts", data );
+        SerEnd( ser );
+    } else if( str == NULL )
+    {
+        data = HalSensorPm_Get();
+        AppIfLcd_CursorSet( 0, 1 );
+        AppIfLcd_Printf( "%3d %%", HalCmn_GetSenRate( data ) );
+        printf( "%3d", HalCmn_GetSenRate( data ) );
+        PrintTime( data );
     } else
     {
         DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
@@ -315,44 +1452,79 @@ Run_Sa_Dist(
     SHalSensor_t*   dataFR;
     SHalSensor_t*   dataFSL;
     SHalSensor_t*   dataFSR;
+    SHalSensor_t*   data[4];
+    SAppIfSer_t*    ser;
+    EMainFormat_t   fmt = GetFormat( str );
 
     DBG_PRINT_TRACE( "str = %s \n\r", str );
 
-    if( str == NULL )
+    if( fmt >= EN_FORMAT_BIN )
+    {
+        data[0] = HalSensorDist_GetFL();
+        data[1] = HalSensorDist_GetFR();
+        data[2] = HalSensorDist_GetFSL();
+        data[3] = HalSensorDist_GetFSR();
+        SendFrame( EN_SEN_CH_DIST_FL, 4, data );
+    } else if( fmt >= EN_FORMAT_JSON && fmt <= EN_FORMAT_CBOR )
     {
         dataFL  = HalSensorDist_GetFL();
         dataFR  = HalSensorDist_GetFR();
         dataFSL = HalSensorDist_GetFSL();
         dataFSR = HalSensorDist_GetFSR();
+
         AppIfLcd_Clear();
         AppIfLcd_CursorSet( 0, 0 );
-        AppIfLcd_Printf( "FL :%2d%%, FR :%2d%%", dataFL->cur_rate, dataFR->cur_rate );
+        AppIfLcd_Printf( "FL :%2d%%, FR :%2d%%", HalCmn_GetSenRate( dataFL ), HalCmn_GetSenRate( dataFR ) );
         AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "FSL:%2d%%, FSR:%2d%%", dataFSL->cur_rate, dataFSR->cur_rate );
-        printf( "( %3d%%, %3d%%, %3d%%, %3d%% )", dataFL->cur_rate, dataFR->cur_rate, dataFSL->cur_rate, dataFSR->cur_rate );
-    } else if( 0 == strncmp( str, "json", strlen("json") ) )
+        AppIfLcd_Printf( "FSL:%2d%%, FSR:%2d%%", HalCmn_GetSenRate( dataFSL ), HalCmn_GetSenRate( dataFSR ) );
+
+        ser = SerBegin( fmt );
+        AppIfSer_Str( ser, "sensor", "sa_dist" );
+        AppIfSer_Str( ser, "unit",   "%" );
+        AppIfSer_ObjBegin( ser, "value" );
+        AppIfSer_Int( ser, "fl",  HalCmn_GetSenRate( dataFL ) );
+        AppIfSer_Int( ser, "fr",  HalCmn_GetSenRate( dataFR ) );
+        AppIfSer_Int( ser, "fsl", HalCmn_GetSenRate( dataFSL ) );
+        AppIfSer_Int( ser, "fsr", HalCmn_GetSenRate( dataFSR ) );
+        AppIfSer_ObjEnd( ser );
+        AppIfSer_ObjBegin( ser, "mm" );
+        AppIfSer_Uint( ser, "fl",  dataFL->cur_mm );
+        AppIfSer_Uint( ser, "fr",  dataFR->cur_mm );
+        AppIfSer_Uint( ser, "fsl", dataFSL->cur_mm );
+        AppIfSer_Uint( ser, "fsr", dataFSR->cur_mm );
+        AppIfSer_ObjEnd( ser );
+        AppIfSer_ObjBegin( ser, "reject" );
+        AppIfSer_Uint( ser, "fl",  HalCmnFilter_GetReject( EN_SEN_CH_DIST_FL ) );
+        AppIfSer_Uint( ser, "fr",  HalCmnFilter_GetReject( EN_SEN_CH_DIST_FR ) );
+        AppIfSer_Uint( ser, "fsl", HalCmnFilter_GetReject( EN_SEN_CH_DIST_FSL ) );
+        AppIfSer_Uint( ser, "fsr", HalCmnFilter_GetReject( EN_SEN_CH_DIST_FSR ) );
+        AppIfSer_ObjEnd( ser );
+        AppIfSer_ObjBegin( ser, "track" );
+        SerTrack( ser, "fl",  EN_SEN_CH_DIST_FL );
+        SerTrack( ser, "fr",  EN_SEN_CH_DIST_FR );
+        SerTrack( ser, "fsl", EN_SEN_CH_DIST_FSL );
+        SerTrack( ser, "fsr", EN_SEN_CH_DIST_FSR );
+        AppIfSer_ObjEnd( ser );
+        AppIfSer_ObjBegin( ser, "ts" );
+        SerTime( ser, "fl",  dataFL );
+        SerTime( ser, "fr",  dataFR );
+        SerTime( ser, "fsl", dataFSL );
+        SerTime( ser, "fsr", dataFSR );
+        AppIfSer_ObjEnd( ser );
+        SerEnd( ser );
+    } else if( str == NULL )
     {
         dataFL  = HalSensorDist_GetFL();
         dataFR  = HalSensorDist_GetFR();
         dataFSL = HalSensorDist_GetFSL();
         dataFSR = HalSensorDist_GetFSR();
-
         AppIfLcd_Clear();
         AppIfLcd_CursorSet( 0, 0 );
-        AppIfLcd_Printf( "FL :%2d%%, FR :%2d%%", dataFL->cur_rate, dataFR->cur_rate );
+        AppIfLcd_Printf( "FL :%2d%%, FR :%2d%%", HalCmn_GetSenRate( dataFL ), HalCmn_GetSenRate( dataFR ) );
         AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "FSL:%2d%%, FSR:%2d%%", dataFSL->cur_rate, dataFSR->cur_rate );
-
-        printf( "{ " );
-        printf( "  \"sensor\": \"sa_dist\"," );
-        printf( "  \"value\":" );
-        printf( "  { " );
-        printf( "    \"fl\": %-3d,",  dataFL->cur_rate );
-        printf( "    \"fr\": %-3d,",  dataFR->cur_rate );
-        printf( "    \"fsl\": %-3d,", dataFSL->cur_rate );
-        printf( "    \"fsr\": %-3d,", dataFSR->cur_rate );
-        printf( "  }" );
-        printf( "}" );
+        AppIfLcd_Printf( "FSL:%2d%%, FSR:%2d%%", HalCmn_GetSenRate( dataFSL ), HalCmn_GetSenRate( dataFSR ) );
+        printf( "( %3d%%, %3d%%, %3d%%, %3d%% )", HalCmn_GetSenRate( dataFL ), HalCmn_GetSenRate( dataFR ), HalCmn_GetSenRate( dataFSL ), HalCmn_GetSenRate( dataFSR ) );
+        PrintSpan( dataFL->ts_start, dataFSR->ts_end );
     } else
     {
         DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
@@ -380,44 +1552,58 @@ Run_Si_BMX055_Acc(
     SHalSensor_t*   dataX;
     SHalSensor_t*   dataY;
     SHalSensor_t*   dataZ;
+    SHalSensor_t*   dataXYZ[3];
+    SAppIfSer_t*    ser;
+    EMainFormat_t   fmt = GetFormat( str );
 
     DBG_PRINT_TRACE( "str = %s \n\r", str );
 
-    if( 0 == strncmp( str, "x", strlen("x") ) )
+    if( fmt >= EN_FORMAT_BIN )
+    {
+        dataXYZ[0] = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X );
+        dataXYZ[1] = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Y );
+        dataXYZ[2] = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Z );
+        SendFrame( EN_SEN_CH_ACC_X, 3, dataXYZ );
+    } else if( fmt >= EN_FORMAT_JSON && fmt <= EN_FORMAT_CBOR )
+    {
+        dataX = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X );
+        dataY = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Y );
+        dataZ = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Z );
+
+        AppIfLcd_CursorSet( 0, 1 );
+        AppIfLcd_Printf( "%+5.1f%+5.1f%+5.1f", dataX->cur, dataY->cur, dataZ->cur );
+
+        ser = SerBegin( fmt );
+        AppIfSer_Str( ser, "sensor", "si_bmx055acc" );
+        AppIfSer_Str( ser, "unit",   "m/s2" );
+        AppIfSer_ObjBegin( ser, "value" );
+        AppIfSer_Fix( ser, "x", dataX->cur, 6 );
+        AppIfSer_Fix( ser, "y", dataY->cur, 6 );
+        AppIfSer_Fix( ser, "z", dataZ->cur, 6 );
+        AppIfSer_ObjEnd( ser );
+        SerTime( ser, "ts", dataX );
+        SerEnd( ser );
+    } else if( 0 == strncmp( str, "x", strlen("x") ) )
     {
         data = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
+        PrintTime( data );
     } else if( 0 == strncmp( str, "y", strlen("y") ) )
     {
         data = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Y );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
+        PrintTime( data );
     } else if( 0 == strncmp( str, "z", strlen("z") ) )
     {
         data = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Z );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
-    } else if( 0 == strncmp( str, "json", strlen("json") ) )
-    {
-        dataX = HalSensorBmx055_GetAcc( EN_SEN_BMX055_X );
-        dataY = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Y );
-        dataZ = HalSensorBmx055_GetAcc( EN_SEN_BMX055_Z );
-
-        AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "%+5.1f%+5.1f%+5.1f", dataX->cur, dataY->cur, dataZ->cur );
-
-        printf( "{ " );
-        printf( "  \"sensor\": \"si_bmx055acc\"," );
-        printf( "  \"value\": {" );
-        printf( "    \"x\": %f,", dataX->cur );
-        printf( "    \"y\": %f,", dataY->cur );
-        printf( "    \"z\": %f ", dataZ->cur );
-        printf( "  }" );
-        printf( "}" );
+        PrintTime( data );
     } else
     {
         DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
@@ -445,44 +1631,58 @@ Run_Si_BMX055_Gyro(
     SHalSensor_t*   dataX;
     SHalSensor_t*   dataY;
     SHalSensor_t*   dataZ;
+    SHalSensor_t*   dataXYZ[3];
+    SAppIfSer_t*    ser;
+    EMainFormat_t   fmt = GetFormat( str );
 
     DBG_PRINT_TRACE( "str = %s \n\r", str );
 
-    if( 0 == strncmp( str, "x", strlen("x") ) )
+    if( fmt >= EN_FORMAT_BIN )
+    {
+        dataXYZ[0] = HalSensorBmx055_GetGyro( EN_SEN_BMX055_X );
+        dataXYZ[1] = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Y );
+        dataXYZ[2] = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Z );
+        SendFrame( EN_SEN_CH_GYRO_X, 3, dataXYZ );
+    } else if( fmt >= EN_FORMAT_JSON && fmt <= EN_FORMAT_CBOR )
+    {
+        dataX = HalSensorBmx055_GetGyro( EN_SEN_BMX055_X );
+        dataY = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Y );
+        dataZ = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Z );
+
+        AppIfLcd_CursorSet( 0, 1 );
+        AppIfLcd_Printf( "%+5.1f%+5.1f%+5.1f", dataX->cur, dataY->cur, dataZ->cur );
+
+        ser = SerBegin( fmt );
+        AppIfSer_Str( ser, "sensor", "si_bmx055gyro" );
+        AppIfSer_Str( ser, "unit",   "deg/s" );
+        AppIfSer_ObjBegin( ser, "value" );
+        AppIfSer_Fix( ser, "x", dataX->cur, 6 );
+        AppIfSer_Fix( ser, "y", dataY->cur, 6 );
+        AppIfSer_Fix( ser, "z", dataZ->cur, 6 );
+        AppIfSer_ObjEnd( ser );
+        SerTime( ser, "ts", dataX );
+        SerEnd( ser );
+    } else if( 0 == strncmp( str, "x", strlen("x") ) )
     {
         data = HalSensorBmx055_GetGyro( EN_SEN_BMX055_X );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
+        PrintTime( data );
     } else if( 0 == strncmp( str, "y", strlen("y") ) )
     {
         data = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Y );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
+        PrintTime( data );
     } else if( 0 == strncmp( str, "z", strlen("z") ) )
     {
         data = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Z );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
-    } else if( 0 == strncmp( str, "json", strlen("json") ) )
-    {
-        dataX = HalSensorBmx055_GetGyro( EN_SEN_BMX055_X );
-        dataY = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Y );
-        dataZ = HalSensorBmx055_GetGyro( EN_SEN_BMX055_Z );
-
-        AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "%+5.1f%+5.1f%+5.1f", dataX->cur, dataY->cur, dataZ->cur );
-
-        printf( "{ " );
-        printf( "  \"sensor\": \"si_bmx055gyro\"," );
-        printf( "  \"value\": {" );
-        printf( "    \"x\": %f,", dataX->cur );
-        printf( "    \"y\": %f,", dataY->cur );
-        printf( "    \"z\": %f ", dataZ->cur );
-        printf( "  }" );
-        printf( "}" );
+        PrintTime( data );
     } else
     {
         DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
@@ -510,44 +1710,58 @@ Run_Si_BMX055_Mag(
     SHalSensor_t*   dataX;
     SHalSensor_t*   dataY;
     SHalSensor_t*   dataZ;
+    SHalSensor_t*   dataXYZ[3];
+    SAppIfSer_t*    ser;
+    EMainFormat_t   fmt = GetFormat( str );
 
     DBG_PRINT_TRACE( "str = %s \n\r", str );
 
-    if( 0 == strncmp( str, "x", strlen("x") ) )
+    if( fmt >= EN_FORMAT_BIN )
+    {
+        dataXYZ[0] = HalSensorBmx055_GetMag( EN_SEN_BMX055_X );
+        dataXYZ[1] = HalSensorBmx055_GetMag( EN_SEN_BMX055_Y );
+        dataXYZ[2] = HalSensorBmx055_GetMag( EN_SEN_BMX055_Z );
+        SendFrame( EN_SEN_CH_MAG_X, 3, dataXYZ );
+    } else if( fmt >= EN_FORMAT_JSON && fmt <= EN_FORMAT_CBOR )
+    {
+        dataX = HalSensorBmx055_GetMag( EN_SEN_BMX055_X );
+        dataY = HalSensorBmx055_GetMag( EN_SEN_BMX055_Y );
+        dataZ = HalSensorBmx055_GetMag( EN_SEN_BMX055_Z );
+
+        AppIfLcd_CursorSet( 0, 1 );
+        AppIfLcd_Printf( "%+5.1f%+5.1f%+5.1f", dataX->cur, dataY->cur, dataZ->cur );
+
+        ser = SerBegin( fmt );
+        AppIfSer_Str( ser, "sensor", "si_bmx055mag" );
+        AppIfSer_Str( ser, "unit",   "LSB" );
+        AppIfSer_ObjBegin( ser, "value" );
+        AppIfSer_Fix( ser, "x", dataX->cur, 6 );
+        AppIfSer_Fix( ser, "y", dataY->cur, 6 );
+        AppIfSer_Fix( ser, "z", dataZ->cur, 6 );
+        AppIfSer_ObjEnd( ser );
+        SerTime( ser, "ts", dataX );
+        SerEnd( ser );
+    } else if( 0 == strncmp( str, "x", strlen("x") ) )
     {
         data = HalSensorBmx055_GetMag( EN_SEN_BMX055_X );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
+        PrintTime( data );
     } else if( 0 == strncmp( str, "y", strlen("y") ) )
     {
         data = HalSensorBmx055_GetMag( EN_SEN_BMX055_Y );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
+        PrintTime( data );
     } else if( 0 == strncmp( str, "z", strlen("z") ) )
     {
         data = HalSensorBmx055_GetMag( EN_SEN_BMX055_Z );
         AppIfLcd_CursorSet( 0, 1 );
         AppIfLcd_Printf( "%+8.4f", data->cur );
         printf( "%f", data->cur );
-    } else if( 0 == strncmp( str, "json", strlen("json") ) )
-    {
-        dataX = HalSensorBmx055_GetMag( EN_SEN_BMX055_X );
-        dataY = HalSensorBmx055_GetMag( EN_SEN_BMX055_Y );
-        dataZ = HalSensorBmx055_GetMag( EN_SEN_BMX055_Z );
-
-        AppIfLcd_CursorSet( 0, 1 );
-        AppIfLcd_Printf( "%+5.1f%+5.1f%+5.1f", dataX->cur, dataY->cur, dataZ->cur );
-
-        printf( "{ " );
-        printf( "  \"sensor\": \"si_bmx055mag\"," );
-        printf( "  \"value\": {" );
-        printf( "    \"x\": %f,", dataX->cur );
-        printf( "    \"y\": %f,", dataY->cur );
-        printf( "    \"z\": %f ", dataZ->cur );
-        printf( "  }" );
-        printf( "}" );
+        PrintTime( data );
     } else
     {
         DBG_PRINT_ERROR( "invalid argument error. : %s \n\r", str );
@@ -570,7 +1784,7 @@ err :
 int main(int argc, char *argv[ ])
 {
     int             opt = 0;
-    const char      optstring[] = "hvc:d:l:p::q::x:y:z:";
+    const char      optstring[] = "hvb:c:f:i:l:o:p::q::r:E:F:H:L:M:Q:R:S::t:V:w:x:y:z:";
     const struct    option longopts[] = {
       //{ *name,           has_arg,           *flag, val }, // 説明
         { "help",          no_argument,       NULL,  'h' },
@@ -579,6 +1793,22 @@ int main(int argc, char *argv[ ])
         { "led",           required_argument, NULL,  'l' },
         { "sa_pm",         optional_argument, NULL,  'p' },
         { "sa_dist",       optional_argument, NULL,  'q' },
+        { "timebase",      required_argument, NULL,  't' },
+        { "repeat",        required_argument, NULL,  'r' },
+        { "interval",      required_argument, NULL,  'i' },
+        { "window",        required_argument, NULL,  'w' },
+        { "stats",         optional_argument, NULL,  'S' },
+        { "filter",        required_argument, NULL,  'f' },
+        { "format",        required_argument, NULL,  'F' },
+        { "output",        required_argument, NULL,  'o' },
+        { "baud",          required_argument, NULL,  'b' },
+        { "listen",        required_argument, NULL,  'L' },
+        { "queue",         required_argument, NULL,  'Q' },
+        { "metrics",       required_argument, NULL,  'M' },
+        { "replay",        required_argument, NULL,  'R' },
+        { "log",           required_argument, NULL,  'V' },
+        { "sim",           required_argument, NULL,  'E' },
+        { "history",       required_argument, NULL,  'H' },
         { "si_bmx055acc",  required_argument, NULL,  'x' },
         { "si_bmx055gyro", required_argument, NULL,  'y' },
         { "si_bmx055mag",  required_argument, NULL,  'z' },
@@ -586,6 +1816,8 @@ int main(int argc, char *argv[ ])
     };
     int longindex = 0;
 
+    AppLog_Init( -1 );
+    ScanEarly( argc, argv );
     Sys_Init();
 
     DBG_PRINT_TRACE( "argc    = %d \n\r", argc );
@@ -628,11 +1860,27 @@ int main(int argc, char *argv[ ])
         case 'h': Run_Help(); break;
         case 'v': Run_Version(); break;
         case 'l': Run_Led( optarg ); break;
-        case 'p': Run_Sa_Pm( optarg ); break;
-        case 'q': Run_Sa_Dist( optarg ); break;
-        case 'x': Run_Si_BMX055_Acc( optarg ); break;
-        case 'y': Run_Si_BMX055_Gyro( optarg ); break;
-        case 'z': Run_Si_BMX055_Mag( optarg ); break;
+        case 'p': Run_Repeat( Run_Sa_Pm, optarg ); break;
+        case 'q': Run_Repeat( Run_Sa_Dist, optarg ); break;
+        case 't': Run_TimeBase( optarg ); break;
+        case 'r': g_repeat = (unsigned int)strtoul( (const char*)optarg, NULL, 10 ); break;
+        case 'i': g_interval = (unsigned int)strtoul( (const char*)optarg, NULL, 10 ); break;
+        case 'w': Run_Window( optarg ); break;
+        case 'S': Run_Stats( optarg ); break;
+        case 'f': Run_Filter( optarg ); break;
+        case 'F': Run_Format( optarg ); break;
+        case 'o': Run_Output( optarg ); break;
+        case 'b': g_baud = (unsigned int)strtoul( (const char*)optarg, NULL, 10 ); break;
+        case 'L': Run_Listen( optarg ); break;
+        case 'Q': Run_Queue( optarg ); break;
+        case 'M': Run_Metrics( optarg ); break;
+        case 'R': Run_Replay( optarg ); break;
+        case 'V': Run_Log( optarg ); break;
+        case 'E': break;    // ScanEarly() で処理済み
+        case 'H': break;    // ScanEarly() で処理済み
+        case 'x': Run_Repeat( Run_Si_BMX055_Acc, optarg ); break;
+        case 'y': Run_Repeat( Run_Si_BMX055_Gyro, optarg ); break;
+        case 'z': Run_Repeat( Run_Si_BMX055_Mag, optarg ); break;
         default:
             DBG_PRINT_ERROR( "invalid command/option. : \"%s\" \n\r", argv[1] );
             Run_Help();
@@ -640,7 +1888,16 @@ int main(int argc, char *argv[ ])
         }
     }
 
+    QueFini();
+    AppIfMetric_Close();
+    AppIfFrame_Close();
+    AppIfShm_Close();
+    AppIfRec_Close();
+    AppIfArc_Close();
+    AppIfAio_Close();
+    HalCmnReplay_Close();
     Sys_Fini();
+    AppLog_Fini();
     return 0;
 }
 
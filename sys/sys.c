@@ -75,6 +75,12 @@ Sys_Init(
 ){
     DBG_PRINT_TRACE( "\n\r" );
 
+    HalCmnClock_Init();
+    HalCmnHist_Init();
+    HalCmnStats_Init();
+    HalCmnFilter_Init();
+    HalCmnTrack_Init();
+
     HalCmnGpio_Init();
     HalCmnI2c_Init();
     HalCmnSpi_Init();
@@ -83,6 +89,11 @@ Sys_Init(
     HalLed_Init();
     HalPushSw_Init();
 //    HalSensorBmx055_Init();
+    if( HalCmnI2c_GetOps() == HalCmnI2cSim_GetOps() )   // エミュレータ ( -E i2c ) の場合は初期化する
+    {
+        HalSensorBmx055_Init();
+    }
+    HalSensorBmx055_OpenHist();     // デバイスを初期化しない場合も IMU の履歴と統計を使う
 
     // SENSOR (ADC)
     HalSensorPm_Init();
@@ -123,6 +134,9 @@ Sys_Fini(
     HalCmnI2c_Fini();
     HalCmnSpi_Fini();
 
+    HalCmnStats_Fini();
+    HalCmnHist_Fini();
+
     return;
 }
 
@@ -139,7 +153,7 @@ void
 Sys_ShowInfo(
     void    ///< [in] ナシ
 ){
-    SHalTime_t*     date;
+    SHalTime_t      date;
 
     DBG_PRINT_TRACE( "\n\r" );
 
@@ -153,9 +167,9 @@ Sys_ShowInfo(
     usleep( 2000 * 1000 );  // 2sec 表示
 
     AppIfLcd_CursorSet( 0, 1 );
-    date = HalTime_GetLocaltime();
+    HalTime_GetLocaltimeR( &date );
     AppIfLcd_Printf( "%04d/%02d/%02d",
-                    date->year, date->month, date->day );
+                    date.year, date.month, date.day );
 
     AppIfPc_Printf( "[Compiler Info]================= \n\r" );
     AppIfPc_Printf( "sizeof(char)  = %d \n\r", sizeof(char) );
@@ -165,18 +179,18 @@ Sys_ShowInfo(
     AppIfPc_Printf( "[System Info]=================== \n\r" );
     AppIfPc_Printf( "S/W Ver.      = 0.01 \n\r" );
 
-    date = HalTime_GetLocaltime();
+    HalTime_GetLocaltimeR( &date );
     AppIfPc_Printf( "Date(local)   = " );
     AppIfPc_Printf( "%04d/%02d/%02d %02d:%02d:%02d",
-            date->year, date->month, date->day,
-            date->hour, date->min,   date->sec );
+            date.year, date.month, date.day,
+            date.hour, date.min,   date.sec );
     AppIfPc_Printf( "\n\r" );
 
-    date = HalTime_GetUTC();
+    HalTime_GetUTCR( &date );
     AppIfPc_Printf( "Date(UTC)     = " );
     AppIfPc_Printf( "%04d/%02d/%02d %02d:%02d:%02d",
-            date->year, date->month, date->day,
-            date->hour, date->min,   date->sec );
+            date.year, date.month, date.day,
+            date.hour, date.min,   date.sec );
     AppIfPc_Printf( "\n\r" );
     AppIfPc_Printf( "================================ \n\r" );
 
@@ -0,0 +1,168 @@
+/**************************************************************************//*!
+ *  @file           arc_dump.c
+ *  @brief          [TOOL] アーカイブのセンサ値を表示するファイル。
+ *  @author         Ryoji Morita
+ *  @attention      board.out -F arc で書き込んだアーカイブを読み出し、CSV で表示する。
+ *                  使い方 : arc_dump.out パス [開始 [終了]]
+ *                      開始, 終了 : アーカイブを作成してからの時間 ( sec, 小数可 )
+ *                      開始を含むブロックを索引で探し、そこから終了までを表示する。
+ *                  列 : blk, ts ( CLOCK_MONOTONIC_RAW, nsec ), real ( UNIX 時間, nsec ), ch 名 ...
+ *                  レコードにない ch は空欄。
+ *                  終了時にブロック数, レコード数, 1 レコードあたりのサイズを標準エラー出力に表示する。
+ *  @sa             app/if_arc/if_arc.h
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "if_arc.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+static SAppIfArcCol_t   g_col;      // 復号したブロック
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Print( const SAppIfArcFile_t* file, unsigned long long blk, unsigned int i );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     レコードを 1 行で表示する。
+ * @attention なし。
+ * @note      UNIX 時間はヘッダの時刻からの経過時間で求める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Print(
+    const SAppIfArcFile_t*  file,   ///< [in] ファイル
+    unsigned long long      blk,    ///< [in] ブロックの番号
+    unsigned int            i       ///< [in] ブロック内のレコードの番号
+){
+    unsigned int    ch = 0;
+
+    printf( "%llu,%llu,%llu", blk, g_col.ts[i],
+            file->hdr->real + ( g_col.ts[i] - file->hdr->mono ) );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        if( g_col.mask[i] & ( 1U << ch ) )
+        {
+            printf( ",%g", g_col.raw[ch][i] * file->hdr->scale[ch] );
+        } else
+        {
+            printf( "," );
+        }
+    }
+    printf( "\n" );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     メイン関数
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EXIT_SUCCESS : 成功, EXIT_FAILURE : 失敗
+ *************************************************************************** */
+int
+main(
+    int     argc,   ///< [in] 引数の数
+    char*   argv[]  ///< [in] 引数
+){
+    SAppIfArcFile_t     file;
+    unsigned long long  from = 0;
+    unsigned long long  to = ~0ULL;
+    unsigned long long  blk = 0;
+    unsigned long long  num = 0;
+    unsigned int        ch = 0;
+    unsigned int        i = 0;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage : %s path [from_sec [to_sec]] \n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    if( AppIfArcReader_Open( &file, argv[1] ) == EN_FALSE )
+    {
+        fprintf( stderr, "arc_dump: %s not found. \n", argv[1] );
+        return EXIT_FAILURE;
+    }
+
+    from = file.hdr->mono;
+    if( argc > 2 ){ from += (unsigned long long)( strtod( argv[2], NULL ) * 1e9 ); }
+    if( argc > 3 ){ to = file.hdr->mono + (unsigned long long)( strtod( argv[3], NULL ) * 1e9 ); }
+
+    printf( "blk,ts,real" );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        printf( ",%s", file.hdr->name[ch] );
+    }
+    printf( "\n" );
+
+    for( blk = AppIfArcReader_Find( &file, from ); blk < file.idx_num && file.idx[blk].first <= to; blk++ )
+    {
+        if( AppIfArcReader_Read( &file, blk, &g_col ) == EN_FALSE )
+        {
+            break;
+        }
+        for( i = 0; i < g_col.count; i++ )
+        {
+            if( g_col.ts[i] >= from && g_col.ts[i] <= to )
+            {
+                Print( &file, blk, i );
+                num++;
+            }
+        }
+    }
+
+    fprintf( stderr, "arc_dump: %llu / %llu records, %llu blocks, %zu Byte ( %.2f Byte/record ) \n",
+             num, file.count, file.idx_num, file.size,
+             ( file.count > 0 ) ? (double)file.size / (double)file.count : 0.0 );
+    AppIfArcReader_Close( &file );
+    return EXIT_SUCCESS;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,209 @@
+/**************************************************************************//*!
+ *  @file           gen_dist_lut.c
+ *  @brief          [TOOL] 距離センサの AD 値 -> 距離 ( mm ) 変換テーブルを生成するファイル。
+ *  @author         Ryoji Morita
+ *  @attention      ビルド時にホスト上で実行し、hal_dist_lut.c を出力する。
+ *                  使い方 : gen_dist_lut.out [出力ファイル]
+ *  @sa             hal/hal_dist_cal.h
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal_dist_cal.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define LUT_PER_LINE    (16)    // 1 行に出力する要素数
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static int              CheckCal( const SHalDistCal_t* cal, unsigned int num );
+static unsigned short   Convert( const SHalDistCal_t* cal, unsigned int num, unsigned int ad );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     校正点が電圧の降順 ( 距離の昇順 ) に並んでいるか確認する。
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    0 : 正常, -1 : 異常
+ *************************************************************************** */
+static int
+CheckCal(
+    const SHalDistCal_t*    cal,    ///< [in] 校正点
+    unsigned int            num     ///< [in] 校正点の数
+){
+    unsigned int    i = 0;
+
+    if( num < 2 )
+    {
+        return -1;
+    }
+
+    for( i = 0; i < num; i++ )
+    {
+        if( cal[i].mm == 0 || cal[i].mm > 0xFFFF )
+        {
+            return -1;
+        }
+
+        if( i > 0 && ( cal[i].mv >= cal[i - 1].mv || cal[i].mm <= cal[i - 1].mm ) )
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**************************************************************************//*!
+ * @brief     AD 値を距離に変換する。
+ * @attention なし。
+ * @note      赤外線測距センサの出力電圧は距離の逆数にほぼ比例するので、
+ *            校正点の間は 1 / 距離 の空間で線形補間する。
+ *            校正点の範囲外は端の校正点の距離に丸める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    距離 ( mm )
+ *************************************************************************** */
+static unsigned short
+Convert(
+    const SHalDistCal_t*    cal,    ///< [in] 校正点
+    unsigned int            num,    ///< [in] 校正点の数
+    unsigned int            ad      ///< [in] AD 値
+){
+    unsigned int    i = 0;
+    double          mv = 0.0;
+    double          inv0 = 0.0;
+    double          inv1 = 0.0;
+    double          inv = 0.0;
+
+    mv = (double)ad * MCP3208_VREF_MV / HAL_DIST_LUT_SIZE;
+
+    if( mv >= cal[0].mv )
+    {
+        return (unsigned short)cal[0].mm;
+    }
+
+    for( i = 1; i < num; i++ )
+    {
+        if( mv >= cal[i].mv )
+        {
+            inv0 = 1.0 / cal[i - 1].mm;
+            inv1 = 1.0 / cal[i].mm;
+            inv  = inv0 + ( inv1 - inv0 ) * ( cal[i - 1].mv - mv ) / ( cal[i - 1].mv - cal[i].mv );
+            return (unsigned short)( 1.0 / inv + 0.5 );
+        }
+    }
+
+    return (unsigned short)cal[num - 1].mm;
+}
+
+
+/**************************************************************************//*!
+ * @brief     メイン関数
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EXIT_SUCCESS : 成功, EXIT_FAILURE : 失敗
+ *************************************************************************** */
+int
+main(
+    int     argc,   ///< [in] 引数の数
+    char*   argv[]  ///< [in] 引数 ( 出力ファイル )
+){
+    FILE*           fp = stdout;
+    unsigned int    m = 0;
+    unsigned int    i = 0;
+
+    for( m = 0; m < EN_DIST_MODEL_NUM; m++ )
+    {
+        if( CheckCal( g_calTable[m].cal, g_calTable[m].num ) != 0 )
+        {
+            fprintf( stderr, "gen_dist_lut: invalid calibration points. : %s \n", g_calTable[m].name );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if( argc > 1 )
+    {
+        fp = fopen( argv[1], "w" );
+        if( fp == NULL )
+        {
+            perror( argv[1] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    fprintf( fp, "/* This file is generated by tools/gen_dist_lut.c. Do not edit. */\n" );
+    fprintf( fp, "#include \"hal.h\"\n\n" );
+    fprintf( fp, "const unsigned short g_halDistLut[EN_DIST_MODEL_NUM][HAL_DIST_LUT_SIZE] = {\n" );
+
+    for( m = 0; m < EN_DIST_MODEL_NUM; m++ )
+    {
+        fprintf( fp, "    /* %s */\n    {", g_calTable[m].name );
+        for( i = 0; i < HAL_DIST_LUT_SIZE; i++ )
+        {
+            if( i % LUT_PER_LINE == 0 )
+            {
+                fprintf( fp, "\n       " );
+            }
+            fprintf( fp, " %4u,", Convert( g_calTable[m].cal, g_calTable[m].num, i ) );
+        }
+        fprintf( fp, "\n    },\n" );
+    }
+
+    fprintf( fp, "};\n" );
+
+    if( fp != stdout && fclose( fp ) != 0 )
+    {
+        perror( argv[1] );
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
@@ -0,0 +1,156 @@
+/**************************************************************************//*!
+ *  @file           rec_dump.c
+ *  @brief          [TOOL] 記録したセグメントファイルのセンサ値を表示するファイル。
+ *  @author         Ryoji Morita
+ *  @attention      board.out -F rec で記録したセグメントを読み出し、CSV で表示する。
+ *                  使い方 : rec_dump.out パスの接頭辞 [先頭のセグメントの番号]
+ *                      path.0000 から ( 指定した番号から ) セグメントがなくなるまで順に表示する。
+ *                  列 : seg, ts ( CLOCK_MONOTONIC_RAW, nsec ), real ( UNIX 時間, nsec ), ch 名 ...
+ *                  レコードにない ch は空欄。
+ *  @sa             app/if_rec/if_rec.h
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "if_rec.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Print( const SAppIfRecFile_t* file, const SAppIfRecRec_t* rec );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     レコードを 1 行で表示する。
+ * @attention なし。
+ * @note      UNIX 時間はセグメントのヘッダの時刻からの経過時間で求める。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Print(
+    const SAppIfRecFile_t*  file,   ///< [in] セグメント
+    const SAppIfRecRec_t*   rec     ///< [in] レコード
+){
+    unsigned int    ch = 0;
+
+    printf( "%u,%llu,%llu", file->hdr->h.seg, rec->ts,
+            file->hdr->h.real + ( rec->ts - file->hdr->h.mono ) );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        if( rec->mask & ( 1U << ch ) )
+        {
+            printf( ",%g", rec->raw[ch] * file->hdr->h.scale[ch] );
+        } else
+        {
+            printf( "," );
+        }
+    }
+    printf( "\n" );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     メイン関数
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EXIT_SUCCESS : 成功, EXIT_FAILURE : 失敗
+ *************************************************************************** */
+int
+main(
+    int     argc,   ///< [in] 引数の数
+    char*   argv[]  ///< [in] 引数
+){
+    SAppIfRecFile_t     file;
+    unsigned int        seg = 0;
+    unsigned int        ch = 0;
+    unsigned long long  i = 0;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage : %s path [seg] \n", argv[0] );
+        return EXIT_FAILURE;
+    }
+    if( argc > 2 )
+    {
+        seg = (unsigned int)strtoul( argv[2], NULL, 10 );
+    }
+
+    if( AppIfRecReader_Open( &file, argv[1], seg ) == EN_FALSE )
+    {
+        fprintf( stderr, "rec_dump: %s.%04u not found. \n", argv[1], seg );
+        return EXIT_FAILURE;
+    }
+
+    printf( "seg,ts,real" );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        printf( ",%s", file.hdr->h.name[ch] );
+    }
+    printf( "\n" );
+
+    do
+    {
+        if( file.hdr->h.closed == 0 )
+        {
+            fprintf( stderr, "rec_dump: %s.%04u is being written. ( %llu records ) \n", argv[1], seg, file.count );
+        }
+        for( i = 0; i < file.count; i++ )
+        {
+            Print( &file, &file.rec[i] );
+        }
+        AppIfRecReader_Close( &file );
+        seg++;
+    } while( AppIfRecReader_Open( &file, argv[1], seg ) == EN_TRUE );
+
+    return EXIT_SUCCESS;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif
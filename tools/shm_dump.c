@@ -0,0 +1,158 @@
+/**************************************************************************//*!
+ *  @file           shm_dump.c
+ *  @brief          [TOOL] 共有メモリのセンサ値を表示するファイル。
+ *  @author         Ryoji Morita
+ *  @attention      board.out -F shm で書き込んだ共有メモリを読み出す。
+ *                  使い方 : shm_dump.out [-f] [共有メモリの名前]
+ *                      なし : 最新レコードを 1 つ表示する
+ *                      -f   : リングバッファに残っているレコードから順に表示し続ける
+ *  @sa             app/if_shm/if_shm.h
+ *  @bug            none.
+ *  @warning        none.
+ *  @version        1.00
+ *  @last updated   2026.10.19
+ *************************************************************************** */
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+
+//********************************************************
+/* include                                               */
+//********************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "if_shm.h"
+
+
+//********************************************************
+/*! @def                                                 */
+//********************************************************
+#define DUMP_POLL_USEC      (1000)      // 新しいレコードがない時に待つ時間 ( usec )
+
+
+//********************************************************
+/*! @enum                                                */
+//********************************************************
+// なし
+
+
+//********************************************************
+/*! @struct                                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* モジュールグローバル変数                              */
+//********************************************************
+// なし
+
+
+//********************************************************
+/* 関数プロトタイプ宣言                                  */
+//********************************************************
+static void         Print( const SAppIfShm_t* shm, const SAppIfShmRec_t* rec );
+
+
+
+
+/**************************************************************************//*!
+ * @brief     レコードを 1 行で表示する。
+ * @attention なし。
+ * @note      通し番号 時刻 ch=物理量 ...
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    なし。
+ *************************************************************************** */
+static void
+Print(
+    const SAppIfShm_t*      shm,    ///< [in] 共有メモリ
+    const SAppIfShmRec_t*   rec     ///< [in] レコード
+){
+    unsigned int    ch = 0;
+
+    printf( "%llu %llu", rec->seq - 1, rec->ts );
+    for( ch = 0; ch < EN_SEN_CH_NUM; ch++ )
+    {
+        if( rec->mask & ( 1U << ch ) )
+        {
+            printf( " %u=%g", ch, rec->raw[ch] * shm->scale[ch] );
+        }
+    }
+    printf( "\n" );
+    return;
+}
+
+
+/**************************************************************************//*!
+ * @brief     メイン関数
+ * @attention なし。
+ * @note      なし。
+ * @sa        なし。
+ * @author    Ryoji Morita
+ * @return    EXIT_SUCCESS : 成功, EXIT_FAILURE : 失敗
+ *************************************************************************** */
+int
+main(
+    int     argc,   ///< [in] 引数の数
+    char*   argv[]  ///< [in] 引数
+){
+    const SAppIfShm_t*  shm = NULL;
+    SAppIfShmRec_t      rec;
+    unsigned long long  cursor = 0;
+    unsigned long long  prev = 0;
+    int                 follow = 0;
+    const char*         name = NULL;
+    int                 i = 0;
+
+    for( i = 1; i < argc; i++ )
+    {
+        if( 0 == strcmp( argv[i], "-f" ) ){ follow = 1; }
+        else                              { name = argv[i]; }
+    }
+
+    shm = AppIfShmReader_Open( name );
+    if( shm == NULL )
+    {
+        return EXIT_FAILURE;
+    }
+
+    if( follow == 0 )
+    {
+        if( AppIfShmReader_Latest( shm, &rec ) == EN_TRUE )
+        {
+            Print( shm, &rec );
+        }
+        AppIfShmReader_Close( shm );
+        return EXIT_SUCCESS;
+    }
+
+    while( 1 )
+    {
+        prev = cursor;
+        if( AppIfShmReader_Next( shm, &cursor, &rec ) == EN_TRUE )
+        {
+            if( rec.seq - 1 != prev )
+            {
+                fprintf( stderr, "shm_dump: %llu records lost. \n", rec.seq - 1 - prev );
+            }
+            Print( shm, &rec );
+        } else
+        {
+            fflush( stdout );
+            usleep( DUMP_POLL_USEC );
+        }
+    }
+
+    AppIfShmReader_Close( shm );
+    return EXIT_SUCCESS;
+}
+
+
+#ifdef __cplusplus
+    }
+#endif